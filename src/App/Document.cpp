@@ -41,6 +41,8 @@ user friendliness and speed (no one will wait for Undo too long).
 The FreeCAD document handles the dependencies of its DocumentObjects with
 an adjacence list. This gives the opportunity to calculate the shortest
 recompute path. Also enables more complicated dependencies beyond trees.
+Objects which don't depend on each other can be recomputed concurrently, see
+Document::setRecomputeThreads().
 
 
 @see App::Application
@@ -55,6 +57,8 @@ recompute path. Also enables more complicated dependencies beyond trees.
 # include <algorithm>
 # include <sstream>
 # include <climits>
+# include <cstring>
+# include <set>
 #endif
 
 #include <boost/graph/topological_sort.hpp>
@@ -65,6 +69,10 @@ recompute path. Also enables more complicated dependencies beyond trees.
 #include <boost/bind.hpp>
 #include <boost/regex.hpp>
 
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
 
 #include "Document.h"
 #include "DocumentPy.h"
@@ -145,8 +153,32 @@ struct DocumentP
     unsigned int UndoMaxStackSize;
     DependencyList DepList;
     std::map<DocumentObject*,Vertex> VertexObjectList;
-
-    DocumentP() {
+    // the objects each object links to and the objects linking to each object,
+    // both are kept up-to-date when a link property changes
+    std::map<const DocumentObject*, std::vector<DocumentObject*> > OutLists;
+    std::map<const DocumentObject*, std::vector<DocumentObject*> > InLists;
+    // DepList must be rebuilt because objects or links have changed
+    bool DependencyListDirty;
+    // the data files of a lazy restore that are read on demand from PendingArchive
+    std::map<const DocumentObject*, std::vector<Base::XMLReader::FileEntry> > PendingFiles;
+    // the objects whose onDocumentRestored() is called once their data files are read
+    std::set<const DocumentObject*> PendingRestored;
+    std::string PendingArchive;
+    // kept open as long as there are deferred data files
+    zipios::ZipFile* PendingZip;
+    bool LazyRestoring;
+    int RecomputeThreads;
+    // guards the recompute log and the scheduling of a parallel recompute
+    QMutex RecomputeMutex;
+    // serializes the property change notifications and guards the in-lists and
+    // out-lists during a parallel recompute
+    QMutex NotifyMutex;
+    // the observers of signalChangedObject may only be called from the main thread,
+    // so the changes of a parallel recompute are collected and emitted afterwards
+    std::vector<std::pair<const DocumentObject*, const Property*> > DeferredChanges;
+    bool DeferChanges;
+
+    DocumentP() : NotifyMutex(QMutex::Recursive) {
         activeObject = 0;
         activeUndoTransaction = 0;
         activeTransaction = 0;
@@ -157,11 +189,91 @@ struct DocumentP
         iUndoMode = 0;
         UndoMemSize = 0;
         UndoMaxStackSize = 20;
+        RecomputeThreads = 1;
+        DependencyListDirty = true;
+        LazyRestoring = false;
+        PendingZip = 0;
+        DeferChanges = false;
     }
 };
 
+/// Shared state of a parallel recompute
+struct RecomputeSchedule
+{
+    QThreadPool pool;
+    // the object of each vertex
+    std::vector<DocumentObject*> objects;
+    // number of dependencies of each vertex that are not yet finished
+    std::vector<int> pending;
+    // the vertices depending on each vertex
+    std::vector< std::vector<Vertex> > dependents;
+    bool abort;
+};
+
+/** Recomputes the object of one vertex of the dependency graph inside the thread
+ * pool of the document. Afterwards it starts the jobs of all objects whose dependencies
+ * are finished now.
+ */
+class RecomputeJob : public QRunnable
+{
+public:
+    RecomputeJob(Document* doc, RecomputeSchedule* schedule, Vertex vertex)
+        : doc(doc), schedule(schedule), vertex(vertex)
+    {
+    }
+    void run();
+
+private:
+    Document* doc;
+    RecomputeSchedule* schedule;
+    Vertex vertex;
+};
+
 } // namespace App
 
+void RecomputeJob::run()
+{
+    DocumentP* d = doc->d;
+    DocumentObject* Cur = schedule->objects[vertex];
+    bool abort;
+    {
+        QMutexLocker locker(&d->RecomputeMutex);
+        abort = schedule->abort;
+    }
+
+    if (Cur && !abort) {
+        bool NeedUpdate = false;
+
+        // ask the object if it should be recomputed
+        if (Cur->mustExecute() == 1)
+            NeedUpdate = true;
+        else {
+            // update if one of the dependencies is touched, all of them are already finished
+            DependencyList::out_edge_iterator j, jend;
+            for (boost::tie(j, jend) = out_edges(vertex, d->DepList); j != jend; ++j) {
+                DocumentObject* Test = schedule->objects[target(*j, d->DepList)];
+                if (Test && Test->isTouched()) {
+                    NeedUpdate = true;
+                    break;
+                }
+            }
+        }
+
+        if (NeedUpdate && doc->_recomputeFeature(Cur)) {
+            // if somthing happen skip all remaining objects
+            QMutexLocker locker(&d->RecomputeMutex);
+            schedule->abort = true;
+        }
+    }
+
+    QMutexLocker locker(&d->RecomputeMutex);
+    const std::vector<Vertex>& dependents = schedule->dependents[vertex];
+    for (std::vector<Vertex>::const_iterator it = dependents.begin(); it != dependents.end(); ++it) {
+        if (--schedule->pending[*it] == 0)
+            schedule->pool.start(new RecomputeJob(doc, schedule, *it));
+    }
+}
+
 PROPERTY_SOURCE(App::Document, App::PropertyContainer)
 
 void Document::writeDependencyGraphViz(std::ostream &out)
@@ -336,6 +448,18 @@ void Document::commitTransaction()
             delete mUndoTransactions.front();
             mUndoTransactions.pop_front();
         }
+        // a memory limit of zero means no limit, the last transaction is always kept
+        if (d->UndoMemSize > 0) {
+            unsigned int size = 0;
+            std::list<Transaction*>::iterator it;
+            for (it = mUndoTransactions.begin(); it != mUndoTransactions.end(); ++it)
+                size += (*it)->getMemSize();
+            while (size > d->UndoMemSize && mUndoTransactions.size() > 1) {
+                size -= mUndoTransactions.front()->getMemSize();
+                delete mUndoTransactions.front();
+                mUndoTransactions.pop_front();
+            }
+        }
     }
 }
 
@@ -439,15 +563,28 @@ void Document::onChanged(const Property* prop)
 
 void Document::onBeforeChangeProperty(const DocumentObject *Who, const Property *What)
 {
+    QMutexLocker locker(&d->NotifyMutex);
+    // the deferred data must not overwrite the new value later on
+    if (!d->PendingFiles.empty())
+        restorePendingFiles(Who);
     if (d->activeUndoTransaction && !d->rollback)
         d->activeUndoTransaction->addObjectChange(Who,What);
 }
 
 void Document::onChangedProperty(const DocumentObject *Who, const Property *What)
 {
+    QMutexLocker locker(&d->NotifyMutex);
+    if (What->isDerivedFrom(PropertyLink::getClassTypeId()) ||
+        What->isDerivedFrom(PropertyLinkSub::getClassTypeId()) ||
+        What->isDerivedFrom(PropertyLinkList::getClassTypeId()) ||
+        What->isDerivedFrom(PropertyLinkSubList::getClassTypeId()))
+        _updateOutList(Who);
     if (d->activeTransaction && !d->rollback)
         d->activeTransaction->addObjectChange(Who,What);
-    signalChangedObject(*Who, *What);
+    if (d->DeferChanges)
+        d->DeferredChanges.push_back(std::make_pair(Who, What));
+    else
+        signalChangedObject(*Who, *What);
 }
 
 void Document::setTransactionMode(int iMode)
@@ -519,6 +656,8 @@ Document::Document(void)
     // have to care about ref counting any more.
     DocumentPythonObject = Py::Object(new DocumentPy(this), true);
     d = new DocumentP;
+    d->RecomputeThreads = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Document")->GetInt("RecomputeThreads",1);
 
 #ifdef FC_LOGUPDATECHAIN
     Console().Log("+App::Document: %p\n",this);
@@ -570,6 +709,9 @@ Document::~Document()
     for (it = d->objectMap.begin(); it != d->objectMap.end(); ++it) {
         delete(it->second);
     }
+    d->OutLists.clear();
+    d->InLists.clear();
+    _clearPendingFiles();
 
     // Remark: The API of Py::Object has been changed to set whether the wrapper owns the passed
     // Python object or not. In the constructor we forced the wrapper to own the object so we need
@@ -690,6 +832,9 @@ void Document::Restore(Base::XMLReader &reader)
 void Document::exportObjects(const std::vector<App::DocumentObject*>& obj,
                              std::ostream& out)
 {
+    for (std::vector<App::DocumentObject*>::const_iterator it = obj.begin(); it != obj.end(); ++it)
+        restorePendingFiles(*it);
+
     Base::ZipWriter writer(out);
     writer.putNextEntry("Document.xml");
     writer.Stream() << "<?xml version='1.0' encoding='utf-8'?>" << endl;
@@ -783,9 +928,20 @@ Document::readObjects(Base::XMLReader& reader)
         std::string name = reader.getName(reader.getAttribute("name"));
         DocumentObject* pObj = getObject(name.c_str());
         if (pObj) { // check if this feature has been registered
+            std::size_t first = reader.countFiles();
             pObj->StatusBits.set(4);
             pObj->Restore(reader);
             pObj->StatusBits.reset(4);
+            // with a lazy restore the data files of the object are read on demand
+            if (d->LazyRestoring && reader.countFiles() > first) {
+                std::vector<Base::XMLReader::FileEntry>& files = d->PendingFiles[pObj];
+                files = reader.takeFiles(first);
+                for (std::vector<Base::XMLReader::FileEntry>::iterator it = files.begin(); it != files.end(); ++it) {
+                    Property* prop = dynamic_cast<Property*>(const_cast<Base::Persistence*>(it->Object));
+                    if (prop)
+                        prop->StatusBits.set(4);
+                }
+            }
         }
         reader.readEndElement("Object");
     }
@@ -827,7 +983,13 @@ unsigned int Document::getMemSize (void) const
     size += PropertyContainer::getMemSize();
 
     // Undo Redo size
-    size += getUndoMemSize();
+    std::list<Transaction*>::const_iterator jt;
+    for (jt = mUndoTransactions.begin(); jt != mUndoTransactions.end(); ++jt)
+        size += (*jt)->getMemSize();
+    for (jt = mRedoTransactions.begin(); jt != mRedoTransactions.end(); ++jt)
+        size += (*jt)->getMemSize();
+    if (d->activeUndoTransaction)
+        size += d->activeUndoTransaction->getMemSize();
 
     return size;
 }
@@ -864,6 +1026,8 @@ bool Document::save (void)
         ("User parameter:BaseApp/Preferences/Document")->GetInt("CompressionLevel",3);
 
     if (*(FileName.getValue()) != '\0') {
+        // all deferred data must be read before the project file gets overwritten
+        restorePendingFiles();
         LastModifiedDate.setValue(Base::TimeInfo::currentDateTimeString());
         // make a tmp. file where to save the project data first and then rename to
         // the actual file name. This may be useful if overwriting an existing file
@@ -968,6 +1132,10 @@ void Document::restore (void)
     }
     d->objectArray.clear();
     d->objectMap.clear();
+    d->OutLists.clear();
+    d->InLists.clear();
+    _clearPendingFiles();
+    d->DependencyListDirty = true;
     d->activeObject = 0;
 
     Base::FileInfo fi(FileName.getValue());
@@ -986,12 +1154,18 @@ void Document::restore (void)
 
     GetApplication().signalStartRestoreDocument(*this);
 
+    // With a lazy restore only Document.xml is read now and the data files of the
+    // objects are read when they are accessed, recomputed or displayed
+    d->LazyRestoring = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Document")->GetBool("LazyRestore",false);
+    d->PendingArchive = FileName.getValue();
     try {
         Document::Restore(reader);
     }
     catch (const Base::Exception& e) {
         Base::Console().Error("Invalid Document.xml: %s\n", e.what());
     }
+    d->LazyRestoring = false;
 
     // Special handling for Gui document, the view representations must already
     // exist, what is done in Restore().
@@ -1002,13 +1176,99 @@ void Document::restore (void)
     
     // reset all touched
     for (std::map<std::string,DocumentObject*>::iterator It= d->objectMap.begin();It!=d->objectMap.end();++It) {
-        It->second->onDocumentRestored();
+        // objects whose data is still deferred are finished when it is read
+        if (hasPendingFiles(It->second))
+            d->PendingRestored.insert(It->second);
+        else
+            It->second->onDocumentRestored();
         It->second->purgeTouched();
     }
 
     GetApplication().signalFinishRestoreDocument(*this);
 }
 
+bool Document::hasPendingFiles(const DocumentObject* obj) const
+{
+    QMutexLocker locker(&d->NotifyMutex);
+    return d->PendingFiles.find(obj) != d->PendingFiles.end();
+}
+
+void Document::restorePendingFiles(const DocumentObject* obj)
+{
+    QMutexLocker locker(&d->NotifyMutex);
+    std::map<const DocumentObject*, std::vector<Base::XMLReader::FileEntry> >::iterator it;
+    it = d->PendingFiles.find(obj);
+    if (it == d->PendingFiles.end())
+        return;
+    // remove the entry first because reading the data notifies this document again
+    std::vector<Base::XMLReader::FileEntry> files;
+    files.swap(it->second);
+    d->PendingFiles.erase(it);
+
+    // the properties can be accessed again while their data is read
+    for (std::vector<Base::XMLReader::FileEntry>::iterator jt = files.begin(); jt != files.end(); ++jt) {
+        Property* prop = dynamic_cast<Property*>(const_cast<Base::Persistence*>(jt->Object));
+        if (prop)
+            prop->StatusBits.reset(4);
+    }
+
+    // reading the data must neither be recorded for undo nor mark the object as touched
+    DocumentObject* pObj = const_cast<DocumentObject*>(obj);
+    bool touched = pObj->isTouched();
+    bool rollback = d->rollback;
+    d->rollback = true;
+    pObj->StatusBits.set(4);
+
+    try {
+        // the central directory of the archive is read only once
+        if (!d->PendingZip)
+            d->PendingZip = new zipios::ZipFile(d->PendingArchive);
+        for (std::vector<Base::XMLReader::FileEntry>::iterator jt = files.begin(); jt != files.end(); ++jt) {
+            std::istream* str = d->PendingZip->getInputStream(jt->FileName);
+            if (!str) {
+                Base::Console().Error("Embedded file '%s' not found in '%s'\n",
+                    jt->FileName.c_str(), d->PendingArchive.c_str());
+                continue;
+            }
+            try {
+                jt->Object->RestoreDocFile(*str);
+            }
+            catch (...) {
+                Base::Console().Error("Reading failed from embedded file: %s\n", jt->FileName.c_str());
+            }
+            delete str;
+        }
+    }
+    catch (const std::exception& e) {
+        Base::Console().Error("Cannot read data of '%s' from '%s': %s\n",
+            obj->getNameInDocument(), d->PendingArchive.c_str(), e.what());
+    }
+
+    pObj->StatusBits.reset(4);
+    if (d->PendingRestored.erase(obj) > 0)
+        pObj->onDocumentRestored();
+    d->rollback = rollback;
+    if (!touched)
+        pObj->purgeTouched();
+
+    if (d->PendingFiles.empty())
+        _clearPendingFiles();
+}
+
+void Document::_clearPendingFiles()
+{
+    d->PendingFiles.clear();
+    d->PendingRestored.clear();
+    delete d->PendingZip;
+    d->PendingZip = 0;
+}
+
+void Document::restorePendingFiles()
+{
+    while (!d->PendingFiles.empty())
+        restorePendingFiles(d->PendingFiles.begin()->first);
+}
+
 bool Document::isSaved() const
 {
     std::string name = FileName.getValue();
@@ -1076,35 +1336,99 @@ int Document::countObjects(void) const
 
 std::vector<App::DocumentObject*> Document::getInList(const DocumentObject* me) const
 {
-    // result list
-    std::vector<App::DocumentObject*> result;
-    // go through all objects
-    for (std::map<std::string,DocumentObject*>::const_iterator It = d->objectMap.begin(); It != d->objectMap.end();++It) {
-        // get the outList and search if me is in that list
-        std::vector<DocumentObject*> OutList = It->second->getOutList();
-        for (std::vector<DocumentObject*>::const_iterator It2=OutList.begin();It2!=OutList.end();++It2)
-            if (*It2 && *It2 == me)
-                // add the parent object
-                result.push_back(It->second);
+    // the links can change in the worker threads of a parallel recompute
+    QMutexLocker locker(&d->NotifyMutex);
+    std::map<const DocumentObject*, std::vector<DocumentObject*> >::const_iterator it = d->InLists.find(me);
+    if (it == d->InLists.end())
+        return std::vector<App::DocumentObject*>();
+    return it->second;
+}
+
+namespace App {
+// sorts the in-lists by the object names like the objects of the document
+static bool compareByName(const DocumentObject* a, const DocumentObject* b)
+{
+    const char* na = a ? a->getNameInDocument() : 0;
+    const char* nb = b ? b->getNameInDocument() : 0;
+    if (!na || !nb)
+        return !na && nb;
+    return strcmp(na, nb) < 0;
+}
+
+// removes obj once from the in-list of each object in targets
+static void removeFromInLists(std::map<const DocumentObject*, std::vector<DocumentObject*> >& InLists,
+                              const std::vector<DocumentObject*>& targets, const DocumentObject* obj)
+{
+    for (std::vector<DocumentObject*>::const_iterator It = targets.begin(); It != targets.end(); ++It) {
+        std::map<const DocumentObject*, std::vector<DocumentObject*> >::iterator jt = InLists.find(*It);
+        if (jt != InLists.end()) {
+            std::vector<DocumentObject*>::iterator kt = std::find(jt->second.begin(), jt->second.end(), obj);
+            if (kt != jt->second.end())
+                jt->second.erase(kt);
+            if (jt->second.empty())
+                InLists.erase(jt);
+        }
     }
-    return result;
+}
 }
 
+void Document::_updateOutList(const DocumentObject* obj)
+{
+    std::vector<DocumentObject*> OutList = obj->getOutList();
+    std::vector<DocumentObject*>& oldList = d->OutLists[obj];
+    if (OutList == oldList)
+        return;
+
+    // the in-lists are kept in the order getInList() returned before they were cached
+    DocumentObject* me = const_cast<DocumentObject*>(obj);
+    removeFromInLists(d->InLists, oldList, obj);
+    for (std::vector<DocumentObject*>::const_iterator It = OutList.begin(); It != OutList.end(); ++It) {
+        std::vector<DocumentObject*>& inList = d->InLists[*It];
+        inList.insert(std::upper_bound(inList.begin(), inList.end(), me, compareByName), me);
+    }
+
+    oldList.swap(OutList);
+    d->DependencyListDirty = true;
+}
+
+void Document::_removeOutList(const DocumentObject* obj)
+{
+    // the in-list of obj is kept because other objects may still link to it
+    // (e.g. if it is removed by an undo and added again by a redo)
+    std::map<const DocumentObject*, std::vector<DocumentObject*> >::iterator it = d->OutLists.find(obj);
+    if (it != d->OutLists.end()) {
+        removeFromInLists(d->InLists, it->second, obj);
+        d->OutLists.erase(it);
+    }
+    d->DependencyListDirty = true;
+}
 
 void Document::_rebuildDependencyList(void){
 
+    // the graph is only rebuilt if an object or a link has changed since the last time
+    if (!d->DependencyListDirty)
+        return;
+    d->DepList.clear();
+    d->VertexObjectList.clear();
+
     // Filling up the adjacency List
     for (std::map<std::string,DocumentObject*>::const_iterator It = d->objectMap.begin(); It != d->objectMap.end();++It)
         // add the object as Vertex and remember the index
         d->VertexObjectList[It->second] = add_vertex(d->DepList);
-    // add the edges
+    // add the edges from the cached out-lists
     for (std::map<std::string,DocumentObject*>::const_iterator It = d->objectMap.begin(); It != d->objectMap.end();++It) {
-        std::vector<DocumentObject*> OutList = It->second->getOutList();
-        for (std::vector<DocumentObject*>::const_iterator It2=OutList.begin();It2!=OutList.end();++It2)
-            if (*It2)
-                add_edge(d->VertexObjectList[It->second],d->VertexObjectList[*It2],d->DepList);
+        std::map<const DocumentObject*, std::vector<DocumentObject*> >::const_iterator jt = d->OutLists.find(It->second);
+        if (jt == d->OutLists.end())
+            continue;
+        for (std::vector<DocumentObject*>::const_iterator It2=jt->second.begin();It2!=jt->second.end();++It2) {
+            std::map<DocumentObject*,Vertex>::const_iterator vt = d->VertexObjectList.find(*It2);
+            // skip links to objects which are not part of the document
+            if (vt != d->VertexObjectList.end())
+                add_edge(d->VertexObjectList[It->second],vt->second,d->DepList);
+        }
     }
 
+    d->DependencyListDirty = false;
 }
 
 
@@ -1149,47 +1473,56 @@ void Document::recompute()
     for (std::map<DocumentObject*,Vertex>::const_iterator It1= d->VertexObjectList.begin();It1 != d->VertexObjectList.end(); ++It1)
         d->vertexMap[It1->second] = It1->first;
 
+    if (d->RecomputeThreads > 1) {
+        if (!_recomputeParallel()) {
+            // if somthing happen break execution of recompute
+            d->vertexMap.clear();
+            return;
+        }
+    }
+    else {
 #ifdef FC_LOGFEATUREUPDATE
-    std::clog << "make ordering: " << std::endl;
+        std::clog << "make ordering: " << std::endl;
 #endif
 
-    for (std::list<Vertex>::reverse_iterator i = make_order.rbegin();i != make_order.rend(); ++i) {
-        DocumentObject* Cur = d->vertexMap[*i];
-        if (!Cur) continue;
+        for (std::list<Vertex>::reverse_iterator i = make_order.rbegin();i != make_order.rend(); ++i) {
+            DocumentObject* Cur = d->vertexMap[*i];
+            if (!Cur) continue;
 #ifdef FC_LOGFEATUREUPDATE
-        std::clog << Cur->getNameInDocument() << " dep on: " ;
+            std::clog << Cur->getNameInDocument() << " dep on: " ;
 #endif
-        bool NeedUpdate = false;
-
-        // ask the object if it should be recomputed
-        if (Cur->mustExecute() == 1)
-            NeedUpdate = true;
-        else {// if (Cur->mustExecute() == -1)
-            // update if one of the dependencies is touched
-            for (boost::tie(j, jend) = out_edges(*i, d->DepList); j != jend; ++j) {
-                DocumentObject* Test = d->vertexMap[target(*j, d->DepList)];
-                if (!Test) continue;
+            bool NeedUpdate = false;
+
+            // ask the object if it should be recomputed
+            if (Cur->mustExecute() == 1)
+                NeedUpdate = true;
+            else {// if (Cur->mustExecute() == -1)
+                // update if one of the dependencies is touched
+                for (boost::tie(j, jend) = out_edges(*i, d->DepList); j != jend; ++j) {
+                    DocumentObject* Test = d->vertexMap[target(*j, d->DepList)];
+                    if (!Test) continue;
 #ifdef FC_LOGFEATUREUPDATE
-                std::clog << Test->getNameInDocument() << ", " ;
+                    std::clog << Test->getNameInDocument() << ", " ;
 #endif
-                if (Test->isTouched()) {
-                    NeedUpdate = true;
-                    break;
+                    if (Test->isTouched()) {
+                        NeedUpdate = true;
+                        break;
+                    }
                 }
-            }
 #ifdef FC_LOGFEATUREUPDATE
-            std::clog << std::endl;
+                std::clog << std::endl;
 #endif
-        }
-        // if one touched recompute
-        if (NeedUpdate) {
+            }
+            // if one touched recompute
+            if (NeedUpdate) {
 #ifdef FC_LOGFEATUREUPDATE
-            std::clog << "Recompute" << std::endl;
+                std::clog << "Recompute" << std::endl;
 #endif
-            if (_recomputeFeature(Cur)) {
-                // if somthing happen break execution of recompute
-                d->vertexMap.clear();
-                return;
+                if (_recomputeFeature(Cur)) {
+                    // if somthing happen break execution of recompute
+                    d->vertexMap.clear();
+                    return;
+                }
             }
         }
     }
@@ -1202,6 +1535,64 @@ void Document::recompute()
     d->vertexMap.clear();
 }
 
+bool Document::_recomputeParallel(void)
+{
+    RecomputeSchedule schedule;
+    schedule.abort = false;
+    std::size_t size = num_vertices(d->DepList);
+    schedule.objects.resize(size, 0);
+    schedule.pending.resize(size, 0);
+    schedule.dependents.resize(size);
+    for (std::map<Vertex,DocumentObject*>::const_iterator it = d->vertexMap.begin(); it != d->vertexMap.end(); ++it)
+        schedule.objects[it->first] = it->second;
+
+    // an edge points from an object to one of its dependencies
+    Traits::edge_iterator ei, ei_end;
+    for (boost::tie(ei, ei_end) = edges(d->DepList); ei != ei_end; ++ei) {
+        Vertex obj = source(*ei, d->DepList);
+        Vertex dep = target(*ei, d->DepList);
+        schedule.pending[obj]++;
+        schedule.dependents[dep].push_back(obj);
+    }
+
+    schedule.pool.setMaxThreadCount(d->RecomputeThreads);
+    d->DeferChanges = true;
+    {
+        // start with all objects without dependencies, the jobs start their dependents
+        QMutexLocker locker(&d->RecomputeMutex);
+        for (Vertex v = 0; v < size; v++) {
+            if (schedule.pending[v] == 0)
+                schedule.pool.start(new RecomputeJob(this, &schedule, v));
+        }
+    }
+    schedule.pool.waitForDone();
+
+    // notify the observers in the order the properties have changed
+    std::vector<std::pair<const DocumentObject*, const Property*> > changes;
+    changes.swap(d->DeferredChanges);
+    d->DeferChanges = false;
+    for (std::vector<std::pair<const DocumentObject*, const Property*> >::iterator it = changes.begin(); it != changes.end(); ++it)
+        signalChangedObject(*it->first, *it->second);
+
+    return !schedule.abort;
+}
+
+void Document::_addRecomputeLog(DocumentObjectExecReturn* returnCode)
+{
+    QMutexLocker locker(&d->RecomputeMutex);
+    _RecomputeLog.push_back(returnCode);
+}
+
+void Document::setRecomputeThreads(int count)
+{
+    d->RecomputeThreads = std::max<int>(count, 1);
+}
+
+int Document::getRecomputeThreads() const
+{
+    return d->RecomputeThreads;
+}
+
 const char * Document::getErrorDescription(const App::DocumentObject*Obj) const
 {
     for (std::vector<App::DocumentObjectExecReturn*>::const_iterator it=_RecomputeLog.begin();it!=_RecomputeLog.end();++it)
@@ -1217,38 +1608,51 @@ bool Document::_recomputeFeature(DocumentObject* Feat)
     std::clog << "Solv: Executing Feature: " << Feat->getNameInDocument() << std::endl;;
 #endif
 
+    // the object and the objects it depends on need their data
+    bool pending;
+    {
+        QMutexLocker locker(&d->NotifyMutex);
+        pending = !d->PendingFiles.empty();
+    }
+    if (pending) {
+        restorePendingFiles(Feat);
+        std::vector<DocumentObject*> OutList = Feat->getOutList();
+        for (std::vector<DocumentObject*>::iterator it = OutList.begin(); it != OutList.end(); ++it)
+            restorePendingFiles(*it);
+    }
+
     DocumentObjectExecReturn  *returnCode = 0;
     try {
         returnCode = Feat->recompute();
     }
     catch(Base::AbortException &e){
         e.ReportException();
-        _RecomputeLog.push_back(new DocumentObjectExecReturn("User abort",Feat));
+        _addRecomputeLog(new DocumentObjectExecReturn("User abort",Feat));
         Feat->setError();
         return true;
     }
     catch (const Base::MemoryException& e) {
         Base::Console().Error("Memory exception in feature '%s' thrown: %s\n",Feat->getNameInDocument(),e.what());
-        _RecomputeLog.push_back(new DocumentObjectExecReturn("Out of memory exception",Feat));
+        _addRecomputeLog(new DocumentObjectExecReturn("Out of memory exception",Feat));
         Feat->setError();
         return true;
     }
     catch (Base::Exception &e) {
         e.ReportException();
-        _RecomputeLog.push_back(new DocumentObjectExecReturn(e.what(),Feat));
+        _addRecomputeLog(new DocumentObjectExecReturn(e.what(),Feat));
         Feat->setError();
         return false;
     }
     catch (std::exception &e) {
         Base::Console().Warning("exception in Feature \"%s\" thrown: %s\n",Feat->getNameInDocument(),e.what());
-        _RecomputeLog.push_back(new DocumentObjectExecReturn(e.what(),Feat));
+        _addRecomputeLog(new DocumentObjectExecReturn(e.what(),Feat));
         Feat->setError();
         return false;
     }
 #ifndef FC_DEBUG
     catch (...) {
         Base::Console().Error("App::Document::_RecomputeFeature(): Unknown exception in Feature \"%s\" thrown\n",Feat->getNameInDocument());
-        _RecomputeLog.push_back(new DocumentObjectExecReturn("Unknown exeption!"));
+        _addRecomputeLog(new DocumentObjectExecReturn("Unknown exeption!"));
         Feat->setError();
         return true;
     }
@@ -1260,7 +1664,7 @@ bool Document::_recomputeFeature(DocumentObject* Feat)
     }
     else {
         returnCode->Which = Feat;
-        _RecomputeLog.push_back(returnCode);
+        _addRecomputeLog(returnCode);
         Base::Console().Error("%s\n",returnCode->Why.c_str());
         Feat->setError();
     }
@@ -1321,6 +1725,8 @@ DocumentObject * Document::addObject(const char* sType, const char* pObjectName)
     d->objectArray.push_back(pcObject);
     // insert in the adjacence list and referenc through the ConectionMap
     //_DepConMap[pcObject] = add_vertex(_DepList);
+    _updateOutList(pcObject);
+    d->DependencyListDirty = true;
 
     pcObject->Label.setValue( ObjectName );
 
@@ -1339,6 +1745,9 @@ void Document::_addObject(DocumentObject* pcObject, const char* pObjectName)
     d->objectArray.push_back(pcObject);
     // cache the pointer to the name string in the Object (for performance of DocumentObject::getNameInDocument())
     pcObject->pcNameInDocument = &(d->objectMap.find(pObjectName)->first);
+    // the object may already link to other objects (undo/redo or moved from another document)
+    _updateOutList(pcObject);
+    d->DependencyListDirty = true;
 
     // do no transactions if we do a rollback!
     if(!d->rollback){
@@ -1378,8 +1787,13 @@ void Document::remObject(const char* sName)
         }
     }
 
+    // the object may be kept for undo, so its deferred data must be read now
+    if (d->activeUndoTransaction && !d->rollback)
+        restorePendingFiles(pos->second);
+
     // Before deleting we must nullify all dependant objects
     breakDependency(pos->second, true);
+    _removeOutList(pos->second);
 
     // do no transactions if we do a rollback!
     if(!d->rollback){
@@ -1395,9 +1809,14 @@ void Document::remObject(const char* sName)
             // set name cache false
             //pos->second->pcNameInDocument = 0;
         }
-        else
+        else {
             // if not saved in undo -> delete object
+            d->PendingFiles.erase(pos->second);
+            d->PendingRestored.erase(pos->second);
+            if (d->PendingFiles.empty())
+                _clearPendingFiles();
             delete pos->second;
+        }
     }
 
     for (std::vector<DocumentObject*>::iterator obj = d->objectArray.begin(); obj != d->objectArray.end(); ++obj) {
@@ -1422,6 +1841,9 @@ void Document::_remObject(DocumentObject* pcObject)
     if (d->activeObject == pcObject)
         d->activeObject = 0;
 
+    // the object is kept by a transaction, so its deferred data must be read now
+    restorePendingFiles(pcObject);
+
     signalDeletedObject(*pcObject);
 
     // do no transactions if we do a rollback!
@@ -1436,6 +1858,7 @@ void Document::_remObject(DocumentObject* pcObject)
     }
     // remove from map
     d->objectMap.erase(pos);
+    _removeOutList(pcObject);
     //// set name cache false
     //pcObject->pcNameInDocument = 0;
 
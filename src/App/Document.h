@@ -51,6 +51,7 @@ namespace App
     class DocumentPy; // the python document class
     class Application;
     class Transaction;
+    class RecomputeJob;
 }
 
 namespace App
@@ -144,6 +145,12 @@ public:
     bool isSaved() const;
     /// Get the document name
     const char* getName() const;
+    /// Returns true if the data files of the object have not been read yet by a lazy restore
+    bool hasPendingFiles(const DocumentObject*) const;
+    /// Reads the data files of the object that were deferred by a lazy restore
+    void restorePendingFiles(const DocumentObject*);
+    /// Reads all data files that were deferred by a lazy restore
+    void restorePendingFiles();
     //@}
 
     virtual void Save (Base::Writer &writer) const;
@@ -209,6 +216,12 @@ public:
     void recompute();
     /// Recompute only one feature
     void recomputeFeature(DocumentObject* Feat);
+    /** Set the maximum number of threads used to recompute independent objects.
+     * A value less or equal to 1 recomputes all objects serially in the main thread.
+     */
+    void setRecomputeThreads(int);
+    /// Returns the maximum number of threads used for recomputation
+    int getRecomputeThreads() const;
     /// get the error log from the recompute run
     const std::vector<App::DocumentObjectExecReturn*> &getRecomputeLog(void)const{return _RecomputeLog;}
     /// get the text of the error of a spezified object
@@ -275,6 +288,8 @@ public:
     friend class DocumentObject;
     friend class Transaction;
     friend class TransactionObject;
+    /// because of parallel recomputation
+    friend class RecomputeJob;
 
     /// Destruction 
     virtual ~Document();
@@ -300,9 +315,19 @@ protected:
     void onChangedProperty(const DocumentObject *Who, const Property *What);
     /// helper which Recompute only this feature
     bool _recomputeFeature(DocumentObject* Feat);
+    /// helper which recomputes the touched objects of the dependency graph with a thread pool
+    bool _recomputeParallel(void);
+    /// adds an entry to the recompute log, this is thread-safe
+    void _addRecomputeLog(DocumentObjectExecReturn*);
     void _clearRedos();
-    /// refresh the internal dependency graph
+    /// refresh the internal dependency graph if objects or links have changed
     void _rebuildDependencyList(void);
+    /// updates the cached out-list of the object and the in-lists of the objects it links to
+    void _updateOutList(const DocumentObject*);
+    /// removes the cached out-list of an object which leaves the document
+    void _removeOutList(const DocumentObject*);
+    /// forgets the deferred data files of a lazy restore and closes the archive
+    void _clearPendingFiles();
 
 
 private:
@@ -174,6 +174,13 @@ void DocumentObject::setDocument(App::Document* doc)
     onSettingDocument();
 }
 
+void DocumentObject::onRemovedDynamicProperty()
+{
+    // the removed property may have been a link
+    if (_pDoc)
+        _pDoc->_updateOutList(this);
+}
+
 void DocumentObject::onBeforeChange(const Property* prop)
 {
     if (_pDoc)
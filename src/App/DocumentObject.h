@@ -185,6 +185,8 @@ protected:
     virtual void onFinishDuplicating() {}
     /// get called after setting the document
     virtual void onSettingDocument() {}
+    /// must be called after removing a dynamic property to update the links in the document
+    void onRemovedDynamicProperty();
 
      /// python object of this class and all descendend
 protected: // attributes
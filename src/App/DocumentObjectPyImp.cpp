@@ -142,6 +142,11 @@ Py::List DocumentObjectPy::getOutList(void) const
 
 PyObject *DocumentObjectPy::getCustomAttributes(const char* /*attr*/) const
 {
+    // make sure that the data of a lazily restored object is read before it's accessed
+    DocumentObject* object = getDocumentObjectPtr();
+    App::Document* doc = object->getDocument();
+    if (doc && doc->hasPendingFiles(object))
+        doc->restorePendingFiles(object);
     return 0;
 }
 
@@ -29,6 +29,7 @@
 
 #include "Document.h"
 #include <Base/FileInfo.h>
+#include <Base/Interpreter.h>
 #include <Base/PyTools.h>
 #include "DocumentObject.h"
 #include "DocumentObjectPy.h"
@@ -216,6 +217,17 @@ PyObject*  DocumentPy::moveObject(PyObject *args)
     }
 }
 
+PyObject*  DocumentPy::hasPendingFiles(PyObject *args)
+{
+    PyObject *obj;
+    if (!PyArg_ParseTuple(args, "O!",&(DocumentObjectPy::Type),&obj))
+        return NULL;    // NULL triggers exception
+
+    DocumentObjectPy* docObj = static_cast<DocumentObjectPy*>(obj);
+    bool pending = getDocumentPtr()->hasPendingFiles(docObj->getDocumentObjectPtr());
+    return Py::new_reference_to(Py::Boolean(pending));
+}
+
 PyObject*  DocumentPy::openTransaction(PyObject *args)
 {
     char *pstr=0;
@@ -272,7 +284,14 @@ PyObject*  DocumentPy::recompute(PyObject * args)
 {
     if (!PyArg_ParseTuple(args, ""))     // convert args: Python->C 
         return NULL;                    // NULL triggers exception 
-    getDocumentPtr()->recompute();
+    if (getDocumentPtr()->getRecomputeThreads() > 1) {
+        // the worker threads must be able to grab the GIL for Python features
+        Base::PyGILStateRelease unlock;
+        getDocumentPtr()->recompute();
+    }
+    else {
+        getDocumentPtr()->recompute();
+    }
     Py_Return;
 }
 
@@ -388,6 +407,16 @@ void  DocumentPy::setUndoMode(Py::Int arg)
     getDocumentPtr()->setUndoMode(arg); 
 }
 
+Py::Int DocumentPy::getRecomputeThreads(void) const
+{
+    return Py::Int(getDocumentPtr()->getRecomputeThreads());
+}
+
+void  DocumentPy::setRecomputeThreads(Py::Int arg)
+{
+    getDocumentPtr()->setRecomputeThreads(arg);
+}
+
 Py::Int DocumentPy::getUndoRedoMemSize(void) const
 {
     return Py::Int((long)getDocumentPtr()->getUndoMemSize());
@@ -101,7 +101,10 @@ public:
         return props->addDynamicProperty(type, name, group, doc, attr, ro, hidden);
     }
     virtual bool removeDynamicProperty(const char* name) {
-        return props->removeDynamicProperty(name);
+        if (!props->removeDynamicProperty(name))
+            return false;
+        this->onRemovedDynamicProperty();
+        return true;
     }
     std::vector<std::string> getDynamicPropertyNames() const {
         return props->getDynamicPropertyNames();
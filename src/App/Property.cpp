@@ -30,6 +30,8 @@
 /// Here the FreeCAD includes sorted by Base,App,Gui......
 #include "Property.h"
 #include "PropertyContainer.h"
+#include "Document.h"
+#include "DocumentObject.h"
 
 using namespace App;
 
@@ -88,6 +90,17 @@ void Property::touch()
     StatusBits.set(0);
 }
 
+void Property::restoreDeferredData(void) const
+{
+    // the data files of a lazy restore are read per object
+    if (father && father->isDerivedFrom(DocumentObject::getClassTypeId())) {
+        DocumentObject* obj = static_cast<DocumentObject*>(father);
+        Document* doc = obj->getDocument();
+        if (doc)
+            doc->restorePendingFiles(obj);
+    }
+}
+
 void Property::hasSetValue(void)
 {
     if (father)
@@ -109,11 +109,19 @@ public:
      * 1 - object is marked as 'immutable'
      * 2 - object is marked as 'read-ony' (for property editor)
      * 3 - object is marked as 'hidden' (for property editor)
+     * 4 - object is marked as 'deferred', i.e. a lazy restore hasn't read its data file yet
      */
     std::bitset<32> StatusBits;
 
+    /// Test if the data file of this property hasn't been read yet by a lazy restore
+    bool isDeferred(void) const {return StatusBits.test(4);}
+
 
 protected:
+    /** Reads the data file of the property if a lazy restore has deferred it.
+     * All methods of properties with data files that access the data must call it.
+     */
+    void restoreDeferred(void) const {if (isDeferred()) restoreDeferredData();}
     /// Gets called by all setValue() methods after the value has changed
     void hasSetValue(void);
     /// Gets called by all setValue() methods before the value has changed
@@ -124,6 +132,9 @@ private:
     Property(const Property&);
     Property& operator = (const Property&);
 
+private:
+    void restoreDeferredData(void) const;
+
 private:
     PropertyContainer *father;
 };
@@ -174,6 +174,8 @@ void PropertyFileIncluded::setValue(const char* sFile, const char* sName)
 
 const char* PropertyFileIncluded::getValue(void) const
 {
+     // the file is created when the data of a lazy restore is read
+     restoreDeferred();
      return _cValue.c_str();
 }
 
@@ -205,6 +205,7 @@ void PropertyVectorList::setSize(int newSize)
 
 int PropertyVectorList::getSize(void) const
 {
+    restoreDeferred();
     return static_cast<int>(_lValueList.size());
 }
 
@@ -315,6 +316,11 @@ void PropertyVectorList::RestoreDocFile(Base::Reader &reader)
     setValues(values);
 }
 
+bool PropertyVectorList::isSaveDocFileThreadSafe() const
+{
+    return true;
+}
+
 Property *PropertyVectorList::Copy(void) const
 {
     PropertyVectorList *p= new PropertyVectorList();
@@ -127,16 +127,19 @@ public:
 
     /// index operator
     const Base::Vector3f& operator[] (const int idx) const {
+        restoreDeferred();
         return _lValueList.operator[] (idx);
     }
 
     void set1Value (const int idx, const Base::Vector3f& value) {
+        restoreDeferred();
         _lValueList.operator[] (idx) = value;
     }
 
     void setValues (const std::vector<Base::Vector3f>& values);
 
     const std::vector<Base::Vector3f> &getValues(void) const {
+        restoreDeferred();
         return _lValueList;
     }
 
@@ -148,6 +151,7 @@ public:
 
     virtual void SaveDocFile (Base::Writer &writer) const;
     virtual void RestoreDocFile(Base::Reader &reader);
+    virtual bool isSaveDocFileThreadSafe() const;
 
     virtual Property *Copy(void) const;
     virtual void Paste(const Property &from);
@@ -904,6 +904,7 @@ void PropertyFloatList::setSize(int newSize)
 
 int PropertyFloatList::getSize(void) const
 {
+    restoreDeferred();
     return static_cast<int>(_lValueList.size());
 }
 
@@ -1009,6 +1010,11 @@ void PropertyFloatList::RestoreDocFile(Base::Reader &reader)
     setValues(values);
 }
 
+bool PropertyFloatList::isSaveDocFileThreadSafe() const
+{
+    return true;
+}
+
 Property *PropertyFloatList::Copy(void) const
 {
     PropertyFloatList *p= new PropertyFloatList();
@@ -1851,6 +1857,7 @@ void PropertyColorList::setSize(int newSize)
 
 int PropertyColorList::getSize(void) const
 {
+    restoreDeferred();
     return static_cast<int>(_lValueList.size());
 }
 
@@ -1968,6 +1975,11 @@ void PropertyColorList::RestoreDocFile(Base::Reader &reader)
     setValues(values);
 }
 
+bool PropertyColorList::isSaveDocFileThreadSafe() const
+{
+    return true;
+}
+
 Property *PropertyColorList::Copy(void) const
 {
     PropertyColorList *p= new PropertyColorList();
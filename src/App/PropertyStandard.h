@@ -476,13 +476,13 @@ public:
     void setValue(float);
     
     /// index operator
-    float operator[] (const int idx) const {return _lValueList.operator[] (idx);} 
+    float operator[] (const int idx) const {restoreDeferred(); return _lValueList.operator[] (idx);} 
     
     
-    void set1Value (const int idx, float value){_lValueList.operator[] (idx) = value;}
+    void set1Value (const int idx, float value){restoreDeferred(); _lValueList.operator[] (idx) = value;}
     void setValues (const std::vector<float>& values);
     
-    const std::vector<float> &getValues(void) const{return _lValueList;}
+    const std::vector<float> &getValues(void) const{restoreDeferred(); return _lValueList;}
     
     virtual PyObject *getPyObject(void);
     virtual void setPyObject(PyObject *);
@@ -492,6 +492,7 @@ public:
     
     virtual void SaveDocFile (Base::Writer &writer) const;
     virtual void RestoreDocFile(Base::Reader &reader);
+    virtual bool isSaveDocFileThreadSafe() const;
     
     virtual Property *Copy(void) const;
     virtual void Paste(const Property &from);
@@ -770,12 +771,12 @@ public:
     void setValue(const Color&);
   
     /// index operator
-    const Color& operator[] (const int idx) const {return _lValueList.operator[] (idx);} 
+    const Color& operator[] (const int idx) const {restoreDeferred(); return _lValueList.operator[] (idx);} 
     
-    void  set1Value (const int idx, const Color& value){_lValueList.operator[] (idx) = value;}
+    void  set1Value (const int idx, const Color& value){restoreDeferred(); _lValueList.operator[] (idx) = value;}
     
     void setValues (const std::vector<Color>& values);
-    const std::vector<Color> &getValues(void) const{return _lValueList;}
+    const std::vector<Color> &getValues(void) const{restoreDeferred(); return _lValueList;}
     
     virtual PyObject *getPyObject(void);
     virtual void setPyObject(PyObject *);
@@ -785,6 +786,7 @@ public:
     
     virtual void SaveDocFile (Base::Writer &writer) const;
     virtual void RestoreDocFile(Base::Reader &reader);
+    virtual bool isSaveDocFileThreadSafe() const;
     
     virtual Property *Copy(void) const;
     virtual void Paste(const Property &from);
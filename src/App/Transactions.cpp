@@ -84,7 +84,11 @@ Transaction::~Transaction()
 
 unsigned int Transaction::getMemSize (void) const
 {
-    return 0;
+    unsigned int size = 0;
+    std::map<const DocumentObject*,TransactionObject*>::const_iterator It;
+    for (It= _Objects.begin();It!=_Objects.end();++It)
+        size += It->second->getMemSize();
+    return size;
 }
 
 void Transaction::Save (Base::Writer &/*writer*/) const
@@ -255,7 +259,13 @@ void TransactionObject::setProperty(const Property* pcProp)
 
 unsigned int TransactionObject::getMemSize (void) const
 {
-    return 0;
+    // Properties that share their payload with the document (copy-on-write)
+    // only report their share of it
+    unsigned int size = 0;
+    std::map<const Property*,Property*>::const_iterator It;
+    for (It=_PropChangeMap.begin();It!=_PropChangeMap.end();++It)
+        size += It->second->getMemSize();
+    return size;
 }
 
 void TransactionObject::Save (Base::Writer &/*writer*/) const
@@ -146,6 +146,12 @@ public:
      * @see Base::Reader,Base::XMLReader
      */
     virtual void RestoreDocFile(Reader &/*reader*/);
+    /** Returns true if SaveDocFile() only reads the data of this object and doesn't
+     * need anything else (no Python, no GUI, no shared handles). In this case the
+     * writer may call it from a worker thread concurrently to SaveDocFile() of other
+     * objects. The default implementation returns false.
+     */
+    virtual bool isSaveDocFileThreadSafe() const;
 };
 
 } //namespace Base
@@ -348,6 +348,21 @@ const std::vector<std::string>& Base::XMLReader::getFilenames() const
     return FileNames;
 }
 
+std::size_t Base::XMLReader::countFiles() const
+{
+    return FileList.size();
+}
+
+std::vector<Base::XMLReader::FileEntry> Base::XMLReader::takeFiles(std::size_t first)
+{
+    std::vector<FileEntry> files;
+    if (first < FileList.size()) {
+        files.assign(FileList.begin() + first, FileList.end());
+        FileList.erase(FileList.begin() + first, FileList.end());
+    }
+    return files;
+}
+
 bool Base::XMLReader::isRegistered(Base::Persistence *Object) const
 {
     if (Object) {
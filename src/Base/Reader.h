@@ -159,6 +159,17 @@ public:
     /// get all registered file names
     const std::vector<std::string>& getFilenames() const;
     bool isRegistered(Base::Persistence *Object) const;
+    /// a registered read request
+    struct FileEntry {
+        std::string FileName;
+        Base::Persistence *Object;
+    };
+    /// get the number of read requests that will be processed by readFiles()
+    std::size_t countFiles() const;
+    /** Removes the read requests from index \a first on from the list processed by
+     * readFiles() and returns them. The caller is responsible to read these files later on.
+     */
+    std::vector<FileEntry> takeFiles(std::size_t first);
     virtual void addName(const char*, const char*);
     virtual const char* getName(const char*) const;
     //@}
@@ -220,10 +231,6 @@ protected:
     XERCES_CPP_NAMESPACE_QUALIFIER XMLPScanToken token;
     bool _valid;
 
-    struct FileEntry {
-        std::string FileName;
-        Base::Persistence *Object;
-    };
     std::vector<FileEntry> FileList;
     std::vector<std::string> FileNames;
 };
@@ -38,6 +38,10 @@
 #include <algorithm>
 #include <locale>
 
+#include <QThread>
+#include <QtConcurrentMap>
+#include <zlib.h>
+
 using namespace Base;
 using namespace std;
 using namespace zipios;
@@ -169,7 +173,7 @@ void Writer::decInd(void)
 }
 
 ZipWriter::ZipWriter(const char* FileName) 
-  : ZipStream(FileName)
+  : ZipStream(FileName), Level(ZipOutputStreambuf::DEFAULT_COMPRESSION)
 {
 #ifdef _MSC_VER
     ZipStream.imbue(std::locale::empty());
@@ -182,7 +186,7 @@ ZipWriter::ZipWriter(const char* FileName)
 }
 
 ZipWriter::ZipWriter(std::ostream& os) 
-  : ZipStream(os)
+  : ZipStream(os), Level(ZipOutputStreambuf::DEFAULT_COMPRESSION)
 {
 #ifdef _MSC_VER
     ZipStream.imbue(std::locale::empty());
@@ -194,8 +198,111 @@ ZipWriter::ZipWriter(std::ostream& os)
     ZipStream.setf(ios::fixed,ios::floatfield);
 }
 
+#ifdef ZIPIOS_HAVE_RAW_ENTRY
+namespace Base {
+// The deflated content of one file that is written into a memory buffer
+struct FileBuffer {
+    const Base::Persistence *Object;
+    std::vector<char> Data;
+    uLong Size;
+    uLong Crc;
+    int Level;
+    bool Valid;
+};
+
+static void saveToBuffer(FileBuffer& buffer)
+{
+    buffer.Valid = false;
+    try {
+        // use the same stream settings as the zip stream
+        StringWriter writer;
+        writer.Stream().imbue(std::locale::classic());
+        writer.Stream().precision(12);
+        writer.Stream().setf(ios::fixed,ios::floatfield);
+        buffer.Object->SaveDocFile(writer);
+        std::string data = writer.getString();
+
+        // raw deflate stream with the same settings as zipios' ZipOutputStream
+        z_stream zs;
+        zs.zalloc = Z_NULL;
+        zs.zfree = Z_NULL;
+        zs.opaque = Z_NULL;
+        if (deflateInit2(&zs, buffer.Level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            return;
+        buffer.Size = (uLong)data.size();
+        buffer.Crc = crc32(crc32(0, Z_NULL, 0), (const Bytef*)data.data(), (uInt)data.size());
+        buffer.Data.resize(deflateBound(&zs, buffer.Size));
+        zs.next_in = (Bytef*)data.data();
+        zs.avail_in = (uInt)data.size();
+        zs.next_out = (Bytef*)&buffer.Data[0];
+        zs.avail_out = (uInt)buffer.Data.size();
+        int err = deflate(&zs, Z_FINISH);
+        buffer.Data.resize(zs.total_out);
+        deflateEnd(&zs);
+        buffer.Valid = (err == Z_STREAM_END);
+    }
+    catch (...) {
+        // the file will be written again in the main thread where the error gets reported
+    }
+}
+}
+#endif
+
 void ZipWriter::writeFiles(void)
 {
+#ifdef ZIPIOS_HAVE_RAW_ENTRY
+    // At most as many files as threads are available are kept in memory at once
+    size_t batchSize = (size_t)std::max<int>(QThread::idealThreadCount(), 1);
+
+    // use a while loop because it is possible that while
+    // processing the files new ones can be added
+    size_t index = 0;
+    while (index < FileList.size()) {
+        size_t count = std::min<size_t>(batchSize, FileList.size() - index);
+        std::vector<FileEntry> entries(FileList.begin() + index, FileList.begin() + index + count);
+
+        std::vector<FileBuffer> buffers;
+        if (count > 1) {
+            for (std::vector<FileEntry>::iterator it = entries.begin(); it != entries.end(); ++it) {
+                if (it->Object->isSaveDocFileThreadSafe()) {
+                    FileBuffer buffer;
+                    buffer.Object = it->Object;
+                    buffer.Level = Level;
+                    buffer.Valid = false;
+                    buffers.push_back(buffer);
+                }
+            }
+        }
+        if (buffers.size() > 1)
+            QtConcurrent::blockingMap(buffers, saveToBuffer);
+        else
+            buffers.clear();
+
+        // only the already deflated data is written serially
+        std::vector<FileBuffer>::iterator jt = buffers.begin();
+        for (std::vector<FileEntry>::iterator it = entries.begin(); it != entries.end(); ++it) {
+            if (jt != buffers.end() && jt->Object == it->Object) {
+                if (jt->Valid) {
+                    ZipStream.putRawEntry(it->FileName, jt->Data.empty() ? "" : &jt->Data[0],
+                        (uint32)jt->Data.size(), (uint32)jt->Crc, (uint32)jt->Size);
+                }
+                else {
+                    ZipStream.putNextEntry(it->FileName);
+                    it->Object->SaveDocFile(*this);
+                }
+                // free the memory as soon as possible
+                std::vector<char>().swap(jt->Data);
+                ++jt;
+            }
+            else {
+                ZipStream.putNextEntry(it->FileName);
+                it->Object->SaveDocFile(*this);
+            }
+        }
+
+        index += count;
+    }
+#else
     // use a while loop because it is possible that while
     // processing the files new ones can be added
     size_t index = 0;
@@ -205,6 +312,7 @@ void ZipWriter::writeFiles(void)
         entry.Object->SaveDocFile(*this);
         index++;
     }
+#endif
 }
 
 ZipWriter::~ZipWriter()
@@ -123,16 +123,22 @@ public:
     ZipWriter(std::ostream&);
     ~ZipWriter();
 
+    /** Writes the requested files into the archive in the order they were added.
+     * The content of objects with a thread-safe SaveDocFile() is produced and deflated
+     * concurrently into memory buffers, which are then appended to the zip stream as
+     * raw entries.
+     */
     virtual void writeFiles(void);
 
     virtual std::ostream &Stream(void){return ZipStream;}
 
     void setComment(const char* str){ZipStream.setComment(str);}
-    void setLevel(int level){ZipStream.setLevel( level );}
+    void setLevel(int level){ZipStream.setLevel( level ); Level = level;}
     void putNextEntry(const char* str){ZipStream.putNextEntry(str);}
 
 private:
     zipios::ZipOutputStream ZipStream;
+    int Level;
 };
 
 /** The StringWriter class 
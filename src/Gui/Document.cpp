@@ -752,6 +752,9 @@ void Document::slotFinishRestoreDocument(const App::Document& doc)
     std::map<const App::DocumentObject*,ViewProviderDocumentObject*>::iterator it;
     for (it = d->_ViewProviderMap.begin(); it != d->_ViewProviderMap.end(); ++it) {
         it->second->finishRestoring();
+        // with a lazy restore only the data of visible objects is read now
+        if (it->second->isShow() && d->_pcDocument->hasPendingFiles(it->first))
+            d->_pcDocument->restorePendingFiles(it->first);
     }
 
     // reset modified flag
@@ -35,6 +35,7 @@
 #include <Base/Console.h>
 #include <App/Material.h>
 #include <App/DocumentObject.h>
+#include <App/Document.h>
 #include "Application.h"
 #include "Document.h"
 #include "Selection.h"
@@ -108,6 +109,11 @@ void ViewProviderDocumentObject::hide(void)
 
 void ViewProviderDocumentObject::show(void)
 {
+    // read the deferred data of a lazily restored object before it gets displayed
+    App::Document* doc = pcObject ? pcObject->getDocument() : 0;
+    if (doc && doc->hasPendingFiles(pcObject))
+        doc->restorePendingFiles(pcObject);
+
     // use this bit to check whether 'Visibility' must be adjusted
     if (Visibility.StatusBits.test(8) == false) {
         Visibility.StatusBits.set(8);
@@ -1518,12 +1518,12 @@ std::vector<Base::Vector3f> best_fit::Comp_Normals(MeshCore::MeshKernel &M)
         origPoint.y = mPnt.y;
         origPoint.z = mPnt.z;
 
-        const std::set<unsigned long>& faceSet = rf2pt[i];
+        MeshCore::MeshIndexRange faceSet = rf2pt[i];
         fArea = 0.0;
         normal.Set(0.0,0.0,0.0);
 
         // Iteriere ber die Dreiecke zu jedem Punkt
-        for (std::set<unsigned long>::const_iterator it = faceSet.begin(); it != faceSet.end(); ++it)
+        for (MeshCore::MeshIndexRange::const_iterator it = faceSet.begin(); it != faceSet.end(); ++it)
         {
             // Zweimal derefernzieren, um an das MeshFacet zu kommen und dem Kernel uebergeben, dass er ein MeshGeomFacet liefert
             t_face = M.GetFacet(*it);
@@ -1852,10 +1852,10 @@ double best_fit::CompTotalError()
     MeshCore::MeshRefPointToPoints vv_it(m_CadMesh);
     MeshCore::MeshPointArray::_TConstIterator v_beg = m_CadMesh.GetPoints().begin();
 
-    std::set<unsigned long>::const_iterator v_it;
+    MeshCore::MeshIndexRange::const_iterator v_it;
     for (unsigned int i=0; i<FailProj.size(); ++i)
     {
-        const std::set<unsigned long>& PntNei = vv_it[FailProj[i]];
+        MeshCore::MeshIndexRange PntNei = vv_it[FailProj[i]];
         m_error[FailProj[i]] = 0.0;
 
         for (v_it = PntNei.begin(); v_it !=PntNei.end(); ++v_it)
@@ -1941,10 +1941,10 @@ double best_fit::CompTotalError(MeshCore::MeshKernel &mesh)
     MeshCore::MeshPointArray::_TConstIterator v_beg = m_CadMesh.GetPoints().begin();
 
 	double error;
-	std::set<unsigned long>::const_iterator v_it;
+	MeshCore::MeshIndexRange::const_iterator v_it;
     for (unsigned int i=0; i<FailProj.size(); ++i)
     {
-        const std::set<unsigned long>& PntNei = vv_it[FailProj[i]];
+        MeshCore::MeshIndexRange PntNei = vv_it[FailProj[i]];
 		error = 0.0;
 
 
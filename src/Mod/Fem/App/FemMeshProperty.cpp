@@ -70,16 +70,19 @@ void PropertyFemMesh::setValue(const FemMesh& sh)
 
 const FemMesh &PropertyFemMesh::getValue(void)const 
 {
+    restoreDeferred();
     return *_FemMesh;
 }
 
 const Data::ComplexGeoData* PropertyFemMesh::getComplexData() const
 {
+    restoreDeferred();
     return (FemMesh*)_FemMesh;
 }
 
 Base::BoundBox3d PropertyFemMesh::getBoundingBox() const
 {
+    restoreDeferred();
     return _FemMesh->getBoundBox();
 }
 
@@ -94,6 +97,7 @@ void PropertyFemMesh::getFaces(std::vector<Base::Vector3d> &aPoints,
                                std::vector<Data::ComplexGeoData::Facet> &aTopo,
                                float accuracy, uint16_t flags) const
 {
+    restoreDeferred();
     _FemMesh->getFaces(aPoints, aTopo, accuracy, flags);
 }
 
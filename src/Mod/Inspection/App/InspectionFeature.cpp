@@ -176,15 +176,19 @@ namespace Inspection {
             assert((rulX < _ulCtGridsX) && (rulY < _ulCtGridsY) && (rulZ < _ulCtGridsZ));
         }
 
-        void AddFacet (const MeshCore::MeshGeomFacet &rclFacet, unsigned long ulFacetIndex)
+        void FindGrids (unsigned long ulIndex, std::vector<unsigned long> &raulGrids) const
         {
             unsigned long ulX, ulY, ulZ;
             unsigned long ulX1, ulY1, ulZ1, ulX2, ulY2, ulZ2;
 
+            MeshCore::MeshGeomFacet clFacet = _pclMesh->GetFacet(ulIndex);
+            for (int i = 0; i < 3; i++)
+                clFacet._aclPoints[i] = _transform * clFacet._aclPoints[i];
+
             Base::BoundBox3f clBB;
-            clBB &= rclFacet._aclPoints[0];
-            clBB &= rclFacet._aclPoints[1];
-            clBB &= rclFacet._aclPoints[2];
+            clBB &= clFacet._aclPoints[0];
+            clBB &= clFacet._aclPoints[1];
+            clBB &= clFacet._aclPoints[2];
 
             Pos(Base::Vector3f(clBB.MinX,clBB.MinY,clBB.MinZ), ulX1, ulY1, ulZ1);
             Pos(Base::Vector3f(clBB.MaxX,clBB.MaxY,clBB.MaxZ), ulX2, ulY2, ulZ2);
@@ -194,20 +198,18 @@ namespace Inspection {
                 for (ulX = ulX1; ulX <= ulX2; ulX++) {
                     for (ulY = ulY1; ulY <= ulY2; ulY++) {
                         for (ulZ = ulZ1; ulZ <= ulZ2; ulZ++) {
-                            if (rclFacet.IntersectBoundingBox(GetBoundBox(ulX, ulY, ulZ)))
-                                _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
+                            if (clFacet.IntersectBoundingBox(GetBoundBox(ulX, ulY, ulZ)))
+                                raulGrids.push_back(GetIndexToPosition(ulX, ulY, ulZ));
                         }
                     }
                 }
             }
             else
-                _aulGrid[ulX1][ulY1][ulZ1].insert(ulFacetIndex);
+                raulGrids.push_back(GetIndexToPosition(ulX1, ulY1, ulZ1));
         }
 
         void InitGrid (void)
         {
-            unsigned long i, j;
-
             Base::BoundBox3f clBBMesh = _pclMesh->GetBoundBox().Transformed(_transform);
 
             float fLengthX = clBBMesh.LengthX(); 
@@ -224,25 +226,15 @@ namespace Inspection {
             _fMinZ = clBBMesh.MinZ - 0.5f;
 
             _aulGrid.clear();
-            _aulGrid.resize(_ulCtGridsX);
-            for (i = 0; i < _ulCtGridsX; i++) {
-                _aulGrid[i].resize(_ulCtGridsY);
-                for (j = 0; j < _ulCtGridsY; j++)
-                    _aulGrid[i][j].resize(_ulCtGridsZ);
-            }
+            _aulGridOffsets.clear();
+            _aulGridOffsets.resize(_ulCtGridsX * _ulCtGridsY * _ulCtGridsZ + 1, 0);
         }
 
         void RebuildGrid (void)
         {
             _ulCtElements = _pclMesh->CountFacets();
             InitGrid();
- 
-            unsigned long i = 0;
-            MeshCore::MeshFacetIterator clFIter(*_pclMesh);
-            clFIter.Transform(_transform);
-            for (clFIter.Init(); clFIter.More(); clFIter.Next()) {
-                AddFacet(*clFIter, i++);
-            }
+            FillGrid();
         }
 
     private:
@@ -39,6 +39,7 @@
 #include "FeatureMeshTransform.h"
 #include "FeatureMeshTransformDemolding.h"
 #include "FeatureMeshCurvature.h"
+#include "FeatureMeshDecimation.h"
 #include "FeatureMeshSegmentByMesh.h"
 #include "FeatureMeshSetOperations.h"
 #include "FeatureMeshDefects.h"
@@ -102,6 +103,7 @@ void MeshExport initMesh()
     Mesh::FixIndices            ::init();
     Mesh::FillHoles             ::init();
     Mesh::RemoveComponents      ::init();
+    Mesh::Decimation            ::init();
 
     Mesh::Sphere                ::init();
     Mesh::Ellipsoid             ::init();
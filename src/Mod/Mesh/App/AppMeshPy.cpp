@@ -27,6 +27,7 @@
 #include <Base/Console.h>
 #include <Base/Interpreter.h>
 #include <Base/FileInfo.h>
+#include <Base/Stream.h>
 #include <App/Application.h>
 #include <App/Document.h>
 #include <App/DocumentObjectPy.h>
@@ -34,6 +35,7 @@
 
 #include "Core/MeshKernel.h"
 #include "Core/MeshIO.h"
+#include "Core/OutOfCore.h"
 #include "MeshPy.h"
 #include "Mesh.h"
 #include "FeatureMeshImport.h"
@@ -63,6 +65,118 @@ static PyObject * read(PyObject *self, PyObject *args)
     Py_Return;
 }
 
+static PyObject * readSimplified(PyObject *self, PyObject *args)
+{
+    const char* Name;
+    float cellSize;
+    if (!PyArg_ParseTuple(args, "sf",&Name,&cellSize))
+        return NULL;
+
+    PY_TRY {
+        MeshCore::MeshOutOfCore file;
+        if (!file.Open(Name)) {
+            PyErr_SetString(PyExc_Exception, "Not a binary STL file");
+            return NULL;
+        }
+
+        MeshCore::MeshKernel kernel;
+        file.Simplify(cellSize, kernel);
+        std::auto_ptr<MeshObject> mesh(new MeshObject);
+        mesh->swap(kernel);
+        return new MeshPy(mesh.release());
+    } PY_CATCH;
+}
+
+static PyObject * readTiles(PyObject *self, PyObject *args)
+{
+    const char* Name;
+    int maxFacets;
+    if (!PyArg_ParseTuple(args, "si",&Name,&maxFacets))
+        return NULL;
+    if (maxFacets < 1) {
+        PyErr_SetString(PyExc_ValueError, "number of facets must be positive");
+        return NULL;
+    }
+
+    PY_TRY {
+        MeshCore::MeshOutOfCore file;
+        if (!file.Open(Name)) {
+            PyErr_SetString(PyExc_Exception, "Not a binary STL file");
+            return NULL;
+        }
+
+        // the empty tiles are skipped
+        file.BuildTiles((unsigned long)maxFacets);
+        Py::List list;
+        for (unsigned long i=0; i<file.CountTiles(); i++) {
+            if (file.CountTileFacets(i) == 0)
+                continue;
+            MeshCore::MeshKernel kernel;
+            file.LoadTile(i, kernel);
+            std::auto_ptr<MeshObject> mesh(new MeshObject);
+            mesh->swap(kernel);
+            list.append(Py::asObject(new MeshPy(mesh.release())));
+        }
+        return Py::new_reference_to(list);
+    } PY_CATCH;
+}
+
+static PyObject * checkBinarySTL(PyObject *self, PyObject *args)
+{
+    const char* Name;
+    if (!PyArg_ParseTuple(args, "s",&Name))
+        return NULL;
+
+    PY_TRY {
+        MeshCore::MeshOutOfCore file;
+        if (!file.Open(Name)) {
+            PyErr_SetString(PyExc_Exception, "Not a binary STL file");
+            return NULL;
+        }
+
+        std::vector<unsigned long> degenerated, invalid;
+        file.GetDegeneratedFacets(degenerated);
+        file.GetInvalidFacets(invalid);
+
+        Py::List degList, invList;
+        for (std::vector<unsigned long>::iterator it = degenerated.begin(); it != degenerated.end(); ++it)
+            degList.append(Py::Int((long)*it));
+        for (std::vector<unsigned long>::iterator it = invalid.begin(); it != invalid.end(); ++it)
+            invList.append(Py::Int((long)*it));
+        Py::Dict dict;
+        dict.setItem("DegeneratedFacets", degList);
+        dict.setItem("InvalidFacets", invList);
+        return Py::new_reference_to(dict);
+    } PY_CATCH;
+}
+
+static PyObject * convertBinarySTL(PyObject *self, PyObject *args)
+{
+    const char* Name;
+    const char* Output;
+    PyObject* ascii=Py_True;
+    if (!PyArg_ParseTuple(args, "ss|O!",&Name,&Output,&PyBool_Type,&ascii))
+        return NULL;
+
+    PY_TRY {
+        MeshCore::MeshOutOfCore file;
+        if (!file.Open(Name)) {
+            PyErr_SetString(PyExc_Exception, "Not a binary STL file");
+            return NULL;
+        }
+
+        Base::FileInfo fi(Output);
+        Base::ofstream str(fi, std::ios::out | std::ios::binary);
+        bool ok = PyObject_IsTrue(ascii) ? file.SaveAsciiSTL(str) : file.SaveBinarySTL(str);
+        if (!ok) {
+            PyErr_Format(PyExc_Exception, "Failed to write file '%s'", Output);
+            return NULL;
+        }
+    } PY_CATCH;
+
+    Py_Return;
+}
+
 static PyObject * open(PyObject *self, PyObject *args)
 {
     const char* Name;
@@ -389,6 +503,14 @@ struct PyMethodDef Mesh_Import_methods[] = {
     {"insert"     ,importer,    METH_VARARGS, inst_doc},
     {"export"     ,exporter,    METH_VARARGS, export_doc},
     {"read"       ,read,        Py_NEWARGS,   "Read a mesh from a file and returns a Mesh object."},
+    {"readSimplified",readSimplified, Py_NEWARGS, "readSimplified(string,float) -- Read a binary STL file that may be larger than the\n"
+                                                  "main memory and simplify it by merging the points in cells of the given size."},
+    {"readTiles"  ,readTiles,   Py_NEWARGS,   "readTiles(string,int) -- Read a binary STL file that may be larger than the main memory\n"
+                                              "as a list of meshes, one for each non-empty spatial tile of about the given number of facets."},
+    {"checkBinarySTL",checkBinarySTL, Py_NEWARGS, "checkBinarySTL(string) -- Return the indices of the degenerated facets and of the facets\n"
+                                                  "with invalid coordinates of a binary STL file that may be larger than the main memory."},
+    {"convertBinarySTL",convertBinarySTL, Py_NEWARGS, "convertBinarySTL(string,string,[bool]) -- Write the facets of a binary STL file that may be larger\n"
+                                                      "than the main memory as ASCII STL, or as binary STL if the flag is False."},
     {"show"       ,show,        Py_NEWARGS,   "Put a mesh object in the active document or creates one if needed"},
     {"createBox"  ,createBox,   Py_NEWARGS,   "Create a solid mesh box"},
     {"createPlane",createPlane, Py_NEWARGS,   "Create a mesh XY plane normal +Z"},
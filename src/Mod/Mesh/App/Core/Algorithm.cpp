@@ -27,6 +27,11 @@
 # include <algorithm>
 #endif
 
+#include <QAtomicInt>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
 #include "Algorithm.h"
 #include "Approximation.h"
 #include "Elements.h"
@@ -637,8 +642,8 @@ bool MeshAlgorithm::FillupHole(const std::vector<unsigned long>& boundary,
     unsigned long refPoint0 = *(boundary.begin());
     unsigned long refPoint1 = *(boundary.begin()+1);
     if (pP2FStructure) {
-        const std::set<unsigned long>& ring1 = (*pP2FStructure)[refPoint0];
-        const std::set<unsigned long>& ring2 = (*pP2FStructure)[refPoint1];
+        MeshIndexRange ring1 = (*pP2FStructure)[refPoint0];
+        MeshIndexRange ring2 = (*pP2FStructure)[refPoint1];
         std::vector<unsigned long> f_int;
         std::set_intersection(ring1.begin(), ring1.end(), ring2.begin(), ring2.end(),
             std::back_insert_iterator<std::vector<unsigned long> >(f_int));
@@ -1694,28 +1699,201 @@ float MeshAlgorithm::CalculateMinimumGridLength(float fLength, const Base::Bound
 
 // ----------------------------------------------------
 
-void MeshRefPointToFacets::Rebuild (void)
+namespace MeshCore {
+
+/**
+ * The MeshIndexTableBuilder fills a MeshIndexTable in two passes: first the number of
+ * entries of each list is counted, then the entries are written to their final place.
+ * Both passes as well as sorting the lists are done by several threads at the same time.
+ */
+class MeshIndexTableBuilder
 {
-    _map.clear();
+public:
+    enum Mode {
+        PointToFacets, /**< facets indexing a point */
+        PointToPoints, /**< points connected with a point by an edge */
+        FacetToFacets  /**< facets sharing at least one point with a facet */
+    };
 
-    const MeshPointArray& rPoints = _rclMesh.GetPoints();
-    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
-    _map.resize(rPoints.size());
+    MeshIndexTableBuilder (MeshIndexTable& table, const MeshFacetArray& facets)
+      : _table(table), _facets(facets), _pointToFacets(0), _mode(PointToFacets)
+    {
+    }
+    void BuildPointToFacets (unsigned long ulCtPoints)
+    {
+        _mode = PointToFacets;
+        Build(ulCtPoints, _facets.size());
+    }
+    void BuildPointToPoints (unsigned long ulCtPoints)
+    {
+        _mode = PointToPoints;
+        Build(ulCtPoints, _facets.size());
+    }
+    void BuildFacetToFacets (const MeshIndexTable& pointToFacets)
+    {
+        _mode = FacetToFacets;
+        _pointToFacets = &pointToFacets;
+        Build(_facets.size(), _facets.size());
+    }
+
+private:
+    struct Chunk
+    {
+        unsigned long begin, end;
+    };
+
+    static std::vector<Chunk> MakeChunks (unsigned long ulCtElements)
+    {
+        // small meshes are not worth to be split
+        unsigned long ulCtChunks = 1;
+        if (ulCtElements > 10000)
+            ulCtChunks = 4 * std::max<int>(QThread::idealThreadCount(), 1);
+        unsigned long ulChunkSize = ulCtElements / ulCtChunks + 1;
+
+        std::vector<Chunk> chunks;
+        for (unsigned long ulBegin = 0; ulBegin < ulCtElements; ulBegin += ulChunkSize) {
+            Chunk chunk;
+            chunk.begin = ulBegin;
+            chunk.end = std::min<unsigned long>(ulBegin + ulChunkSize, ulCtElements);
+            chunks.push_back(chunk);
+        }
+        return chunks;
+    }
+
+    void Build (unsigned long ulCtRows, unsigned long ulCtElements)
+    {
+        _table.clear();
+        _counts = std::vector<QAtomicInt>(ulCtRows);
+
+        // first pass: count the entries of each list
+        std::vector<Chunk> chunks = MakeChunks(ulCtElements);
+        QtConcurrent::blockingMap(chunks, boost::bind(&MeshIndexTableBuilder::Count, this, _1));
+
+        std::vector<unsigned long>& offsets = _table._offsets;
+        offsets.resize(ulCtRows + 1);
+        offsets[0] = 0;
+        for (unsigned long i = 0; i < ulCtRows; i++) {
+            offsets[i+1] = offsets[i] + (int)_counts[i];
+            _counts[i].fetchAndStoreRelaxed(0);
+        }
+
+        // second pass: write the entries, the counters serve as cursors now
+        _table._indices.resize(offsets.back());
+        QtConcurrent::blockingMap(chunks, boost::bind(&MeshIndexTableBuilder::Fill, this, _1));
+        _counts.clear();
+
+        // sort each list and remove duplicates
+        _sizes.resize(ulCtRows);
+        std::vector<Chunk> rows = MakeChunks(ulCtRows);
+        QtConcurrent::blockingMap(rows, boost::bind(&MeshIndexTableBuilder::Sort, this, _1));
+
+        // close the gaps left by the removed duplicates
+        std::vector<unsigned long>& indices = _table._indices;
+        unsigned long ulPos = 0;
+        for (unsigned long i = 0; i < ulCtRows; i++) {
+            std::vector<unsigned long>::iterator first = indices.begin() + offsets[i];
+            offsets[i] = ulPos;
+            if (indices.begin() + ulPos != first)
+                std::copy(first, first + _sizes[i], indices.begin() + ulPos);
+            ulPos += _sizes[i];
+        }
+        offsets[ulCtRows] = ulPos;
+        _sizes.clear();
+
+        if (ulPos < indices.size()) {
+            indices.resize(ulPos);
+            std::vector<unsigned long>(indices).swap(indices);
+        }
+    }
+
+    void Count (Chunk& chunk)
+    {
+        if (_mode == FacetToFacets) {
+            for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+                const MeshFacet& face = _facets[i];
+                int count = 0;
+                for (int j = 0; j < 3; j++)
+                    count += (int)(*_pointToFacets)[face._aulPoints[j]].size();
+                _counts[i].fetchAndStoreRelaxed(count);
+            }
+        }
+        else {
+            int count = (_mode == PointToPoints ? 2 : 1);
+            for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+                const MeshFacet& face = _facets[i];
+                for (int j = 0; j < 3; j++)
+                    _counts[face._aulPoints[j]].fetchAndAddRelaxed(count);
+            }
+        }
+    }
 
-    MeshFacetArray::_TConstIterator pFBegin = rFacets.begin();
-    for (MeshFacetArray::_TConstIterator pFIter = rFacets.begin(); pFIter != rFacets.end(); ++pFIter) {
-        _map[pFIter->_aulPoints[0]].insert(pFIter - pFBegin);
-        _map[pFIter->_aulPoints[1]].insert(pFIter - pFBegin);
-        _map[pFIter->_aulPoints[2]].insert(pFIter - pFBegin);
+    void Fill (Chunk& chunk)
+    {
+        const std::vector<unsigned long>& offsets = _table._offsets;
+        std::vector<unsigned long>& indices = _table._indices;
+        for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+            const MeshFacet& face = _facets[i];
+            if (_mode == FacetToFacets) {
+                std::vector<unsigned long>::iterator it = indices.begin() + offsets[i];
+                for (int j = 0; j < 3; j++) {
+                    MeshIndexRange faces = (*_pointToFacets)[face._aulPoints[j]];
+                    it = std::copy(faces.begin(), faces.end(), it);
+                }
+            }
+            else if (_mode == PointToPoints) {
+                for (int j = 0; j < 3; j++) {
+                    unsigned long p = face._aulPoints[j];
+                    unsigned long pos = offsets[p] + _counts[p].fetchAndAddRelaxed(2);
+                    indices[pos] = face._aulPoints[(j+1)%3];
+                    indices[pos+1] = face._aulPoints[(j+2)%3];
+                }
+            }
+            else {
+                for (int j = 0; j < 3; j++) {
+                    unsigned long p = face._aulPoints[j];
+                    indices[offsets[p] + _counts[p].fetchAndAddRelaxed(1)] = i;
+                }
+            }
+        }
     }
+
+    void Sort (Chunk& chunk)
+    {
+        const std::vector<unsigned long>& offsets = _table._offsets;
+        std::vector<unsigned long>& indices = _table._indices;
+        for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+            std::vector<unsigned long>::iterator first = indices.begin() + offsets[i];
+            std::vector<unsigned long>::iterator last = indices.begin() + offsets[i+1];
+            std::sort(first, last);
+            _sizes[i] = std::unique(first, last) - first;
+        }
+    }
+
+private:
+    MeshIndexTable& _table;
+    const MeshFacetArray& _facets;
+    const MeshIndexTable* _pointToFacets;
+    Mode _mode;
+    std::vector<QAtomicInt> _counts;
+    std::vector<unsigned long> _sizes;
+};
+
+} // namespace MeshCore
+
+// ----------------------------------------------------
+
+void MeshRefPointToFacets::Rebuild (void)
+{
+    MeshIndexTableBuilder builder(_map, _rclMesh.GetFacets());
+    builder.BuildPointToFacets(_rclMesh.CountPoints());
 }
 
 Base::Vector3f MeshRefPointToFacets::GetNormal(unsigned long pos) const
 {
-    const std::set<unsigned long>& n = _map[pos];
+    MeshIndexRange n = _map[pos];
     Base::Vector3f normal;
     MeshGeomFacet f;
-    for (std::set<unsigned long>::const_iterator it = n.begin(); it != n.end(); ++it) {
+    for (MeshIndexRange::const_iterator it = n.begin(); it != n.end(); ++it) {
         f = _rclMesh.GetFacet(*it);
         normal += f.Area() * f.GetNormal();
     }
@@ -1733,8 +1911,8 @@ std::set<unsigned long> MeshRefPointToFacets::NeighbourPoints(const std::vector<
     for (int i=0; i < level; i++) {
         std::set<unsigned long> cur;
         for (std::set<unsigned long>::iterator it = lp.begin(); it != lp.end(); ++it) {
-            const std::set<unsigned long>& ft = (*this)[*it];
-            for (std::set<unsigned long>::const_iterator jt = ft.begin(); jt != ft.end(); ++jt) {
+            MeshIndexRange ft = (*this)[*it];
+            for (MeshIndexRange::const_iterator jt = ft.begin(); jt != ft.end(); ++jt) {
                 for (int j = 0; j < 3; j++) {
                     unsigned long index = f_it[*jt]._aulPoints[j];
                     if (cp.find(index) == cp.end() && nb.find(index) == nb.end()) {
@@ -1774,9 +1952,9 @@ void MeshRefPointToFacets::SearchNeighbours(const MeshFacetArray& rFacets, unsig
     visited.insert(index);
     collect.Append(_rclMesh, index);
     for (int i = 0; i < 3; i++) {
-        const std::set<unsigned long> &f = (*this)[face._aulPoints[i]];
+        MeshIndexRange f = (*this)[face._aulPoints[i]];
 
-        for (std::set<unsigned long>::const_iterator j = f.begin(); j != f.end(); ++j) {
+        for (MeshIndexRange::const_iterator j = f.begin(); j != f.end(); ++j) {
             SearchNeighbours(rFacets, *j, rclCenter, fMaxDist2, visited, collect);
         }
     }
@@ -1788,7 +1966,7 @@ MeshRefPointToFacets::GetFacet (unsigned long index) const
     return _rclMesh.GetFacets().begin() + index;
 }
 
-const std::set<unsigned long>&
+MeshIndexRange
 MeshRefPointToFacets::operator[] (unsigned long pos) const
 {
     return _map[pos];
@@ -1798,23 +1976,13 @@ MeshRefPointToFacets::operator[] (unsigned long pos) const
 
 void MeshRefFacetToFacets::Rebuild (void)
 {
-    _map.clear();
-
     const MeshFacetArray& rFacets = _rclMesh.GetFacets();
-    _map.resize(rFacets.size());
-
-    MeshRefPointToFacets  vertexFace(_rclMesh);
-    MeshFacetArray::_TConstIterator pFBegin = rFacets.begin();
-    for (MeshFacetArray::_TConstIterator pFIter = pFBegin; pFIter != rFacets.end(); ++pFIter) {
-        for (int i = 0; i < 3; i++) {
-            const std::set<unsigned long>& faces = vertexFace[pFIter->_aulPoints[i]];
-            for (std::set<unsigned long>::const_iterator it = faces.begin(); it != faces.end(); ++it)
-                _map[pFIter - pFBegin].insert(*it);
-        }
-    }
+    MeshIndexTable vertexFace;
+    MeshIndexTableBuilder(vertexFace, rFacets).BuildPointToFacets(_rclMesh.CountPoints());
+    MeshIndexTableBuilder(_map, rFacets).BuildFacetToFacets(vertexFace);
 }
 
-const std::set<unsigned long>&
+MeshIndexRange
 MeshRefFacetToFacets::operator[] (unsigned long pos) const
 {
     return _map[pos];
@@ -1824,24 +1992,8 @@ MeshRefFacetToFacets::operator[] (unsigned long pos) const
 
 void MeshRefPointToPoints::Rebuild (void)
 {
-    _map.clear();
-
-    const MeshPointArray& rPoints = _rclMesh.GetPoints();
-    _map.resize(rPoints.size());
-
-    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
-    for (MeshFacetArray::_TConstIterator pFIter = rFacets.begin(); pFIter != rFacets.end(); ++pFIter) {
-        unsigned long ulP0 = pFIter->_aulPoints[0];
-        unsigned long ulP1 = pFIter->_aulPoints[1];
-        unsigned long ulP2 = pFIter->_aulPoints[2];
-
-        _map[ulP0].insert(ulP1);
-        _map[ulP0].insert(ulP2);
-        _map[ulP1].insert(ulP0);
-        _map[ulP1].insert(ulP2);
-        _map[ulP2].insert(ulP0);
-        _map[ulP2].insert(ulP1);
-    }
+    MeshIndexTableBuilder builder(_map, _rclMesh.GetFacets());
+    builder.BuildPointToPoints(_rclMesh.CountPoints());
 }
 
 Base::Vector3f MeshRefPointToPoints::GetNormal(unsigned long pos) const
@@ -1850,8 +2002,8 @@ Base::Vector3f MeshRefPointToPoints::GetNormal(unsigned long pos) const
     MeshCore::PlaneFit pf;
     pf.AddPoint(rPoints[pos]);
     MeshCore::MeshPoint center = rPoints[pos];
-    const std::set<unsigned long>& cv = _map[pos];
-    for (std::set<unsigned long>::const_iterator cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
+    MeshIndexRange cv = _map[pos];
+    for (MeshIndexRange::const_iterator cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
         pf.AddPoint(rPoints[*cv_it]);
         center += rPoints[*cv_it];
     }
@@ -1867,15 +2019,15 @@ float MeshRefPointToPoints::GetAverageEdgeLength(unsigned long index) const
 {
     const MeshPointArray& rPoints = _rclMesh.GetPoints();
     float len=0.0f;
-    const std::set<unsigned long>& n = (*this)[index];
+    MeshIndexRange n = (*this)[index];
     const Base::Vector3f& p = rPoints[index];
-    for (std::set<unsigned long>::const_iterator it = n.begin(); it != n.end(); ++it) {
+    for (MeshIndexRange::const_iterator it = n.begin(); it != n.end(); ++it) {
         len += Base::Distance(p, rPoints[*it]);
     }
     return (len/n.size());
 }
 
-const std::set<unsigned long>&
+MeshIndexRange
 MeshRefPointToPoints::operator[] (unsigned long pos) const
 {
     return _map[pos];
@@ -24,6 +24,7 @@
 #ifndef MESHALGORITHM_H
 #define MESHALGORITHM_H
 
+#include <algorithm>
 #include <set>
 #include <vector>
 #include <map>
@@ -351,6 +352,66 @@ private:
     std::vector<unsigned long>& indices;
 };
 
+/**
+ * The MeshIndexRange class gives access to the sorted indices of one list of a
+ * MeshIndexTable. It can be used like a read-only set of indices.
+ */
+class MeshExport MeshIndexRange
+{
+public:
+    typedef std::vector<unsigned long>::const_iterator const_iterator;
+    typedef const_iterator iterator;
+
+    MeshIndexRange (const_iterator first, const_iterator last)
+      : _first(first), _last(last) { }
+
+    const_iterator begin() const
+    { return _first; }
+    const_iterator end() const
+    { return _last; }
+    std::size_t size() const
+    { return _last - _first; }
+    bool empty() const
+    { return _first == _last; }
+    /// Searches for \a index with a binary search and returns end() if not found.
+    const_iterator find(unsigned long index) const
+    {
+        const_iterator it = std::lower_bound(_first, _last, index);
+        return (it != _last && *it == index) ? it : _last;
+    }
+    std::size_t count(unsigned long index) const
+    { return find(index) != _last ? 1 : 0; }
+
+private:
+    const_iterator _first, _last;
+};
+
+/**
+ * The MeshIndexTable class stores a sorted list of indices for each point or facet
+ * in compressed row storage, i.e. the indices of all lists are kept in one array and
+ * a second array holds the offset of each list. Compared to a std::set per list this
+ * needs only a fraction of the memory.
+ */
+class MeshExport MeshIndexTable
+{
+public:
+    MeshIndexTable (void) { }
+
+    /// Returns the number of lists.
+    unsigned long size (void) const
+    { return _offsets.empty() ? 0 : _offsets.size() - 1; }
+    void clear (void)
+    { _offsets.clear(); _indices.clear(); }
+    MeshIndexRange operator[] (unsigned long pos) const
+    { return MeshIndexRange(_indices.begin() + _offsets[pos], _indices.begin() + _offsets[pos + 1]); }
+
+private:
+    std::vector<unsigned long> _offsets;
+    std::vector<unsigned long> _indices;
+
+    friend class MeshIndexTableBuilder;
+};
+
 /**
  * The MeshRefPointToFacets builds up a structure to have access to all facets indexing
  * a point.
@@ -369,7 +430,7 @@ public:
 
     /// Rebuilds up data structure
     void Rebuild (void);
-    const std::set<unsigned long>& operator[] (unsigned long) const;
+    MeshIndexRange operator[] (unsigned long) const;
     MeshFacetArray::_TConstIterator GetFacet (unsigned long) const;
     std::set<unsigned long> NeighbourPoints(const std::vector<unsigned long>& , int level) const;
     void Neighbours (unsigned long ulFacetInd, float fMaxDist, MeshCollector& collect) const;
@@ -381,7 +442,7 @@ protected:
 
 protected:
     const MeshKernel  &_rclMesh; /**< The mesh kernel. */
-    std::vector<std::set<unsigned long> > _map;
+    MeshIndexTable _map;
 };
 
 /**
@@ -404,11 +465,11 @@ public:
 
     /// Returns a set of facets sharing one or more points with the facet with
     /// index \a ulFacetIndex.
-    const std::set<unsigned long>& operator[] (unsigned long) const;
+    MeshIndexRange operator[] (unsigned long) const;
 
 protected:
     const MeshKernel  &_rclMesh; /**< The mesh kernel. */
-    std::vector<std::set<unsigned long> > _map;
+    MeshIndexTable _map;
 };
 
 /**
@@ -429,13 +490,13 @@ public:
 
     /// Rebuilds up data structure
     void Rebuild (void);
-    const std::set<unsigned long>& operator[] (unsigned long) const;
+    MeshIndexRange operator[] (unsigned long) const;
     Base::Vector3f GetNormal(unsigned long) const;
     float GetAverageEdgeLength(unsigned long) const;
 
 protected:
     const MeshKernel  &_rclMesh; /**< The mesh kernel. */
-    std::vector<std::set<unsigned long> > _map;
+    MeshIndexTable _map;
 };
 
 /**
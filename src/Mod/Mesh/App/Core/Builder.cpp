@@ -25,8 +25,14 @@
 
 #ifndef _PreComp_
 # include <algorithm>
+# include <cmath>
 #endif
 
+#include <QThread>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+#include <boost/functional/hash.hpp>
+
 #include <Base/Sequencer.h>
 #include <Base/Exception.h>
 
@@ -151,52 +157,6 @@ void MeshBuilder::AddFacet (Base::Vector3f* facetPoints, unsigned char flag, uns
     _meshKernel._aclFacetArray.push_back(mf);
 }
 
-void MeshBuilder::SetNeighbourhood ()
-{
-    std::set<Edge> edges;
-    int facetIdx = 0;
-
-    for (MeshFacetArray::_TIterator it = _meshKernel._aclFacetArray.begin(); it != _meshKernel._aclFacetArray.end(); it++)
-    {
-        this->_seq->next(true); // allow to cancel
-        MeshFacet& mf = *it;
-
-        for (int i = 0; i < 3; i++)
-        {
-            Edge edge(mf._aulPoints[i], mf._aulPoints[(i+1)%3], facetIdx);
-            std::set<Edge>::iterator e = edges.find(edge);
-            if (e != edges.end())
-            { // edge exists, set neighbourhood
-                MeshFacet& mf1 = _meshKernel._aclFacetArray[e->facetIdx];
-                if (mf1._aulPoints[0] == edge.pt1)
-                {
-                    if (mf1._aulPoints[1] == edge.pt2)
-                        mf1._aulNeighbours[0] = facetIdx;
-                    else
-                        mf1._aulNeighbours[2] = facetIdx;
-                }
-                else if (mf1._aulPoints[0] == edge.pt2)
-                {
-                    if (mf1._aulPoints[1] == edge.pt1)
-                        mf1._aulNeighbours[0] = facetIdx;
-                    else
-                        mf1._aulNeighbours[2] = facetIdx;
-                }
-                else
-                    mf1._aulNeighbours[1] = facetIdx;
-
-                mf._aulNeighbours[i] = e->facetIdx;
-            }
-            else
-            {  // new edge
-                edges.insert(edge);
-            }
-        }
-
-        facetIdx++;
-    }
-}
-
 void MeshBuilder::RemoveUnreferencedPoints()
 {
     _meshKernel._aclPointArray.SetFlag(MeshPoint::INVALID);
@@ -224,7 +184,7 @@ void MeshBuilder::Finish (bool freeMemory)
     { std::vector<MeshPointIterator>().swap(_pointsIterator); }
     _points.clear();
 
-    SetNeighbourhood();
+    _meshKernel.RebuildNeighbours();
     RemoveUnreferencedPoints();
 
     // if AddFacet() has been called more often (or even less) as specified in Initialize() we have a wastage of memory
@@ -249,3 +209,353 @@ void MeshBuilder::Finish (bool freeMemory)
 
     _meshKernel.RecalcBoundBox();
 }
+
+// ----------------------------------------------------------------------------
+
+namespace MeshCore {
+
+struct MeshPointWelder::Entry
+{
+    unsigned long index;
+    /** offset of the grid cell the entry is sorted into, for a copy of a
+     * point lying near the border of a neighbour cell it is not zero */
+    signed char dx, dy, dz;
+};
+
+struct MeshPointWelder::Chunk
+{
+    unsigned long begin, end;
+    std::vector<unsigned long> counts;
+    std::vector<unsigned long> offsets;
+};
+
+struct MeshPointWelder::Partition
+{
+    unsigned long begin, end;
+};
+
+struct MeshPointWelder::Less
+{
+    Less(const MeshPointWelder& w) : welder(w) {}
+    bool operator () (const Entry& e, const Entry& f) const
+    {
+        const Base::Vector3f& p = welder._points[e.index];
+        const Base::Vector3f& q = welder._points[f.index];
+        double pc = welder.Cell(p.x) + e.dx, qc = welder.Cell(q.x) + f.dx;
+        if (pc != qc)
+            return pc < qc;
+        pc = welder.Cell(p.y) + e.dy; qc = welder.Cell(q.y) + f.dy;
+        if (pc != qc)
+            return pc < qc;
+        pc = welder.Cell(p.z) + e.dz; qc = welder.Cell(q.z) + f.dz;
+        if (pc != qc)
+            return pc < qc;
+        return e.index < f.index;
+    }
+    const MeshPointWelder& welder;
+};
+
+} // namespace MeshCore
+
+MeshPointWelder::MeshPointWelder(const std::vector<Base::Vector3f>& points, float fTolerance)
+  : _points(points), _fTolerance(fTolerance)
+  , _invCellSize(fTolerance > 0.0f ? 1.0 / (double(fTolerance) * MESH_WELD_CELL_SIZE) : 0.0)
+  , _numPartitions(1), _firstPartition(0), _lastPartition(0), _representative(0)
+{
+}
+
+MeshPointWelder::~MeshPointWelder()
+{
+}
+
+double MeshPointWelder::Cell(float v) const
+{
+    // adding 0.0 turns -0.0 into 0.0
+    if (_invCellSize > 0.0)
+        return floor(double(v) * _invCellSize) + 0.0;
+    return double(v) + 0.0;
+}
+
+bool MeshPointWelder::SameCell(const Entry& e, const Entry& f) const
+{
+    const Base::Vector3f& p = _points[e.index];
+    const Base::Vector3f& q = _points[f.index];
+    return Cell(p.x) + e.dx == Cell(q.x) + f.dx &&
+           Cell(p.y) + e.dy == Cell(q.y) + f.dy &&
+           Cell(p.z) + e.dz == Cell(q.z) + f.dz;
+}
+
+bool MeshPointWelder::IsEqual(const Base::Vector3f& p, const Base::Vector3f& q) const
+{
+    // the same comparison as MeshPoint::operator< does
+    float dx = fabs(p.x - q.x), dy = fabs(p.y - q.y), dz = fabs(p.z - q.z);
+    return (dx < _fTolerance || dx == 0.0f) &&
+           (dy < _fTolerance || dy == 0.0f) &&
+           (dz < _fTolerance || dz == 0.0f);
+}
+
+int MeshPointWelder::GetEntries(unsigned long index, Entry* entries) const
+{
+    // The first entry is the point in its own cell. If the point is closer than
+    // the tolerance to the border of a neighbour cell it is added to that cell,
+    // too, so that it can be found from the points of the neighbour cell.
+    const Base::Vector3f& p = _points[index];
+    signed char offsets[3][2];
+    int counts[3];
+    float coords[3] = { p.x, p.y, p.z };
+    double border = 1.0 / MESH_WELD_CELL_SIZE;
+    for (int i = 0; i < 3; i++) {
+        offsets[i][0] = 0;
+        counts[i] = 1;
+        if (_invCellSize > 0.0) {
+            double pos = double(coords[i]) * _invCellSize - Cell(coords[i]);
+            if (pos <= border)
+                offsets[i][counts[i]++] = -1;
+            else if (pos >= 1.0 - border)
+                offsets[i][counts[i]++] = 1;
+        }
+    }
+
+    int count = 0;
+    for (int i = 0; i < counts[0]; i++) {
+        for (int j = 0; j < counts[1]; j++) {
+            for (int k = 0; k < counts[2]; k++) {
+                Entry& entry = entries[count++];
+                entry.index = index;
+                entry.dx = offsets[0][i];
+                entry.dy = offsets[1][j];
+                entry.dz = offsets[2][k];
+            }
+        }
+    }
+
+    return count;
+}
+
+unsigned long MeshPointWelder::GetPartition(const Entry& entry) const
+{
+    const Base::Vector3f& p = _points[entry.index];
+    std::size_t seed = 0;
+    boost::hash_combine(seed, Cell(p.x) + entry.dx);
+    boost::hash_combine(seed, Cell(p.y) + entry.dy);
+    boost::hash_combine(seed, Cell(p.z) + entry.dz);
+    return seed % _numPartitions;
+}
+
+void MeshPointWelder::Count(Chunk& chunk) const
+{
+    Entry entries[8];
+    chunk.counts.resize(_numPartitions, 0);
+    for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+        int count = GetEntries(i, entries);
+        for (int j = 0; j < count; j++)
+            chunk.counts[GetPartition(entries[j])]++;
+    }
+}
+
+void MeshPointWelder::Scatter(Chunk& chunk)
+{
+    // only the entries of the currently handled partitions are taken
+    Entry entries[8];
+    for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+        int count = GetEntries(i, entries);
+        for (int j = 0; j < count; j++) {
+            unsigned long part = GetPartition(entries[j]);
+            if (part >= _firstPartition && part < _lastPartition)
+                _order[chunk.offsets[part]++] = entries[j];
+        }
+    }
+}
+
+void MeshPointWelder::Merge(Partition& part)
+{
+    std::vector<Entry>::iterator first = _order.begin() + part.begin;
+    std::vector<Entry>::iterator last = _order.begin() + part.end;
+    std::sort(first, last, Less(*this));
+
+    // Like MeshBuilder does, each point is merged with the first point within the
+    // tolerance that hasn't been merged itself. As the copies of the points of the
+    // neighbour cells are handled in their own cell only, a point may also be merged
+    // with a point that is merged itself. This chain is resolved by the caller.
+    std::vector<unsigned long> candidates;
+    std::vector<Entry>::iterator group = first;
+    for (std::vector<Entry>::iterator it = first; it != last; ++it) {
+        // the entries of the same cell are sorted by their point index
+        if (!SameCell(*group, *it)) {
+            group = it;
+            candidates.clear();
+        }
+
+        bool owner = (it->dx == 0 && it->dy == 0 && it->dz == 0);
+        if (!owner) {
+            candidates.push_back(it->index);
+            continue;
+        }
+
+        unsigned long rep = it->index;
+        const Base::Vector3f& p = _points[rep];
+        for (std::vector<unsigned long>::iterator jt = candidates.begin(); jt != candidates.end(); ++jt) {
+            if (IsEqual(_points[*jt], p)) {
+                rep = *jt;
+                break;
+            }
+        }
+
+        if (rep == it->index)
+            candidates.push_back(rep);
+        (*_representative)[it->index] = rep;
+    }
+}
+
+void MeshPointWelder::Run(std::vector<unsigned long>& rep)
+{
+    unsigned long count = _points.size();
+    // most points have less than one copy in a neighbour cell
+    unsigned long numPasses = 2 * count / MESH_MAX_SORT_SIZE + 1;
+    int numThreads = std::max<int>(QThread::idealThreadCount(), 1);
+    _numPartitions = 16 * numThreads * numPasses;
+    unsigned long numChunks = 4 * numThreads;
+    unsigned long chunkSize = count / numChunks + 1;
+
+    std::vector<Chunk> chunks;
+    for (unsigned long begin = 0; begin < count; begin += chunkSize) {
+        Chunk chunk;
+        chunk.begin = begin;
+        chunk.end = std::min<unsigned long>(begin + chunkSize, count);
+        chunks.push_back(chunk);
+    }
+    QtConcurrent::blockingMap(chunks, boost::bind(&MeshPointWelder::Count, this, _1));
+    for (std::vector<Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+        it->offsets.resize(_numPartitions);
+
+    rep.resize(count);
+    _representative = &rep;
+
+    // handle as many partitions at a time as fit into the sort buffer
+    _lastPartition = 0;
+    while (_lastPartition < _numPartitions) {
+        _firstPartition = _lastPartition;
+        std::vector<Partition> parts;
+        unsigned long offset = 0;
+        while (_lastPartition < _numPartitions) {
+            unsigned long size = 0;
+            for (std::vector<Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+                size += it->counts[_lastPartition];
+            if (offset > 0 && offset + size > MESH_MAX_SORT_SIZE)
+                break;
+
+            // convert the counts into offsets of the partition in the sort buffer
+            Partition part;
+            part.begin = offset;
+            for (std::vector<Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+                it->offsets[_lastPartition] = offset;
+                offset += it->counts[_lastPartition];
+            }
+            part.end = offset;
+            parts.push_back(part);
+            _lastPartition++;
+        }
+
+        _order.resize(offset);
+        QtConcurrent::blockingMap(chunks, boost::bind(&MeshPointWelder::Scatter, this, _1));
+        QtConcurrent::blockingMap(parts, boost::bind(&MeshPointWelder::Merge, this, _1));
+    }
+
+    // free memory of the internal structure
+    { std::vector<Entry>().swap(_order); }
+    _representative = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+MeshFastBuilder::MeshFastBuilder (MeshKernel& kernel)
+  : _meshKernel(kernel), _fTolerance(MeshDefinitions::_fMinPointDistanceD1)
+{
+}
+
+MeshFastBuilder::~MeshFastBuilder (void)
+{
+}
+
+void MeshFastBuilder::Initialize (unsigned long ctFacets)
+{
+    _meshKernel.Clear();
+    _corners.resize(3 * ctFacets);
+}
+
+void MeshFastBuilder::SetFacet (unsigned long index, const Base::Vector3f* facetPoints)
+{
+    Base::Vector3f* corner = &_corners[3 * index];
+    corner[0] = facetPoints[0];
+    corner[1] = facetPoints[1];
+    corner[2] = facetPoints[2];
+
+    // adjust circulation direction
+    if ((((facetPoints[1] - facetPoints[0]) % (facetPoints[2] - facetPoints[0])) * facetPoints[3]) < 0.0f)
+    {
+        std::swap(corner[1], corner[2]);
+    }
+}
+
+void MeshFastBuilder::Finish ()
+{
+    Base::SequencerLauncher seq("create mesh structure...", 3);
+
+    std::vector<unsigned long> index;
+    MeshPointWelder(_corners, _fTolerance).Run(index);
+    seq.next(true); // allow to cancel
+
+    // number the points in the order of their first occurrence
+    unsigned long ctCorners = _corners.size();
+    unsigned long ctPoints = 0;
+    for (unsigned long i = 0; i < ctCorners; i++) {
+        if (index[i] == i)
+            ctPoints++;
+    }
+
+    MeshPointArray points;
+    points.reserve(ctPoints);
+    for (unsigned long i = 0; i < ctCorners; i++) {
+        if (index[i] == i) {
+            index[i] = points.size();
+            points.push_back(_corners[i]);
+        }
+        else {
+            // the representative has a lower index and is already numbered
+            index[i] = index[index[i]];
+        }
+    }
+
+    // free memory of the internal structure
+    { std::vector<Base::Vector3f>().swap(_corners); }
+
+    // skip degenerated facets
+    MeshFacetArray facets;
+    facets.reserve(ctCorners / 3);
+    for (unsigned long i = 0; i < ctCorners; i += 3) {
+        unsigned long p0 = index[i], p1 = index[i+1], p2 = index[i+2];
+        if (p0 != p1 && p0 != p2 && p1 != p2)
+            facets.push_back(MeshFacet(p0, p1, p2));
+    }
+    seq.next(true); // allow to cancel
+
+    // As degenerated facets are skipped some of their points may not be used
+    if (facets.size() < ctCorners / 3) {
+        std::fill(index.begin(), index.begin() + points.size(), ULONG_MAX);
+        MeshPointArray used;
+        for (MeshFacetArray::_TIterator it = facets.begin(); it != facets.end(); ++it) {
+            for (int i = 0; i < 3; i++) {
+                unsigned long& pos = index[it->_aulPoints[i]];
+                if (pos == ULONG_MAX) {
+                    pos = used.size();
+                    used.push_back(points[it->_aulPoints[i]]);
+                }
+                it->_aulPoints[i] = pos;
+            }
+        }
+        points.swap(used);
+    }
+
+    _meshKernel.Adopt(points, facets, true);
+    seq.next(true); // allow to cancel
+}
@@ -107,7 +107,6 @@ private:
     std::vector<MeshPointIterator> _pointsIterator;
     unsigned long				_ptIdx; 
 
-    void SetNeighbourhood  ();
     // As it's forbidden to insert a degenerated facet but insert its vertices anyway we must remove them 
     void RemoveUnreferencedPoints();
 
@@ -164,6 +163,97 @@ private:
     float _fSaveTolerance;
 };
 
+/**
+ * Class for creating the mesh structure of big data sets, e.g. from binary STL files.
+ * In contrast to MeshBuilder the facets are set at a given position so that several
+ * threads can fill in the data at the same time. The coincident vertices are merged
+ * in Finish() with a hash grid that is processed in parallel, too.
+ * \code
+ * // Sample Code for building a mesh structure
+ * MeshFastBuilder builder(someMeshReference);
+ * builder.Initialize(numberOfFacets);
+ * ...
+ * for (...) // may be done by several threads
+ *   builder.SetFacet(index, ...);
+ * ...
+ * builder.Finish();
+ * \endcode
+ */
+class MeshExport MeshFastBuilder
+{
+public:
+    MeshFastBuilder(MeshKernel &rclM);
+    ~MeshFastBuilder(void);
+
+    /** Initializes the class for \a ctFacets facets. The mesh kernel gets cleared. */
+    void Initialize (unsigned long ctFacets);
+    /** Sets the facet at position \a index.
+     * @param facetPoints Array of vectors (size 4) in order of vec1, vec2,
+     *                    vec3, normal
+     * @remarks It is safe to set different facets from several threads.
+     */
+    void SetFacet (unsigned long index, const Base::Vector3f* facetPoints);
+    /** Finishes building up the mesh structure. Coincident vertices get merged,
+     * degenerated facets are removed and the neighbourhood is set.
+     */
+    void Finish ();
+
+private:
+    MeshKernel& _meshKernel;
+    std::vector<Base::Vector3f> _corners;
+    float _fTolerance;
+};
+
+/**
+ * The MeshPointWelder class finds coincident points with a hash grid. The points
+ * are distributed over several partitions by the hash of the grid cell they lie in
+ * and the partitions are sorted by several threads at the same time. To limit the
+ * temporary memory only a part of the partitions is sorted at a time.
+ * A point that is closer than the tolerance to the border of a neighbour cell is
+ * added to that cell, too, so that points on both sides of the border are found.
+ */
+class MeshExport MeshPointWelder
+{
+public:
+    /** Like MeshBuilder does, points are considered to be equal if their distance
+     * is lower than \a fTolerance along each axis. If \a fTolerance is 0 only
+     * points with the same coordinates are equal.
+     */
+    MeshPointWelder(const std::vector<Base::Vector3f>& points, float fTolerance);
+    ~MeshPointWelder();
+
+    /** For each point the index of the first point within the tolerance is set
+     * to \a rep. The representative of a point never has a higher index but it
+     * may have a representative itself.
+     */
+    void Run(std::vector<unsigned long>& rep);
+
+private:
+    struct Entry;
+    struct Chunk;
+    struct Partition;
+    struct Less;
+    friend struct Less;
+
+    double Cell(float v) const;
+    bool SameCell(const Entry&, const Entry&) const;
+    bool IsEqual(const Base::Vector3f&, const Base::Vector3f&) const;
+    int GetEntries(unsigned long index, Entry* entries) const;
+    unsigned long GetPartition(const Entry&) const;
+    void Count(Chunk&) const;
+    void Scatter(Chunk&);
+    void Merge(Partition&);
+
+private:
+    const std::vector<Base::Vector3f>& _points;
+    float _fTolerance;
+    double _invCellSize;
+    unsigned long _numPartitions;
+    unsigned long _firstPartition, _lastPartition;
+    std::vector<Entry> _order;
+    std::vector<unsigned long>* _representative;
+};
+
 } // namespace MeshCore
 
 #endif 
@@ -0,0 +1,611 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <cfloat>
+# include <climits>
+# include <cmath>
+#endif
+
+#include <QThread>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
+#include "Decimation.h"
+#include "Definitions.h"
+#include "MeshKernel.h"
+
+using namespace MeshCore;
+
+// weight of the planes that keep border and feature edges
+#define MESH_DECIMATION_CONSTRAINT_WEIGHT 1000.0
+// number of coefficients of a symmetric 4x4 matrix
+#define MESH_QUADRIC_SIZE 10
+
+namespace MeshCore {
+
+/** A candidate edge for a collapse of \a p1 into \a p0. */
+struct MeshDecimation::Collapse
+{
+    unsigned long p0, p1;
+    unsigned long v0, v1; // versions of the points when the cost was computed
+    double cost;
+    Base::Vector3f pos;
+
+    // the heap must return the lowest cost first
+    bool operator < (const Collapse& c) const
+    { return cost > c.cost; }
+};
+
+/** The facets of a slab and the number of facets to remove from it. */
+struct MeshDecimation::Partition
+{
+    int index;
+    std::vector<unsigned long> facets;
+    unsigned long toRemove;
+    unsigned long removed;
+};
+
+} // namespace MeshCore
+
+// The quadric of a plane n*x+d=0 is stored as the upper triangle of the matrix
+// (nx,ny,nz,d)^T*(nx,ny,nz,d): xx xy xz xd yy yz yd zz zd dd
+static double evaluateQuadric(const double* q, const Base::Vector3f& v)
+{
+    double x = v.x, y = v.y, z = v.z;
+    return q[0]*x*x + 2.0*q[1]*x*y + 2.0*q[2]*x*z + 2.0*q[3]*x
+                    +     q[4]*y*y + 2.0*q[5]*y*z + 2.0*q[6]*y
+                                   +     q[7]*z*z + 2.0*q[8]*z
+                                                  +     q[9];
+}
+
+// Computes the point with the minimum error, false is returned if it is not unique
+static bool optimizeQuadric(const double* q, Base::Vector3f& v)
+{
+    // solve A*v = -b with Cramer's rule
+    double a00 = q[0], a01 = q[1], a02 = q[2];
+    double a11 = q[4], a12 = q[5], a22 = q[7];
+    double b0 = -q[3], b1 = -q[6], b2 = -q[8];
+
+    double c00 = a11*a22 - a12*a12;
+    double c01 = a02*a12 - a01*a22;
+    double c02 = a01*a12 - a02*a11;
+    double det = a00*c00 + a01*c01 + a02*c02;
+
+    // the matrix is the sum of n*n^T of unit normals, so its scale is known
+    double scale = (a00 + a11 + a22) / 3.0;
+    if (fabs(det) <= 1.0e-6 * scale * scale * scale)
+        return false;
+
+    double c11 = a00*a22 - a02*a02;
+    double c12 = a01*a02 - a00*a12;
+    double c22 = a00*a11 - a01*a01;
+    v.x = (float)((c00*b0 + c01*b1 + c02*b2) / det);
+    v.y = (float)((c01*b0 + c11*b1 + c12*b2) / det);
+    v.z = (float)((c02*b0 + c12*b1 + c22*b2) / det);
+    return true;
+}
+
+MeshDecimation::MeshDecimation(MeshKernel& rclMesh)
+  : _rclMesh(rclMesh), _ulTargetSize(0), _fTolerance(0.0f)
+  , _bPreserveBoundary(true), _fFeatureAngle(F_PI), _uiPartitions(0)
+{
+}
+
+MeshDecimation::~MeshDecimation()
+{
+}
+
+void MeshDecimation::Simplify()
+{
+    // without a target size and an error bound everything would be removed
+    unsigned long ulCtFacets = _rclMesh.CountFacets();
+    if (ulCtFacets <= _ulTargetSize || (_ulTargetSize == 0 && _fTolerance <= 0.0f))
+        return;
+
+    _points.resize(_rclMesh.CountPoints());
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    for (std::size_t i = 0; i < _points.size(); i++)
+        _points[i] = rPoints[i];
+    _facets = _rclMesh.GetFacets();
+    _validFacets.resize(ulCtFacets, 1);
+    _version.resize(_points.size(), 0);
+
+    _pointFacets.resize(_points.size());
+    for (unsigned long i = 0; i < ulCtFacets; i++) {
+        for (int j = 0; j < 3; j++)
+            _pointFacets[_facets[i]._aulPoints[j]].push_back(i);
+    }
+
+    InitQuadrics();
+
+    // decimate the slabs in parallel, the locked points at the slab borders
+    // are handled by the sequential pass afterwards
+    unsigned int uiCount = _uiPartitions;
+    if (uiCount == 0)
+        uiCount = ulCtFacets > 100000 ? std::max<int>(QThread::idealThreadCount(), 1) : 1;
+    unsigned long ulRemoved = 0;
+    if (uiCount > 1) {
+        std::vector<Partition> parts;
+        SplitIntoPartitions(uiCount, parts);
+        QtConcurrent::blockingMap(parts, boost::bind(&MeshDecimation::SimplifyPartition, this, _1));
+        for (std::vector<Partition>::iterator it = parts.begin(); it != parts.end(); ++it)
+            ulRemoved += it->removed;
+    }
+
+    std::vector<Partition> all(1);
+    Partition& part = all.front();
+    part.index = 0;
+    part.removed = 0;
+    part.toRemove = _ulTargetSize > 0 ? ulCtFacets - ulRemoved - std::min<unsigned long>(_ulTargetSize, ulCtFacets - ulRemoved) : ULONG_MAX;
+    for (unsigned long i = 0; i < ulCtFacets; i++) {
+        if (_validFacets[i])
+            part.facets.push_back(i);
+    }
+    _owner.assign(_points.size(), 0);
+    SimplifyPartition(part);
+
+    Finish();
+}
+
+void MeshDecimation::AddPlane(unsigned long ulPoint, const Base::Vector3f& rclNormal,
+                              const Base::Vector3f& rclBase, double fWeight)
+{
+    double a = rclNormal.x, b = rclNormal.y, c = rclNormal.z;
+    double d = -(rclNormal * rclBase);
+    double* q = &_quadrics[MESH_QUADRIC_SIZE * ulPoint];
+    q[0] += fWeight*a*a; q[1] += fWeight*a*b; q[2] += fWeight*a*c; q[3] += fWeight*a*d;
+    q[4] += fWeight*b*b; q[5] += fWeight*b*c; q[6] += fWeight*b*d;
+    q[7] += fWeight*c*c; q[8] += fWeight*c*d;
+    q[9] += fWeight*d*d;
+}
+
+void MeshDecimation::AddEdgeConstraint(const MeshFacet& rclFacet, int iSide)
+{
+    // a plane through the edge that is perpendicular to the facet
+    unsigned long ulP0 = rclFacet._aulPoints[iSide];
+    unsigned long ulP1 = rclFacet._aulPoints[(iSide+1)%3];
+    unsigned long ulP2 = rclFacet._aulPoints[(iSide+2)%3];
+    Base::Vector3f clEdge = _points[ulP1] - _points[ulP0];
+    Base::Vector3f clNormal = clEdge % (_points[ulP2] - _points[ulP0]);
+    Base::Vector3f clPlane = clEdge % clNormal;
+    if (clPlane.Length() < FLOAT_EPS * FLOAT_EPS)
+        return;
+    clPlane.Normalize();
+    AddPlane(ulP0, clPlane, _points[ulP0], MESH_DECIMATION_CONSTRAINT_WEIGHT);
+    AddPlane(ulP1, clPlane, _points[ulP0], MESH_DECIMATION_CONSTRAINT_WEIGHT);
+}
+
+void MeshDecimation::InitQuadrics()
+{
+    _quadrics.clear();
+    _quadrics.resize(MESH_QUADRIC_SIZE * _points.size(), 0.0);
+
+    float fCosFeature = (float)cos(_fFeatureAngle);
+    unsigned long ulCtFacets = _facets.size();
+    for (unsigned long i = 0; i < ulCtFacets; i++) {
+        const MeshFacet& rclFacet = _facets[i];
+        const Base::Vector3f& p0 = _points[rclFacet._aulPoints[0]];
+        Base::Vector3f clNormal = (_points[rclFacet._aulPoints[1]] - p0) % (_points[rclFacet._aulPoints[2]] - p0);
+        if (clNormal.Length() == 0.0f)
+            continue; // degenerated facet
+        clNormal.Normalize();
+        for (int j = 0; j < 3; j++)
+            AddPlane(rclFacet._aulPoints[j], clNormal, p0, 1.0);
+
+        for (int j = 0; j < 3; j++) {
+            unsigned long ulNeighbour = rclFacet._aulNeighbours[j];
+            if (ulNeighbour == ULONG_MAX) {
+                if (_bPreserveBoundary)
+                    AddEdgeConstraint(rclFacet, j);
+            }
+            else if (i < ulNeighbour && _fFeatureAngle < F_PI) {
+                const MeshFacet& rclOther = _facets[ulNeighbour];
+                const Base::Vector3f& q0 = _points[rclOther._aulPoints[0]];
+                Base::Vector3f clOther = (_points[rclOther._aulPoints[1]] - q0) % (_points[rclOther._aulPoints[2]] - q0);
+                if (clOther.Length() == 0.0f)
+                    continue;
+                clOther.Normalize();
+                if (clNormal * clOther < fCosFeature) {
+                    AddEdgeConstraint(rclFacet, j);
+                    for (int k = 0; k < 3; k++) {
+                        if (rclOther._aulNeighbours[k] == i)
+                            AddEdgeConstraint(rclOther, k);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void MeshDecimation::SplitIntoPartitions(unsigned int uiCount, std::vector<Partition>& raclParts)
+{
+    // cut the mesh into slabs with about the same number of facets along the longest axis
+    const Base::BoundBox3f& clBox = _rclMesh.GetBoundBox();
+    int iAxis = 0;
+    float fMin = clBox.MinX, fLength = clBox.LengthX();
+    if (clBox.LengthY() > fLength) {
+        iAxis = 1; fMin = clBox.MinY; fLength = clBox.LengthY();
+    }
+    if (clBox.LengthZ() > fLength) {
+        iAxis = 2; fMin = clBox.MinZ; fLength = clBox.LengthZ();
+    }
+
+    const int iCtBins = 1024;
+    unsigned long ulCtFacets = _facets.size();
+    std::vector<int> facetBin(ulCtFacets);
+    std::vector<unsigned long> histogram(iCtBins, 0);
+    for (unsigned long i = 0; i < ulCtFacets; i++) {
+        const MeshFacet& rclFacet = _facets[i];
+        float fCenter = (_points[rclFacet._aulPoints[0]][iAxis] +
+                         _points[rclFacet._aulPoints[1]][iAxis] +
+                         _points[rclFacet._aulPoints[2]][iAxis]) / 3.0f;
+        int iBin = fLength > 0.0f ? (int)((fCenter - fMin) / fLength * iCtBins) : 0;
+        iBin = std::max<int>(0, std::min<int>(iBin, iCtBins - 1));
+        facetBin[i] = iBin;
+        histogram[iBin]++;
+    }
+
+    std::vector<int> binPart(iCtBins);
+    unsigned long ulSum = 0;
+    for (int i = 0; i < iCtBins; i++) {
+        binPart[i] = (int)std::min<unsigned long>((ulSum * uiCount) / ulCtFacets, uiCount - 1);
+        ulSum += histogram[i];
+    }
+
+    raclParts.resize(uiCount);
+    for (unsigned int i = 0; i < uiCount; i++) {
+        raclParts[i].index = (int)i;
+        raclParts[i].removed = 0;
+    }
+
+    // points used by more than one slab are locked
+    _owner.assign(_points.size(), -2);
+    for (unsigned long i = 0; i < ulCtFacets; i++) {
+        int iPart = binPart[facetBin[i]];
+        raclParts[iPart].facets.push_back(i);
+        for (int j = 0; j < 3; j++) {
+            int& iOwner = _owner[_facets[i]._aulPoints[j]];
+            if (iOwner == -2)
+                iOwner = iPart;
+            else if (iOwner != iPart)
+                iOwner = -1;
+        }
+    }
+
+    unsigned long ulToRemove = _ulTargetSize > 0 ? ulCtFacets - _ulTargetSize : ULONG_MAX;
+    for (unsigned int i = 0; i < uiCount; i++) {
+        Partition& part = raclParts[i];
+        if (_ulTargetSize > 0)
+            part.toRemove = (unsigned long)((double)ulToRemove * part.facets.size() / ulCtFacets);
+        else
+            part.toRemove = ULONG_MAX;
+    }
+}
+
+void MeshDecimation::SimplifyPartition(Partition& rclPart)
+{
+    double fMaxCost = _fTolerance > 0.0f ? (double)_fTolerance * (double)_fTolerance : DBL_MAX;
+
+    // The heap is filled lazily: entries whose points have changed since are skipped
+    std::vector<Collapse> heap;
+    Collapse clCollapse;
+    for (std::vector<unsigned long>::iterator it = rclPart.facets.begin(); it != rclPart.facets.end(); ++it) {
+        const MeshFacet& rclFacet = _facets[*it];
+        for (int j = 0; j < 3; j++) {
+            unsigned long ulP0 = rclFacet._aulPoints[j];
+            unsigned long ulP1 = rclFacet._aulPoints[(j+1)%3];
+            if (_owner[ulP0] != rclPart.index || _owner[ulP1] != rclPart.index)
+                continue;
+            if (GetCollapse(std::min<unsigned long>(ulP0, ulP1), std::max<unsigned long>(ulP0, ulP1), clCollapse))
+                heap.push_back(clCollapse);
+        }
+    }
+    std::make_heap(heap.begin(), heap.end());
+
+    while (!heap.empty() && rclPart.removed < rclPart.toRemove) {
+        std::pop_heap(heap.begin(), heap.end());
+        clCollapse = heap.back();
+        heap.pop_back();
+
+        if (clCollapse.cost > fMaxCost)
+            break;
+        if (_version[clCollapse.p0] != clCollapse.v0 || _version[clCollapse.p1] != clCollapse.v1)
+            continue;
+        if (!CanCollapse(clCollapse))
+            continue;
+
+        rclPart.removed += DoCollapse(clCollapse);
+        PushEdges(clCollapse.p0, rclPart.index, heap);
+    }
+}
+
+void MeshDecimation::PushEdges(unsigned long ulPoint, int iOwner, std::vector<Collapse>& raclHeap) const
+{
+    std::vector<unsigned long> neighbours;
+    const std::vector<unsigned long>& facets = _pointFacets[ulPoint];
+    for (std::vector<unsigned long>::const_iterator it = facets.begin(); it != facets.end(); ++it) {
+        if (!_validFacets[*it])
+            continue;
+        for (int j = 0; j < 3; j++) {
+            unsigned long ulOther = _facets[*it]._aulPoints[j];
+            if (ulOther != ulPoint && _owner[ulOther] == iOwner)
+                neighbours.push_back(ulOther);
+        }
+    }
+
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+
+    Collapse clCollapse;
+    for (std::vector<unsigned long>::iterator it = neighbours.begin(); it != neighbours.end(); ++it) {
+        if (GetCollapse(ulPoint, *it, clCollapse)) {
+            raclHeap.push_back(clCollapse);
+            std::push_heap(raclHeap.begin(), raclHeap.end());
+        }
+    }
+}
+
+bool MeshDecimation::GetCollapse(unsigned long ulP0, unsigned long ulP1, Collapse& rclCollapse) const
+{
+    double q[MESH_QUADRIC_SIZE];
+    const double* q0 = &_quadrics[MESH_QUADRIC_SIZE * ulP0];
+    const double* q1 = &_quadrics[MESH_QUADRIC_SIZE * ulP1];
+    for (int i = 0; i < MESH_QUADRIC_SIZE; i++)
+        q[i] = q0[i] + q1[i];
+
+    const Base::Vector3f& p0 = _points[ulP0];
+    const Base::Vector3f& p1 = _points[ulP1];
+    Base::Vector3f clMid = 0.5f * (p0 + p1);
+
+    // the optimal point must not be too far away from the edge, otherwise
+    // take the best of the end and mid points
+    Base::Vector3f clPos;
+    if (optimizeQuadric(q, clPos) && Base::DistanceP2(clPos, clMid) <= 4.0f * Base::DistanceP2(p0, p1)) {
+        rclCollapse.pos = clPos;
+        rclCollapse.cost = evaluateQuadric(q, clPos);
+    }
+    else {
+        rclCollapse.pos = p0;
+        rclCollapse.cost = evaluateQuadric(q, p0);
+        double fCost = evaluateQuadric(q, p1);
+        if (fCost < rclCollapse.cost) {
+            rclCollapse.pos = p1;
+            rclCollapse.cost = fCost;
+        }
+        fCost = evaluateQuadric(q, clMid);
+        if (fCost < rclCollapse.cost) {
+            rclCollapse.pos = clMid;
+            rclCollapse.cost = fCost;
+        }
+    }
+
+    rclCollapse.cost = std::max<double>(rclCollapse.cost, 0.0);
+    rclCollapse.p0 = ulP0;
+    rclCollapse.p1 = ulP1;
+    rclCollapse.v0 = _version[ulP0];
+    rclCollapse.v1 = _version[ulP1];
+    return true;
+}
+
+bool MeshDecimation::IsBoundaryPoint(unsigned long ulPoint) const
+{
+    // at a border point there is an edge used by one facet only
+    std::vector<unsigned long> neighbours;
+    const std::vector<unsigned long>& facets = _pointFacets[ulPoint];
+    for (std::vector<unsigned long>::const_iterator it = facets.begin(); it != facets.end(); ++it) {
+        if (!_validFacets[*it])
+            continue;
+        for (int j = 0; j < 3; j++) {
+            if (_facets[*it]._aulPoints[j] != ulPoint)
+                neighbours.push_back(_facets[*it]._aulPoints[j]);
+        }
+    }
+
+    std::sort(neighbours.begin(), neighbours.end());
+    for (std::size_t i = 0; i < neighbours.size(); ) {
+        std::size_t j = i + 1;
+        while (j < neighbours.size() && neighbours[j] == neighbours[i])
+            j++;
+        if (j - i == 1)
+            return true;
+        i = j;
+    }
+
+    return false;
+}
+
+bool MeshDecimation::CanCollapse(const Collapse& rclCollapse) const
+{
+    unsigned long ulP0 = rclCollapse.p0;
+    unsigned long ulP1 = rclCollapse.p1;
+
+    // the facets sharing the edge
+    std::vector<unsigned long> edgeFacets, neighbours0, neighbours1, opposite;
+    const std::vector<unsigned long>& facets0 = _pointFacets[ulP0];
+    for (std::vector<unsigned long>::const_iterator it = facets0.begin(); it != facets0.end(); ++it) {
+        if (!_validFacets[*it])
+            continue;
+        const MeshFacet& rclFacet = _facets[*it];
+        bool bEdge = false;
+        for (int j = 0; j < 3; j++) {
+            if (rclFacet._aulPoints[j] == ulP1)
+                bEdge = true;
+            else if (rclFacet._aulPoints[j] != ulP0)
+                neighbours0.push_back(rclFacet._aulPoints[j]);
+        }
+        if (bEdge) {
+            edgeFacets.push_back(*it);
+            opposite.push_back(neighbours0.back());
+        }
+    }
+
+    // non-manifold edges are kept
+    if (edgeFacets.empty() || edgeFacets.size() > 2)
+        return false;
+
+    const std::vector<unsigned long>& facets1 = _pointFacets[ulP1];
+    for (std::vector<unsigned long>::const_iterator it = facets1.begin(); it != facets1.end(); ++it) {
+        if (!_validFacets[*it])
+            continue;
+        const MeshFacet& rclFacet = _facets[*it];
+        for (int j = 0; j < 3; j++) {
+            if (rclFacet._aulPoints[j] != ulP0 && rclFacet._aulPoints[j] != ulP1)
+                neighbours1.push_back(rclFacet._aulPoints[j]);
+        }
+    }
+
+    // link condition: the only common neighbours are the opposite points of the edge facets
+    std::sort(neighbours0.begin(), neighbours0.end());
+    neighbours0.erase(std::unique(neighbours0.begin(), neighbours0.end()), neighbours0.end());
+    std::sort(neighbours1.begin(), neighbours1.end());
+    neighbours1.erase(std::unique(neighbours1.begin(), neighbours1.end()), neighbours1.end());
+    std::vector<unsigned long> common;
+    std::set_intersection(neighbours0.begin(), neighbours0.end(), neighbours1.begin(), neighbours1.end(),
+                          std::back_inserter(common));
+    std::sort(opposite.begin(), opposite.end());
+    opposite.erase(std::unique(opposite.begin(), opposite.end()), opposite.end());
+    if (common != opposite)
+        return false;
+
+    // don't join two borders by an inner edge
+    if (edgeFacets.size() == 2 && IsBoundaryPoint(ulP0) && IsBoundaryPoint(ulP1))
+        return false;
+
+    // the remaining facets must not flip or degenerate
+    for (int i = 0; i < 2; i++) {
+        unsigned long ulPoint = (i == 0 ? ulP0 : ulP1);
+        const std::vector<unsigned long>& facets = _pointFacets[ulPoint];
+        for (std::vector<unsigned long>::const_iterator it = facets.begin(); it != facets.end(); ++it) {
+            if (!_validFacets[*it] || std::find(edgeFacets.begin(), edgeFacets.end(), *it) != edgeFacets.end())
+                continue;
+            const MeshFacet& rclFacet = _facets[*it];
+            Base::Vector3f clOld[3], clNew[3];
+            for (int j = 0; j < 3; j++) {
+                clOld[j] = _points[rclFacet._aulPoints[j]];
+                clNew[j] = (rclFacet._aulPoints[j] == ulPoint ? rclCollapse.pos : clOld[j]);
+            }
+            Base::Vector3f clOldNormal = (clOld[1] - clOld[0]) % (clOld[2] - clOld[0]);
+            Base::Vector3f clNewNormal = (clNew[1] - clNew[0]) % (clNew[2] - clNew[0]);
+            float fOldLength = clOldNormal.Length();
+            float fNewLength = clNewNormal.Length();
+            if (fNewLength <= FLOAT_EPS * fOldLength)
+                return false;
+            if (clOldNormal * clNewNormal < 0.2f * fOldLength * fNewLength)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+unsigned long MeshDecimation::DoCollapse(const Collapse& rclCollapse)
+{
+    unsigned long ulP0 = rclCollapse.p0;
+    unsigned long ulP1 = rclCollapse.p1;
+    unsigned long ulRemoved = 0;
+
+    _points[ulP0] = rclCollapse.pos;
+    double* q0 = &_quadrics[MESH_QUADRIC_SIZE * ulP0];
+    const double* q1 = &_quadrics[MESH_QUADRIC_SIZE * ulP1];
+    for (int i = 0; i < MESH_QUADRIC_SIZE; i++)
+        q0[i] += q1[i];
+    _version[ulP0]++;
+    _version[ulP1]++;
+    _owner[ulP1] = -1;
+
+    // remove the facets of the edge, the lists of the opposite points are
+    // not touched because they may be used by another thread
+    std::vector<unsigned long>& facets0 = _pointFacets[ulP0];
+    for (std::vector<unsigned long>::iterator it = facets0.begin(); it != facets0.end(); ++it) {
+        if (!_validFacets[*it])
+            continue;
+        const MeshFacet& rclFacet = _facets[*it];
+        if (rclFacet._aulPoints[0] == ulP1 || rclFacet._aulPoints[1] == ulP1 || rclFacet._aulPoints[2] == ulP1) {
+            _validFacets[*it] = 0;
+            ulRemoved++;
+        }
+    }
+
+    // move the facets of the removed point to the kept point
+    std::vector<unsigned long>& facets1 = _pointFacets[ulP1];
+    for (std::vector<unsigned long>::iterator it = facets1.begin(); it != facets1.end(); ++it) {
+        if (!_validFacets[*it])
+            continue;
+        MeshFacet& rclFacet = _facets[*it];
+        for (int j = 0; j < 3; j++) {
+            if (rclFacet._aulPoints[j] == ulP1)
+                rclFacet._aulPoints[j] = ulP0;
+        }
+        facets0.push_back(*it);
+    }
+    std::vector<unsigned long>().swap(facets1);
+
+    // drop the removed facets from the list of the kept point
+    std::vector<unsigned long> valid;
+    for (std::vector<unsigned long>::iterator it = facets0.begin(); it != facets0.end(); ++it) {
+        if (_validFacets[*it])
+            valid.push_back(*it);
+    }
+    facets0.swap(valid);
+
+    return ulRemoved;
+}
+
+void MeshDecimation::Finish()
+{
+    // keep only the used points
+    std::vector<unsigned long> index(_points.size(), ULONG_MAX);
+    MeshPointArray points;
+    MeshFacetArray facets;
+    unsigned long ulCtFacets = _facets.size();
+    for (unsigned long i = 0; i < ulCtFacets; i++) {
+        if (!_validFacets[i])
+            continue;
+        unsigned long aulPoints[3];
+        for (int j = 0; j < 3; j++) {
+            unsigned long ulPoint = _facets[i]._aulPoints[j];
+            if (index[ulPoint] == ULONG_MAX) {
+                index[ulPoint] = points.size();
+                points.push_back(MeshPoint(_points[ulPoint]));
+            }
+            aulPoints[j] = index[ulPoint];
+        }
+        MeshFacet clFacet;
+        clFacet.SetVertices(aulPoints[0], aulPoints[1], aulPoints[2]);
+        facets.push_back(clFacet);
+    }
+
+    _points.clear();
+    _facets.clear();
+    _validFacets.clear();
+    _quadrics.clear();
+    _pointFacets.clear();
+    _owner.clear();
+    _version.clear();
+
+    _rclMesh.Adopt(points, facets, true);
+}
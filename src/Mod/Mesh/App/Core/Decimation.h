@@ -0,0 +1,125 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESH_DECIMATION_H
+#define MESH_DECIMATION_H
+
+#include <vector>
+
+#include "Elements.h"
+
+namespace MeshCore
+{
+class MeshKernel;
+
+/**
+ * The MeshDecimation class reduces the number of facets of a mesh by edge collapses.
+ * The edges are collapsed in the order of the quadric error metric of Garland and
+ * Heckbert, i.e. each point keeps the sum of the squared distances to the planes of
+ * its original facets and the edge with the lowest error is collapsed first.
+ *
+ * Collapses that change the topology, flip facets or join two borders are rejected.
+ * Border edges and sharp edges get additional planes perpendicular to their facets
+ * so that they are kept as far as possible.
+ *
+ * For big meshes the space is split into slabs which are decimated by several threads
+ * at the same time. Points that are used by facets of more than one slab are locked
+ * in this phase. Afterwards a sequential pass over the whole mesh removes the remaining
+ * facets.
+ * \code
+ * MeshDecimation decimate(kernel);
+ * decimate.SetTargetSize(kernel.CountFacets() / 10);
+ * decimate.Simplify();
+ * \endcode
+ */
+class MeshExport MeshDecimation
+{
+public:
+    MeshDecimation(MeshKernel& rclMesh);
+    ~MeshDecimation();
+
+    /** Stops when the mesh has \a ulSize facets or less. 0 means no limit which is the default. */
+    void SetTargetSize(unsigned long ulSize)
+    { _ulTargetSize = ulSize; }
+    /** Stops when the error of collapsing an edge exceeds \a fTolerance. The error is the
+     * square root of the quadric error, i.e. of the sum of the squared distances of the new
+     * point to the planes of the original facets around it. So no point moves farther than
+     * \a fTolerance from any of these planes. A value of 0 or less means no limit which is
+     * the default.
+     */
+    void SetTolerance(float fTolerance)
+    { _fTolerance = fTolerance; }
+    /** Keeps the border edges of an open mesh, this is the default. */
+    void SetPreserveBoundary(bool bOn)
+    { _bPreserveBoundary = bOn; }
+    /** Keeps edges where the normals of the adjacent facets differ by more than \a fAngle
+     * (in radian). By default no feature edges are kept.
+     */
+    void SetFeatureAngle(float fAngle)
+    { _fFeatureAngle = fAngle; }
+    /** Sets the number of slabs decimated in parallel. 0 means to choose it depending on
+     * the size of the mesh and the number of processors, which is the default. 1 means to
+     * decimate the whole mesh sequentially.
+     */
+    void SetPartitions(unsigned int uiCount)
+    { _uiPartitions = uiCount; }
+
+    /** Decimates the mesh. */
+    void Simplify();
+
+private:
+    struct Collapse;
+    struct Partition;
+
+    void InitQuadrics();
+    void AddPlane(unsigned long ulPoint, const Base::Vector3f& rclNormal, const Base::Vector3f& rclBase, double fWeight);
+    void AddEdgeConstraint(const MeshFacet& rclFacet, int iSide);
+    void SplitIntoPartitions(unsigned int uiCount, std::vector<Partition>& raclParts);
+    void SimplifyPartition(Partition& rclPart);
+    void PushEdges(unsigned long ulPoint, int iOwner, std::vector<Collapse>& raclHeap) const;
+    bool GetCollapse(unsigned long ulP0, unsigned long ulP1, Collapse& rclCollapse) const;
+    bool CanCollapse(const Collapse& rclCollapse) const;
+    bool IsBoundaryPoint(unsigned long ulPoint) const;
+    unsigned long DoCollapse(const Collapse& rclCollapse);
+    void Finish();
+
+private:
+    MeshKernel& _rclMesh;
+    unsigned long _ulTargetSize;
+    float _fTolerance;
+    bool _bPreserveBoundary;
+    float _fFeatureAngle;
+    unsigned int _uiPartitions;
+
+    std::vector<Base::Vector3f> _points;
+    MeshFacetArray _facets;
+    std::vector<char> _validFacets;
+    std::vector<double> _quadrics;
+    std::vector<std::vector<unsigned long> > _pointFacets;
+    std::vector<int> _owner;
+    std::vector<unsigned long> _version;
+};
+
+} // namespace MeshCore
+
+#endif // MESH_DECIMATION_H
@@ -30,6 +30,9 @@
 #define MESH_MIN_EDGE_ANGLE        float(RAD(2.0))
 #define MESH_REMOVE_MIN_LEN        true
 #define MESH_REMOVE_G3_EDGES       true
+#define MESH_MAX_SORT_SIZE         (1ul << 25) // maximum number of elements sorted at a time
+#define MESH_PARALLEL_NEIGHBOURS   100000      // minimum number of facets to rebuild the neighbourhood in parallel
+#define MESH_WELD_CELL_SIZE        16          // size of the grid cells to weld points in multiples of the tolerance
 
 /*
  * general constant definitions
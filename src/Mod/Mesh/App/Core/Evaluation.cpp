@@ -32,6 +32,7 @@
 #include <Mod/Mesh/App/WildMagic4/Wm4Vector3.h>
 
 #include "Evaluation.h"
+#include "Degeneration.h"
 #include "Iterator.h"
 #include "Algorithm.h"
 #include "Approximation.h"
@@ -43,6 +44,13 @@
 
 #include <Base/Sequencer.h>
 
+#include <QAtomicInt>
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+#include <boost/functional/hash.hpp>
+
 using namespace MeshCore;
 
 
@@ -471,8 +479,8 @@ bool MeshEvalPointManifolds::Evaluate ()
     unsigned long ctPoints = _rclMesh.CountPoints();
     for (unsigned long index=0; index < ctPoints; index++) {
         // get the local neighbourhood of the point
-        const std::set<unsigned long>& nf = vf_it[index];
-        const std::set<unsigned long>& np = vv_it[index];
+        MeshIndexRange nf = vf_it[index];
+        MeshIndexRange np = vv_it[index];
 
         std::set<unsigned long>::size_type sp, sf;
         sp = np.size();
@@ -588,76 +596,205 @@ bool MeshFixSingleFacet::Fixup ()
 
 // ----------------------------------------------------------------
 
-bool MeshEvalSelfIntersection::Evaluate ()
+namespace MeshCore {
+
+/**
+ * The MeshSelfIntersectionSearch class checks the facets of ranges of grid
+ * elements for intersections. The ranges are independent of each other and
+ * can be handled by several threads at the same time.
+ */
+class MeshSelfIntersectionSearch
 {
-    // Contains bounding boxes for every facet 
-    std::vector<Base::BoundBox3f> boxes;
+public:
+    struct Range
+    {
+        Range(unsigned long b, unsigned long e) : begin(b), end(e) {}
+        unsigned long begin, end;
+        std::vector<std::pair<unsigned long, unsigned long> > result;
+    };
+
+    MeshSelfIntersectionSearch(const MeshKernel& rclMesh, const std::vector<Base::BoundBox3f>& rBoxes,
+                               const std::vector<std::vector<unsigned long> >& rCells, bool first)
+      : mesh(rclMesh), boxes(rBoxes), cells(rCells), firstOnly(first), found(0)
+    {
+    }
+    bool HasFound() const
+    {
+        return int(found) != 0;
+    }
+    void Check(Range& range) const
+    {
+        const MeshFacetArray& rFaces = mesh.GetFacets();
+        MeshGeomFacet facet1, facet2;
+        Base::Vector3f pt1, pt2;
+        for (unsigned long index = range.begin; index < range.end; index++) {
+            // another thread already found an intersection
+            if (firstOnly && HasFound())
+                return;
+            const std::vector<unsigned long>& elements = cells[index];
+            for (std::vector<unsigned long>::const_iterator it = elements.begin(); it != elements.end(); ++it) {
+                const Base::BoundBox3f& box1 = boxes[*it];
+                const MeshFacet& rface1 = rFaces[*it];
+                bool hasFacet1 = false;
+                for (std::vector<unsigned long>::const_iterator jt = it + 1; jt != elements.end(); ++jt) {
+                    // If the facets share a common vertex we do not check for self-intersections because they 
+                    // could but usually do not intersect each other and the algorithm below would detect false-positives,
+                    // otherwise
+                    const MeshFacet& rface2 = rFaces[*jt];
+                    if (rface1._aulPoints[0] == rface2._aulPoints[0] || 
+                        rface1._aulPoints[0] == rface2._aulPoints[1] ||
+                        rface1._aulPoints[0] == rface2._aulPoints[2])
+                        continue; // ignore facets sharing a common vertex
+                    if (rface1._aulPoints[1] == rface2._aulPoints[0] || 
+                        rface1._aulPoints[1] == rface2._aulPoints[1] ||
+                        rface1._aulPoints[1] == rface2._aulPoints[2])
+                        continue; // ignore facets sharing a common vertex
+                    if (rface1._aulPoints[2] == rface2._aulPoints[0] || 
+                        rface1._aulPoints[2] == rface2._aulPoints[1] ||
+                        rface1._aulPoints[2] == rface2._aulPoints[2])
+                        continue; // ignore facets sharing a common vertex
+
+                    const Base::BoundBox3f& box2 = boxes[*jt];
+                    if (box1 && box2) {
+                        if (!hasFacet1) {
+                            facet1 = mesh.GetFacet(rface1);
+                            hasFacet1 = true;
+                        }
+                        facet2 = mesh.GetFacet(rface2);
+                        int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
+                        if (ret == 2) {
+                            range.result.push_back(std::make_pair(*it, *jt));
+                            if (firstOnly) {
+                                found.fetchAndStoreRelaxed(1);
+                                return;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    const MeshKernel& mesh;
+    const std::vector<Base::BoundBox3f>& boxes;
+    const std::vector<std::vector<unsigned long> >& cells;
+    bool firstOnly;
+    mutable QAtomicInt found;
+};
+
+} // namespace MeshCore
 
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(_rclMesh);
+void MeshEvalSelfIntersection::FindIntersections(std::vector<std::pair<unsigned long, unsigned long> >& intersection,
+                                                 bool firstOnly, bool canAbort) const
+{
     const MeshFacetArray& rFaces = _rclMesh.GetFacets();
-    MeshGridIterator clGridIter(cMeshFacetGrid);
-    unsigned long ulGridX, ulGridY, ulGridZ;
-    cMeshFacetGrid.GetCtGrids(ulGridX, ulGridY, ulGridZ);
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    if (rFaces.empty())
+        return;
 
-    MeshFacetIterator cMFI(_rclMesh);
-    for (cMFI.Begin(); cMFI.More(); cMFI.Next()) {
-        boxes.push_back((*cMFI).GetBoundBox());
+    // Contains bounding boxes for every facet 
+    std::vector<Base::BoundBox3f> boxes;
+    boxes.reserve(rFaces.size());
+    float fMeanSize = 0.0f;
+    for (MeshFacetArray::_TConstIterator it = rFaces.begin(); it != rFaces.end(); ++it) {
+        Base::BoundBox3f box;
+        box &= rPoints[it->_aulPoints[0]];
+        box &= rPoints[it->_aulPoints[1]];
+        box &= rPoints[it->_aulPoints[2]];
+        fMeanSize += std::max<float>(box.LengthX(), std::max<float>(box.LengthY(), box.LengthZ()));
+        boxes.push_back(box);
+    }
+    fMeanSize /= float(rFaces.size());
+
+    // Splits the mesh using grid for speeding up the calculation. The grid elements
+    // are only a few facets wide so that the number of facet pairs per element keeps
+    // small. As the grid is a dense array over the bounding box, most elements of a
+    // surface mesh are empty, so the number of all grid elements is limited to a
+    // fraction of the number of facets.
+    const unsigned long ulFacetsPerGrid = 32;
+    Base::BoundBox3f clBox = _rclMesh.GetBoundBox();
+    unsigned long ulMaxGrids = std::max<unsigned long>(MESH_MAX_GRIDS, rFaces.size() / ulFacetsPerGrid);
+    float fGridLen = std::max<float>(8.0f * fMeanSize, (float)pow(clBox.LengthX() * clBox.LengthY() *
+                                     clBox.LengthZ() / float(ulMaxGrids), 1.0f / 3.0f));
+    // for flat bounding boxes the volume underestimates the number of grid elements
+    for (int i = 0; i < 10 && fGridLen > 0.0f; i++) {
+        double dCtGrids = std::max<double>(floor(clBox.LengthX() / fGridLen), 1.0) *
+                           std::max<double>(floor(clBox.LengthY() / fGridLen), 1.0) *
+                           std::max<double>(floor(clBox.LengthZ() / fGridLen), 1.0);
+        if (dCtGrids <= double(ulMaxGrids))
+            break;
+        fGridLen *= 1.1f * (float)sqrt(dCtGrids / double(ulMaxGrids));
     }
 
-    // Calculates the intersections
-    Base::SequencerLauncher seq("Checking for self-intersections...", ulGridX*ulGridY*ulGridZ);
-    for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
-        //Get the facet indices, belonging to the current grid unit
-        std::vector<unsigned long> aulGridElements;
-        clGridIter.GetElements(aulGridElements);
+    // collect the grid elements with at least two facets
+    std::vector<std::vector<unsigned long> > cells;
+    {
+        MeshFacetGrid* pGrid = (fGridLen > 0.0f ? new MeshFacetGrid(_rclMesh, fGridLen)
+                                                : new MeshFacetGrid(_rclMesh));
+        MeshGridIterator clGridIter(*pGrid);
+        unsigned long ulCtCells = 0;
+        for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
+            if (clGridIter.GetCtElements() > 1)
+                ulCtCells++;
+        }
+        cells.resize(ulCtCells);
+        std::vector<std::vector<unsigned long> >::iterator jt = cells.begin();
+        for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
+            if (clGridIter.GetCtElements() > 1)
+                clGridIter.GetElements(*jt++);
+        }
+        delete pGrid;
+    }
 
-        seq.next();
-        if (aulGridElements.size()==0)
-            continue;
+    // split the grid elements into ranges of about the same amount of work
+    int numThreads = std::max<int>(QThread::idealThreadCount(), 1);
+    double work = 0.0;
+    for (std::vector<std::vector<unsigned long> >::iterator it = cells.begin(); it != cells.end(); ++it)
+        work += double(it->size()) * double(it->size());
+    double workPerRange = work / double(64 * numThreads);
+
+    std::vector<MeshSelfIntersectionSearch::Range> ranges;
+    unsigned long begin = 0;
+    double rangeWork = 0.0;
+    for (unsigned long index = 0; index < cells.size(); index++) {
+        rangeWork += double(cells[index].size()) * double(cells[index].size());
+        if (rangeWork >= workPerRange || index + 1 == cells.size()) {
+            ranges.push_back(MeshSelfIntersectionSearch::Range(begin, index + 1));
+            begin = index + 1;
+            rangeWork = 0.0;
+        }
+    }
 
-        MeshGeomFacet facet1, facet2;
-        Base::Vector3f pt1, pt2;
-        for (std::vector<unsigned long>::iterator it = aulGridElements.begin(); it != aulGridElements.end(); ++it) {
-            const Base::BoundBox3f& box1 = boxes[*it];
-            cMFI.Set(*it);
-            facet1 = *cMFI;
-            const MeshFacet& rface1 = rFaces[*it];
-            for (std::vector<unsigned long>::iterator jt = it; jt != aulGridElements.end(); ++jt) {
-                if (jt == it) // the identical facet
-                    continue;
-                // If the facets share a common vertex we do not check for self-intersections because they 
-                // could but usually do not intersect each other and the algorithm below would detect false-positives,
-                // otherwise
-                const MeshFacet& rface2 = rFaces[*jt];
-                if (rface1._aulPoints[0] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[0] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[0] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[1] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[1] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[1] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[2] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[2] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[2] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-
-                const Base::BoundBox3f& box2 = boxes[*jt];
-                if (box1 && box2) {
-                    cMFI.Set(*jt);
-                    facet2 = *cMFI;
-                    int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                    if (ret == 2) {
-                        // abort after the first detected self-intersection
-                        return false;
-                    }
-                }
-            }
+    // Calculates the intersections. The ranges are handled in blocks in order to
+    // report the progress and to check for user abortion in this thread.
+    MeshSelfIntersectionSearch search(_rclMesh, boxes, cells, firstOnly);
+    Base::SequencerLauncher seq("Checking for self-intersections...", ranges.size());
+    std::size_t blockSize = 4 * numThreads;
+    for (std::size_t index = 0; index < ranges.size(); index += blockSize) {
+        std::vector<MeshSelfIntersectionSearch::Range>::iterator first = ranges.begin() + index;
+        std::vector<MeshSelfIntersectionSearch::Range>::iterator last = ranges.begin() +
+            std::min<std::size_t>(index + blockSize, ranges.size());
+        QtConcurrent::blockingMap(first, last, boost::bind(&MeshSelfIntersectionSearch::Check, &search, _1));
+        for (std::vector<MeshSelfIntersectionSearch::Range>::iterator it = first; it != last; ++it) {
+            intersection.insert(intersection.end(), it->result.begin(), it->result.end());
+            seq.next(canAbort);
         }
+        if (firstOnly && search.HasFound())
+            break;
     }
 
-    return true;
+    // a pair of facets is reported by each grid element they both are registered in
+    std::sort(intersection.begin(), intersection.end());
+    intersection.erase(std::unique(intersection.begin(), intersection.end()), intersection.end());
+}
+
+bool MeshEvalSelfIntersection::Evaluate ()
+{
+    // abort after the first detected self-intersection
+    std::vector<std::pair<unsigned long, unsigned long> > intersection;
+    FindIntersections(intersection, true, false);
+    return intersection.empty();
 }
 
 void MeshEvalSelfIntersection::GetIntersections(const std::vector<std::pair<unsigned long, unsigned long> >& indices,
@@ -686,73 +823,7 @@ void MeshEvalSelfIntersection::GetIntersections(const std::vector<std::pair<unsi
 
 void MeshEvalSelfIntersection::GetIntersections(std::vector<std::pair<unsigned long, unsigned long> >& intersection) const
 {
-    // Contains bounding boxes for every facet 
-    std::vector<Base::BoundBox3f> boxes;
-    //intersection.clear();
-
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(_rclMesh);
-    const MeshFacetArray& rFaces = _rclMesh.GetFacets();
-    MeshGridIterator clGridIter(cMeshFacetGrid);
-    unsigned long ulGridX, ulGridY, ulGridZ;
-    cMeshFacetGrid.GetCtGrids(ulGridX, ulGridY, ulGridZ);
-
-    MeshFacetIterator cMFI(_rclMesh);
-    for(cMFI.Begin(); cMFI.More(); cMFI.Next()) {
-        boxes.push_back((*cMFI).GetBoundBox());
-    }
-
-    // Calculates the intersections
-    Base::SequencerLauncher seq("Checking for self-intersections...", ulGridX*ulGridY*ulGridZ);
-    for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
-        //Get the facet indices, belonging to the current grid unit
-        std::vector<unsigned long> aulGridElements;
-        clGridIter.GetElements(aulGridElements);
-
-        seq.next(true);
-        if (aulGridElements.size()==0)
-            continue;
-
-        MeshGeomFacet facet1, facet2;
-        Base::Vector3f pt1, pt2;
-        for (std::vector<unsigned long>::iterator it = aulGridElements.begin(); it != aulGridElements.end(); ++it) {
-            const Base::BoundBox3f& box1 = boxes[*it];
-            cMFI.Set(*it);
-            facet1 = *cMFI;
-            const MeshFacet& rface1 = rFaces[*it];
-            for (std::vector<unsigned long>::iterator jt = it; jt != aulGridElements.end(); ++jt) {
-                if (jt == it) // the identical facet
-                    continue;
-                // If the facets share a common vertex we do not check for self-intersections because they 
-                // could but usually do not intersect each other and the algorithm below would detect false-positives,
-                // otherwise
-                const MeshFacet& rface2 = rFaces[*jt];
-                if (rface1._aulPoints[0] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[0] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[0] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[1] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[1] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[1] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[2] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[2] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[2] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-
-                const Base::BoundBox3f& box2 = boxes[*jt];
-                if (box1 && box2) {
-                    cMFI.Set(*jt);
-                    facet2 = *cMFI;
-                    int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                    if (ret == 2) {
-                        intersection.push_back(std::make_pair
-                            <unsigned long, unsigned long>(*it,*jt));
-                    }
-                }
-            }
-        }
-    }
+    FindIntersections(intersection, false, true);
 }
 
 bool MeshFixSelfIntersection::Fixup()
@@ -941,33 +1012,212 @@ bool MeshFixNeighbourhood::Fixup()
     _rclMesh.RebuildNeighbours();
     return true;
 }
-
-void MeshKernel::RebuildNeighbours (unsigned long index)
-{
-    std::vector<Edge_Index> edges;
-    edges.reserve(3 * (this->_aclFacetArray.size() - index));
 
-    // build up an array of edges
-    MeshFacetArray::_TConstIterator pI;
-    MeshFacetArray::_TConstIterator pB = this->_aclFacetArray.begin();
-    for (pI = pB + index; pI != this->_aclFacetArray.end(); pI++) {
-        for (int i = 0; i < 3; i++) {
-            Edge_Index item;
-            item.p0 = std::min<unsigned long>(pI->_aulPoints[i], pI->_aulPoints[(i+1)%3]);
-            item.p1 = std::max<unsigned long>(pI->_aulPoints[i], pI->_aulPoints[(i+1)%3]);
-            item.f  = pI - pB;
-            edges.push_back(item);
+// ----------------------------------------------------------------
+
+MeshDefectReport::MeshDefectReport() : nonUniformOrientation(false)
+{
+}
+
+void MeshDefectReport::Clear()
+{
+    *this = MeshDefectReport();
+}
+
+bool MeshDefectReport::IsEmpty() const
+{
+    return flippedFacets.empty() && !nonUniformOrientation &&
+           duplicatedFacets.empty() && duplicatedPoints.empty() &&
+           nonManifoldEdges.empty() && nonManifoldPoints.empty() &&
+           degeneratedFacets.empty() && invalidFacetIndices.empty() &&
+           invalidPointIndices.empty() && corruptedFacets.empty() &&
+           invalidNeighbours.empty() && selfIntersections.empty() &&
+           foldsOnSurface.empty() && foldsOnBoundary.empty() &&
+           foldOversOnSurface.empty();
+}
+
+void MeshDefectReport::Append(const MeshDefectReport& rclReport)
+{
+    flippedFacets.insert(flippedFacets.end(), rclReport.flippedFacets.begin(), rclReport.flippedFacets.end());
+    nonUniformOrientation = nonUniformOrientation || rclReport.nonUniformOrientation;
+    duplicatedFacets.insert(duplicatedFacets.end(), rclReport.duplicatedFacets.begin(), rclReport.duplicatedFacets.end());
+    duplicatedPoints.insert(duplicatedPoints.end(), rclReport.duplicatedPoints.begin(), rclReport.duplicatedPoints.end());
+    nonManifoldEdges.insert(nonManifoldEdges.end(), rclReport.nonManifoldEdges.begin(), rclReport.nonManifoldEdges.end());
+    nonManifoldPoints.insert(nonManifoldPoints.end(), rclReport.nonManifoldPoints.begin(), rclReport.nonManifoldPoints.end());
+    degeneratedFacets.insert(degeneratedFacets.end(), rclReport.degeneratedFacets.begin(), rclReport.degeneratedFacets.end());
+    invalidFacetIndices.insert(invalidFacetIndices.end(), rclReport.invalidFacetIndices.begin(), rclReport.invalidFacetIndices.end());
+    invalidPointIndices.insert(invalidPointIndices.end(), rclReport.invalidPointIndices.begin(), rclReport.invalidPointIndices.end());
+    corruptedFacets.insert(corruptedFacets.end(), rclReport.corruptedFacets.begin(), rclReport.corruptedFacets.end());
+    invalidNeighbours.insert(invalidNeighbours.end(), rclReport.invalidNeighbours.begin(), rclReport.invalidNeighbours.end());
+    selfIntersections.insert(selfIntersections.end(), rclReport.selfIntersections.begin(), rclReport.selfIntersections.end());
+    foldsOnSurface.insert(foldsOnSurface.end(), rclReport.foldsOnSurface.begin(), rclReport.foldsOnSurface.end());
+    foldsOnBoundary.insert(foldsOnBoundary.end(), rclReport.foldsOnBoundary.begin(), rclReport.foldsOnBoundary.end());
+    foldOversOnSurface.insert(foldOversOnSurface.end(), rclReport.foldOversOnSurface.begin(), rclReport.foldOversOnSurface.end());
+}
+
+// ----------------------------------------------------------------
+
+struct MeshEvalAll::Job
+{
+    enum Type {
+        Topology, Neighbourhood, CorruptedFacets, RangeFacets, RangePoints,
+        DuplicatedPoints, DuplicatedFacets, DegeneratedFacets,
+        PointManifolds, SelfIntersections,
+        FoldsOnSurface, FoldsOnBoundary, FoldOversOnSurface
+    };
+
+    Job(Type t) : type(t) {}
+
+    Type type;
+    MeshDefectReport result;
+};
+
+MeshEvalAll::MeshEvalAll (const MeshKernel &rclB) : MeshEvaluation(rclB)
+{
+}
+
+MeshEvalAll::~MeshEvalAll ()
+{
+}
+
+bool MeshEvalAll::Evaluate ()
+{
+    report.Clear();
+
+    // This is the top-level sequencer, thus the sequencers created by the
+    // single checks inside the worker threads are ignored
+    Base::SequencerLauncher seq("Checking mesh...", 3);
+
+    // The checks of the indices come first because the geometric checks
+    // would access invalid memory with broken indices
+    std::vector<Job> jobs;
+    jobs.push_back(Job(Job::Topology));
+    jobs.push_back(Job(Job::Neighbourhood));
+    jobs.push_back(Job(Job::CorruptedFacets));
+    jobs.push_back(Job(Job::RangeFacets));
+    jobs.push_back(Job(Job::RangePoints));
+    jobs.push_back(Job(Job::DuplicatedPoints));
+    jobs.push_back(Job(Job::DuplicatedFacets));
+    RunJobs(jobs);
+    seq.next();
+
+    jobs.clear();
+    if (report.invalidPointIndices.empty()) {
+        // The self-intersection check takes longest and is started first
+        jobs.push_back(Job(Job::SelfIntersections));
+        jobs.push_back(Job(Job::DegeneratedFacets));
+        jobs.push_back(Job(Job::PointManifolds));
+        if (report.invalidFacetIndices.empty()) {
+            jobs.push_back(Job(Job::FoldsOnSurface));
+            jobs.push_back(Job(Job::FoldsOnBoundary));
+            jobs.push_back(Job(Job::FoldOversOnSurface));
         }
     }
+    RunJobs(jobs);
+    seq.next();
+
+    // The orientation check uses the flags of the facets and therefore cannot
+    // run concurrently to the other checks
+    if (report.invalidPointIndices.empty() && report.invalidFacetIndices.empty()) {
+        MeshEvalOrientation eval(_rclMesh);
+        report.flippedFacets = eval.GetIndices();
+        if (report.flippedFacets.empty())
+            report.nonUniformOrientation = !eval.Evaluate();
+    }
+    seq.next();
 
-    // sort the edges
-    std::sort(edges.begin(), edges.end(), Edge_Less());
+    return report.IsEmpty();
+}
 
+void MeshEvalAll::RunJobs(std::vector<Job>& jobs)
+{
+    QtConcurrent::blockingMap(jobs, boost::bind(&MeshEvalAll::RunJob, this, _1));
+    for (std::vector<Job>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+        report.Append(it->result);
+}
+
+void MeshEvalAll::RunJob(Job& job) const
+{
+    // Each job runs one of the existing evaluation classes
+    switch (job.type) {
+    case Job::Topology:
+        {
+            MeshEvalTopology eval(_rclMesh);
+            eval.Evaluate();
+            job.result.nonManifoldEdges = eval.GetIndices();
+        }
+        break;
+    case Job::Neighbourhood:
+        job.result.invalidNeighbours = MeshEvalNeighbourhood(_rclMesh).GetIndices();
+        break;
+    case Job::CorruptedFacets:
+        job.result.corruptedFacets = MeshEvalCorruptedFacets(_rclMesh).GetIndices();
+        break;
+    case Job::RangeFacets:
+        job.result.invalidFacetIndices = MeshEvalRangeFacet(_rclMesh).GetIndices();
+        break;
+    case Job::RangePoints:
+        job.result.invalidPointIndices = MeshEvalRangePoint(_rclMesh).GetIndices();
+        break;
+    case Job::DuplicatedPoints:
+        job.result.duplicatedPoints = MeshEvalDuplicatePoints(_rclMesh).GetIndices();
+        break;
+    case Job::DuplicatedFacets:
+        job.result.duplicatedFacets = MeshEvalDuplicateFacets(_rclMesh).GetIndices();
+        break;
+    case Job::DegeneratedFacets:
+        job.result.degeneratedFacets = MeshEvalDegeneratedFacets(_rclMesh).GetIndices();
+        break;
+    case Job::PointManifolds:
+        {
+            MeshEvalPointManifolds eval(_rclMesh);
+            eval.Evaluate();
+            job.result.nonManifoldPoints = eval.GetIndices();
+        }
+        break;
+    case Job::SelfIntersections:
+        MeshEvalSelfIntersection(_rclMesh).GetIntersections(job.result.selfIntersections);
+        break;
+    case Job::FoldsOnSurface:
+        {
+            MeshEvalFoldsOnSurface eval(_rclMesh);
+            eval.Evaluate();
+            job.result.foldsOnSurface = eval.GetIndices();
+        }
+        break;
+    case Job::FoldsOnBoundary:
+        {
+            MeshEvalFoldsOnBoundary eval(_rclMesh);
+            eval.Evaluate();
+            job.result.foldsOnBoundary = eval.GetIndices();
+        }
+        break;
+    case Job::FoldOversOnSurface:
+        {
+            MeshEvalFoldOversOnSurface eval(_rclMesh);
+            eval.Evaluate();
+            job.result.foldOversOnSurface = eval.GetIndices();
+        }
+        break;
+    }
+}
+
+namespace MeshCore {
+
+/**
+ * Sets the neighbourhood of the facets sharing the edges in the given sorted range.
+ * Each edge in the range is handled exactly once so that several ranges of different
+ * edges can be processed at the same time.
+ */
+static void SetNeighbours(MeshFacetArray& facets,
+                          std::vector<Edge_Index>::const_iterator begin,
+                          std::vector<Edge_Index>::const_iterator end)
+{
     unsigned long p0 = ULONG_MAX, p1 = ULONG_MAX;
     unsigned long f0 = ULONG_MAX, f1 = ULONG_MAX;
     int count = 0;
-    std::vector<Edge_Index>::iterator pE;
-    for (pE = edges.begin(); pE != edges.end(); pE++) {
+    std::vector<Edge_Index>::const_iterator pE;
+    for (pE = begin; pE != end; pE++) {
         if (p0 == pE->p0 && p1 == pE->p1) {
             f1 = pE->f;
             count++;
@@ -976,15 +1226,15 @@ void MeshKernel::RebuildNeighbours (unsigned long index)
             // we handle only the cases for 1 and 2, for all higher
             // values we have a non-manifold that is ignorned here
             if (count == 2) {
-                MeshFacet& rFace0 = this->_aclFacetArray[f0];
-                MeshFacet& rFace1 = this->_aclFacetArray[f1];
+                MeshFacet& rFace0 = facets[f0];
+                MeshFacet& rFace1 = facets[f1];
                 unsigned short side0 = rFace0.Side(p0,p1);
                 unsigned short side1 = rFace1.Side(p0,p1);
                 rFace0._aulNeighbours[side0] = f1;
                 rFace1._aulNeighbours[side1] = f0;
             }
             else if (count == 1) {
-                MeshFacet& rFace = this->_aclFacetArray[f0];
+                MeshFacet& rFace = facets[f0];
                 unsigned short side = rFace.Side(p0,p1);
                 rFace._aulNeighbours[side] = ULONG_MAX;
             }
@@ -999,18 +1249,181 @@ void MeshKernel::RebuildNeighbours (unsigned long index)
     // we handle only the cases for 1 and 2, for all higher
     // values we have a non-manifold that is ignorned here
     if (count == 2) {
-        MeshFacet& rFace0 = this->_aclFacetArray[f0];
-        MeshFacet& rFace1 = this->_aclFacetArray[f1];
+        MeshFacet& rFace0 = facets[f0];
+        MeshFacet& rFace1 = facets[f1];
         unsigned short side0 = rFace0.Side(p0,p1);
         unsigned short side1 = rFace1.Side(p0,p1);
         rFace0._aulNeighbours[side0] = f1;
         rFace1._aulNeighbours[side1] = f0;
     }
     else if (count == 1) {
-        MeshFacet& rFace = this->_aclFacetArray[f0];
+        MeshFacet& rFace = facets[f0];
         unsigned short side = rFace.Side(p0,p1);
         rFace._aulNeighbours[side] = ULONG_MAX;
     }
+}
+
+/**
+ * The MeshNeighbourBuilder class sets the neighbourhood of big meshes in parallel.
+ * The edges are distributed over several partitions by the hash of their end points,
+ * so that equal edges always end up in the same partition. Each partition is sorted
+ * and evaluated by its own thread. To limit the temporary memory only a part of the
+ * partitions is handled at a time.
+ */
+class MeshNeighbourBuilder
+{
+public:
+    struct Chunk
+    {
+        unsigned long begin, end;
+        std::vector<unsigned long> counts;
+        std::vector<unsigned long> offsets;
+    };
+    struct Partition
+    {
+        unsigned long begin, end;
+    };
+
+    MeshNeighbourBuilder(MeshFacetArray& facets, unsigned long index)
+      : _facets(facets), _index(index), _numPartitions(1)
+      , _firstPartition(0), _lastPartition(0)
+    {
+    }
+
+    void Run()
+    {
+        unsigned long count = _facets.size() - _index;
+        unsigned long numPasses = (3 * count) / MESH_MAX_SORT_SIZE + 1;
+        int numThreads = std::max<int>(QThread::idealThreadCount(), 1);
+        _numPartitions = 16 * numThreads * numPasses;
+        unsigned long numChunks = 4 * numThreads;
+        unsigned long chunkSize = count / numChunks + 1;
+
+        std::vector<Chunk> chunks;
+        for (unsigned long begin = _index; begin < _facets.size(); begin += chunkSize) {
+            Chunk chunk;
+            chunk.begin = begin;
+            chunk.end = std::min<unsigned long>(begin + chunkSize, _facets.size());
+            chunks.push_back(chunk);
+        }
+        QtConcurrent::blockingMap(chunks, boost::bind(&MeshNeighbourBuilder::Count, this, _1));
+        for (std::vector<Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+            it->offsets.resize(_numPartitions);
+
+        // handle as many partitions at a time as fit into the sort buffer
+        _lastPartition = 0;
+        while (_lastPartition < _numPartitions) {
+            _firstPartition = _lastPartition;
+            std::vector<Partition> parts;
+            unsigned long offset = 0;
+            while (_lastPartition < _numPartitions) {
+                unsigned long size = 0;
+                for (std::vector<Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+                    size += it->counts[_lastPartition];
+                if (offset > 0 && offset + size > MESH_MAX_SORT_SIZE)
+                    break;
+
+                // convert the counts into offsets of the partition in the sort buffer
+                Partition part;
+                part.begin = offset;
+                for (std::vector<Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+                    it->offsets[_lastPartition] = offset;
+                    offset += it->counts[_lastPartition];
+                }
+                part.end = offset;
+                parts.push_back(part);
+                _lastPartition++;
+            }
+
+            _edges.resize(offset);
+            QtConcurrent::blockingMap(chunks, boost::bind(&MeshNeighbourBuilder::Scatter, this, _1));
+            QtConcurrent::blockingMap(parts, boost::bind(&MeshNeighbourBuilder::Merge, this, _1));
+        }
+    }
+
+private:
+    Edge_Index GetEdge(unsigned long facet, int side) const
+    {
+        const MeshFacet& rFace = _facets[facet];
+        Edge_Index item;
+        item.p0 = std::min<unsigned long>(rFace._aulPoints[side], rFace._aulPoints[(side+1)%3]);
+        item.p1 = std::max<unsigned long>(rFace._aulPoints[side], rFace._aulPoints[(side+1)%3]);
+        item.f  = facet;
+        return item;
+    }
+    unsigned long GetPartition(const Edge_Index& edge) const
+    {
+        std::size_t seed = 0;
+        boost::hash_combine(seed, edge.p0);
+        boost::hash_combine(seed, edge.p1);
+        return seed % _numPartitions;
+    }
+    void Count(Chunk& chunk) const
+    {
+        chunk.counts.resize(_numPartitions, 0);
+        for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+            for (int j = 0; j < 3; j++)
+                chunk.counts[GetPartition(GetEdge(i, j))]++;
+        }
+    }
+    void Scatter(Chunk& chunk)
+    {
+        // only the edges of the currently handled partitions are taken
+        for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+            for (int j = 0; j < 3; j++) {
+                Edge_Index item = GetEdge(i, j);
+                unsigned long part = GetPartition(item);
+                if (part >= _firstPartition && part < _lastPartition)
+                    _edges[chunk.offsets[part]++] = item;
+            }
+        }
+    }
+    void Merge(Partition& part)
+    {
+        std::vector<Edge_Index>::iterator first = _edges.begin() + part.begin;
+        std::vector<Edge_Index>::iterator last = _edges.begin() + part.end;
+        std::sort(first, last, Edge_Less());
+        SetNeighbours(_facets, first, last);
+    }
+
+private:
+    MeshFacetArray& _facets;
+    unsigned long _index;
+    unsigned long _numPartitions;
+    unsigned long _firstPartition, _lastPartition;
+    std::vector<Edge_Index> _edges;
+};
+
+}
+
+void MeshKernel::RebuildNeighbours (unsigned long index)
+{
+    // for big meshes the edges are sorted by several threads
+    if (this->_aclFacetArray.size() - index > MESH_PARALLEL_NEIGHBOURS) {
+        MeshNeighbourBuilder builder(this->_aclFacetArray, index);
+        builder.Run();
+        return;
+    }
+
+    std::vector<Edge_Index> edges;
+    edges.reserve(3 * (this->_aclFacetArray.size() - index));
+
+    // build up an array of edges
+    MeshFacetArray::_TConstIterator pI;
+    MeshFacetArray::_TConstIterator pB = this->_aclFacetArray.begin();
+    for (pI = pB + index; pI != this->_aclFacetArray.end(); pI++) {
+        for (int i = 0; i < 3; i++) {
+            Edge_Index item;
+            item.p0 = std::min<unsigned long>(pI->_aulPoints[i], pI->_aulPoints[(i+1)%3]);
+            item.p1 = std::max<unsigned long>(pI->_aulPoints[i], pI->_aulPoints[(i+1)%3]);
+            item.f  = pI - pB;
+            edges.push_back(item);
+        }
+    }
+
+    // sort the edges
+    std::sort(edges.begin(), edges.end(), Edge_Less());
+    SetNeighbours(this->_aclFacetArray, edges.begin(), edges.end());
 }
 
 void MeshKernel::RebuildNeighbours (void)
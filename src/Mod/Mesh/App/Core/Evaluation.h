@@ -297,6 +297,10 @@ public:
         std::vector<std::pair<Base::Vector3f, Base::Vector3f> >&) const;
     /// collect the index of all facets with self intersections
     void GetIntersections(std::vector<std::pair<unsigned long, unsigned long> >&) const;
+
+private:
+    void FindIntersections(std::vector<std::pair<unsigned long, unsigned long> >&,
+                           bool firstOnly, bool canAbort) const;
 };
 
 /**
@@ -345,6 +349,78 @@ public:
 
 // ----------------------------------------------------
 
+/**
+ * The MeshDefectReport structure collects the results of MeshEvalAll. Each list
+ * contains the same indices as the corresponding single evaluation class does.
+ */
+struct MeshExport MeshDefectReport
+{
+    MeshDefectReport();
+    /// Removes all entries
+    void Clear();
+    /// Returns true if no defects were found
+    bool IsEmpty() const;
+    /// Appends the entries of \a rclReport
+    void Append(const MeshDefectReport& rclReport);
+
+    /// facets with wrong orientation, see MeshEvalOrientation
+    std::vector<unsigned long> flippedFacets;
+    /// true if the facets are not uniformly oriented but no flipped facets could be determined
+    bool nonUniformOrientation;
+    /// see MeshEvalDuplicateFacets
+    std::vector<unsigned long> duplicatedFacets;
+    /// see MeshEvalDuplicatePoints
+    std::vector<unsigned long> duplicatedPoints;
+    /// point indices of the non-manifold edges, see MeshEvalTopology
+    std::vector<std::pair<unsigned long, unsigned long> > nonManifoldEdges;
+    /// see MeshEvalPointManifolds
+    std::vector<unsigned long> nonManifoldPoints;
+    /// see MeshEvalDegeneratedFacets
+    std::vector<unsigned long> degeneratedFacets;
+    /// facets with out of range neighbour indices, see MeshEvalRangeFacet
+    std::vector<unsigned long> invalidFacetIndices;
+    /// facets with out of range point indices, see MeshEvalRangePoint
+    std::vector<unsigned long> invalidPointIndices;
+    /// see MeshEvalCorruptedFacets
+    std::vector<unsigned long> corruptedFacets;
+    /// see MeshEvalNeighbourhood
+    std::vector<unsigned long> invalidNeighbours;
+    /// pairs of intersecting facets, see MeshEvalSelfIntersection
+    std::vector<std::pair<unsigned long, unsigned long> > selfIntersections;
+    /// see MeshEvalFoldsOnSurface
+    std::vector<unsigned long> foldsOnSurface;
+    /// see MeshEvalFoldsOnBoundary
+    std::vector<unsigned long> foldsOnBoundary;
+    /// see MeshEvalFoldOversOnSurface
+    std::vector<unsigned long> foldOversOnSurface;
+};
+
+/**
+ * The MeshEvalAll class runs all read-only checks of the other evaluation classes
+ * at once. The checks run concurrently to each other, the geometric checks only
+ * if the index checks haven't found invalid indices.
+ */
+class MeshExport MeshEvalAll : public MeshEvaluation
+{
+public:
+    MeshEvalAll (const MeshKernel &rclB);
+    ~MeshEvalAll ();
+    /// Runs all checks and returns true if no defects were found
+    bool Evaluate ();
+    /// Returns the result of the last call of Evaluate()
+    const MeshDefectReport& GetReport() const { return report; }
+
+private:
+    struct Job;
+    void RunJobs(std::vector<Job>&);
+    void RunJob(Job&) const;
+
+private:
+    MeshDefectReport report;
+};
+
+// ----------------------------------------------------
+
 /**
  * The MeshEigensystem class actually does not try to check for or fix errors but
  * it provides methods to calculate the mesh's local coordinate system with the center
@@ -25,8 +25,13 @@
 
 #ifndef _PreComp_
 # include <algorithm>
+# include <numeric>
 #endif
 
+#include <QThread>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
 #include "Grid.h"
 #include "Iterator.h"
 
@@ -63,6 +68,7 @@ void MeshGrid::Attach (const MeshKernel &rclM)
 void MeshGrid::Clear (void)
 {
   _aulGrid.clear();
+  _aulGridOffsets.clear();
   _pclMesh = NULL;  
 }
 
@@ -93,8 +99,6 @@ void MeshGrid::InitGrid (void)
 {
   assert(_pclMesh != NULL);
 
-  unsigned long i, j;
-
   // Grid Laengen berechnen wenn nicht initialisiert
   //
   if ((_ulCtGridsX == 0) || (_ulCtGridsX == 0) || (_ulCtGridsX == 0))
@@ -129,12 +133,69 @@ void MeshGrid::InitGrid (void)
 
   // Daten-Struktur anlegen
   _aulGrid.clear();
-  _aulGrid.resize(_ulCtGridsX);
-  for (i = 0; i < _ulCtGridsX; i++)
+  _aulGridOffsets.clear();
+  _aulGridOffsets.resize(_ulCtGridsX * _ulCtGridsY * _ulCtGridsZ + 1, 0);
+}
+
+namespace MeshCore {
+struct MeshGrid::GridChunk
+{
+  unsigned long begin, end;
+  std::vector<std::pair<unsigned long, unsigned long> > entries; // grid and element index
+};
+}
+
+void MeshGrid::FillChunk (GridChunk &rclChunk) const
+{
+  std::vector<unsigned long> aulGrids;
+  for (unsigned long i = rclChunk.begin; i < rclChunk.end; i++)
+  {
+    aulGrids.clear();
+    FindGrids(i, aulGrids);
+    for (std::vector<unsigned long>::iterator it = aulGrids.begin(); it != aulGrids.end(); ++it)
+      rclChunk.entries.push_back(std::make_pair(*it, i));
+  }
+}
+
+void MeshGrid::FillGrid (void)
+{
+  // small meshes are not worth to be split
+  unsigned long ulCtElements = HasElements();
+  unsigned long ulCtChunks = 1;
+  if (ulCtElements > 10000)
+    ulCtChunks = 4 * std::max<int>(QThread::idealThreadCount(), 1);
+  unsigned long ulChunkSize = ulCtElements / ulCtChunks + 1;
+
+  std::vector<GridChunk> aclChunks;
+  for (unsigned long ulBegin = 0; ulBegin < ulCtElements; ulBegin += ulChunkSize)
+  {
+    GridChunk clChunk;
+    clChunk.begin = ulBegin;
+    clChunk.end = std::min<unsigned long>(ulBegin + ulChunkSize, ulCtElements);
+    aclChunks.push_back(clChunk);
+  }
+
+  QtConcurrent::blockingMap(aclChunks, boost::bind(&MeshGrid::FillChunk, this, _1));
+
+  // counting sort by grid index, as the chunks are in order of the elements
+  // the indices of each grid element are sorted, too
+  std::vector<GridChunk>::iterator jt;
+  std::vector<std::pair<unsigned long, unsigned long> >::iterator kt;
+  std::fill(_aulGridOffsets.begin(), _aulGridOffsets.end(), 0);
+  for (jt = aclChunks.begin(); jt != aclChunks.end(); ++jt)
+  {
+    for (kt = jt->entries.begin(); kt != jt->entries.end(); ++kt)
+      _aulGridOffsets[kt->first + 1]++;
+  }
+  std::partial_sum(_aulGridOffsets.begin(), _aulGridOffsets.end(), _aulGridOffsets.begin());
+
+  std::vector<unsigned long> aulPos(_aulGridOffsets.begin(), _aulGridOffsets.end() - 1);
+  _aulGrid.resize(_aulGridOffsets.back());
+  for (jt = aclChunks.begin(); jt != aclChunks.end(); ++jt)
   {
-    _aulGrid[i].resize(_ulCtGridsY);
-    for (j = 0; j < _ulCtGridsY; j++)
-      _aulGrid[i][j].resize(_ulCtGridsZ);
+    for (kt = jt->entries.begin(); kt != jt->entries.end(); ++kt)
+      _aulGrid[aulPos[kt->first]++] = kt->second;
+    std::vector<std::pair<unsigned long, unsigned long> >().swap(jt->entries);
   }
 }
 
@@ -155,7 +216,7 @@ unsigned long MeshGrid::Inside (const Base::BoundBox3f &rclBB, std::vector<unsig
     {
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
-        raulElements.insert(raulElements.end(), _aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+        raulElements.insert(raulElements.end(), GridBegin(i, j, k), GridEnd(i, j, k));
       }
     }
   }  
@@ -190,7 +251,7 @@ unsigned long MeshGrid::Inside (const Base::BoundBox3f &rclBB, std::vector<unsig
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
         if (Base::DistanceP2(GetBoundBox(i, j, k).CalcCenter(), rclOrg) < fMinDistP2)
-          raulElements.insert(raulElements.end(), _aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+          raulElements.insert(raulElements.end(), GridBegin(i, j, k), GridEnd(i, j, k));
       }
     }
   }  
@@ -221,7 +282,7 @@ unsigned long MeshGrid::Inside (const Base::BoundBox3f &rclBB, std::set<unsigned
     {
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
-        raulElements.insert(_aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+        raulElements.insert(GridBegin(i, j, k), GridEnd(i, j, k));
       }
     }
   }  
@@ -450,7 +511,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsY; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+              raclInd.insert(GridBegin(nX, i, j), GridEnd(nX, i, j));
           }
           nX++;
         }
@@ -464,7 +525,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsY; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+              raclInd.insert(GridBegin(nX, i, j), GridEnd(nX, i, j));
           }
           nX++;
         }
@@ -478,7 +539,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+              raclInd.insert(GridBegin(i, nY, j), GridEnd(i, nY, j));
           }
           nY++;
         }
@@ -492,7 +553,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+              raclInd.insert(GridBegin(i, nY, j), GridEnd(i, nY, j));
           }
           nY--;
         }
@@ -506,7 +567,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsY; j++)
-              raclInd.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+              raclInd.insert(GridBegin(i, j, nZ), GridEnd(i, j, nZ));
           }
           nZ++;
         }
@@ -520,7 +581,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsY; j++)
-              raclInd.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+              raclInd.insert(GridBegin(i, j, nZ), GridEnd(i, j, nZ));
           }
           nZ--;
         }
@@ -586,11 +647,11 @@ void MeshGrid::GetHull (unsigned long ulX, unsigned long ulY, unsigned long ulZ,
 unsigned long MeshGrid::GetElements (unsigned long ulX, unsigned long ulY, unsigned long ulZ,  
                                      std::set<unsigned long> &raclInd) const
 {
-  const std::set<unsigned long> &rclSet = _aulGrid[ulX][ulY][ulZ];
-  if (rclSet.size() > 0)
+  unsigned long ulCount = GetCtElements(ulX, ulY, ulZ);
+  if (ulCount > 0)
   {
-    raclInd.insert(rclSet.begin(), rclSet.end());
-    return rclSet.size();
+    raclInd.insert(GridBegin(ulX, ulY, ulZ), GridEnd(ulX, ulY, ulZ));
+    return ulCount;
   }
 
   return 0;
@@ -602,9 +663,9 @@ unsigned long MeshGrid::GetElements(const Base::Vector3f &rclPoint, std::vector<
   if (!CheckPosition(rclPoint, ulX, ulY, ulZ))
     return 0;
 
-  aulFacets.resize(_aulGrid[ulX][ulY][ulZ].size());
+  aulFacets.resize(GetCtElements(ulX, ulY, ulZ));
 
-  std::copy(_aulGrid[ulX][ulY][ulZ].begin(), _aulGrid[ulX][ulY][ulZ].end(), aulFacets.begin());
+  std::copy(GridBegin(ulX, ulY, ulZ), GridEnd(ulX, ulY, ulZ), aulFacets.begin());
   return aulFacets.size();
 }
 
@@ -709,15 +770,41 @@ void MeshFacetGrid::RebuildGrid (void)
   InitGrid();
  
   // Daten-Struktur fuellen
-  MeshFacetIterator clFIter(*_pclMesh);
+  FillGrid();
+}
+
+void MeshFacetGrid::FindGrids (unsigned long ulIndex, std::vector<unsigned long> &raulGrids) const
+{
+  unsigned long ulX, ulY, ulZ;
+  unsigned long ulX1, ulY1, ulZ1, ulX2, ulY2, ulZ2;
+
+  MeshGeomFacet clFacet = _pclMesh->GetFacet(ulIndex);
+  Base::BoundBox3f clBB;
 
-  unsigned long i = 0;
-  for (clFIter.Init(); clFIter.More(); clFIter.Next())
+  clBB &= clFacet._aclPoints[0];
+  clBB &= clFacet._aclPoints[1];
+  clBB &= clFacet._aclPoints[2];
+
+  Pos(Base::Vector3f(clBB.MinX,clBB.MinY,clBB.MinZ), ulX1, ulY1, ulZ1);
+  Pos(Base::Vector3f(clBB.MaxX,clBB.MaxY,clBB.MaxZ), ulX2, ulY2, ulZ2);
+
+  // falls Facet ueber mehrere BB reicht
+  if ((ulX1 < ulX2) || (ulY1 < ulY2) || (ulZ1 < ulZ2))
   {
-//    AddFacet(*clFIter, i++, 2.0f);
-    AddFacet(*clFIter, i++);
+    for (ulX = ulX1; ulX <= ulX2; ulX++)
+    {
+      for (ulY = ulY1; ulY <= ulY2; ulY++)
+      {
+        for (ulZ = ulZ1; ulZ <= ulZ2; ulZ++)
+        {
+          if ( clFacet.IntersectBoundingBox( GetBoundBox(ulX, ulY, ulZ) ) )
+            raulGrids.push_back(GetIndexToPosition(ulX, ulY, ulZ));
+        }
+      }
+    }
   }
-
+  else
+    raulGrids.push_back(GetIndexToPosition(ulX1, ulY1, ulZ1));
 }
 
 unsigned long MeshFacetGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt) const
@@ -918,8 +1005,8 @@ void MeshFacetGrid::SearchNearestFacetInGrid(unsigned long ulX, unsigned long ul
                                              const Base::Vector3f &rclPt, float &rfMinDist,
                                              unsigned long &rulFacetInd) const
 {
-  const std::set<unsigned long> &rclSet = _aulGrid[ulX][ulY][ulZ];
-  for (std::set<unsigned long>::const_iterator pI = rclSet.begin(); pI != rclSet.end(); pI++)
+  std::vector<unsigned long>::const_iterator pE = GridEnd(ulX, ulY, ulZ);
+  for (std::vector<unsigned long>::const_iterator pI = GridBegin(ulX, ulY, ulZ); pI != pE; pI++)
   {
     float fDist = _pclMesh->GetFacet(*pI).DistanceToPoint(rclPt);
     if (fDist < rfMinDist)
@@ -964,12 +1051,12 @@ MeshPointGrid::MeshPointGrid (const MeshKernel &rclM, float fGridLen)
           std::max<unsigned long>((unsigned long)(clBBMesh.LengthZ() / fGridLen), 1));
 }
 
-void MeshPointGrid::AddPoint (const MeshPoint &rclPt, unsigned long ulPtIndex, float fEpsilon)
+void MeshPointGrid::FindGrids (unsigned long ulIndex, std::vector<unsigned long> &raulGrids) const
 {
   unsigned long ulX, ulY, ulZ;
-  Pos(Base::Vector3f(rclPt.x, rclPt.y, rclPt.z), ulX, ulY, ulZ);
+  Pos(_pclMesh->GetPoint(ulIndex), ulX, ulY, ulZ);
   if ( (ulX < _ulCtGridsX) && (ulY < _ulCtGridsY) && (ulZ < _ulCtGridsZ) )
-    _aulGrid[ulX][ulY][ulZ].insert(ulPtIndex);
+    raulGrids.push_back(GetIndexToPosition(ulX, ulY, ulZ));
 }
 
 void MeshPointGrid::Validate (const MeshKernel &rclMesh)
@@ -1020,14 +1107,7 @@ void MeshPointGrid::RebuildGrid (void)
   InitGrid();
  
   // Daten-Struktur fuellen
-
-  MeshPointIterator cPIter(*_pclMesh);
-
-  unsigned long i = 0;
-  for (cPIter.Init(); cPIter.More(); cPIter.Next())
-  {
-    AddPoint(*cPIter, i++);
-  }
+  FillGrid();
 }
 
 void MeshPointGrid::Pos (const Base::Vector3f &rclPoint, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ) const
@@ -1089,7 +1169,7 @@ bool MeshGridIterator::InitOnRay (const Base::Vector3f &rclPt, const Base::Vecto
   if ((_rclGrid.GetBoundBox().IsInBox(rclPt)) == true)
   {  // Voxel bestimmen, indem der Startpunkt liegt
     _rclGrid.Position(rclPt, _ulX, _ulY, _ulZ);
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+    raulElements.insert(raulElements.end(), _rclGrid.GridBegin(_ulX, _ulY, _ulZ), _rclGrid.GridEnd(_ulX, _ulY, _ulZ));
     _bValidRay = true;
   }
   else
@@ -1102,7 +1182,7 @@ bool MeshGridIterator::InitOnRay (const Base::Vector3f &rclPt, const Base::Vecto
       else
         _rclGrid.Position(cP1, _ulX, _ulY, _ulZ);
 
-      raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+      raulElements.insert(raulElements.end(), _rclGrid.GridBegin(_ulX, _ulY, _ulZ), _rclGrid.GridEnd(_ulX, _ulY, _ulZ));
       _bValidRay = true;
     }
   }
@@ -1153,7 +1233,7 @@ bool MeshGridIterator::NextOnRay (std::vector<unsigned long> &raulElements)
   if ((_bValidRay == true) && (_rclGrid.CheckPos(_ulX, _ulY, _ulZ) == true))
   {
     GridElement pos(_ulX, _ulY, _ulZ); _cSearchPositions.insert(pos);
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end()); 
+    raulElements.insert(raulElements.end(), _rclGrid.GridBegin(_ulX, _ulY, _ulZ), _rclGrid.GridEnd(_ulX, _ulY, _ulZ)); 
   }
   else
     _bValidRay = false;  // Strahl ausgetreten
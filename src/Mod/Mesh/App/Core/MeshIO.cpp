@@ -43,6 +43,12 @@
 #include <iomanip>
 #include <boost/regex.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/bind.hpp>
+
+#include <QAtomicInt>
+#include <QFile>
+#include <QThread>
+#include <QtConcurrentMap>
 
 
 using namespace MeshCore;
@@ -299,6 +305,238 @@ Convert_Camera_Model(Vector *pos, Vector *at, Vector *up, Vector *res_axis,
 
 // --------------------------------------------------------------
 
+namespace MeshCore {
+
+/**
+ * Splits the index range [0, count) into smaller ranges which are handled by
+ * \a func in parallel. The progress is reported and user abortion is checked
+ * in the calling thread after each block of ranges.
+ */
+template <class Function>
+static void mapRanges(unsigned long count, const char* text, Function func)
+{
+    typedef std::pair<unsigned long, unsigned long> Range;
+    int numThreads = std::max<int>(QThread::idealThreadCount(), 1);
+    unsigned long size = std::max<unsigned long>(count / (64 * numThreads), 10000);
+    std::vector<Range> ranges;
+    for (unsigned long begin = 0; begin < count; begin += size)
+        ranges.push_back(Range(begin, std::min<unsigned long>(begin + size, count)));
+
+    Base::SequencerLauncher seq(text, ranges.size());
+    std::size_t blockSize = 4 * numThreads;
+    for (std::size_t index = 0; index < ranges.size(); index += blockSize) {
+        std::vector<Range>::iterator first = ranges.begin() + index;
+        std::vector<Range>::iterator last = ranges.begin() +
+            std::min<std::size_t>(index + blockSize, ranges.size());
+        QtConcurrent::blockingMap(first, last, func);
+        for (std::vector<Range>::iterator it = first; it != last; ++it)
+            seq.next(true); // allow to cancel
+    }
+}
+
+/**
+ * Decodes the facet records of a binary STL file. Different ranges of
+ * records can be decoded by several threads at the same time.
+ */
+class MeshBinarySTLDecoder
+{
+public:
+    MeshBinarySTLDecoder(const char* pData, MeshFastBuilder& rBuilder)
+      : data(pData), builder(rBuilder)
+    {
+    }
+    void Decode(std::pair<unsigned long, unsigned long>& range) const
+    {
+        Base::Vector3f clVects[4];
+        for (unsigned long i = range.first; i < range.second; i++) {
+            // read normal, points and overread 2 bytes attribute
+            memcpy(clVects, data + 50 * i, sizeof(clVects));
+            std::swap(clVects[0], clVects[3]);
+            builder.SetFacet(i, clVects);
+        }
+    }
+
+private:
+    const char* data;
+    MeshFastBuilder& builder;
+};
+
+/**
+ * Decodes the vertex and face elements of a binary PLY file. Different
+ * ranges of elements can be decoded by several threads at the same time.
+ */
+class MeshBinaryPLYDecoder
+{
+public:
+    enum Type {
+        Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64, Invalid
+    };
+    struct Property {
+        std::string name;
+        Type type;
+        Type countType;
+        bool list;
+    };
+    struct Element {
+        std::string name;
+        std::size_t count;
+        std::vector<Property> properties;
+    };
+
+    static Type GetType(const std::string& name)
+    {
+        if (name == "char" || name == "int8")
+            return Int8;
+        if (name == "uchar" || name == "uint8")
+            return UInt8;
+        if (name == "short" || name == "int16")
+            return Int16;
+        if (name == "ushort" || name == "uint16")
+            return UInt16;
+        if (name == "int" || name == "int32")
+            return Int32;
+        if (name == "uint" || name == "uint32")
+            return UInt32;
+        if (name == "float" || name == "float32")
+            return Float32;
+        if (name == "double" || name == "float64")
+            return Float64;
+        return Invalid;
+    }
+    static std::size_t GetSize(Type type)
+    {
+        static const std::size_t size[] = {1, 1, 2, 2, 4, 4, 4, 8, 0};
+        return size[type];
+    }
+
+    MeshBinaryPLYDecoder()
+      : swap(false), vertexData(0), vertexStride(0), xyzType(Invalid), rgbType(Invalid)
+      , faceData(0), countType(Invalid), indexType(Invalid)
+      , points(0), facets(0), colors(0), polygons(0)
+    {
+        xyz[0] = xyz[1] = xyz[2] = 0;
+        rgb[0] = rgb[1] = rgb[2] = 0;
+    }
+    double GetValue(const char* data, Type type) const
+    {
+        char buf[8];
+        std::size_t size = GetSize(type);
+        if (swap) {
+            for (std::size_t i = 0; i < size; i++)
+                buf[i] = data[size - 1 - i];
+        }
+        else {
+            memcpy(buf, data, size);
+        }
+
+        switch (type) {
+        case Int8:    { int8_t   v; memcpy(&v, buf, size); return v; }
+        case UInt8:   { uint8_t  v; memcpy(&v, buf, size); return v; }
+        case Int16:   { int16_t  v; memcpy(&v, buf, size); return v; }
+        case UInt16:  { uint16_t v; memcpy(&v, buf, size); return v; }
+        case Int32:   { int32_t  v; memcpy(&v, buf, size); return v; }
+        case UInt32:  { uint32_t v; memcpy(&v, buf, size); return v; }
+        case Float32: { float    v; memcpy(&v, buf, size); return v; }
+        case Float64: { double   v; memcpy(&v, buf, size); return v; }
+        default:
+            return 0.0;
+        }
+    }
+    void DecodeVertices(std::pair<unsigned long, unsigned long>& range) const
+    {
+        for (unsigned long i = range.first; i < range.second; i++) {
+            const char* data = vertexData + i * vertexStride;
+            MeshPoint& pt = (*points)[i];
+            pt.x = (float)GetValue(data + xyz[0], xyzType);
+            pt.y = (float)GetValue(data + xyz[1], xyzType);
+            pt.z = (float)GetValue(data + xyz[2], xyzType);
+            if (colors) {
+                float scale = (rgbType == Float32 || rgbType == Float64) ? 1.0f : 1.0f/255.0f;
+                float r = (float)GetValue(data + rgb[0], rgbType) * scale;
+                float g = (float)GetValue(data + rgb[1], rgbType) * scale;
+                float b = (float)GetValue(data + rgb[2], rgbType) * scale;
+                (*colors)[i] = App::Color(r, g, b);
+            }
+        }
+    }
+    void DecodeFaces(std::pair<unsigned long, unsigned long>& range) const
+    {
+        std::size_t countSize = GetSize(countType);
+        std::size_t indexSize = GetSize(indexType);
+        std::size_t stride = countSize + 3 * indexSize;
+        for (unsigned long i = range.first; i < range.second; i++) {
+            const char* data = faceData + i * stride;
+            if (GetValue(data, countType) != 3.0) {
+                // the faces don't have a fixed size
+                polygons.fetchAndStoreRelaxed(1);
+                return;
+            }
+            SetFace(i, data + countSize, indexSize);
+        }
+    }
+    /** Decodes the faces one after another if there are also polygons. Only the
+     * triangles are taken. Returns the number of triangles.
+     */
+    unsigned long DecodePolygons(unsigned long count, const char* end) const
+    {
+        std::size_t countSize = GetSize(countType);
+        std::size_t indexSize = GetSize(indexType);
+        const char* data = faceData;
+        unsigned long index = 0;
+        for (unsigned long i = 0; i < count; i++) {
+            if (data + countSize > end)
+                break;
+            unsigned long n = (unsigned long)GetValue(data, countType);
+            data += countSize;
+            if (data + n * indexSize > end)
+                break;
+            if (n == 3)
+                SetFace(index++, data, indexSize);
+            data += n * indexSize;
+        }
+        return index;
+    }
+    bool HasPolygons() const
+    {
+        return int(polygons) != 0;
+    }
+
+private:
+    void SetFace(unsigned long index, const char* data, std::size_t indexSize) const
+    {
+        MeshFacet& face = (*facets)[index];
+        for (int j = 0; j < 3; j++) {
+            double v = GetValue(data + j * indexSize, indexType);
+            // a face with invalid point indices is removed afterwards
+            if (v < 0.0 || v >= double(points->size())) {
+                face = MeshFacet();
+                return;
+            }
+            face._aulPoints[j] = (unsigned long)v;
+        }
+    }
+
+public:
+    bool swap;
+    const char* vertexData;
+    std::size_t vertexStride;
+    std::size_t xyz[3];
+    Type xyzType;
+    std::size_t rgb[3];
+    Type rgbType;
+    const char* faceData;
+    Type countType;
+    Type indexType;
+    MeshPointArray* points;
+    MeshFacetArray* facets;
+    std::vector<App::Color>* colors;
+
+private:
+    mutable QAtomicInt polygons;
+};
+
+} // namespace MeshCore
+
 bool MeshInput::LoadAny(const char* FileName)
 {
     // ask for read permission
@@ -308,6 +546,37 @@ bool MeshInput::LoadAny(const char* FileName)
     if (!fi.isReadable())
         throw Base::FileException("No permission on the file",FileName);
 
+    // binary STL and PLY files are read from a memory-mapped file which is much
+    // faster for big files, all other files are read from the stream
+    if (fi.hasExtension("stl") || fi.hasExtension("ply")) {
+        QFile file(QString::fromUtf8(fi.filePath().c_str()));
+        if (file.open(QIODevice::ReadOnly) && file.size() > 0) {
+            uchar* data = file.map(0, file.size());
+            if (data) {
+                bool ok = false;
+                try {
+                    const char* pData = reinterpret_cast<const char*>(data);
+                    if (fi.hasExtension("stl"))
+                        ok = LoadBinarySTL(pData, (std::size_t)file.size());
+                    else
+                        ok = LoadBinaryPLY(pData, (std::size_t)file.size());
+                }
+                catch (const Base::AbortException&) {
+                    _rclMesh.Clear();
+                    return false;
+                }
+                catch (...) {
+                    _rclMesh.Clear();
+                    throw;
+                }
+
+                file.unmap(data);
+                if (ok)
+                    return true;
+            }
+        }
+    }
+
     Base::ifstream str(fi, std::ios::in | std::ios::binary);
 
     if (fi.hasExtension("bms")) {
@@ -878,6 +1147,163 @@ bool MeshInput::LoadPLY (std::istream &inp)
     return true;
 }
 
+bool MeshInput::LoadBinaryPLY (const char* pData, std::size_t ulSize)
+{
+    // the header is plain text and ends with the 'end_header' line
+    std::string header(pData, std::min<std::size_t>(ulSize, 65536));
+    std::string::size_type pos = header.find("end_header");
+    if (header.compare(0, 3, "ply") != 0 || pos == std::string::npos)
+        return false;
+    pos = header.find('\n', pos);
+    if (pos == std::string::npos)
+        return false;
+    header.resize(pos + 1);
+
+    typedef MeshBinaryPLYDecoder::Property Property;
+    typedef MeshBinaryPLYDecoder::Element Element;
+    std::vector<Element> elements;
+    bool littleEndian = true;
+
+    std::istringstream str(header);
+    std::string line;
+    std::getline(str, line); // ply
+    while (std::getline(str, line)) {
+        std::istringstream tokens(line);
+        std::string kw;
+        tokens >> kw;
+        if (kw == "format") {
+            std::string format, version;
+            tokens >> format >> version;
+            if (format == "binary_little_endian")
+                littleEndian = true;
+            else if (format == "binary_big_endian")
+                littleEndian = false;
+            else
+                return false; // ASCII format is handled by LoadPLY()
+            if (version != "1.0")
+                return false;
+        }
+        else if (kw == "element") {
+            Element element;
+            tokens >> element.name >> element.count;
+            if (!tokens || (element.name != "vertex" && element.name != "face"))
+                return false;
+            elements.push_back(element);
+        }
+        else if (kw == "property") {
+            if (elements.empty())
+                return false;
+            Property prop;
+            std::string type;
+            tokens >> type;
+            prop.list = (type == "list");
+            prop.countType = MeshBinaryPLYDecoder::Invalid;
+            if (prop.list) {
+                std::string countType;
+                tokens >> countType >> type;
+                prop.countType = MeshBinaryPLYDecoder::GetType(countType);
+                if (prop.countType == MeshBinaryPLYDecoder::Invalid)
+                    return false;
+            }
+            tokens >> prop.name;
+            prop.type = MeshBinaryPLYDecoder::GetType(type);
+            if (!tokens || prop.type == MeshBinaryPLYDecoder::Invalid)
+                return false;
+            elements.back().properties.push_back(prop);
+        }
+    }
+
+    // only files with vertices followed by triangles are supported
+    if (elements.size() != 2 || elements[0].name != "vertex" || elements[1].name != "face")
+        return false;
+
+    MeshBinaryPLYDecoder decoder;
+    unsigned short endian = 1;
+    bool hostLittleEndian = (*reinterpret_cast<unsigned char*>(&endian) == 1);
+    decoder.swap = (littleEndian != hostLittleEndian);
+
+    const std::vector<Property>& vertexProps = elements[0].properties;
+    int ctXYZ = 0, ctRGB = 0;
+    for (std::vector<Property>::const_iterator it = vertexProps.begin(); it != vertexProps.end(); ++it) {
+        if (it->list)
+            return false;
+        int xyz = (it->name == "x" ? 0 : it->name == "y" ? 1 : it->name == "z" ? 2 : -1);
+        int rgb = (it->name == "red" ? 0 : it->name == "green" ? 1 : it->name == "blue" ? 2 : -1);
+        if (xyz >= 0) {
+            if (ctXYZ > 0 && decoder.xyzType != it->type)
+                return false;
+            decoder.xyz[xyz] = decoder.vertexStride;
+            decoder.xyzType = it->type;
+            ctXYZ++;
+        }
+        else if (rgb >= 0) {
+            if (ctRGB > 0 && decoder.rgbType != it->type)
+                return false;
+            decoder.rgb[rgb] = decoder.vertexStride;
+            decoder.rgbType = it->type;
+            ctRGB++;
+        }
+        decoder.vertexStride += MeshBinaryPLYDecoder::GetSize(it->type);
+    }
+    if (ctXYZ != 3)
+        return false;
+
+    const std::vector<Property>& faceProps = elements[1].properties;
+    if (faceProps.size() != 1 || !faceProps[0].list ||
+        faceProps[0].type == MeshBinaryPLYDecoder::Float32 ||
+        faceProps[0].type == MeshBinaryPLYDecoder::Float64)
+        return false;
+    decoder.countType = faceProps[0].countType;
+    decoder.indexType = faceProps[0].type;
+
+    std::size_t v_count = elements[0].count;
+    std::size_t f_count = elements[1].count;
+    const char* pEnd = pData + ulSize;
+    decoder.vertexData = pData + header.size();
+    decoder.faceData = decoder.vertexData + v_count * decoder.vertexStride;
+    if (decoder.faceData > pEnd)
+        return false;
+
+    MeshPointArray meshPoints(v_count);
+    MeshFacetArray meshFacets(f_count);
+    decoder.points = &meshPoints;
+    decoder.facets = &meshFacets;
+    if (_material && ctRGB == 3) {
+        _material->binding = MeshIO::PER_VERTEX;
+        _material->diffuseColor.resize(v_count);
+        decoder.colors = &_material->diffuseColor;
+    }
+
+    mapRanges(v_count, "Reading vertices...", boost::bind(&MeshBinaryPLYDecoder::DecodeVertices, &decoder, _1));
+
+    // as long as there are only triangles the faces can be decoded in parallel
+    std::size_t faceSize = MeshBinaryPLYDecoder::GetSize(decoder.countType) +
+                           3 * MeshBinaryPLYDecoder::GetSize(decoder.indexType);
+    if (decoder.faceData + f_count * faceSize <= pEnd) {
+        mapRanges(f_count, "Reading faces...", boost::bind(&MeshBinaryPLYDecoder::DecodeFaces, &decoder, _1));
+    }
+    if (decoder.faceData + f_count * faceSize > pEnd || decoder.HasPolygons()) {
+        meshFacets.resize(decoder.DecodePolygons(f_count, pEnd));
+    }
+
+    // remove the faces with invalid point indices
+    MeshFacetArray::_TIterator jt = meshFacets.begin();
+    for (MeshFacetArray::_TIterator it = meshFacets.begin(); it != meshFacets.end(); ++it) {
+        if (it->_aulPoints[0] != ULONG_MAX)
+            *jt++ = *it;
+    }
+    meshFacets.erase(jt, meshFacets.end());
+
+    this->_rclMesh.Clear(); // remove all data before
+    // Don't use Assign() because Merge() checks which points are really needed.
+    // This method sets already the correct neighbourhood
+    MeshKernel tmp;
+    tmp.Adopt(meshPoints,meshFacets);
+    this->_rclMesh.Merge(tmp);
+
+    return true;
+}
+
 bool MeshInput::LoadMeshNode (std::istream &rstrIn)
 {
     boost::regex rx_p("^v\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
@@ -1057,6 +1483,41 @@ bool MeshInput::LoadBinarySTL (std::istream &rstrIn)
     return true;
 }
 
+/** Loads a binary STL file from a memory block. */
+bool MeshInput::LoadBinarySTL (const char* pData, std::size_t ulSize)
+{
+    // header info and number of facets
+    if (ulSize < 80 + sizeof(uint32_t))
+        return false;
+    uint32_t ulCt;
+    memcpy(&ulCt, pData + 80, sizeof(ulCt));
+
+    // compare with the number of facets calculated from the size
+    std::size_t ulFac = (ulSize - (80 + sizeof(uint32_t))) / 50;
+    if (ulCt > ulFac)
+        return false;// not a valid STL file
+
+    // check for the keywords of an ASCII STL file as done in LoadSTL()
+    char szBuf[200];
+    std::size_t ulBytes = std::min<std::size_t>(ulCt > 1 ? 100 : 50, ulSize - (80 + sizeof(uint32_t)));
+    memcpy(szBuf, pData + 80 + sizeof(uint32_t), ulBytes);
+    szBuf[ulBytes] = 0;
+    upper(szBuf);
+    if ((strstr(szBuf, "SOLID") != NULL)  || (strstr(szBuf, "FACET") != NULL)    || (strstr(szBuf, "NORMAL") != NULL) ||
+        (strstr(szBuf, "VERTEX") != NULL) || (strstr(szBuf, "ENDFACET") != NULL) || (strstr(szBuf, "ENDLOOP") != NULL))
+        return false;
+
+    MeshFastBuilder builder(this->_rclMesh);
+    builder.Initialize(ulCt);
+
+    MeshBinarySTLDecoder decoder(pData + 80 + sizeof(uint32_t), builder);
+    mapRanges(ulCt, "Reading facets...", boost::bind(&MeshBinarySTLDecoder::Decode, &decoder, _1));
+
+    builder.Finish();
+
+    return true;
+}
+
 /** Loads the mesh object from an XML file. */
 void MeshInput::LoadXML (Base::XMLReader &reader)
 {
@@ -1392,6 +1853,11 @@ void MeshOutput::SetSTLHeaderData(const std::string& header)
     }
 }
 
+const std::string& MeshOutput::GetSTLHeaderData()
+{
+    return stl_header;
+}
+
 void MeshOutput::Transform(const Base::Matrix4D& mat)
 {
     _transform = mat;
@@ -91,12 +91,22 @@ public:
     bool LoadAsciiSTL (std::istream &rstrIn);
     /** Loads a binary STL file. */
     bool LoadBinarySTL (std::istream &rstrIn);
+    /** Loads a binary STL file from a memory block, e.g. a memory-mapped file.
+     * The facets are decoded in parallel. False is returned if the block doesn't
+     * contain a binary STL file.
+     */
+    bool LoadBinarySTL (const char* pData, std::size_t ulSize);
     /** Loads an OBJ Mesh file. */
     bool LoadOBJ (std::istream &rstrIn);
     /** Loads an OFF Mesh file. */
     bool LoadOFF (std::istream &rstrIn);
     /** Loads a PLY Mesh file. */
     bool LoadPLY (std::istream &rstrIn);
+    /** Loads a binary PLY file from a memory block, e.g. a memory-mapped file.
+     * The elements are decoded in parallel. False is returned if the block doesn't
+     * contain a binary PLY file with only vertices and faces of scalar properties.
+     */
+    bool LoadBinaryPLY (const char* pData, std::size_t ulSize);
     /** Loads the mesh object from an XML file. */
     void LoadXML (Base::XMLReader &reader);
     /** Loads a node from an OpenInventor file. */
@@ -132,6 +142,8 @@ public:
      * automatically filled up with spaces.
      */
     static void SetSTLHeaderData(const std::string&);
+    /// Returns the 80 characters of the header of a binary STL
+    static const std::string& GetSTLHeaderData();
     /// Saves the file, decided by extension if not explicitly given
     bool SaveAny(const char* FileName, MeshIO::Format f=MeshIO::Undefined) const;
 
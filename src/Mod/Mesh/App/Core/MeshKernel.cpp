@@ -385,6 +385,47 @@ void MeshKernel::Merge(const MeshPointArray& rPoints, const MeshFacetArray& rFac
     RebuildNeighbours(countFacets);
 }
 
+void MeshKernel::Merge(const MeshPointArray& rPoints, const MeshFacetArray& rFaces, float fTolerance)
+{
+    Merge(rPoints, rFaces);
+
+    std::vector<unsigned long> rep;
+    std::vector<Base::Vector3f> points(this->_aclPointArray.begin(), this->_aclPointArray.end());
+    MeshPointWelder(points, fTolerance).Run(rep);
+    std::vector<Base::Vector3f>().swap(points);
+
+    // the representative of a point never has a higher index
+    unsigned long countPoints = 0;
+    std::vector<unsigned long> index(rep.size());
+    for (unsigned long i = 0; i < rep.size(); i++) {
+        if (rep[i] == i) {
+            index[i] = countPoints;
+            this->_aclPointArray[countPoints++] = this->_aclPointArray[i];
+        }
+        else {
+            index[i] = index[rep[i]];
+        }
+    }
+
+    if (countPoints == this->_aclPointArray.size())
+        return; // no points merged
+    this->_aclPointArray.resize(countPoints);
+
+    // adjust the point indices and remove the degenerated facets
+    MeshFacetArray::_TIterator pO = this->_aclFacetArray.begin();
+    for (MeshFacetArray::_TIterator pF = this->_aclFacetArray.begin();
+        pF != this->_aclFacetArray.end(); ++pF) {
+        for (int i=0; i<3; i++) {
+            pF->_aulPoints[i] = index[pF->_aulPoints[i]];
+        }
+        if (!pF->IsDegenerated())
+            *pO++ = *pF;
+    }
+    this->_aclFacetArray.erase(pO, this->_aclFacetArray.end());
+
+    RebuildNeighbours();
+}
+
 void MeshKernel::Clear (void)
 {
     _aclPointArray.clear();
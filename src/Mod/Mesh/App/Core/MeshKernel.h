@@ -312,6 +312,13 @@ public:
      * mesh but only these points which are referenced by facets of \a rFaces.
      */
     void Merge(const MeshPointArray& rPoints, const MeshFacetArray& rFaces);
+    /**
+     * Does the same as the above method but afterwards all points of the mesh whose
+     * distance is lower than \a fTolerance along each axis are merged. Facets that
+     * get degenerated by this are removed.
+     * @note The point indices of the underlying mesh may change when points get merged.
+     */
+    void Merge(const MeshPointArray& rPoints, const MeshFacetArray& rFaces, float fTolerance);
     /** Deletes the facet the iterator points to. The deletion of a facet requires
      * the following steps:
      * \li Mark the neighbour index of all neighbour facets to the deleted facet as invalid
@@ -0,0 +1,683 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <map>
+# include <cmath>
+# include <cstring>
+# include <iostream>
+#endif
+
+#include <QFile>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
+#include "OutOfCore.h"
+#include "Builder.h"
+#include "Definitions.h"
+#include "MeshKernel.h"
+
+#include <Base/Console.h>
+#include <Base/Sequencer.h>
+
+using namespace MeshCore;
+
+// number of facets that are mapped into memory at a time
+#define MESH_OUT_OF_CORE_WINDOW (1ul << 22)
+// size of a facet record of a binary STL file
+#define STL_FACET_SIZE 50
+// size of the header of a binary STL file
+#define STL_HEADER_SIZE 84
+
+namespace MeshCore {
+
+struct MeshOutOfCore::Chunk
+{
+    const char* data;
+    unsigned long begin, end;
+    Base::BoundBox3f box;
+    std::vector<unsigned long> facets;
+    std::vector<unsigned long> tiles;
+};
+
+/**
+ * Facets with a coordinate that is NaN, infinite or out of the range of FLOAT_MAX are
+ * ignored by the bounding box, the tiles and the simplification. Otherwise they would
+ * make the bounding box infinite and the conversion of their position into a grid
+ * index undefined.
+ */
+static bool IsValidFacet(const MeshGeomFacet& rclFacet)
+{
+    for (int i = 0; i < 3; i++) {
+        const Base::Vector3f& p = rclFacet._aclPoints[i];
+        // NaN fails this test, too
+        if (!(fabs(p.x) <= FLOAT_MAX && fabs(p.y) <= FLOAT_MAX && fabs(p.z) <= FLOAT_MAX))
+            return false;
+    }
+    return true;
+}
+
+} // namespace MeshCore
+
+MeshOutOfCore::MeshOutOfCore()
+  : _file(0), _ulCtFacets(0)
+  , _ulCtTilesX(0), _ulCtTilesY(0), _ulCtTilesZ(0), _fTileLength(0.0f)
+{
+}
+
+MeshOutOfCore::~MeshOutOfCore()
+{
+    Close();
+}
+
+bool MeshOutOfCore::Open(const char* FileName)
+{
+    Close();
+
+    _file = new QFile(QString::fromUtf8(FileName));
+    if (!_file->open(QIODevice::ReadOnly)) {
+        Base::Console().Error("Cannot open file '%s'\n", FileName);
+        Close();
+        return false;
+    }
+
+    // header info and number of facets
+    qint64 ulSize = _file->size();
+    char szHeader[STL_HEADER_SIZE];
+    if (ulSize < STL_HEADER_SIZE || _file->read(szHeader, STL_HEADER_SIZE) != STL_HEADER_SIZE) {
+        Close();
+        return false;
+    }
+
+    uint32_t ulCt;
+    memcpy(&ulCt, szHeader + 80, sizeof(ulCt));
+    if (ulCt > (ulSize - STL_HEADER_SIZE) / STL_FACET_SIZE) {
+        Base::Console().Error("File '%s' is not a binary STL file\n", FileName);
+        Close();
+        return false;
+    }
+
+    _ulCtFacets = ulCt;
+
+    std::vector<Chunk> chunks;
+    try {
+        if (!ForEachWindow(boost::bind(&MeshOutOfCore::BoundBoxChunk, this, _1), chunks)) {
+            Close();
+            return false;
+        }
+    }
+    catch (const Base::AbortException&) {
+        Close();
+        return false;
+    }
+
+    for (std::vector<Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+        _clBoundBox.Add(it->box);
+
+    return true;
+}
+
+void MeshOutOfCore::Close()
+{
+    delete _file;
+    _file = 0;
+    _ulCtFacets = 0;
+    _clBoundBox = Base::BoundBox3f();
+    ClearTiles();
+}
+
+void MeshOutOfCore::ClearTiles()
+{
+    _ulCtTilesX = _ulCtTilesY = _ulCtTilesZ = 0;
+    _tileOffsets.clear();
+    _tileFacets.clear();
+}
+
+bool MeshOutOfCore::IsOpen() const
+{
+    return _file != 0;
+}
+
+const char* MeshOutOfCore::MapFacets(unsigned long ulFirst, unsigned long ulLast) const
+{
+    qint64 offset = STL_HEADER_SIZE + (qint64)STL_FACET_SIZE * ulFirst;
+    qint64 size = (qint64)STL_FACET_SIZE * (ulLast - ulFirst);
+    const char* data = reinterpret_cast<const char*>(_file->map(offset, size));
+    if (!data)
+        Base::Console().Error("Cannot map facets %lu to %lu into memory\n", ulFirst, ulLast);
+    return data;
+}
+
+void MeshOutOfCore::UnmapFacets(const char* data) const
+{
+    _file->unmap(reinterpret_cast<uchar*>(const_cast<char*>(data)));
+}
+
+void MeshOutOfCore::GetFacet(const char* data, MeshGeomFacet& rclFacet)
+{
+    // read normal, points and overread 2 bytes attribute
+    Base::Vector3f clVects[4];
+    memcpy(clVects, data, sizeof(clVects));
+    rclFacet._aclPoints[0] = clVects[1];
+    rclFacet._aclPoints[1] = clVects[2];
+    rclFacet._aclPoints[2] = clVects[3];
+    rclFacet.NormalInvalid();
+    rclFacet.SetNormal(clVects[0]);
+}
+
+/**
+ * Maps the file window by window and calls \a func for the chunks of each window by
+ * several threads at the same time. If \a chunks is empty the chunks are created,
+ * otherwise the chunks of a previous call are processed again.
+ */
+template <class Function>
+bool MeshOutOfCore::ForEachWindow(Function func, std::vector<Chunk>& chunks) const
+{
+    bool create = chunks.empty();
+    int numThreads = std::max<int>(QThread::idealThreadCount(), 1);
+    unsigned long ulCtWindows = (_ulCtFacets + MESH_OUT_OF_CORE_WINDOW - 1) / MESH_OUT_OF_CORE_WINDOW;
+    Base::SequencerLauncher seq("Processing facets...", ulCtWindows);
+
+    std::size_t index = 0;
+    for (unsigned long ulFirst = 0; ulFirst < _ulCtFacets; ulFirst += MESH_OUT_OF_CORE_WINDOW) {
+        unsigned long ulLast = std::min<unsigned long>(ulFirst + MESH_OUT_OF_CORE_WINDOW, _ulCtFacets);
+        const char* data = MapFacets(ulFirst, ulLast);
+        if (!data)
+            return false;
+
+        if (create) {
+            unsigned long ulChunkSize = (ulLast - ulFirst) / (4 * numThreads) + 1;
+            for (unsigned long ulBegin = ulFirst; ulBegin < ulLast; ulBegin += ulChunkSize) {
+                Chunk chunk;
+                chunk.begin = ulBegin;
+                chunk.end = std::min<unsigned long>(ulBegin + ulChunkSize, ulLast);
+                chunks.push_back(chunk);
+            }
+        }
+
+        std::vector<Chunk>::iterator first = chunks.begin() + index;
+        std::vector<Chunk>::iterator last = first;
+        for (; last != chunks.end() && last->begin < ulLast; ++last)
+            last->data = data + STL_FACET_SIZE * (last->begin - ulFirst);
+
+        QtConcurrent::blockingMap(first, last, func);
+        UnmapFacets(data);
+
+        index = last - chunks.begin();
+        seq.next(true); // allow to cancel
+    }
+
+    return true;
+}
+
+void MeshOutOfCore::GetFacets(unsigned long ulFirst, unsigned long ulLast, std::vector<MeshGeomFacet>& rclFacets) const
+{
+    ulLast = std::min<unsigned long>(ulLast, _ulCtFacets);
+    if (ulFirst >= ulLast)
+        return;
+
+    const char* data = MapFacets(ulFirst, ulLast);
+    if (!data)
+        return;
+
+    std::size_t ulPos = rclFacets.size();
+    rclFacets.resize(ulPos + (ulLast - ulFirst));
+    for (unsigned long i = ulFirst; i < ulLast; i++)
+        GetFacet(data + STL_FACET_SIZE * (i - ulFirst), rclFacets[ulPos++]);
+    UnmapFacets(data);
+}
+
+void MeshOutOfCore::BoundBoxChunk(Chunk& chunk) const
+{
+    MeshGeomFacet facet;
+    for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+        GetFacet(chunk.data + STL_FACET_SIZE * (i - chunk.begin), facet);
+        if (!IsValidFacet(facet))
+            continue;
+        chunk.box.Add(facet._aclPoints[0]);
+        chunk.box.Add(facet._aclPoints[1]);
+        chunk.box.Add(facet._aclPoints[2]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void MeshOutOfCore::BuildTiles(unsigned long ulMaxFacets)
+{
+    ClearTiles();
+    // the box is invalid if no facet has valid coordinates
+    if (_ulCtFacets == 0 || !_clBoundBox.IsValid())
+        return;
+
+    // shrink the tiles until there are enough of them, this also works for flat scans.
+    // The loop ends because the box is finite, see IsValidFacet().
+    unsigned long ulCtTiles = _ulCtFacets / std::max<unsigned long>(ulMaxFacets, 1) + 1;
+    float fMaxLength = std::max<float>(_clBoundBox.LengthX(), std::max<float>(_clBoundBox.LengthY(), _clBoundBox.LengthZ()));
+    _fTileLength = std::max<float>(fMaxLength, FLOAT_EPS);
+    if (fMaxLength <= 0.0f)
+        ulCtTiles = 1; // all points are equal
+    for (;;) {
+        _ulCtTilesX = (unsigned long)(_clBoundBox.LengthX() / _fTileLength) + 1;
+        _ulCtTilesY = (unsigned long)(_clBoundBox.LengthY() / _fTileLength) + 1;
+        _ulCtTilesZ = (unsigned long)(_clBoundBox.LengthZ() / _fTileLength) + 1;
+        if (_ulCtTilesX * _ulCtTilesY * _ulCtTilesZ >= ulCtTiles)
+            break;
+        _fTileLength *= 0.9f;
+    }
+
+    try {
+        FillTiles();
+    }
+    catch (const Base::AbortException&) {
+        ClearTiles();
+    }
+}
+
+void MeshOutOfCore::FillTiles()
+{
+    unsigned long ulCtTiles = CountTiles();
+
+    // first pass: each chunk counts its facets per tile
+    std::vector<Chunk> chunks;
+    if (!ForEachWindow(boost::bind(&MeshOutOfCore::CountTileChunk, this, _1), chunks)) {
+        ClearTiles();
+        return;
+    }
+
+    // turn the counts into the position where each chunk writes its facets of a tile,
+    // so the facets of a tile keep the order of the file
+    _tileOffsets.resize(ulCtTiles + 1);
+    unsigned long ulPos = 0;
+    for (unsigned long i = 0; i < ulCtTiles; i++) {
+        _tileOffsets[i] = ulPos;
+        for (std::vector<Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+            unsigned long ulCount = it->tiles[i];
+            it->tiles[i] = ulPos;
+            ulPos += ulCount;
+        }
+    }
+    _tileOffsets[ulCtTiles] = ulPos;
+
+    // second pass: write the facet indices
+    _tileFacets.resize(ulPos);
+    if (!ForEachWindow(boost::bind(&MeshOutOfCore::FillTileChunk, this, _1), chunks))
+        ClearTiles();
+}
+
+unsigned long MeshOutOfCore::GetTile(const MeshGeomFacet& rclFacet) const
+{
+    Base::Vector3f clCenter = rclFacet.GetGravityPoint();
+    unsigned long ulX = (unsigned long)std::max<float>((clCenter.x - _clBoundBox.MinX) / _fTileLength, 0.0f);
+    unsigned long ulY = (unsigned long)std::max<float>((clCenter.y - _clBoundBox.MinY) / _fTileLength, 0.0f);
+    unsigned long ulZ = (unsigned long)std::max<float>((clCenter.z - _clBoundBox.MinZ) / _fTileLength, 0.0f);
+    ulX = std::min<unsigned long>(ulX, _ulCtTilesX - 1);
+    ulY = std::min<unsigned long>(ulY, _ulCtTilesY - 1);
+    ulZ = std::min<unsigned long>(ulZ, _ulCtTilesZ - 1);
+    return (ulZ * _ulCtTilesY + ulY) * _ulCtTilesX + ulX;
+}
+
+void MeshOutOfCore::CountTileChunk(Chunk& chunk) const
+{
+    chunk.tiles.resize(CountTiles());
+    MeshGeomFacet facet;
+    for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+        GetFacet(chunk.data + STL_FACET_SIZE * (i - chunk.begin), facet);
+        if (IsValidFacet(facet))
+            chunk.tiles[GetTile(facet)]++;
+    }
+}
+
+void MeshOutOfCore::FillTileChunk(Chunk& chunk)
+{
+    MeshGeomFacet facet;
+    for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+        GetFacet(chunk.data + STL_FACET_SIZE * (i - chunk.begin), facet);
+        if (IsValidFacet(facet))
+            _tileFacets[chunk.tiles[GetTile(facet)]++] = i;
+    }
+}
+
+unsigned long MeshOutOfCore::CountTiles() const
+{
+    return _ulCtTilesX * _ulCtTilesY * _ulCtTilesZ;
+}
+
+unsigned long MeshOutOfCore::CountTileFacets(unsigned long ulTile) const
+{
+    if (ulTile + 1 >= _tileOffsets.size())
+        return 0;
+    return _tileOffsets[ulTile + 1] - _tileOffsets[ulTile];
+}
+
+Base::BoundBox3f MeshOutOfCore::GetTileBoundBox(unsigned long ulTile) const
+{
+    unsigned long ulX = ulTile % _ulCtTilesX;
+    unsigned long ulY = (ulTile / _ulCtTilesX) % _ulCtTilesY;
+    unsigned long ulZ = ulTile / (_ulCtTilesX * _ulCtTilesY);
+    float fMinX = _clBoundBox.MinX + ulX * _fTileLength;
+    float fMinY = _clBoundBox.MinY + ulY * _fTileLength;
+    float fMinZ = _clBoundBox.MinZ + ulZ * _fTileLength;
+    return Base::BoundBox3f(fMinX, fMinY, fMinZ, fMinX + _fTileLength, fMinY + _fTileLength, fMinZ + _fTileLength);
+}
+
+void MeshOutOfCore::LoadTile(unsigned long ulTile, MeshKernel& rclMesh) const
+{
+    unsigned long ulCtFacets = CountTileFacets(ulTile);
+    MeshFastBuilder builder(rclMesh);
+    builder.Initialize(ulCtFacets);
+    if (ulCtFacets == 0)
+        return;
+
+    // the indices of a tile are sorted, so only the windows with facets of the tile are mapped
+    std::vector<unsigned long>::const_iterator it = _tileFacets.begin() + _tileOffsets[ulTile];
+    std::vector<unsigned long>::const_iterator end = it + ulCtFacets;
+    unsigned long ulPos = 0;
+    Base::Vector3f clVects[4];
+    while (it != end) {
+        unsigned long ulFirst = (*it / MESH_OUT_OF_CORE_WINDOW) * MESH_OUT_OF_CORE_WINDOW;
+        unsigned long ulLast = std::min<unsigned long>(ulFirst + MESH_OUT_OF_CORE_WINDOW, _ulCtFacets);
+        const char* data = MapFacets(ulFirst, ulLast);
+        if (!data) {
+            rclMesh.Clear();
+            return;
+        }
+
+        for (; it != end && *it < ulLast; ++it) {
+            memcpy(clVects, data + STL_FACET_SIZE * (*it - ulFirst), sizeof(clVects));
+            std::swap(clVects[0], clVects[3]);
+            builder.SetFacet(ulPos++, clVects);
+        }
+
+        UnmapFacets(data);
+    }
+
+    builder.Finish();
+}
+
+// ----------------------------------------------------------------------------
+
+void MeshOutOfCore::GetDegeneratedFacets(std::vector<unsigned long>& raulFacets) const
+{
+    std::vector<Chunk> chunks;
+    ForEachWindow(boost::bind(&MeshOutOfCore::DegeneratedChunk, this, _1), chunks);
+    for (std::vector<Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+        raulFacets.insert(raulFacets.end(), it->facets.begin(), it->facets.end());
+}
+
+void MeshOutOfCore::DegeneratedChunk(Chunk& chunk) const
+{
+    MeshGeomFacet facet;
+    for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+        GetFacet(chunk.data + STL_FACET_SIZE * (i - chunk.begin), facet);
+        if (facet.IsDegenerated())
+            chunk.facets.push_back(i);
+    }
+}
+
+void MeshOutOfCore::GetInvalidFacets(std::vector<unsigned long>& raulFacets) const
+{
+    std::vector<Chunk> chunks;
+    ForEachWindow(boost::bind(&MeshOutOfCore::InvalidChunk, this, _1), chunks);
+    for (std::vector<Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+        raulFacets.insert(raulFacets.end(), it->facets.begin(), it->facets.end());
+}
+
+void MeshOutOfCore::InvalidChunk(Chunk& chunk) const
+{
+    MeshGeomFacet facet;
+    for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+        GetFacet(chunk.data + STL_FACET_SIZE * (i - chunk.begin), facet);
+        if (!IsValidFacet(facet))
+            chunk.facets.push_back(i);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool MeshOutOfCore::SaveBinarySTL(std::ostream &rstrOut) const
+{
+    if (!rstrOut || rstrOut.bad() == true || !IsOpen())
+        return false;
+
+    // the file is copied unchanged
+    const char* header = reinterpret_cast<const char*>(_file->map(0, STL_HEADER_SIZE));
+    if (!header)
+        return false;
+    rstrOut.write(header, STL_HEADER_SIZE);
+    UnmapFacets(header);
+
+    Base::SequencerLauncher seq("saving...", _ulCtFacets / MESH_OUT_OF_CORE_WINDOW + 1);
+    for (unsigned long ulFirst = 0; ulFirst < _ulCtFacets; ulFirst += MESH_OUT_OF_CORE_WINDOW) {
+        unsigned long ulLast = std::min<unsigned long>(ulFirst + MESH_OUT_OF_CORE_WINDOW, _ulCtFacets);
+        const char* data = MapFacets(ulFirst, ulLast);
+        if (!data)
+            return false;
+        rstrOut.write(data, STL_FACET_SIZE * (ulLast - ulFirst));
+        UnmapFacets(data);
+        seq.next(true); // allow to cancel
+    }
+
+    return rstrOut.good();
+}
+
+bool MeshOutOfCore::SaveAsciiSTL(std::ostream &rstrOut) const
+{
+    if (!rstrOut || rstrOut.bad() == true || !IsOpen())
+        return false;
+
+    rstrOut.precision(6);
+    rstrOut.setf(std::ios::fixed | std::ios::showpoint);
+    Base::SequencerLauncher seq("saving...", _ulCtFacets / MESH_OUT_OF_CORE_WINDOW + 1);
+
+    rstrOut << "solid Mesh" << std::endl;
+
+    MeshGeomFacet facet;
+    for (unsigned long ulFirst = 0; ulFirst < _ulCtFacets; ulFirst += MESH_OUT_OF_CORE_WINDOW) {
+        unsigned long ulLast = std::min<unsigned long>(ulFirst + MESH_OUT_OF_CORE_WINDOW, _ulCtFacets);
+        const char* data = MapFacets(ulFirst, ulLast);
+        if (!data)
+            return false;
+
+        for (unsigned long i = ulFirst; i < ulLast; i++) {
+            GetFacet(data + STL_FACET_SIZE * (i - ulFirst), facet);
+            // normal
+            Base::Vector3f clNormal = facet.GetNormal();
+            rstrOut << "  facet normal " << clNormal.x << " "
+                                         << clNormal.y << " "
+                                         << clNormal.z << std::endl;
+            rstrOut << "    outer loop" << std::endl;
+
+            // vertices
+            for (int j = 0; j < 3; j++) {
+                rstrOut << "      vertex "  << facet._aclPoints[j].x << " "
+                                            << facet._aclPoints[j].y << " "
+                                            << facet._aclPoints[j].z << std::endl;
+            }
+
+            rstrOut << "    endloop" << std::endl;
+            rstrOut << "  endfacet" << std::endl;
+        }
+
+        UnmapFacets(data);
+        seq.next(true); // allow to cancel
+    }
+
+    rstrOut << "endsolid Mesh" << std::endl;
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+namespace MeshCore {
+
+/**
+ * The MeshVertexClustering class merges all points of a facet soup that lie in
+ * the same cell of a regular grid. Only the occupied cells and the remaining
+ * facets are kept in memory.
+ */
+class MeshVertexClustering
+{
+public:
+    MeshVertexClustering(const Base::BoundBox3f& box, float fCellSize)
+      : _clOrigin(box.MinX, box.MinY, box.MinZ)
+    {
+        // the cell indices must fit into an int
+        float fMaxLength = std::max<float>(box.LengthX(), std::max<float>(box.LengthY(), box.LengthZ()));
+        _fCellSize = std::max<float>(fCellSize, fMaxLength / 1.0e9f);
+        _fCellSize = std::max<float>(_fCellSize, FLOAT_EPS);
+    }
+
+    void AddFacet(const MeshGeomFacet& rclFacet)
+    {
+        unsigned long aulPoints[3];
+        for (int i = 0; i < 3; i++)
+            aulPoints[i] = AddPoint(rclFacet._aclPoints[i]);
+        if (aulPoints[0] == aulPoints[1] || aulPoints[1] == aulPoints[2] || aulPoints[2] == aulPoints[0])
+            return; // the facet collapses
+
+        // start with the lowest index to detect duplicates, the orientation is kept
+        int iFirst = 0;
+        if (aulPoints[1] < aulPoints[iFirst])
+            iFirst = 1;
+        if (aulPoints[2] < aulPoints[iFirst])
+            iFirst = 2;
+        Triangle tria;
+        tria.p[0] = aulPoints[iFirst];
+        tria.p[1] = aulPoints[(iFirst+1)%3];
+        tria.p[2] = aulPoints[(iFirst+2)%3];
+        _triangles.push_back(tria);
+    }
+
+    void Finish(MeshKernel& rclMesh)
+    {
+        std::sort(_triangles.begin(), _triangles.end());
+        _triangles.erase(std::unique(_triangles.begin(), _triangles.end()), _triangles.end());
+
+        MeshPointArray points(_sums.size());
+        for (std::size_t i = 0; i < _sums.size(); i++) {
+            const Sum& sum = _sums[i];
+            points[i].Set((float)(sum.x / sum.count), (float)(sum.y / sum.count), (float)(sum.z / sum.count));
+        }
+        _sums.clear();
+        _cells.clear();
+
+        MeshFacetArray facets(_triangles.size());
+        for (std::size_t i = 0; i < _triangles.size(); i++)
+            facets[i].SetVertices(_triangles[i].p[0], _triangles[i].p[1], _triangles[i].p[2]);
+        _triangles.clear();
+
+        rclMesh.Adopt(points, facets, true);
+    }
+
+private:
+    struct Cell
+    {
+        int x, y, z;
+        bool operator < (const Cell& c) const
+        {
+            if (x != c.x) return x < c.x;
+            if (y != c.y) return y < c.y;
+            return z < c.z;
+        }
+    };
+    struct Sum
+    {
+        double x, y, z;
+        unsigned long count;
+    };
+    struct Triangle
+    {
+        unsigned long p[3];
+        bool operator < (const Triangle& t) const
+        {
+            if (p[0] != t.p[0]) return p[0] < t.p[0];
+            if (p[1] != t.p[1]) return p[1] < t.p[1];
+            return p[2] < t.p[2];
+        }
+        bool operator == (const Triangle& t) const
+        {
+            return p[0] == t.p[0] && p[1] == t.p[1] && p[2] == t.p[2];
+        }
+    };
+
+    unsigned long AddPoint(const Base::Vector3f& rclPoint)
+    {
+        Cell cell;
+        cell.x = (int)((rclPoint.x - _clOrigin.x) / _fCellSize);
+        cell.y = (int)((rclPoint.y - _clOrigin.y) / _fCellSize);
+        cell.z = (int)((rclPoint.z - _clOrigin.z) / _fCellSize);
+
+        std::map<Cell, unsigned long>::iterator it = _cells.lower_bound(cell);
+        if (it == _cells.end() || cell < it->first) {
+            Sum sum = { 0.0, 0.0, 0.0, 0 };
+            it = _cells.insert(it, std::make_pair(cell, (unsigned long)_sums.size()));
+            _sums.push_back(sum);
+        }
+
+        Sum& sum = _sums[it->second];
+        sum.x += rclPoint.x;
+        sum.y += rclPoint.y;
+        sum.z += rclPoint.z;
+        sum.count++;
+        return it->second;
+    }
+
+private:
+    Base::Vector3f _clOrigin;
+    float _fCellSize;
+    std::map<Cell, unsigned long> _cells;
+    std::vector<Sum> _sums;
+    std::vector<Triangle> _triangles;
+};
+
+} // namespace MeshCore
+
+void MeshOutOfCore::Simplify(float fCellSize, MeshKernel& rclMesh) const
+{
+    MeshVertexClustering clustering(_clBoundBox, fCellSize);
+
+    Base::SequencerLauncher seq("Simplifying mesh...", _ulCtFacets / MESH_OUT_OF_CORE_WINDOW + 1);
+    MeshGeomFacet facet;
+    for (unsigned long ulFirst = 0; ulFirst < _ulCtFacets; ulFirst += MESH_OUT_OF_CORE_WINDOW) {
+        unsigned long ulLast = std::min<unsigned long>(ulFirst + MESH_OUT_OF_CORE_WINDOW, _ulCtFacets);
+        const char* data = MapFacets(ulFirst, ulLast);
+        if (!data)
+            return;
+
+        for (unsigned long i = ulFirst; i < ulLast; i++) {
+            GetFacet(data + STL_FACET_SIZE * (i - ulFirst), facet);
+            if (IsValidFacet(facet))
+                clustering.AddFacet(facet);
+        }
+
+        UnmapFacets(data);
+        seq.next(true); // allow to cancel
+    }
+
+    clustering.Finish(rclMesh);
+}
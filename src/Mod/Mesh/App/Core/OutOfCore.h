@@ -0,0 +1,156 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESH_OUTOFCORE_H
+#define MESH_OUTOFCORE_H
+
+#include <vector>
+#include <string>
+#include <Base/BoundBox.h>
+
+#include "Elements.h"
+
+class QFile;
+
+namespace MeshCore
+{
+class MeshKernel;
+
+/**
+ * The MeshOutOfCore class gives access to the facets of a binary STL file that may
+ * be larger than the main memory. The file is never read as a whole but mapped window
+ * by window, so that only the part that is currently processed must be held in memory.
+ *
+ * Besides the operations that work directly on the file the facets can be sorted into
+ * spatial tiles with BuildTiles(). Each tile can then be loaded into a MeshKernel of its
+ * own to run the usual algorithms on it. Note that the facets are assigned to the tiles
+ * by their center of gravity, so that edges at the tile border appear as open edges.
+ * \code
+ * MeshOutOfCore scan;
+ * if (scan.Open("scan.stl")) {
+ *   scan.BuildTiles(10000000);
+ *   for (unsigned long i=0; i<scan.CountTiles(); i++) {
+ *     MeshKernel tile;
+ *     scan.LoadTile(i, tile);
+ *     ...
+ *   }
+ * }
+ * \endcode
+ */
+class MeshExport MeshOutOfCore
+{
+public:
+    MeshOutOfCore();
+    ~MeshOutOfCore();
+
+    /** Opens a binary STL file. False is returned if the file cannot be opened, is not
+     * a binary STL file or if the user aborts reading it.
+     */
+    bool Open(const char* FileName);
+    /** Closes the file and frees the tiles. */
+    void Close();
+    bool IsOpen() const;
+    /** Returns the number of facets of the file. */
+    unsigned long CountFacets() const
+    { return _ulCtFacets; }
+    /** Returns the bounding box of all facets. It is computed when opening the file. */
+    const Base::BoundBox3f& GetBoundBox() const
+    { return _clBoundBox; }
+    /** Reads the facets with the indices [\a ulFirst, \a ulLast) into \a rclFacets. */
+    void GetFacets(unsigned long ulFirst, unsigned long ulLast, std::vector<MeshGeomFacet>& rclFacets) const;
+
+    /** @name Spatial tiles */
+    //@{
+    /** Sorts the facets into a regular grid of tiles by their center of gravity. The size of
+     * the tiles is chosen so that each tile holds about \a ulMaxFacets facets on average.
+     * Facets with invalid coordinates are not assigned to any tile. If the user aborts
+     * the operation there are no tiles afterwards.
+     */
+    void BuildTiles(unsigned long ulMaxFacets);
+    /** Returns the number of tiles, including the empty ones. */
+    unsigned long CountTiles() const;
+    /** Returns the number of facets of the given tile. */
+    unsigned long CountTileFacets(unsigned long ulTile) const;
+    /** Returns the box of the given tile. Facets of the tile may stick out of it. */
+    Base::BoundBox3f GetTileBoundBox(unsigned long ulTile) const;
+    /** Loads the facets of the given tile into \a rclMesh. Coincident points are merged and
+     * the neighbourhood is set, so that all algorithms can be used on the tile.
+     */
+    void LoadTile(unsigned long ulTile, MeshKernel& rclMesh) const;
+    //@}
+
+    /** @name Checks */
+    //@{
+    /** Returns the indices of all degenerated facets. */
+    void GetDegeneratedFacets(std::vector<unsigned long>& raulFacets) const;
+    /** Returns the indices of all facets with non-finite coordinates. */
+    void GetInvalidFacets(std::vector<unsigned long>& raulFacets) const;
+    //@}
+
+    /** @name Conversion */
+    //@{
+    /** Writes all facets as binary STL. */
+    bool SaveBinarySTL(std::ostream &rstrOut) const;
+    /** Writes all facets as ASCII STL. */
+    bool SaveAsciiSTL(std::ostream &rstrOut) const;
+    //@}
+
+    /** Simplifies the mesh by vertex clustering: all points lying in the same cell of a grid
+     * with the cell size \a fCellSize are replaced by their average and facets that collapse
+     * or have invalid coordinates are removed. The memory needed depends on the size of the result only. The simplified
+     * mesh is written to \a rclMesh.
+     */
+    void Simplify(float fCellSize, MeshKernel& rclMesh) const;
+
+private:
+    struct Chunk;
+    template <class Function>
+    bool ForEachWindow(Function func, std::vector<Chunk>& chunks) const;
+    const char* MapFacets(unsigned long ulFirst, unsigned long ulLast) const;
+    void UnmapFacets(const char*) const;
+    static void GetFacet(const char*, MeshGeomFacet&);
+    unsigned long GetTile(const MeshGeomFacet&) const;
+    void FillTiles();
+    void ClearTiles();
+
+    void BoundBoxChunk(Chunk&) const;
+    void DegeneratedChunk(Chunk&) const;
+    void InvalidChunk(Chunk&) const;
+    void CountTileChunk(Chunk&) const;
+    void FillTileChunk(Chunk&);
+
+private:
+    QFile* _file;
+    unsigned long _ulCtFacets;
+    Base::BoundBox3f _clBoundBox;
+
+    // the tiles in compressed row storage
+    unsigned long _ulCtTilesX, _ulCtTilesY, _ulCtTilesZ;
+    float _fTileLength;
+    std::vector<unsigned long> _tileOffsets;
+    std::vector<unsigned long> _tileFacets;
+};
+
+} // namespace MeshCore
+
+#endif // MESH_OUTOFCORE_H
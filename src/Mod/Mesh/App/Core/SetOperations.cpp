@@ -25,10 +25,16 @@
 
 
 #ifndef _PreComp_
+# include <algorithm>
+# include <cfloat>
 # include <ios>
 #endif
 
 #include <fstream>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
 #include "SetOperations.h"
 #include "Algorithm.h"
 #include "Elements.h"
@@ -170,171 +176,321 @@ void SetOperations::Do ()
   MeshDefinitions::SetMinPointDistance(saveMinMeshDistance);
 }
 
-void SetOperations::Cut (std::set<unsigned long>& facetsCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1)
+namespace MeshCore {
+
+// Sign of the determinant |a-d, b-d, c-d|, i.e. the side of the plane through a, b, c
+// on which d lies. The double precision result is checked with the static error bound
+// of Shewchuk's orient3d predicate. Only if it fails the determinant is evaluated again
+// in extended precision and if the sign is still uncertain 0 is returned.
+static int orient3d(const Base::Vector3f& a, const Base::Vector3f& b,
+                    const Base::Vector3f& c, const Base::Vector3f& d, double& det)
 {
-  MeshFacetGrid grid1(_cutMesh0, 20);
-  MeshFacetGrid grid2(_cutMesh1, 20);
+  // differences of floats are exact in double precision
+  double adx = (double)a.x - d.x, ady = (double)a.y - d.y, adz = (double)a.z - d.z;
+  double bdx = (double)b.x - d.x, bdy = (double)b.y - d.y, bdz = (double)b.z - d.z;
+  double cdx = (double)c.x - d.x, cdy = (double)c.y - d.y, cdz = (double)c.z - d.z;
+
+  double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+  double cdxady = cdx * ady, adxcdy = adx * cdy;
+  double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+  det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+  double permanent = (fabs(bdxcdy) + fabs(cdxbdy)) * fabs(adz)
+                   + (fabs(cdxady) + fabs(adxcdy)) * fabs(bdz)
+                   + (fabs(adxbdy) + fabs(bdxady)) * fabs(cdz);
+  const double eps = DBL_EPSILON * 0.5;
+  const double errbound = (7.0 + 56.0 * eps) * eps;
+  if (det > errbound * permanent)
+    return 1;
+  if (-det > errbound * permanent)
+    return -1;
+
+  long double ldet = (long double)adz * ((long double)bdx * cdy - (long double)cdx * bdy)
+                   + (long double)bdz * ((long double)cdx * ady - (long double)adx * cdy)
+                   + (long double)cdz * ((long double)adx * bdy - (long double)bdx * ady);
+  const long double leps = LDBL_EPSILON * 0.5L;
+  const long double lerrbound = (7.0L + 56.0L * leps) * leps * permanent;
+  det = (double)ldet;
+  if (ldet > lerrbound)
+    return 1;
+  if (-ldet > lerrbound)
+    return -1;
+  det = 0.0;
+  return 0;
+}
 
-  unsigned long ctGx1, ctGy1, ctGz1;
-  grid1.GetCtGrids(ctGx1, ctGy1, ctGz1);
+// Computes the section of the facet with the plane of another facet. \a sign and
+// \a dist are the side and the scaled distance of the corners to the plane.
+static int planeSection(const MeshGeomFacet& facet, const int sign[3], const double dist[3],
+                        Base::Vector3d& rclPt0, Base::Vector3d& rclPt1)
+{
+  Base::Vector3d pts[3];
+  int ct = 0;
+  for (int i = 0; i < 3 && ct < 2; i++) {
+    int j = (i + 1) % 3;
+    const Base::Vector3f& pi = facet._aclPoints[i];
+    const Base::Vector3f& pj = facet._aclPoints[j];
+    if (sign[i] == 0) {
+      pts[ct++] = Base::Vector3d(pi.x, pi.y, pi.z);
+    }
+    else if (sign[i] * sign[j] < 0) {
+      double t = dist[i] / (dist[i] - dist[j]);
+      pts[ct++] = Base::Vector3d(pi.x + t * ((double)pj.x - pi.x),
+                                 pi.y + t * ((double)pj.y - pi.y),
+                                 pi.z + t * ((double)pj.z - pi.z));
+    }
+  }
 
-  unsigned long gx1;
-  for (gx1 = 0; gx1 < ctGx1; gx1++)  
-  {
-    unsigned long gy1;
-    for (gy1 = 0; gy1 < ctGy1; gy1++)
-    {
-      unsigned long gz1;
-      for (gz1 = 0; gz1 < ctGz1; gz1++)
-      {
-        if (grid1.GetCtElements(gx1, gy1, gz1) > 0)
-        {
-          std::vector<unsigned long> vecFacets2;
-          grid2.Inside(grid1.GetBoundBox(gx1, gy1, gz1), vecFacets2);
-      
-          if (vecFacets2.size() > 0)
-          {
-            std::set<unsigned long> vecFacets1;
-            grid1.GetElements(gx1, gy1, gz1, vecFacets1);
-            
-            std::set<unsigned long>::iterator it1;
-            for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); it1++)
-            {
-              unsigned long fidx1 = *it1;
-              MeshGeomFacet f1 = _cutMesh0.GetFacet(*it1);
-              
-              std::vector<unsigned long>::iterator it2;
-              for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); it2++)
-              {
-                unsigned long fidx2 = *it2;
-                MeshGeomFacet f2 = _cutMesh1.GetFacet(fidx2);
-
-                MeshPoint p0, p1;
-
-                int isect = f1.IntersectWithFacet(f2, p0, p1);
-                if (isect > 0)
-                { 
-                   // optimize cut line if distance to nearest point is too small
-                  float minDist1 = _minDistanceToPoint, minDist2 = _minDistanceToPoint;
-                  MeshPoint np0 = p0, np1 = p1;
-                  int i;
-                  for (i = 0; i < 3; i++)
-                  {
-                    float d1 = (f1._aclPoints[i] - p0).Length();
-                    float d2 = (f1._aclPoints[i] - p1).Length();
-                    if (d1 < minDist1)
-                    {
-                      minDist1 = d1;
-                      np0 = f1._aclPoints[i];
-                    }
-                    if (d2 < minDist2)
-                    {
-                      minDist2 = d2;
-                      p1 = f1._aclPoints[i];
-                    }
-                  } // for (int i = 0; i < 3; i++)
-
-                  // optimize cut line if distance to nearest point is too small
-                  for (i = 0; i < 3; i++)
-                  {
-                    float d1 = (f2._aclPoints[i] - p0).Length();
-                    float d2 = (f2._aclPoints[i] - p1).Length();
-                    if (d1 < minDist1)
-                    {
-                      minDist1 = d1;
-                      np0 = f2._aclPoints[i];
-                    }
-                    if (d2 < minDist2)
-                    {
-                      minDist2 = d2;
-                      np1 = f2._aclPoints[i];
-                    }
-                  } // for (int i = 0; i < 3; i++)
-
-                  MeshPoint mp0 = np0;
-                  MeshPoint mp1 = np1;
-
-                  if (mp0 != mp1)
-                  {
-                    facetsCuttingEdge0.insert(fidx1);
-                    facetsCuttingEdge1.insert(fidx2);
-
-                    _cutPoints.insert(mp0);
-                    _cutPoints.insert(mp1);
-
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit0 = _cutPoints.insert(mp0);
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit1 = _cutPoints.insert(mp1);
-
-                    _edges[Edge(mp0, mp1)] = EdgeInfo();
-
-                    _facet2points[0][fidx1].push_back(pit0.first);
-                    _facet2points[0][fidx1].push_back(pit1.first);
-                    _facet2points[1][fidx2].push_back(pit0.first);
-                    _facet2points[1][fidx2].push_back(pit1.first);
-
-                  }
-                  else
-                  {
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit = _cutPoints.insert(mp0);
-
-                    // do not insert a facet when only one corner point cuts the edge
-                    // if (!((mp0 == f1._aclPoints[0]) || (mp0 == f1._aclPoints[1]) || (mp0 == f1._aclPoints[2])))
-                    {
-                      facetsCuttingEdge0.insert(fidx1);
-                      _facet2points[0][fidx1].push_back(pit.first);
-                    }
-
-                    // if (!((mp0 == f2._aclPoints[0]) || (mp0 == f2._aclPoints[1]) || (mp0 == f2._aclPoints[2])))
-                    {
-                      facetsCuttingEdge1.insert(fidx2);
-                      _facet2points[1][fidx2].push_back(pit.first);
-                    }
-                  }
-
-                 } // if (f1.IntersectWithFacet(f2, p0, p1))
-              } // for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); it2++)
-            } // for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); it1++)
-          } // if (vecFacets2.size() > 0)
-        } // if (grid1.GetCtElements(gx1, gy1, gz1) > 0)
-      } // for (gz1 = 0; gz1 < ctGz1; gz1++)
-    } // for (gy1 = 0; gy1 < ctGy1; gy1++)
-  } // for (gx1 = 0; gx1 < ctGx1; gx1++)  
+  if (ct == 0)
+    return 0;
+  rclPt0 = pts[0];
+  rclPt1 = pts[ct - 1];
+  return ct;
 }
 
-void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
+/**
+ * Computes the cut line of two facets. In contrast to MeshGeomFacet::IntersectWithFacet()
+ * all decisions are made with the filtered orientation predicate so that nearly co-planar
+ * facets do not give false-positives. Co-planar facets are not considered to cut each other.
+ * Returns 0 if the facets don't cut each other, 1 if they touch in one point and 2 if
+ * they cut each other in a line.
+ */
+static int intersectFacets(const MeshGeomFacet& f0, const MeshGeomFacet& f1,
+                           Base::Vector3f& rclPt0, Base::Vector3f& rclPt1)
 {
-  // Triangulate Mesh 
-  std::map<unsigned long, std::list<std::set<MeshPoint>::iterator> >::iterator it1;
-  for (it1 = _facet2points[side].begin(); it1 != _facet2points[side].end(); it1++)
+  int sign0[3], sign1[3];
+  double dist0[3], dist1[3];
+  int i;
+  for (i = 0; i < 3; i++)
+    sign1[i] = orient3d(f0._aclPoints[0], f0._aclPoints[1], f0._aclPoints[2], f1._aclPoints[i], dist1[i]);
+  if (sign1[0] == sign1[1] && sign1[1] == sign1[2])
+    return 0; // all corners on the same side or co-planar
+  for (i = 0; i < 3; i++)
+    sign0[i] = orient3d(f1._aclPoints[0], f1._aclPoints[1], f1._aclPoints[2], f0._aclPoints[i], dist0[i]);
+  if (sign0[0] == sign0[1] && sign0[1] == sign0[2])
+    return 0;
+
+  // both facets cut the line where their planes meet, so intersect both sections
+  Base::Vector3d a0, a1, b0, b1;
+  if (!planeSection(f0, sign0, dist0, a0, a1) || !planeSection(f1, sign1, dist1, b0, b1))
+    return 0;
+
+  Base::Vector3d dir = (a1 - a0).Sqr() >= (b1 - b0).Sqr() ? a1 - a0 : b1 - b0;
+  if (dir.Sqr() == 0.0) {
+    if (a0 == b0) {
+      rclPt0 = rclPt1 = Base::Vector3f((float)a0.x, (float)a0.y, (float)a0.z);
+      return 1;
+    }
+    return 0;
+  }
+
+  double ta0 = dir * a0, ta1 = dir * a1, tb0 = dir * b0, tb1 = dir * b1;
+  if (ta0 > ta1) { std::swap(ta0, ta1); std::swap(a0, a1); }
+  if (tb0 > tb1) { std::swap(tb0, tb1); std::swap(b0, b1); }
+  if (ta1 < tb0 || tb1 < ta0)
+    return 0;
+
+  const Base::Vector3d& p0 = ta0 >= tb0 ? a0 : b0;
+  const Base::Vector3d& p1 = ta1 <= tb1 ? a1 : b1;
+  rclPt0 = Base::Vector3f((float)p0.x, (float)p0.y, (float)p0.z);
+  rclPt1 = Base::Vector3f((float)p1.x, (float)p1.y, (float)p1.z);
+  return rclPt0 == rclPt1 ? 1 : 2;
+}
+
+/**
+ * The MeshFacetCutter class finds all pairs of cutting facets of two meshes with
+ * several threads. The grid elements of the first mesh are distributed over the
+ * threads, each collects the candidate pairs of its elements. After removing the
+ * pairs found in several grid elements the cut lines are computed in parallel.
+ */
+class MeshFacetCutter
+{
+public:
+  struct Chunk
+  {
+    unsigned long begin, end;
+    std::vector<std::pair<unsigned long, unsigned long> > pairs;
+  };
+
+  struct Cut
+  {
+    int type;
+    Base::Vector3f pt0, pt1;
+  };
+
+  MeshFacetCutter (const MeshKernel& mesh0, const MeshKernel& mesh1)
+    : _mesh0(mesh0), _mesh1(mesh1), _grid0(mesh0, 20), _grid1(mesh1, 20)
+  {
+  }
+
+  void Run (std::vector<std::pair<unsigned long, unsigned long> >& pairs, std::vector<Cut>& cuts)
+  {
+    unsigned long ulX, ulY, ulZ;
+    _grid0.GetCtGrids(ulX, ulY, ulZ);
+    for (unsigned long i = 0; i < ulX; i++) {
+      for (unsigned long j = 0; j < ulY; j++) {
+        for (unsigned long k = 0; k < ulZ; k++) {
+          if (_grid0.GetCtElements(i, j, k) > 0)
+            _cells.push_back(_grid0.GetIndexToPosition(i, j, k));
+        }
+      }
+    }
+
+    std::vector<Chunk> chunks;
+    MakeChunks(_cells.size(), chunks);
+    QtConcurrent::blockingMap(chunks, boost::bind(&MeshFacetCutter::Collect, this, _1));
+
+    pairs.clear();
+    for (std::vector<Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+      pairs.insert(pairs.end(), it->pairs.begin(), it->pairs.end());
+      std::vector<std::pair<unsigned long, unsigned long> >().swap(it->pairs);
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    _pairs = &pairs;
+    _cuts = &cuts;
+    cuts.resize(pairs.size());
+    MakeChunks(pairs.size(), chunks);
+    QtConcurrent::blockingMap(chunks, boost::bind(&MeshFacetCutter::Intersect, this, _1));
+  }
+
+private:
+  static void MakeChunks (unsigned long ulCount, std::vector<Chunk>& chunks)
+  {
+    unsigned long ulCtChunks = ulCount > 10000 ? 4 * std::max<int>(QThread::idealThreadCount(), 1) : 1;
+    unsigned long ulStep = (ulCount + ulCtChunks - 1) / ulCtChunks;
+    chunks.clear();
+    for (unsigned long i = 0; i < ulCount; i += ulStep) {
+      chunks.push_back(Chunk());
+      chunks.back().begin = i;
+      chunks.back().end = std::min<unsigned long>(i + ulStep, ulCount);
+    }
+  }
+
+  void Collect (Chunk& chunk) const
+  {
+    std::set<unsigned long> elements0;
+    std::vector<unsigned long> elements1;
+    std::vector<Base::BoundBox3f> boxes1;
+    for (unsigned long c = chunk.begin; c < chunk.end; c++) {
+      unsigned long ulX, ulY, ulZ;
+      _grid0.GetPositionToIndex(_cells[c], ulX, ulY, ulZ);
+      _grid1.Inside(_grid0.GetBoundBox(ulX, ulY, ulZ), elements1);
+      if (elements1.empty())
+        continue;
+
+      boxes1.resize(elements1.size());
+      for (std::size_t j = 0; j < elements1.size(); j++)
+        boxes1[j] = _mesh1.GetFacet(elements1[j]).GetBoundBox();
+
+      elements0.clear();
+      _grid0.GetElements(ulX, ulY, ulZ, elements0);
+      for (std::set<unsigned long>::iterator it0 = elements0.begin(); it0 != elements0.end(); ++it0) {
+        Base::BoundBox3f box0 = _mesh0.GetFacet(*it0).GetBoundBox();
+        for (std::size_t j = 0; j < elements1.size(); j++) {
+          if (box0 && boxes1[j])
+            chunk.pairs.push_back(std::make_pair(*it0, elements1[j]));
+        }
+      }
+    }
+  }
+
+  void Intersect (Chunk& chunk) const
+  {
+    for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+      const std::pair<unsigned long, unsigned long>& pair = (*_pairs)[i];
+      Cut& cut = (*_cuts)[i];
+      cut.type = intersectFacets(_mesh0.GetFacet(pair.first), _mesh1.GetFacet(pair.second), cut.pt0, cut.pt1);
+    }
+  }
+
+private:
+  const MeshKernel& _mesh0;
+  const MeshKernel& _mesh1;
+  MeshFacetGrid _grid0, _grid1;
+  std::vector<unsigned long> _cells;
+  const std::vector<std::pair<unsigned long, unsigned long> >* _pairs;
+  std::vector<Cut>* _cuts;
+};
+
+/**
+ * The MeshFacetSplitter class re-triangulates the facets with their cut points.
+ * The facets are independent of each other and thus split by several threads.
+ */
+class MeshFacetSplitter
+{
+public:
+  typedef std::map<unsigned long, std::list<std::set<MeshPoint>::iterator> > FacetPoints;
+
+  struct Chunk
+  {
+    unsigned long begin, end;
+  };
+
+  MeshFacetSplitter (const MeshKernel& mesh, const FacetPoints& facetPoints, float fMinDistance)
+    : _mesh(mesh), _fMinDistance(fMinDistance)
+  {
+    _facets.reserve(facetPoints.size());
+    for (FacetPoints::const_iterator it = facetPoints.begin(); it != facetPoints.end(); ++it)
+      _facets.push_back(it);
+  }
+
+  void Run ()
+  {
+    _result.resize(_facets.size());
+    unsigned long ulCount = _facets.size();
+    unsigned long ulCtChunks = ulCount > 1000 ? 4 * std::max<int>(QThread::idealThreadCount(), 1) : 1;
+    unsigned long ulStep = (ulCount + ulCtChunks - 1) / ulCtChunks;
+    std::vector<Chunk> chunks;
+    for (unsigned long i = 0; i < ulCount; i += ulStep) {
+      Chunk chunk;
+      chunk.begin = i;
+      chunk.end = std::min<unsigned long>(i + ulStep, ulCount);
+      chunks.push_back(chunk);
+    }
+    QtConcurrent::blockingMap(chunks, boost::bind(&MeshFacetSplitter::Split, this, _1));
+  }
+
+  unsigned long CountFacets () const
+  { return _facets.size(); }
+  unsigned long GetFacetIndex (unsigned long i) const
+  { return _facets[i]->first; }
+  const std::vector<MeshGeomFacet>& GetTriangles (unsigned long i) const
+  { return _result[i]; }
+
+private:
+  void Split (Chunk& chunk)
+  {
+    for (unsigned long i = chunk.begin; i < chunk.end; i++)
+      SplitFacet(_facets[i]->first, _facets[i]->second, _result[i]);
+  }
+
+  void SplitFacet (unsigned long fidx, const std::list<std::set<MeshPoint>::iterator>& cutPoints,
+                   std::vector<MeshGeomFacet>& triangles) const
   {
     std::vector<Vector3f> points;
     std::set<MeshPoint>   pointsSet;
 
-    unsigned long fidx = it1->first;
-    MeshGeomFacet f = cutMesh.GetFacet(fidx);
-
-    //if (side == 1)
-    //    _builder.addSingleTriangle(f._aclPoints[0], f._aclPoints[1], f._aclPoints[2], 3, 0, 1, 1);
+    MeshGeomFacet f = _mesh.GetFacet(fidx);
 
-     // facet corner points
-    //const MeshFacet& mf = cutMesh._aclFacetArray[fidx];
+    // facet corner points
     int i;
     for (i = 0; i < 3; i++)
     {
       pointsSet.insert(f._aclPoints[i]);
       points.push_back(f._aclPoints[i]);
     }
-    
-    // triangulated facets
-    std::list<std::set<MeshPoint>::iterator>::iterator it2;
-    for (it2 = it1->second.begin(); it2 != it1->second.end(); it2++)
+
+    // cut points
+    std::list<std::set<MeshPoint>::iterator>::const_iterator it2;
+    for (it2 = cutPoints.begin(); it2 != cutPoints.end(); it2++)
     {
       if (pointsSet.find(*(*it2)) == pointsSet.end())
       {
         pointsSet.insert(*(*it2));
         points.push_back(*(*it2));
       }
-
     }
 
     Vector3f normal = f.GetNormal();
@@ -344,7 +500,6 @@ void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
     Vector3f dirY = dirX % normal;
 
     // project points to 2D plane
-    i = 0;
     std::vector<Vector3f>::iterator it;
     std::vector<Vector3f> vertices;
     for (it = points.begin(); it != points.end(); it++)
@@ -367,19 +522,11 @@ void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
       { // two same triangle corner points
         continue;
       }
-  
+
       MeshGeomFacet facet(points[it->_aulPoints[0]],
                           points[it->_aulPoints[1]],
                           points[it->_aulPoints[2]]);
 
-      //if (side == 1)
-      // _builder.addSingleTriangle(facet._aclPoints[0], facet._aclPoints[1], facet._aclPoints[2], true, 3, 0, 1, 1);
-
-      //if (facet.Area() < 0.0001f)
-      //{ // too small facet
-      //  continue;
-      //}
-
       float dist0 = facet._aclPoints[0].DistanceToLine
           (facet._aclPoints[1],facet._aclPoints[1] - facet._aclPoints[2]);
       float dist1 = facet._aclPoints[1].DistanceToLine
@@ -387,22 +534,13 @@ void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
       float dist2 = facet._aclPoints[2].DistanceToLine
           (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[1]);
 
-      if ((dist0 < _minDistanceToPoint) ||
-          (dist1 < _minDistanceToPoint) ||
-          (dist2 < _minDistanceToPoint))
+      if ((dist0 < _fMinDistance) ||
+          (dist1 < _fMinDistance) ||
+          (dist2 < _fMinDistance))
       {
         continue;
       }
 
-      //dist0 = (facet._aclPoints[0] - facet._aclPoints[1]).Length();
-      //dist1 = (facet._aclPoints[1] - facet._aclPoints[2]).Length();
-      //dist2 = (facet._aclPoints[2] - facet._aclPoints[3]).Length();
-
-      //if ((dist0 < _minDistanceToPoint) || (dist1 < _minDistanceToPoint) || (dist2 < _minDistanceToPoint))
-      //{
-      //  continue;
-      //}
-
       facet.CalcNormal();
       if ((facet.GetNormal() * f.GetNormal()) < 0.0f)
       { // adjust normal
@@ -410,7 +548,121 @@ void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
          facet.CalcNormal();
       }
 
+      triangles.push_back(facet);
+    }
+  }
+
+private:
+  const MeshKernel& _mesh;
+  float _fMinDistance;
+  std::vector<FacetPoints::const_iterator> _facets;
+  std::vector<std::vector<MeshGeomFacet> > _result;
+};
+
+} // namespace MeshCore
+
+void SetOperations::Cut (std::set<unsigned long>& facetsCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1)
+{
+  std::vector<std::pair<unsigned long, unsigned long> > pairs;
+  std::vector<MeshFacetCutter::Cut> cuts;
+  MeshFacetCutter cutter(_cutMesh0, _cutMesh1);
+  cutter.Run(pairs, cuts);
+
+  // the pairs are sorted, so the result doesn't depend on the number of threads
+  for (std::size_t index = 0; index < pairs.size(); index++)
+  {
+    const MeshFacetCutter::Cut& cut = cuts[index];
+    if (cut.type == 0)
+      continue;
+
+    unsigned long fidx1 = pairs[index].first;
+    unsigned long fidx2 = pairs[index].second;
+    MeshGeomFacet f1 = _cutMesh0.GetFacet(fidx1);
+    MeshGeomFacet f2 = _cutMesh1.GetFacet(fidx2);
+    MeshPoint p0 = cut.pt0, p1 = cut.pt1;
+
+    // optimize cut line if distance to nearest point is too small
+    float minDist1 = _minDistanceToPoint, minDist2 = _minDistanceToPoint;
+    MeshPoint np0 = p0, np1 = p1;
+    int i;
+    for (i = 0; i < 3; i++)
+    {
+      float d1 = (f1._aclPoints[i] - p0).Length();
+      float d2 = (f1._aclPoints[i] - p1).Length();
+      if (d1 < minDist1)
+      {
+        minDist1 = d1;
+        np0 = f1._aclPoints[i];
+      }
+      if (d2 < minDist2)
+      {
+        minDist2 = d2;
+        np1 = f1._aclPoints[i];
+      }
+    } // for (int i = 0; i < 3; i++)
 
+    // optimize cut line if distance to nearest point is too small
+    for (i = 0; i < 3; i++)
+    {
+      float d1 = (f2._aclPoints[i] - p0).Length();
+      float d2 = (f2._aclPoints[i] - p1).Length();
+      if (d1 < minDist1)
+      {
+        minDist1 = d1;
+        np0 = f2._aclPoints[i];
+      }
+      if (d2 < minDist2)
+      {
+        minDist2 = d2;
+        np1 = f2._aclPoints[i];
+      }
+    } // for (int i = 0; i < 3; i++)
+
+    MeshPoint mp0 = np0;
+    MeshPoint mp1 = np1;
+
+    if (mp0 != mp1)
+    {
+      facetsCuttingEdge0.insert(fidx1);
+      facetsCuttingEdge1.insert(fidx2);
+
+      std::pair<std::set<MeshPoint>::iterator, bool> pit0 = _cutPoints.insert(mp0);
+      std::pair<std::set<MeshPoint>::iterator, bool> pit1 = _cutPoints.insert(mp1);
+
+      _edges[Edge(mp0, mp1)] = EdgeInfo();
+
+      _facet2points[0][fidx1].push_back(pit0.first);
+      _facet2points[0][fidx1].push_back(pit1.first);
+      _facet2points[1][fidx2].push_back(pit0.first);
+      _facet2points[1][fidx2].push_back(pit1.first);
+    }
+    else
+    {
+      std::pair<std::set<MeshPoint>::iterator, bool> pit = _cutPoints.insert(mp0);
+
+      facetsCuttingEdge0.insert(fidx1);
+      _facet2points[0][fidx1].push_back(pit.first);
+
+      facetsCuttingEdge1.insert(fidx2);
+      _facet2points[1][fidx2].push_back(pit.first);
+    }
+  }
+}
+
+void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
+{
+  // Triangulate Mesh 
+  MeshFacetSplitter splitter(cutMesh, _facet2points[side], _minDistanceToPoint);
+  splitter.Run();
+
+  // register the new facets at the cut edges, this must be done in the order of the facets
+  for (unsigned long i = 0; i < splitter.CountFacets(); i++)
+  {
+    unsigned long fidx = splitter.GetFacetIndex(i);
+    const std::vector<MeshGeomFacet>& triangles = splitter.GetTriangles(i);
+    for (std::vector<MeshGeomFacet>::const_iterator it = triangles.begin(); it != triangles.end(); ++it)
+    {
+      MeshGeomFacet facet = *it;
       int j;
       for (j = 0; j < 3; j++)
       {
@@ -418,25 +670,19 @@ void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
 
         if (eit != _edges.end())
         {
-
           if (eit->second.fcounter[side] < 2)
           {
-            //if (side == 0)
-            //   _builder.addSingleTriangle(facet._aclPoints[0], facet._aclPoints[1], facet._aclPoints[2], true, 3, 0, 1, 1);
-
             eit->second.facet[side] = fidx;
             eit->second.facets[side][eit->second.fcounter[side]] = facet;
             eit->second.fcounter[side]++;
             facet.SetFlag(MeshFacet::MARKED); // set all facets connected to an edge: MARKED
-
           }
         }
       }
 
       _newMeshFacets[side].push_back(facet);
-
-    } // for (i = 0; i < (out->numberoftriangles * 3); i += 3)
-  } // for (it1 = _facet2points[side].begin(); it1 != _facet2points[side].end(); it1++)
+    }
+  }
 }
 
 void SetOperations::CollectFacets (int side, float mult)
@@ -169,9 +169,9 @@ private:
 
   std::vector<MeshGeomFacet> _newMeshFacets[2];
 
-  /** Cut mesh 1 with mesh 2 */
+  /** Cut mesh 1 with mesh 2. The candidate pairs of facets are intersected by several threads */
   void Cut (std::set<unsigned long>& facetsNotCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1);
-  /** Trianglute each facets cutted with his cutting points */
+  /** Trianglute each facets cutted with his cutting points, the facets are split by several threads */
   void TriangulateMesh (const MeshKernel &cutMesh, int side);
   /** search facets for adding (with region growing) */
   void CollectFacets (int side, float mult);
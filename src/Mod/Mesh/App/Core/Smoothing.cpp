@@ -23,8 +23,13 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
 #endif
 
+#include <QThread>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
 #include "Smoothing.h"
 #include "MeshKernel.h"
 #include "Algorithm.h"
@@ -36,52 +41,131 @@
 using namespace MeshCore;
 
 
-AbstractSmoothing::AbstractSmoothing(MeshKernel& m) : kernel(m)
-{
-}
+namespace MeshCore {
 
-AbstractSmoothing::~AbstractSmoothing()
+/**
+ * The SmoothingKernel class moves a subset of the mesh points by several threads at the
+ * same time. The coordinates are kept twice as separate arrays of x, y and z values: each
+ * step only reads the positions of the previous step and writes the new positions to the
+ * other buffer, so the result doesn't depend on the order the points are processed.
+ */
+class SmoothingKernel
 {
-}
+public:
+    SmoothingKernel(MeshKernel& kernel, const MeshRefPointToPoints& vv_it,
+                    const std::vector<unsigned long>& points)
+      : _kernel(kernel), _vv(vv_it), _points(points), _current(0)
+      , _stepsize(0.0), _tolerance(0.0f)
+    {
+        const MeshPointArray& rPoints = kernel.GetPoints();
+        unsigned long ulCtPoints = rPoints.size();
+        for (int i=0; i<2; i++) {
+            _x[i].resize(ulCtPoints);
+            _y[i].resize(ulCtPoints);
+            _z[i].resize(ulCtPoints);
+        }
+        for (unsigned long i=0; i<ulCtPoints; i++) {
+            _x[0][i] = _x[1][i] = rPoints[i].x;
+            _y[0][i] = _y[1][i] = rPoints[i].y;
+            _z[0][i] = _z[1][i] = rPoints[i].z;
+        }
 
-void AbstractSmoothing::initialize(Component comp, Continuity cont)
-{
-    this->component = comp;
-    this->continuity = cont;
-}
+        // small meshes are not worth to be split
+        unsigned long ulCtElements = _points.size();
+        unsigned long ulCtChunks = 1;
+        if (ulCtElements > 10000)
+            ulCtChunks = 4 * std::max<int>(QThread::idealThreadCount(), 1);
+        unsigned long ulChunkSize = ulCtElements / ulCtChunks + 1;
+        for (unsigned long ulBegin = 0; ulBegin < ulCtElements; ulBegin += ulChunkSize) {
+            Chunk chunk;
+            chunk.begin = ulBegin;
+            chunk.end = std::min<unsigned long>(ulBegin + ulChunkSize, ulCtElements);
+            _chunks.push_back(chunk);
+        }
+    }
 
-PlaneFitSmoothing::PlaneFitSmoothing(MeshKernel& m)
-  : AbstractSmoothing(m)
-{
-}
+    /// Moves each point by \a stepsize towards the center of its neighbours.
+    void Umbrella(double stepsize)
+    {
+        _stepsize = stepsize;
+        QtConcurrent::blockingMap(_chunks, boost::bind(&SmoothingKernel::UmbrellaChunk, this, _1));
+        _current = 1 - _current;
+    }
 
-PlaneFitSmoothing::~PlaneFitSmoothing()
-{
-}
+    /// Moves each point towards the plane fitted through it and its neighbours, at most by \a tolerance.
+    void FitPlane(float tolerance)
+    {
+        _tolerance = tolerance;
+        QtConcurrent::blockingMap(_chunks, boost::bind(&SmoothingKernel::FitPlaneChunk, this, _1));
+        _current = 1 - _current;
+    }
 
-void PlaneFitSmoothing::Smooth(unsigned int iterations)
-{
-    MeshCore::MeshPoint center;
-    MeshCore::MeshPointArray PointArray = kernel.GetPoints();
+    /// Writes the new positions of the moved points to the mesh kernel.
+    void Finish()
+    {
+        const std::vector<float>& x = _x[_current];
+        const std::vector<float>& y = _y[_current];
+        const std::vector<float>& z = _z[_current];
+        for (std::vector<unsigned long>::const_iterator it = _points.begin(); it != _points.end(); ++it)
+            _kernel.SetPoint(*it, x[*it], y[*it], z[*it]);
+    }
 
-    MeshCore::MeshPointIterator v_it(kernel);
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshPointArray::_TConstIterator v_beg = kernel.GetPoints().begin();
+private:
+    struct Chunk
+    {
+        unsigned long begin, end;
+    };
+
+    void UmbrellaChunk(Chunk& chunk)
+    {
+        const std::vector<float>& sx = _x[_current];
+        const std::vector<float>& sy = _y[_current];
+        const std::vector<float>& sz = _z[_current];
+        std::vector<float>& dx = _x[1-_current];
+        std::vector<float>& dy = _y[1-_current];
+        std::vector<float>& dz = _z[1-_current];
+
+        for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+            unsigned long pos = _points[i];
+            MeshIndexRange cv = _vv[pos];
+            float px = sx[pos], py = sy[pos], pz = sz[pos];
+
+            double delx=0.0,dely=0.0,delz=0.0;
+            for (MeshIndexRange::const_iterator cv_it = cv.begin(); cv_it != cv.end(); ++cv_it) {
+                delx += sx[*cv_it]-px;
+                dely += sy[*cv_it]-py;
+                delz += sz[*cv_it]-pz;
+            }
+
+            double w = _stepsize/double(cv.size());
+            dx[pos] = (float)(px+w*delx);
+            dy[pos] = (float)(py+w*dely);
+            dz[pos] = (float)(pz+w*delz);
+        }
+    }
+
+    void FitPlaneChunk(Chunk& chunk)
+    {
+        const std::vector<float>& sx = _x[_current];
+        const std::vector<float>& sy = _y[_current];
+        const std::vector<float>& sz = _z[_current];
+        std::vector<float>& dx = _x[1-_current];
+        std::vector<float>& dy = _y[1-_current];
+        std::vector<float>& dz = _z[1-_current];
 
-    for (unsigned int i=0; i<iterations; i++) {
         Base::Vector3f N, L;
-        for (v_it.Begin(); v_it.More(); v_it.Next()) {
+        for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+            unsigned long pos = _points[i];
+            MeshIndexRange cv = _vv[pos];
+            Base::Vector3f point(sx[pos], sy[pos], sz[pos]);
+
             MeshCore::PlaneFit pf;
-            pf.AddPoint(*v_it);
-            center = *v_it;
-            const std::set<unsigned long>& cv = vv_it[v_it.Position()];
-            if (cv.size() < 3)
-                continue;
-
-            std::set<unsigned long>::const_iterator cv_it;
-            for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-                pf.AddPoint(v_beg[*cv_it]);
-                center += v_beg[*cv_it];
+            pf.AddPoint(point);
+            Base::Vector3f center = point;
+            for (MeshIndexRange::const_iterator cv_it = cv.begin(); cv_it != cv.end(); ++cv_it) {
+                Base::Vector3f neighbour(sx[*cv_it], sy[*cv_it], sz[*cv_it]);
+                pf.AddPoint(neighbour);
+                center += neighbour;
             }
 
             float scale = 1.0f/((float)cv.size()+1.0f);
@@ -93,77 +177,91 @@ void PlaneFitSmoothing::Smooth(unsigned int iterations)
             N.Normalize();
 
             // look in which direction we should move the vertex
-            L.Set(v_it->x - center.x, v_it->y - center.y, v_it->z - center.z);
+            L = point - center;
             if (N*L < 0.0)
                 N.Scale(-1.0, -1.0, -1.0);
 
             // maximum value to move is distance to mean plane
-            float d = std::min<float>((float)fabs(this->tolerance),(float)fabs(N*L));
+            float d = std::min<float>((float)fabs(_tolerance),(float)fabs(N*L));
             N.Scale(d,d,d);
 
-            PointArray[v_it.Position()].Set(v_it->x - N.x, v_it->y - N.y, v_it->z - N.z);
-        }
-
-        // assign values without affecting iterators
-        unsigned long count = kernel.CountPoints();
-        for (unsigned long idx = 0; idx < count; idx++) {
-            kernel.SetPoint(idx, PointArray[idx]);
+            dx[pos] = point.x - N.x;
+            dy[pos] = point.y - N.y;
+            dz[pos] = point.z - N.z;
         }
     }
+
+private:
+    MeshKernel& _kernel;
+    const MeshRefPointToPoints& _vv;
+    const std::vector<unsigned long>& _points;
+    std::vector<Chunk> _chunks;
+    std::vector<float> _x[2], _y[2], _z[2];
+    int _current;
+    double _stepsize;
+    float _tolerance;
+};
+
+} // namespace MeshCore
+
+AbstractSmoothing::AbstractSmoothing(MeshKernel& m) : kernel(m)
+{
 }
 
-void PlaneFitSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
+AbstractSmoothing::~AbstractSmoothing()
 {
-    MeshCore::MeshPoint center;
-    MeshCore::MeshPointArray PointArray = kernel.GetPoints();
+}
 
-    MeshCore::MeshPointIterator v_it(kernel);
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshPointArray::_TConstIterator v_beg = kernel.GetPoints().begin();
+void AbstractSmoothing::initialize(Component comp, Continuity cont)
+{
+    this->component = comp;
+    this->continuity = cont;
+}
 
-    for (unsigned int i=0; i<iterations; i++) {
-        Base::Vector3f N, L;
-        for (std::vector<unsigned long>::const_iterator it = point_indices.begin(); it != point_indices.end(); ++it) {
-            v_it.Set(*it);
-            MeshCore::PlaneFit pf;
-            pf.AddPoint(*v_it);
-            center = *v_it;
-            const std::set<unsigned long>& cv = vv_it[v_it.Position()];
-            if (cv.size() < 3)
-                continue;
-
-            std::set<unsigned long>::const_iterator cv_it;
-            for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-                pf.AddPoint(v_beg[*cv_it]);
-                center += v_beg[*cv_it];
-            }
+PlaneFitSmoothing::PlaneFitSmoothing(MeshKernel& m)
+  : AbstractSmoothing(m)
+{
+}
 
-            float scale = 1.0f/((float)cv.size()+1.0f);
-            center.Scale(scale,scale,scale);
+PlaneFitSmoothing::~PlaneFitSmoothing()
+{
+}
 
-            // get the mean plane of the current vertex with the surrounding vertices
-            pf.Fit();
-            N = pf.GetNormal();
-            N.Normalize();
+void PlaneFitSmoothing::Smooth(unsigned int iterations)
+{
+    MeshCore::MeshRefPointToPoints vv_it(kernel);
 
-            // look in which direction we should move the vertex
-            L.Set(v_it->x - center.x, v_it->y - center.y, v_it->z - center.z);
-            if (N*L < 0.0)
-                N.Scale(-1.0, -1.0, -1.0);
+    // points with less than three neighbours are kept
+    std::vector<unsigned long> points;
+    unsigned long count = kernel.CountPoints();
+    for (unsigned long pos = 0; pos < count; pos++) {
+        if (vv_it[pos].size() >= 3)
+            points.push_back(pos);
+    }
 
-            // maximum value to move is distance to mean plane
-            float d = std::min<float>((float)fabs(this->tolerance),(float)fabs(N*L));
-            N.Scale(d,d,d);
+    SmoothingKernel smooth(kernel, vv_it, points);
+    for (unsigned int i=0; i<iterations; i++) {
+        smooth.FitPlane(this->tolerance);
+    }
+    smooth.Finish();
+}
 
-            PointArray[v_it.Position()].Set(v_it->x - N.x, v_it->y - N.y, v_it->z - N.z);
-        }
+void PlaneFitSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
+{
+    MeshCore::MeshRefPointToPoints vv_it(kernel);
 
-        // assign values without affecting iterators
-        unsigned long count = kernel.CountPoints();
-        for (unsigned long idx = 0; idx < count; idx++) {
-            kernel.SetPoint(idx, PointArray[idx]);
-        }
+    // points with less than three neighbours are kept
+    std::vector<unsigned long> points;
+    for (std::vector<unsigned long>::const_iterator it = point_indices.begin(); it != point_indices.end(); ++it) {
+        if (vv_it[*it].size() >= 3)
+            points.push_back(*it);
     }
+
+    SmoothingKernel smooth(kernel, vv_it, points);
+    for (unsigned int i=0; i<iterations; i++) {
+        smooth.FitPlane(this->tolerance);
+    }
+    smooth.Finish();
 }
 
 LaplaceSmoothing::LaplaceSmoothing(MeshKernel& m)
@@ -175,95 +273,58 @@ LaplaceSmoothing::~LaplaceSmoothing()
 {
 }
 
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it, double stepsize)
+void LaplaceSmoothing::GetInnerPoints(const MeshRefPointToPoints& vv_it,
+                                      std::vector<unsigned long>& points) const
 {
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_it,
-    v_beg = points.begin(), v_end = points.end();
-
-    unsigned long pos = 0;
-    for (v_it = points.begin(); v_it != v_end; ++v_it,++pos) {
-        const std::set<unsigned long>& cv = vv_it[pos];
-        if (cv.size() < 3)
-            continue;
-        if (cv.size() != vf_it[pos].size()) {
-            // do nothing for border points
-            continue;
-        }
-
-        unsigned int n_count = cv.size();
-        double w;
-        w=1.0/double(n_count);
-
-        double delx=0.0,dely=0.0,delz=0.0;
-        std::set<unsigned long>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-            delx += w*((v_beg[*cv_it]).x-v_it->x);
-            dely += w*((v_beg[*cv_it]).y-v_it->y);
-            delz += w*((v_beg[*cv_it]).z-v_it->z);
-        }
+    MeshCore::MeshRefPointToFacets vf_it(kernel);
 
-        float x = (float)(v_it->x+stepsize*delx);
-        float y = (float)(v_it->y+stepsize*dely);
-        float z = (float)(v_it->z+stepsize*delz);
-        kernel.SetPoint(pos,x,y,z);
+    unsigned long count = kernel.CountPoints();
+    for (unsigned long pos = 0; pos < count; pos++) {
+        MeshIndexRange cv = vv_it[pos];
+        // do nothing for border points
+        if (cv.size() >= 3 && cv.size() == vf_it[pos].size())
+            points.push_back(pos);
     }
 }
 
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it, double stepsize,
-                                const std::vector<unsigned long>& point_indices)
+void LaplaceSmoothing::GetInnerPoints(const MeshRefPointToPoints& vv_it,
+                                      const std::vector<unsigned long>& point_indices,
+                                      std::vector<unsigned long>& points) const
 {
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_beg = points.begin();
+    MeshCore::MeshRefPointToFacets vf_it(kernel);
 
     for (std::vector<unsigned long>::const_iterator pos = point_indices.begin(); pos != point_indices.end(); ++pos) {
-        const std::set<unsigned long>& cv = vv_it[*pos];
-        if (cv.size() < 3)
-            continue;
-        if (cv.size() != vf_it[*pos].size()) {
-            // do nothing for border points
-            continue;
-        }
-
-        unsigned int n_count = cv.size();
-        double w;
-        w=1.0/double(n_count);
-
-        double delx=0.0,dely=0.0,delz=0.0;
-        std::set<unsigned long>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-            delx += w*((v_beg[*cv_it]).x-(v_beg[*pos]).x);
-            dely += w*((v_beg[*cv_it]).y-(v_beg[*pos]).y);
-            delz += w*((v_beg[*cv_it]).z-(v_beg[*pos]).z);
-        }
-
-        float x = (float)((v_beg[*pos]).x+stepsize*delx);
-        float y = (float)((v_beg[*pos]).y+stepsize*dely);
-        float z = (float)((v_beg[*pos]).z+stepsize*delz);
-        kernel.SetPoint(*pos,x,y,z);
+        MeshIndexRange cv = vv_it[*pos];
+        // do nothing for border points
+        if (cv.size() >= 3 && cv.size() == vf_it[*pos].size())
+            points.push_back(*pos);
     }
 }
 
 void LaplaceSmoothing::Smooth(unsigned int iterations)
 {
     MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    std::vector<unsigned long> points;
+    GetInnerPoints(vv_it, points);
 
+    SmoothingKernel smooth(kernel, vv_it, points);
     for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda);
+        smooth.Umbrella(lambda);
     }
+    smooth.Finish();
 }
 
 void LaplaceSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
 {
     MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    std::vector<unsigned long> points;
+    GetInnerPoints(vv_it, point_indices, points);
 
+    SmoothingKernel smooth(kernel, vv_it, points);
     for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda, point_indices);
+        smooth.Umbrella(lambda);
     }
+    smooth.Finish();
 }
 
 TaubinSmoothing::TaubinSmoothing(MeshKernel& m)
@@ -277,28 +338,32 @@ TaubinSmoothing::~TaubinSmoothing()
 
 void TaubinSmoothing::Smooth(unsigned int iterations)
 {
-    MeshCore::MeshPointArray::_TConstIterator v_it;
     MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    std::vector<unsigned long> points;
+    GetInnerPoints(vv_it, points);
 
     // Theoretically Taubin does not shrink the surface
+    SmoothingKernel smooth(kernel, vv_it, points);
     iterations = (iterations+1)/2; // two steps per iteration
     for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda);
-        Umbrella(vv_it, vf_it, -(lambda+micro));
+        smooth.Umbrella(lambda);
+        smooth.Umbrella(-(lambda+micro));
     }
+    smooth.Finish();
 }
 
 void TaubinSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
 {
-    MeshCore::MeshPointArray::_TConstIterator v_it;
     MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    std::vector<unsigned long> points;
+    GetInnerPoints(vv_it, point_indices, points);
 
     // Theoretically Taubin does not shrink the surface
+    SmoothingKernel smooth(kernel, vv_it, points);
     iterations = (iterations+1)/2; // two steps per iteration
     for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda, point_indices);
-        Umbrella(vv_it, vf_it, -(lambda+micro), point_indices);
+        smooth.Umbrella(lambda);
+        smooth.Umbrella(-(lambda+micro));
     }
+    smooth.Finish();
 }
@@ -32,7 +32,10 @@ class MeshKernel;
 class MeshRefPointToPoints;
 class MeshRefPointToFacets;
 
-/** Base class for smoothing algorithms. */
+/** Base class for smoothing algorithms.
+ * The points are moved by several threads at the same time. Each step only reads the
+ * positions of the previous step.
+ */
 class MeshExport AbstractSmoothing
 {
 public:
@@ -83,11 +86,13 @@ public:
     void SetLambda(double l) { lambda = l;}
 
 protected:
-    void Umbrella(const MeshRefPointToPoints&,
-                  const MeshRefPointToFacets&, double);
-    void Umbrella(const MeshRefPointToPoints&,
-                  const MeshRefPointToFacets&, double,
-                  const std::vector<unsigned long>&);
+    /** Collects all points that are neither border points nor have less than three neighbours. */
+    void GetInnerPoints(const MeshRefPointToPoints&,
+                        std::vector<unsigned long>&) const;
+    /** Collects the points of the given list that are neither border points nor have less than three neighbours. */
+    void GetInnerPoints(const MeshRefPointToPoints&,
+                        const std::vector<unsigned long>&,
+                        std::vector<unsigned long>&) const;
 
 protected:
     double lambda;
@@ -0,0 +1,88 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#endif
+
+#include <Base/Tools.h>
+
+#include "FeatureMeshDecimation.h"
+
+using namespace Mesh;
+
+
+//===========================================================================
+// Decimation Feature
+//===========================================================================
+
+PROPERTY_SOURCE(Mesh::Decimation, Mesh::Feature)
+
+Decimation::Decimation()
+{
+    ADD_PROPERTY(Source,(0));
+    ADD_PROPERTY(TargetSize,(0));
+    ADD_PROPERTY(Tolerance,(0.0f));
+    ADD_PROPERTY(FeatureAngle,(180.0f));
+    ADD_PROPERTY(PreserveBoundary,(true));
+    ADD_PROPERTY(Parallel,(true));
+}
+
+Decimation::~Decimation()
+{
+}
+
+short Decimation::mustExecute() const
+{
+    if (Source.isTouched() ||
+        TargetSize.isTouched() ||
+        Tolerance.isTouched() ||
+        FeatureAngle.isTouched() ||
+        PreserveBoundary.isTouched() ||
+        Parallel.isTouched())
+        return 1;
+    return 0;
+}
+
+App::DocumentObjectExecReturn *Decimation::execute(void)
+{
+    App::DocumentObject* link = Source.getValue();
+    if (!link) return new App::DocumentObjectExecReturn("No mesh linked");
+    if (TargetSize.getValue() < 0)
+        return new App::DocumentObjectExecReturn("Target size must not be negative");
+    App::Property* prop = link->getPropertyByName("Mesh");
+    if (prop && prop->getTypeId() == Mesh::PropertyMeshKernel::getClassTypeId()) {
+        Mesh::PropertyMeshKernel* kernel = static_cast<Mesh::PropertyMeshKernel*>(prop);
+        std::auto_ptr<MeshObject> mesh(new MeshObject);
+        *mesh = kernel->getValue();
+        mesh->decimate((unsigned long)TargetSize.getValue(), (float)Tolerance.getValue(),
+                       Base::toRadians<float>((float)FeatureAngle.getValue()),
+                       PreserveBoundary.getValue(), Parallel.getValue());
+        this->Mesh.setValuePtr(mesh.release());
+    }
+
+    return App::DocumentObject::StdReturn;
+}
@@ -0,0 +1,74 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#ifndef MESH_FEATURE_MESH_DECIMATION_H
+#define MESH_FEATURE_MESH_DECIMATION_H
+
+#include <App/PropertyLinks.h>
+#include <App/PropertyStandard.h>
+#include "MeshFeature.h"
+
+namespace Mesh
+{
+
+/**
+ * The Decimation class reduces the number of facets of the linked mesh with the
+ * quadric error metric, see MeshCore::MeshDecimation.
+ */
+class MeshExport Decimation : public Mesh::Feature
+{
+  PROPERTY_HEADER(Mesh::Decimation);
+
+public:
+  /// Constructor
+  Decimation(void);
+  virtual ~Decimation();
+
+  /** @name Properties */
+  //@{
+  App::PropertyLink    Source;
+  /// The number of facets to keep, 0 means no limit
+  App::PropertyInteger TargetSize;
+  /** The maximum error of a collapse, 0 means no limit. The error is the square root of the
+   * sum of the squared distances of the new point to the planes of the original facets
+   * around it, so no point moves farther than this from any of these planes.
+   */
+  App::PropertyFloat   Tolerance;
+  /// Edges with a larger angle (in degree) between the adjacent facets are kept
+  App::PropertyFloat   FeatureAngle;
+  App::PropertyBool    PreserveBoundary;
+  App::PropertyBool    Parallel;
+  //@}
+
+  /** @name methods override Feature */
+  //@{
+  /// recalculate the Feature
+  virtual App::DocumentObjectExecReturn *execute(void);
+  short mustExecute() const;
+  //@}
+};
+
+}
+
+#endif // MESH_FEATURE_MESH_DECIMATION_H
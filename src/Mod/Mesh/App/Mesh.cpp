@@ -38,6 +38,7 @@
 #include <Base/ViewProj.h>
 
 #include "Core/Builder.h"
+#include "Core/Decimation.h"
 #include "Core/MeshKernel.h"
 #include "Core/Grid.h"
 #include "Core/Iterator.h"
@@ -476,6 +477,12 @@ void MeshObject::addMesh(const MeshObject& mesh)
     _kernel.Merge(mesh._kernel);
 }
 
+void MeshObject::addMesh(const MeshObject& mesh, float fTolerance)
+{
+    if (this != &mesh)
+        _kernel.Merge(mesh._kernel.GetPoints(), mesh._kernel.GetFacets(), fTolerance);
+}
+
 void MeshObject::addMesh(const MeshCore::MeshKernel& kernel)
 {
     _kernel.Merge(kernel);
@@ -989,6 +996,23 @@ void MeshObject::optimizeEdges()
     topalg.AdjustEdgesToCurvatureDirection();
 }
 
+void MeshObject::decimate(unsigned long targetSize, float tolerance, float featureAngle,
+                          bool preserveBoundary, bool parallel)
+{
+    MeshCore::MeshDecimation decimate(_kernel);
+    decimate.SetTargetSize(targetSize);
+    decimate.SetTolerance(tolerance);
+    decimate.SetFeatureAngle(featureAngle);
+    decimate.SetPreserveBoundary(preserveBoundary);
+    if (!parallel)
+        decimate.SetPartitions(1);
+    decimate.Simplify();
+
+    // clear the segments because we don't know how the new
+    // topology looks like
+    this->_segments.clear();
+}
+
 void MeshObject::splitEdges()
 {
     std::vector<std::pair<unsigned long, unsigned long> > adjacentFacet;
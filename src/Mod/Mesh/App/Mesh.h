@@ -167,6 +167,11 @@ public:
      * this mesh object.
      */
     void addMesh(const MeshObject&);
+    /**
+     * Combines two mesh objects and merges all points whose distance is lower
+     * than \a fTolerance along each axis.
+     */
+    void addMesh(const MeshObject&, float fTolerance);
     /**
      * Combines two independent mesh objects.
      * @note The mesh object we want to add must not overlap or intersect with
@@ -231,6 +236,11 @@ public:
     void refine();
     void optimizeTopology(float);
     void optimizeEdges();
+    /** Reduces the mesh to \a targetSize facets or until the error exceeds \a tolerance,
+     * see MeshCore::MeshDecimation. The feature angle is given in radian.
+     */
+    void decimate(unsigned long targetSize, float tolerance, float featureAngle,
+                  bool preserveBoundary, bool parallel);
     void splitEdges();
     void splitEdge(unsigned long, unsigned long, const Base::Vector3f&);
     void splitFacet(unsigned long, const Base::Vector3f&, const Base::Vector3f&);
@@ -236,6 +236,11 @@ void PropertyCurvatureList::RestoreDocFile(Base::Reader &reader)
     setValues(values);
 }
 
+bool PropertyCurvatureList::isSaveDocFileThreadSafe() const
+{
+    return true;
+}
+
 PyObject* PropertyCurvatureList::getPyObject(void)
 {
     Py::List list;
@@ -305,13 +310,14 @@ void PropertyMeshKernel::setValuePtr(MeshObject* mesh)
     // before calling hasSetValue()
     Base::Reference<MeshObject> tmp(_meshObject);
     aboutToSetValue();
-    _meshObject = mesh;
+    referenceMesh(mesh);
     hasSetValue();
 }
 
 void PropertyMeshKernel::setValue(const MeshObject& mesh)
 {
     aboutToSetValue();
+    detachMesh(false);
     *_meshObject = mesh;
     hasSetValue();
 }
@@ -319,6 +325,7 @@ void PropertyMeshKernel::setValue(const MeshObject& mesh)
 void PropertyMeshKernel::setValue(const MeshCore::MeshKernel& mesh)
 {
     aboutToSetValue();
+    detachMesh(false);
     _meshObject->setKernel(mesh);
     hasSetValue();
 }
@@ -326,6 +333,7 @@ void PropertyMeshKernel::setValue(const MeshCore::MeshKernel& mesh)
 void PropertyMeshKernel::swapMesh(MeshObject& mesh)
 {
     aboutToSetValue();
+    detachMesh(true);
     _meshObject->swap(mesh);
     hasSetValue();
 }
@@ -333,27 +341,59 @@ void PropertyMeshKernel::swapMesh(MeshObject& mesh)
 void PropertyMeshKernel::swapMesh(MeshCore::MeshKernel& mesh)
 {
     aboutToSetValue();
+    detachMesh(true);
     _meshObject->swap(mesh);
     hasSetValue();
 }
 
+void PropertyMeshKernel::detachMesh(bool copyContent)
+{
+    // The mesh object is shared with a copy of this property, e.g. a snapshot
+    // in the undo stack. Thus, the data must be duplicated before it gets modified.
+    // Note: The Python wrapper doesn't hold a reference to the mesh object.
+    if (_meshObject.getRefCount() > 1) {
+        MeshObject* mesh;
+        if (copyContent) {
+            mesh = new MeshObject(*_meshObject);
+        }
+        else {
+            mesh = new MeshObject();
+            mesh->setTransform(_meshObject->getTransform());
+        }
+
+        referenceMesh(mesh);
+    }
+}
+
+void PropertyMeshKernel::referenceMesh(MeshObject* mesh)
+{
+    _meshObject = mesh;
+    // the Python wrapper must refer to the mesh object of this property
+    if (meshPyObject)
+        meshPyObject->_pcTwinPointer = mesh;
+}
+
 const MeshObject& PropertyMeshKernel::getValue(void)const 
 {
+    restoreDeferred();
     return *_meshObject;
 }
 
 const MeshObject* PropertyMeshKernel::getValuePtr(void)const 
 {
+    restoreDeferred();
     return (MeshObject*)_meshObject;
 }
 
 const Data::ComplexGeoData* PropertyMeshKernel::getComplexData() const
 {
+    restoreDeferred();
     return (MeshObject*)_meshObject;
 }
 
 Base::BoundBox3d PropertyMeshKernel::getBoundingBox() const
 {
+    restoreDeferred();
     return _meshObject->getBoundBox();
 }
 
@@ -361,13 +401,16 @@ void PropertyMeshKernel::getFaces(std::vector<Base::Vector3d> &aPoints,
                                   std::vector<Data::ComplexGeoData::Facet> &aTopo,
                                   float accuracy, uint16_t flags) const
 {
+    restoreDeferred();
     _meshObject->getFaces(aPoints, aTopo, accuracy, flags);
 }
 
 unsigned int PropertyMeshKernel::getMemSize (void) const
 {
+    // a mesh shared between several properties is only counted once in total
     unsigned int size = 0;
-    size += _meshObject->getMemSize();
+    int count = _meshObject.getRefCount();
+    size += _meshObject->getMemSize() / (count > 1 ? count : 1);
     
     return size;
 }
@@ -375,6 +418,7 @@ unsigned int PropertyMeshKernel::getMemSize (void) const
 MeshObject* PropertyMeshKernel::startEditing()
 {
     aboutToSetValue();
+    detachMesh(true);
     return (MeshObject*)_meshObject;
 }
 
@@ -386,13 +430,25 @@ void PropertyMeshKernel::finishEditing()
 void PropertyMeshKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
     aboutToSetValue();
+    detachMesh(true);
     _meshObject->transformGeometry(rclMat);
     hasSetValue();
 }
 
+void PropertyMeshKernel::setTransform(const Base::Matrix4D &rclMat)
+{
+    restoreDeferred();
+    // the view provider must be notified if the mesh object gets replaced
+    aboutToSetValue();
+    detachMesh(true);
+    _meshObject->setTransform(rclMat);
+    hasSetValue();
+}
+
 void PropertyMeshKernel::setPointIndices(const std::vector<std::pair<unsigned long, Base::Vector3f> >& inds)
 {
     aboutToSetValue();
+    detachMesh(true);
     MeshCore::MeshKernel& kernel = _meshObject->getKernel();
     for (std::vector<std::pair<unsigned long, Base::Vector3f> >::const_iterator it = inds.begin(); it != inds.end(); ++it)
         kernel.SetPoint(it->first, it->second);
@@ -464,6 +520,7 @@ void PropertyMeshKernel::Restore(Base::XMLReader &reader)
         kernel.Adopt(points, facets);
 
         aboutToSetValue();
+        detachMesh(false);
         _meshObject->getKernel().Adopt(points, facets);
         hasSetValue();
     } 
@@ -481,23 +538,30 @@ void PropertyMeshKernel::SaveDocFile (Base::Writer &writer) const
 void PropertyMeshKernel::RestoreDocFile(Base::Reader &reader)
 {
     aboutToSetValue();
+    detachMesh(false);
     _meshObject->load(reader);
     hasSetValue();
 }
 
+bool PropertyMeshKernel::isSaveDocFileThreadSafe() const
+{
+    return true;
+}
+
 App::Property *PropertyMeshKernel::Copy(void) const
 {
-    // Note: Copy the content, do NOT reference the same mesh object
+    // Note: The copy references the same mesh object (copy-on-write). Whichever
+    // property gets modified first creates its own mesh object, see detachMesh().
     PropertyMeshKernel *prop = new PropertyMeshKernel();
-    *(prop->_meshObject) = *(this->_meshObject);
+    prop->_meshObject = this->_meshObject;
     return prop;
 }
 
 void PropertyMeshKernel::Paste(const App::Property &from)
 {
-    // Note: Copy the content, do NOT reference the same mesh object
+    // Note: Reference the same mesh object, see Copy()
     aboutToSetValue();
     const PropertyMeshKernel& prop = dynamic_cast<const PropertyMeshKernel&>(from);
-    *(this->_meshObject) = *(prop._meshObject);
+    referenceMesh(prop._meshObject);
     hasSetValue();
 }
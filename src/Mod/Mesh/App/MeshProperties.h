@@ -92,15 +92,15 @@ public:
     ~PropertyCurvatureList();
 
     void setSize(int newSize){_lValueList.resize(newSize);}   
-    int getSize(void) const {return _lValueList.size();}   
+    int getSize(void) const {restoreDeferred(); return _lValueList.size();}   
     std::vector<float> getCurvature( int tMode) const;
     void setValue(const CurvatureInfo&);
     void setValues(const std::vector<CurvatureInfo>&);
 
     /// index operator
-    const CurvatureInfo& operator[] (const int idx) const {return _lValueList.operator[] (idx);} 
-    void  set1Value (const int idx, const CurvatureInfo& value){_lValueList.operator[] (idx) = value;}
-    const std::vector<CurvatureInfo> &getValues(void) const{return _lValueList;}
+    const CurvatureInfo& operator[] (const int idx) const {restoreDeferred(); return _lValueList.operator[] (idx);} 
+    void  set1Value (const int idx, const CurvatureInfo& value){restoreDeferred(); _lValueList.operator[] (idx) = value;}
+    const std::vector<CurvatureInfo> &getValues(void) const{restoreDeferred(); return _lValueList;}
     void transform(const Base::Matrix4D &rclMat);
 
     void Save (Base::Writer &writer) const;
@@ -108,6 +108,7 @@ public:
 
     void SaveDocFile (Base::Writer &writer) const;
     void RestoreDocFile(Base::Reader &reader);
+    bool isSaveDocFileThreadSafe() const;
 
     /** @name Python interface */
     //@{
@@ -179,6 +180,10 @@ public:
     void finishEditing();
     /// Transform the real mesh data
     void transformGeometry(const Base::Matrix4D &rclMat);
+    /** Sets the placement of the mesh without notifying the container.
+     * A mesh shared with a copy of this property is duplicated before.
+     */
+    void setTransform(const Base::Matrix4D &rclMat);
     void setPointIndices( const std::vector<std::pair<unsigned long, Base::Vector3f> >& );
     //@}
 
@@ -206,11 +211,18 @@ public:
 
     void SaveDocFile (Base::Writer &writer) const;
     void RestoreDocFile(Base::Reader &reader);
+    bool isSaveDocFileThreadSafe() const;
 
     App::Property *Copy(void) const;
     void Paste(const App::Property &from);
     //@}
 
+private:
+    /// Creates an own mesh object if it is shared with a copy of this property
+    void detachMesh(bool copyContent);
+    /// Replaces the referenced mesh object, the Python wrapper is kept in sync
+    void referenceMesh(MeshObject* mesh);
+
 private:
     Base::Reference<MeshObject> _meshObject;
     MeshPy* meshPyObject;
@@ -624,11 +624,15 @@ PyObject* MeshPy::rebuildNeighbourHood(PyObject *args)
 PyObject*  MeshPy::addMesh(PyObject *args)
 {
     PyObject* mesh;
-    if (!PyArg_ParseTuple(args, "O!",&(MeshPy::Type), &mesh))
+    float tol = -1.0f;
+    if (!PyArg_ParseTuple(args, "O!|f",&(MeshPy::Type), &mesh, &tol))
         return NULL;
 
     PY_TRY {
-        getMeshObjectPtr()->addMesh(*static_cast<MeshPy*>(mesh)->getMeshObjectPtr());
+        if (tol < 0.0f)
+            getMeshObjectPtr()->addMesh(*static_cast<MeshPy*>(mesh)->getMeshObjectPtr());
+        else
+            getMeshObjectPtr()->addMesh(*static_cast<MeshPy*>(mesh)->getMeshObjectPtr(), tol);
     } PY_CATCH;
 
     Py_Return;
@@ -838,6 +842,54 @@ PyObject*  MeshPy::countNonUniformOrientedFacets(PyObject *args)
     return Py_BuildValue("k", count); 
 }
 
+static Py::List indexList(const std::vector<unsigned long>& indices)
+{
+    Py::List list;
+    for (std::vector<unsigned long>::const_iterator it = indices.begin(); it != indices.end(); ++it)
+        list.append(Py::Long(*it));
+    return list;
+}
+
+static Py::List pairList(const std::vector<std::pair<unsigned long, unsigned long> >& pairs)
+{
+    Py::List list;
+    for (std::vector<std::pair<unsigned long, unsigned long> >::const_iterator it = pairs.begin(); it != pairs.end(); ++it) {
+        Py::Tuple pair(2);
+        pair.setItem(0, Py::Long(it->first));
+        pair.setItem(1, Py::Long(it->second));
+        list.append(pair);
+    }
+    return list;
+}
+
+PyObject*  MeshPy::getDefects(PyObject *args)
+{
+    if (!PyArg_ParseTuple(args, ""))
+        return NULL;
+
+    MeshCore::MeshEvalAll eval(getMeshObjectPtr()->getKernel());
+    eval.Evaluate();
+    const MeshCore::MeshDefectReport& report = eval.GetReport();
+
+    Py::Dict dict;
+    dict.setItem("FlippedFacets", indexList(report.flippedFacets));
+    dict.setItem("NonUniformOrientation", Py::Boolean(report.nonUniformOrientation));
+    dict.setItem("DuplicatedFacets", indexList(report.duplicatedFacets));
+    dict.setItem("DuplicatedPoints", indexList(report.duplicatedPoints));
+    dict.setItem("NonManifoldEdges", pairList(report.nonManifoldEdges));
+    dict.setItem("NonManifoldPoints", indexList(report.nonManifoldPoints));
+    dict.setItem("DegeneratedFacets", indexList(report.degeneratedFacets));
+    dict.setItem("InvalidFacetIndices", indexList(report.invalidFacetIndices));
+    dict.setItem("InvalidPointIndices", indexList(report.invalidPointIndices));
+    dict.setItem("CorruptedFacets", indexList(report.corruptedFacets));
+    dict.setItem("InvalidNeighbours", indexList(report.invalidNeighbours));
+    dict.setItem("SelfIntersections", pairList(report.selfIntersections));
+    dict.setItem("FoldsOnSurface", indexList(report.foldsOnSurface));
+    dict.setItem("FoldsOnBoundary", indexList(report.foldsOnBoundary));
+    dict.setItem("FoldOversOnSurface", indexList(report.foldOversOnSurface));
+    return Py::new_reference_to(dict);
+}
+
 PyObject*  MeshPy::harmonizeNormals(PyObject *args)
 {
     if (!PyArg_ParseTuple(args, ""))
@@ -991,6 +1043,30 @@ PyObject*  MeshPy::optimizeTopology(PyObject *args)
     Py_Return; 
 }
 
+PyObject*  MeshPy::decimate(PyObject *args)
+{
+    int targetSize;
+    float tolerance=0.0f;
+    float featureAngle=F_PI;
+    PyObject* boundary=Py_True;
+    PyObject* parallel=Py_True;
+    if (!PyArg_ParseTuple(args, "i|ffO!O!", &targetSize, &tolerance, &featureAngle,
+                          &PyBool_Type, &boundary, &PyBool_Type, &parallel))
+        return NULL;
+    if (targetSize < 0) {
+        PyErr_SetString(PyExc_ValueError, "target size must not be negative");
+        return NULL;
+    }
+
+    PY_TRY {
+        MeshPropertyLock lock(this->parentProperty);
+        getMeshObjectPtr()->decimate((unsigned long)targetSize, tolerance, featureAngle,
+            PyObject_IsTrue(boundary) ? true : false, PyObject_IsTrue(parallel) ? true : false);
+    } PY_CATCH;
+
+    Py_Return; 
+}
+
 PyObject*  MeshPy::optimizeEdges(PyObject *args)
 {
     if (!PyArg_ParseTuple(args, ""))
@@ -1,7 +1,7 @@
 #   (c) Juergen Riegel (juergen.riegel@web.de) 2007      LGPL
 
 import FreeCAD, os, sys, unittest, Mesh
-import thread, time, tempfile
+import thread, time, tempfile, math
 
 
 #---------------------------------------------------------------------------
@@ -71,6 +71,36 @@ class MeshGeoTestCases(unittest.TestCase):
 		res=f1.intersect(f2)
 		self.failUnless(len(res) == 0)
 
+class MeshSetOperationsTestCases(unittest.TestCase):
+	def setUp(self):
+		# two overlapping spheres with radius 1
+		self.sphere1 = Mesh.createSphere(1.0, 30)
+		self.sphere2 = Mesh.createSphere(1.0, 30)
+		self.sphere2.translate(0.5, 0.0, 0.0)
+
+	def testUnion(self):
+		res = self.sphere1.unite(self.sphere2)
+		self.failUnless(res.CountFacets > 0)
+		self.failUnless(abs(res.BoundBox.XLength - 2.5) < 0.01)
+
+	def testIntersection(self):
+		res = self.sphere1.intersect(self.sphere2)
+		self.failUnless(res.CountFacets > 0)
+		self.failUnless(abs(res.BoundBox.XLength - 1.5) < 0.01)
+
+	def testDifference(self):
+		res = self.sphere1.difference(self.sphere2)
+		self.failUnless(res.CountFacets > 0)
+		# the cut circle lies at x=0.25
+		self.failUnless(abs(res.BoundBox.XLength - 1.25) < 0.05)
+
+	def testDisjoint(self):
+		self.sphere2.translate(5.0, 0.0, 0.0)
+		res = self.sphere1.intersect(self.sphere2)
+		self.failUnless(res.CountFacets == 0)
+		res = self.sphere1.unite(self.sphere2)
+		self.failUnless(res.CountFacets == self.sphere1.CountFacets + self.sphere2.CountFacets)
+
 class PivyTestCases(unittest.TestCase):
 	def setUp(self):
 		# set up a planar face with 2 triangles
@@ -163,3 +193,367 @@ class LoadMeshInThreadsCases(unittest.TestCase):
 
     def tearDown(self):
         pass
+
+class MeshMergeTestCases(unittest.TestCase):
+    def square(self, x):
+        # a unit square of two triangles in the xy plane starting at x
+        return [[x, 0.0, 0.0], [x + 1.0, 0.0, 0.0], [x + 1.0, 1.0, 0.0],
+                [x, 0.0, 0.0], [x + 1.0, 1.0, 0.0], [x, 1.0, 0.0]]
+
+    def testMergeWithoutTolerance(self):
+        mesh = Mesh.Mesh(self.square(0.0))
+        mesh.addMesh(Mesh.Mesh(self.square(0.99)))
+        self.failUnless(mesh.CountPoints == 8)
+        self.failUnless(mesh.CountFacets == 4)
+
+    def testMergeAcrossCellBorder(self):
+        # with this tolerance x=1.0 is the border of two cells of the welding grid,
+        # the points at x=0.99 and x=1.0 lie on both sides of it
+        mesh = Mesh.Mesh(self.square(0.0))
+        mesh.addMesh(Mesh.Mesh(self.square(0.99)), 0.0625)
+        self.failUnless(mesh.CountPoints == 6)
+        self.failUnless(mesh.CountFacets == 4)
+
+    def testMergeOutsideTolerance(self):
+        mesh = Mesh.Mesh(self.square(0.0))
+        mesh.addMesh(Mesh.Mesh(self.square(0.99)), 0.005)
+        self.failUnless(mesh.CountPoints == 8)
+        self.failUnless(mesh.CountFacets == 4)
+
+class MeshSmoothingTestCases(unittest.TestCase):
+    def setUp(self):
+        # a plane of 110x110 squares with a zigzag noise on the inner points,
+        # more than 10000 points so that the kernel smooths them in chunks
+        n = 110
+        triangles = []
+        for i in range(n):
+            for j in range(n):
+                a = self.point(i, j, n)
+                b = self.point(i + 1, j, n)
+                c = self.point(i + 1, j + 1, n)
+                d = self.point(i, j + 1, n)
+                triangles += [a, b, c, a, c, d]
+        self.mesh = Mesh.Mesh(triangles)
+
+    def point(self, i, j, n):
+        z = 0.0
+        if 0 < i < n and 0 < j < n:
+            z = 0.1 - 0.2 * ((i + j) % 2)
+        return [float(i), float(j), z]
+
+    def smoothSequential(self, points, facets, iterations, stepsize):
+        # the former Laplace smoothing moving the points in place one after another
+        points = [[p.x, p.y, p.z] for p in points]
+        neighbours = [set() for p in points]
+        count = [0] * len(points)
+        for f in facets:
+            for k in range(3):
+                neighbours[f[k]].update(f)
+                count[f[k]] += 1
+        for i in range(len(points)):
+            neighbours[i].discard(i)
+        for it in range(iterations):
+            for i in range(len(points)):
+                nb = neighbours[i]
+                # border points and points with too few neighbours are kept
+                if len(nb) < 3 or len(nb) != count[i]:
+                    continue
+                w = stepsize / len(nb)
+                for c in range(3):
+                    points[i][c] += w * sum([points[k][c] - points[i][c] for k in nb])
+        return points
+
+    def testLaplaceMatchesSequential(self):
+        points, facets = self.mesh.Topology
+        expected = self.smoothSequential(points, facets, 10, 0.6307)
+        self.mesh.smooth(10)
+        result = self.mesh.Topology[0]
+        self.failUnless(len(result) == len(expected))
+        for p, q in zip(result, expected):
+            dist = ((p.x - q[0]) ** 2 + (p.y - q[1]) ** 2 + (p.z - q[2]) ** 2) ** 0.5
+            self.failUnless(dist < 0.001, "Deviation %f from sequential smoothing" % (dist))
+
+class MeshOutOfCoreTestCases(unittest.TestCase):
+    def setUp(self):
+        self.name = tempfile.gettempdir() + os.sep + "outofcore.stl"
+
+    def writeSTL(self, triangles):
+        import struct
+        data = open(self.name, "wb")
+        data.write(" " * 80)
+        data.write(struct.pack("<I", len(triangles)))
+        for t in triangles:
+            data.write(struct.pack("<12fH", *([0.0, 0.0, 0.0] + t + [0])))
+        data.close()
+
+    def boxTriangles(self):
+        points, facets = Mesh.createBox(1.0, 1.0, 1.0).Topology
+        triangles = []
+        for f in facets:
+            t = []
+            for i in f:
+                t += [points[i].x, points[i].y, points[i].z]
+            triangles.append(t)
+        return triangles
+
+    def testSimplifyKeepsFacets(self):
+        self.writeSTL(self.boxTriangles())
+        mesh = Mesh.readSimplified(self.name, 0.01)
+        self.failUnless(mesh.CountPoints == 8)
+        self.failUnless(mesh.CountFacets == 12)
+
+    def testSimplifyMergesPoints(self):
+        self.writeSTL(self.boxTriangles())
+        mesh = Mesh.readSimplified(self.name, 10.0)
+        self.failUnless(mesh.CountFacets == 0)
+
+    def testInvalidCoordinates(self):
+        # facets with NaN, infinite or too big coordinates are skipped
+        triangles = self.boxTriangles()
+        for v in [float("nan"), float("inf"), 1.0e35]:
+            triangles.append([0.0, 0.0, 0.0, v, 0.0, 0.0, 0.0, 1.0, 0.0])
+        self.writeSTL(triangles)
+        mesh = Mesh.readSimplified(self.name, 0.01)
+        self.failUnless(mesh.CountPoints == 8)
+        self.failUnless(mesh.CountFacets == 12)
+        self.failUnless(mesh.BoundBox.XMax < 1.5)
+
+    def testOnlyInvalidCoordinates(self):
+        self.writeSTL([[float("nan")] * 9])
+        mesh = Mesh.readSimplified(self.name, 0.01)
+        self.failUnless(mesh.CountFacets == 0)
+
+    def testNoBinarySTL(self):
+        data = open(self.name, "w")
+        data.write("solid Mesh\nendsolid Mesh\n")
+        data.close()
+        self.failUnlessRaises(Exception, Mesh.readSimplified, self.name, 0.01)
+
+    def testTiles(self):
+        # each facet is loaded into exactly one tile
+        self.writeSTL(self.boxTriangles())
+        tiles = Mesh.readTiles(self.name, 2)
+        self.failUnless(len(tiles) > 1)
+        self.failUnless(sum([t.CountFacets for t in tiles]) == 12)
+        box = Mesh.readTiles(self.name, 100)
+        self.failUnless(len(box) == 1)
+        self.failUnless(box[0].CountPoints == 8)
+        self.failUnless(box[0].isSolid())
+
+    def testCheck(self):
+        triangles = self.boxTriangles()
+        triangles.append([0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 2.0, 0.0, 0.0])
+        triangles.append([0.0, 0.0, 0.0, float("nan"), 0.0, 0.0, 0.0, 1.0, 0.0])
+        self.writeSTL(triangles)
+        defects = Mesh.checkBinarySTL(self.name)
+        self.failUnless(12 in defects["DegeneratedFacets"])
+        self.failUnless(defects["InvalidFacets"] == [13])
+
+    def testConvert(self):
+        self.writeSTL(self.boxTriangles())
+        output = tempfile.gettempdir() + os.sep + "outofcore_conv.stl"
+        try:
+            Mesh.convertBinarySTL(self.name, output)
+            self.failUnless(open(output, "r").read().startswith("solid"))
+            self.failUnless(Mesh.read(output).CountFacets == 12)
+            # the binary output is a copy of the file
+            Mesh.convertBinarySTL(self.name, output, False)
+            self.failUnless(open(output, "rb").read() == open(self.name, "rb").read())
+        finally:
+            os.remove(output)
+
+    def tearDown(self):
+        os.remove(self.name)
+
+class MeshDecimationTestCases(unittest.TestCase):
+    def setUp(self):
+        # more than 100000 facets so that the slabs are decimated in parallel
+        self.sphere = Mesh.createSphere(5.0, 240)
+        self.failUnless(self.sphere.CountFacets > 100000)
+
+    def testTargetSize(self):
+        count = self.sphere.CountFacets
+        self.sphere.decimate(count // 4)
+        self.failUnless(0 < self.sphere.CountFacets <= count // 4)
+        self.failUnless(self.sphere.isSolid())
+
+    def testSerial(self):
+        # the parallel and the serial decimation reach the same target size
+        serial = self.sphere.copy()
+        count = self.sphere.CountFacets
+        self.sphere.decimate(count // 4)
+        serial.decimate(count // 4, 0.0, math.pi, True, False)
+        self.failUnless(0 < serial.CountFacets <= count // 4)
+        self.failUnless(serial.isSolid())
+        self.failUnless(abs(serial.CountFacets - self.sphere.CountFacets) <= count // 100)
+
+    def testTolerance(self):
+        # the surface moves by less than the tolerance, so the points stay close to the sphere
+        count = self.sphere.CountFacets
+        tolerance = 0.05
+        self.sphere.decimate(0, tolerance)
+        self.failUnless(self.sphere.CountFacets < count)
+        for p in self.sphere.Topology[0]:
+            self.failUnless(abs(p.Length - 5.0) <= tolerance)
+
+    def testPreserveBoundary(self):
+        # a flat square of 10x10 squares, all inner points can be removed
+        n = 10
+        triangles = []
+        for i in range(n):
+            for j in range(n):
+                x = float(i)
+                y = float(j)
+                triangles += [[x, y, 0.0], [x + 1.0, y, 0.0], [x + 1.0, y + 1.0, 0.0],
+                              [x, y, 0.0], [x + 1.0, y + 1.0, 0.0], [x, y + 1.0, 0.0]]
+        mesh = Mesh.Mesh(triangles)
+        mesh.decimate(2)
+        self.failUnless(mesh.CountFacets < 2 * n * n)
+
+        # the border edges must still form the outline of the square
+        points, facets = mesh.Topology
+        edges = {}
+        for f in facets:
+            for k in range(3):
+                e = (min(f[k], f[(k + 1) % 3]), max(f[k], f[(k + 1) % 3]))
+                edges[e] = edges.get(e, 0) + 1
+        length = 0.0
+        for e, count in edges.items():
+            if count == 1:
+                p = points[e[0]]
+                q = points[e[1]]
+                self.failUnless((p.x == q.x and p.x in (0, n)) or (p.y == q.y and p.y in (0, n)))
+                length += (p - q).Length
+        self.failUnless(abs(length - 4 * n) < 0.001)
+
+class MeshEvaluationTestCases(unittest.TestCase):
+    def createMesh(self, triangles):
+        points = []
+        for t in triangles:
+            points += t
+        return Mesh.Mesh(points)
+
+    def testNoDefects(self):
+        defects = Mesh.createBox(1.0, 1.0, 1.0).getDefects()
+        self.failUnless(not defects["NonUniformOrientation"])
+        for key, value in defects.items():
+            if key != "NonUniformOrientation":
+                self.failUnless(len(value) == 0)
+
+    def testNonManifolds(self):
+        # three facets share the edge of the first two points and
+        # two facets share only the point (5,0,0)
+        mesh = self.createMesh([[[0.0,0.0,0.0],[1.0,0.0,0.0],[0.0,1.0,0.0]],
+                                [[0.0,0.0,0.0],[1.0,0.0,0.0],[0.0,-1.0,0.0]],
+                                [[0.0,0.0,0.0],[1.0,0.0,0.0],[0.0,0.0,1.0]],
+                                [[5.0,0.0,0.0],[6.0,0.0,0.0],[6.0,1.0,0.0]],
+                                [[5.0,0.0,0.0],[4.0,0.0,0.0],[4.0,-1.0,0.0]]])
+        defects = mesh.getDefects()
+        self.failUnless(defects["NonManifoldEdges"] == [(0, 1)])
+        points = [mesh.Points[i] for i in defects["NonManifoldPoints"]]
+        self.failUnless(len(points) == 1)
+        self.failUnless(points[0].Vector == FreeCAD.Vector(5.0,0.0,0.0))
+        self.failUnless(len(defects["DuplicatedPoints"]) == 0)
+        self.failUnless(len(defects["DegeneratedFacets"]) == 0)
+
+    def testDuplicatedPoints(self):
+        # the points of a separate copy of the triangle are duplicated
+        triangle = self.createMesh([[[0.0,0.0,0.0],[1.0,0.0,0.0],[0.0,1.0,0.0]]])
+        mesh = self.createMesh([[[0.0,0.0,0.0],[1.0,0.0,0.0],[0.0,1.0,0.0]],
+                                [[1.0,0.0,0.0],[1.0,1.0,0.0],[0.0,1.0,0.0]]])
+        mesh.addMesh(triangle)
+        self.failUnless(mesh.CountPoints == 7)
+        defects = mesh.getDefects()
+        self.failUnless(len(defects["DuplicatedPoints"]) == 3)
+        self.failUnless(len(defects["DuplicatedFacets"]) == 0)
+        self.failUnless(len(defects["NonManifoldEdges"]) == 0)
+        self.failUnless(len(defects["DegeneratedFacets"]) == 0)
+
+    def testDegeneratedFacets(self):
+        # the corners of the second facet lie on a line
+        mesh = self.createMesh([[[0.0,0.0,0.0],[1.0,0.0,0.0],[0.0,1.0,0.0]],
+                                [[5.0,0.0,0.0],[6.0,0.0,0.0],[7.0,0.0,0.0]]])
+        self.failUnless(mesh.CountFacets == 2)
+        defects = mesh.getDefects()
+        self.failUnless(defects["DegeneratedFacets"] == [1])
+        self.failUnless(len(defects["DuplicatedPoints"]) == 0)
+        self.failUnless(len(defects["NonManifoldEdges"]) == 0)
+
+class MeshSelfIntersectionTestCases(unittest.TestCase):
+    def testCrossingFacets(self):
+        # the second facet pierces the first one, the third one is apart
+        mesh = Mesh.Mesh([[0.0,0.0,0.0],[2.0,0.0,0.0],[0.0,2.0,0.0],
+                          [0.5,0.5,-1.0],[0.5,0.5,1.0],[1.5,0.5,0.0],
+                          [5.0,0.0,0.0],[6.0,0.0,0.0],[5.0,1.0,0.0]])
+        self.failUnless(mesh.hasSelfIntersections())
+        pairs = [tuple(sorted(p)) for p in mesh.getDefects()["SelfIntersections"]]
+        self.failUnless(pairs == [(0, 1)])
+
+    def testSphere(self):
+        sphere = Mesh.createSphere(5.0, 50)
+        self.failUnless(not sphere.hasSelfIntersections())
+        self.failUnless(len(sphere.getDefects()["SelfIntersections"]) == 0)
+
+        # a big triangle cuts the sphere near the equator, so it intersects
+        # exactly the facets crossing its plane
+        z = 0.123
+        index = sphere.CountFacets
+        crossing = []
+        for f in sphere.Facets:
+            h = [p[2] for p in f.Points]
+            if min(h) < z and max(h) > z:
+                crossing.append(f.Index)
+        sphere.addMesh(Mesh.Mesh([[-10.0,-10.0,z],[10.0,-10.0,z],[0.0,15.0,z]]))
+        self.failUnless(sphere.hasSelfIntersections())
+
+        pairs = sphere.getDefects()["SelfIntersections"]
+        facets = []
+        for p in pairs:
+            self.failUnless(index in p)
+            facets.append(p[0] + p[1] - index)
+        self.failUnless(sorted(facets) == sorted(crossing))
+
+class MeshBinaryPLYTestCases(unittest.TestCase):
+    def setUp(self):
+        self.name = tempfile.gettempdir() + os.sep + "binary.ply"
+
+    def testRoundTrip(self):
+        mesh = Mesh.createSphere(5.0, 30)
+        mesh.write(self.name)
+        self.failUnless(open(self.name, "rb").read(50).find("binary_little_endian") > 0)
+
+        other = Mesh.Mesh(self.name)
+        self.failUnless(other.CountPoints == mesh.CountPoints)
+        self.failUnless(other.CountFacets == mesh.CountFacets)
+        points1, facets1 = mesh.Topology
+        points2, facets2 = other.Topology
+        for i in range(len(points1)):
+            self.failUnless(points1[i] == points2[i])
+        self.failUnless(facets1 == facets2)
+
+    def testBigEndianDouble(self):
+        import struct
+        points = [(0.0,0.0,0.0),(1.0,0.0,0.0),(0.0,1.0,0.0),(0.0,0.0,1.0)]
+        facets = [(0,2,1),(0,1,3),(1,2,3),(0,3,2)]
+        data = open(self.name, "wb")
+        data.write("ply\nformat binary_big_endian 1.0\n")
+        data.write("element vertex 4\nproperty double x\nproperty double y\nproperty double z\n")
+        data.write("element face 4\nproperty list uchar uint vertex_indices\nend_header\n")
+        for p in points:
+            data.write(struct.pack(">3d", *p))
+        for f in facets:
+            data.write(struct.pack(">B3I", 3, *f))
+        data.close()
+
+        mesh = Mesh.Mesh(self.name)
+        self.failUnless(mesh.CountPoints == 4)
+        self.failUnless(mesh.CountFacets == 4)
+        points2, facets2 = mesh.Topology
+        for i in range(4):
+            self.failUnless(points2[i] == FreeCAD.Vector(points[i]))
+        self.failUnless(facets2 == facets)
+        self.failUnless(mesh.isSolid())
+
+    def tearDown(self):
+        if os.path.exists(self.name):
+            os.remove(self.name)
@@ -23,17 +23,24 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <Inventor/nodes/SoDirectionalLight.h>
+# include <Inventor/nodes/SoPerspectiveCamera.h>
+# include <Inventor/nodes/SoRotation.h>
+# include <Inventor/nodes/SoSeparator.h>
 #endif
 
 #include <Base/Interpreter.h>
 #include <Base/Console.h>
+#include <Base/TimeInfo.h>
 
 #include <Gui/Application.h>
 #include <Gui/BitmapFactory.h>
+#include <Gui/SoFCOffscreenRenderer.h>
 #include <Gui/WidgetFactory.h>
 #include <Gui/Language/Translator.h>
 
 #include <Mod/Mesh/App/MeshProperties.h>
+#include <Mod/Mesh/App/MeshPy.h>
 
 #include "images.h"
 #include "DlgEvaluateMeshImp.h"
@@ -62,8 +69,79 @@ void loadMeshResource()
     Gui::Translator::instance()->refresh();
 }
 
+static PyObject *
+renderBenchmark(PyObject *self, PyObject *args)
+{
+    PyObject *pcObj;
+    PyObject *retained=Py_True;
+    int frames=36, width=512, height=512;
+    if (!PyArg_ParseTuple(args, "O!|iO!ii", &(Mesh::MeshPy::Type), &pcObj, &frames,
+                                            &PyBool_Type, &retained, &width, &height))
+        return NULL;
+    if (frames < 1) {
+        PyErr_SetString(PyExc_ValueError, "number of frames must be positive");
+        return NULL;
+    }
+
+    PY_TRY {
+        const Mesh::MeshObject* mesh = static_cast<Mesh::MeshPy*>(pcObj)->getMeshObjectPtr();
+
+        SoSeparator* root = new SoSeparator();
+        root->ref();
+        SoPerspectiveCamera* cam = new SoPerspectiveCamera();
+        root->addChild(cam);
+        root->addChild(new SoDirectionalLight());
+        SoRotation* rot = new SoRotation();
+        root->addChild(rot);
+        MeshGui::SoFCMeshObjectNode* node = new MeshGui::SoFCMeshObjectNode();
+        node->mesh.setValue(mesh);
+        root->addChild(node);
+        MeshGui::SoFCMeshObjectShape* shape = new MeshGui::SoFCMeshObjectShape();
+        shape->retainedMode = PyObject_IsTrue(retained) ? true : false;
+        root->addChild(shape);
+
+        SbViewportRegion vp(width, height);
+        cam->viewAll(root, vp);
+        Gui::SoFCOffscreenRenderer& renderer = Gui::SoFCOffscreenRenderer::instance();
+        renderer.setViewportRegion(vp);
+
+        // The first frame additionally measures the creation of the vertex arrays
+        float first=0, total=0, minimum=0, maximum=0;
+        for (int i=0; i<=frames; i++) {
+            rot->rotation.setValue(SbVec3f(0,1,0), 6.2831853f*(float)i/(float)frames);
+            Base::TimeInfo start;
+            renderer.render(root);
+            float time = 1000.0f * Base::TimeInfo::diffTimeF(start, Base::TimeInfo());
+            if (i == 0) {
+                first = time;
+                continue;
+            }
+            total += time;
+            if (i == 1 || time < minimum)
+                minimum = time;
+            if (time > maximum)
+                maximum = time;
+        }
+        root->unref();
+
+        Py::Dict dict;
+        dict.setItem("first", Py::Float(first));
+        dict.setItem("average", Py::Float(total/(float)frames));
+        dict.setItem("minimum", Py::Float(minimum));
+        dict.setItem("maximum", Py::Float(maximum));
+        return Py::new_reference_to(dict);
+    } PY_CATCH;
+}
+
+PyDoc_STRVAR(renderBenchmark_doc,
+"renderBenchmark(Mesh,[frames=36,retained=True,width=512,height=512]) -> dict\n\n"
+"Renders the mesh offscreen while rotating it and returns the time of the first\n"
+"frame and the average, minimum and maximum time of the other frames in ms.\n"
+"With retained=False the mesh is rendered in immediate mode for comparison.");
+
 /* registration table  */
 static struct PyMethodDef MeshGui_methods[] = {
+    {"renderBenchmark",renderBenchmark, METH_VARARGS, renderBenchmark_doc},
     {NULL, NULL}                   /* end of table marker */
 };
 
@@ -404,36 +404,42 @@ void DlgEvaluateMeshImp::on_analyzeOrientationButton_clicked()
         const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
         MeshEvalOrientation eval(rMesh);
         std::vector<unsigned long> inds = eval.GetIndices();
-        if (inds.empty() && !eval.Evaluate()) {
-            checkOrientationButton->setText(tr("Flipped normals found"));
-            MeshEvalFoldOversOnSurface f_eval(rMesh);
-            if (!f_eval.Evaluate()) {
-                qApp->restoreOverrideCursor();
-                QMessageBox::warning(this, tr("Orientation"),
-                    tr("Check failed due to folds on the surface.\n"
-                    "Please run the command to repair folds first"));
-                qApp->setOverrideCursor(Qt::WaitCursor);
-            }
-        }
-        else if (inds.empty()) {
-            checkOrientationButton->setText( tr("No flipped normals") );
-            checkOrientationButton->setChecked(false);
-            repairOrientationButton->setEnabled(false);
-            removeViewProvider( "MeshGui::ViewProviderMeshOrientation" );
-        }
-        else {
-            checkOrientationButton->setText( tr("%1 flipped normals").arg(inds.size()) );
-            checkOrientationButton->setChecked(true);
-            repairOrientationButton->setEnabled(true);
-            repairAllTogether->setEnabled(true);
-            addViewProvider( "MeshGui::ViewProviderMeshOrientation", eval.GetIndices());
-        }
+        bool nonUniform = inds.empty() && !eval.Evaluate();
+        bool foldOvers = nonUniform && !MeshEvalFoldOversOnSurface(rMesh).Evaluate();
+        showOrientation(inds, nonUniform, foldOvers);
 
         qApp->restoreOverrideCursor();
         analyzeOrientationButton->setEnabled(true);
     }
 }
 
+void DlgEvaluateMeshImp::showOrientation(const std::vector<unsigned long>& inds, bool nonUniform, bool foldOvers)
+{
+    if (nonUniform) {
+        checkOrientationButton->setText(tr("Flipped normals found"));
+        if (foldOvers) {
+            qApp->restoreOverrideCursor();
+            QMessageBox::warning(this, tr("Orientation"),
+                tr("Check failed due to folds on the surface.\n"
+                "Please run the command to repair folds first"));
+            qApp->setOverrideCursor(Qt::WaitCursor);
+        }
+    }
+    else if (inds.empty()) {
+        checkOrientationButton->setText( tr("No flipped normals") );
+        checkOrientationButton->setChecked(false);
+        repairOrientationButton->setEnabled(false);
+        removeViewProvider( "MeshGui::ViewProviderMeshOrientation" );
+    }
+    else {
+        checkOrientationButton->setText( tr("%1 flipped normals").arg(inds.size()) );
+        checkOrientationButton->setChecked(true);
+        repairOrientationButton->setEnabled(true);
+        repairAllTogether->setEnabled(true);
+        addViewProvider( "MeshGui::ViewProviderMeshOrientation", inds);
+    }
+}
+
 void DlgEvaluateMeshImp::on_repairOrientationButton_clicked()
 {
     if (d->meshFeature) {
@@ -480,42 +486,46 @@ void DlgEvaluateMeshImp::on_analyzeNonmanifoldsButton_clicked()
         const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
         MeshEvalTopology f_eval(rMesh);
         MeshEvalPointManifolds p_eval(rMesh);
-        bool ok1 = f_eval.Evaluate();
-        bool ok2 = p_eval.Evaluate();
-    
-        if (ok1 && ok2) {
-            checkNonmanifoldsButton->setText(tr("No non-manifolds"));
-            checkNonmanifoldsButton->setChecked(false);
-            repairNonmanifoldsButton->setEnabled(false);
-            removeViewProvider("MeshGui::ViewProviderMeshNonManifolds");
-        }
-        else {
-            checkNonmanifoldsButton->setText(tr("%1 non-manifolds").arg(f_eval.CountManifolds()+p_eval.CountManifolds()));
-            checkNonmanifoldsButton->setChecked(true);
-            repairNonmanifoldsButton->setEnabled(true);
-            repairAllTogether->setEnabled(true);
-            if (!ok1) {
-                const std::vector<std::pair<unsigned long, unsigned long> >& inds = f_eval.GetIndices();
-                std::vector<unsigned long> indices;
-                indices.reserve(2*inds.size());
-                std::vector<std::pair<unsigned long, unsigned long> >::const_iterator it;
-                for (it = inds.begin(); it != inds.end(); ++it) {
-                    indices.push_back(it->first);
-                    indices.push_back(it->second);
-                }
-
-                addViewProvider("MeshGui::ViewProviderMeshNonManifolds", indices);
-            }
-            if (!ok2) {
-                addViewProvider("MeshGui::ViewProviderMeshNonManifoldPoints", p_eval.GetIndices());
-            }
-        }
+        f_eval.Evaluate();
+        p_eval.Evaluate();
+        showNonManifolds(f_eval.GetIndices(), p_eval.GetIndices());
 
         qApp->restoreOverrideCursor();
         analyzeNonmanifoldsButton->setEnabled(true);
     }
 }
 
+void DlgEvaluateMeshImp::showNonManifolds(const std::vector<std::pair<unsigned long, unsigned long> >& edges,
+                                          const std::vector<unsigned long>& points)
+{
+    if (edges.empty() && points.empty()) {
+        checkNonmanifoldsButton->setText(tr("No non-manifolds"));
+        checkNonmanifoldsButton->setChecked(false);
+        repairNonmanifoldsButton->setEnabled(false);
+        removeViewProvider("MeshGui::ViewProviderMeshNonManifolds");
+    }
+    else {
+        checkNonmanifoldsButton->setText(tr("%1 non-manifolds").arg(edges.size()+points.size()));
+        checkNonmanifoldsButton->setChecked(true);
+        repairNonmanifoldsButton->setEnabled(true);
+        repairAllTogether->setEnabled(true);
+        if (!edges.empty()) {
+            std::vector<unsigned long> indices;
+            indices.reserve(2*edges.size());
+            std::vector<std::pair<unsigned long, unsigned long> >::const_iterator it;
+            for (it = edges.begin(); it != edges.end(); ++it) {
+                indices.push_back(it->first);
+                indices.push_back(it->second);
+            }
+
+            addViewProvider("MeshGui::ViewProviderMeshNonManifolds", indices);
+        }
+        if (!points.empty()) {
+            addViewProvider("MeshGui::ViewProviderMeshNonManifoldPoints", points);
+        }
+    }
+}
+
 void DlgEvaluateMeshImp::on_repairNonmanifoldsButton_clicked()
 {
     if (d->meshFeature) {
@@ -567,47 +577,65 @@ void DlgEvaluateMeshImp::on_analyzeIndicesButton_clicked()
         MeshEvalRangePoint rp(rMesh);
         MeshEvalCorruptedFacets cf(rMesh);
         MeshEvalNeighbourhood nb(rMesh);
-        
-        if (!rf.Evaluate()) {
-            checkIndicesButton->setText(tr("Invalid face indices"));
-            checkIndicesButton->setChecked(true);
-            repairIndicesButton->setEnabled(true);
-            repairAllTogether->setEnabled(true);
-            addViewProvider("MeshGui::ViewProviderMeshIndices", rf.GetIndices());
-        }
-        else if (!rp.Evaluate()) {
-            checkIndicesButton->setText(tr("Invalid point indices"));
-            checkIndicesButton->setChecked(true);
-            repairIndicesButton->setEnabled(true);
-            repairAllTogether->setEnabled(true);
-            //addViewProvider("MeshGui::ViewProviderMeshIndices", rp.GetIndices());
-        }
-        else if (!cf.Evaluate()) {
-            checkIndicesButton->setText(tr("Multiple point indices"));
-            checkIndicesButton->setChecked(true);
-            repairIndicesButton->setEnabled(true);
-            repairAllTogether->setEnabled(true);
-            addViewProvider("MeshGui::ViewProviderMeshIndices", cf.GetIndices());
-        }
-        else if (!nb.Evaluate()) {
-            checkIndicesButton->setText(tr("Invalid neighbour indices"));
-            checkIndicesButton->setChecked(true);
-            repairIndicesButton->setEnabled(true);
-            repairAllTogether->setEnabled(true);
-            addViewProvider("MeshGui::ViewProviderMeshIndices", nb.GetIndices());
-        }
-        else {
-            checkIndicesButton->setText(tr("No invalid indices"));
-            checkIndicesButton->setChecked(false);
-            repairIndicesButton->setEnabled(false);
-            removeViewProvider("MeshGui::ViewProviderMeshIndices");
-        }
+
+        // only the first found kind of error is shown
+        std::vector<unsigned long> rf_inds, rp_inds, cf_inds, nb_inds;
+        if (!rf.Evaluate())
+            rf_inds = rf.GetIndices();
+        else if (!rp.Evaluate())
+            rp_inds = rp.GetIndices();
+        else if (!cf.Evaluate())
+            cf_inds = cf.GetIndices();
+        else if (!nb.Evaluate())
+            nb_inds = nb.GetIndices();
+        showIndices(rf_inds, rp_inds, cf_inds, nb_inds);
 
         qApp->restoreOverrideCursor();
         analyzeIndicesButton->setEnabled(true);
     }
 }
 
+void DlgEvaluateMeshImp::showIndices(const std::vector<unsigned long>& rangeFacets,
+                                     const std::vector<unsigned long>& rangePoints,
+                                     const std::vector<unsigned long>& corruptedFacets,
+                                     const std::vector<unsigned long>& neighbours)
+{
+    if (!rangeFacets.empty()) {
+        checkIndicesButton->setText(tr("Invalid face indices"));
+        checkIndicesButton->setChecked(true);
+        repairIndicesButton->setEnabled(true);
+        repairAllTogether->setEnabled(true);
+        addViewProvider("MeshGui::ViewProviderMeshIndices", rangeFacets);
+    }
+    else if (!rangePoints.empty()) {
+        checkIndicesButton->setText(tr("Invalid point indices"));
+        checkIndicesButton->setChecked(true);
+        repairIndicesButton->setEnabled(true);
+        repairAllTogether->setEnabled(true);
+        //addViewProvider("MeshGui::ViewProviderMeshIndices", rangePoints);
+    }
+    else if (!corruptedFacets.empty()) {
+        checkIndicesButton->setText(tr("Multiple point indices"));
+        checkIndicesButton->setChecked(true);
+        repairIndicesButton->setEnabled(true);
+        repairAllTogether->setEnabled(true);
+        addViewProvider("MeshGui::ViewProviderMeshIndices", corruptedFacets);
+    }
+    else if (!neighbours.empty()) {
+        checkIndicesButton->setText(tr("Invalid neighbour indices"));
+        checkIndicesButton->setChecked(true);
+        repairIndicesButton->setEnabled(true);
+        repairAllTogether->setEnabled(true);
+        addViewProvider("MeshGui::ViewProviderMeshIndices", neighbours);
+    }
+    else {
+        checkIndicesButton->setText(tr("No invalid indices"));
+        checkIndicesButton->setChecked(false);
+        repairIndicesButton->setEnabled(false);
+        removeViewProvider("MeshGui::ViewProviderMeshIndices");
+    }
+}
+
 void DlgEvaluateMeshImp::on_repairIndicesButton_clicked()
 {
     if (d->meshFeature) {
@@ -653,27 +681,30 @@ void DlgEvaluateMeshImp::on_analyzeDegeneratedButton_clicked()
 
         const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
         MeshEvalDegeneratedFacets eval(rMesh);
-        std::vector<unsigned long> degen = eval.GetIndices();
-        
-        if (degen.empty()) {
-            checkDegenerationButton->setText(tr("No degenerations"));
-            checkDegenerationButton->setChecked(false);
-            repairDegeneratedButton->setEnabled(false);
-            removeViewProvider("MeshGui::ViewProviderMeshDegenerations");
-        }
-        else {
-            checkDegenerationButton->setText(tr("%1 degenerated faces").arg(degen.size()));
-            checkDegenerationButton->setChecked(true);
-            repairDegeneratedButton->setEnabled(true);
-            repairAllTogether->setEnabled(true);
-            addViewProvider("MeshGui::ViewProviderMeshDegenerations", degen);
-        }
+        showDegenerations(eval.GetIndices());
 
         qApp->restoreOverrideCursor();
         analyzeDegeneratedButton->setEnabled(true);
     }
 }
 
+void DlgEvaluateMeshImp::showDegenerations(const std::vector<unsigned long>& degen)
+{
+    if (degen.empty()) {
+        checkDegenerationButton->setText(tr("No degenerations"));
+        checkDegenerationButton->setChecked(false);
+        repairDegeneratedButton->setEnabled(false);
+        removeViewProvider("MeshGui::ViewProviderMeshDegenerations");
+    }
+    else {
+        checkDegenerationButton->setText(tr("%1 degenerated faces").arg(degen.size()));
+        checkDegenerationButton->setChecked(true);
+        repairDegeneratedButton->setEnabled(true);
+        repairAllTogether->setEnabled(true);
+        addViewProvider("MeshGui::ViewProviderMeshDegenerations", degen);
+    }
+}
+
 void DlgEvaluateMeshImp::on_repairDegeneratedButton_clicked()
 {
     if (d->meshFeature) {
@@ -719,28 +750,31 @@ void DlgEvaluateMeshImp::on_analyzeDuplicatedFacesButton_clicked()
 
         const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
         MeshEvalDuplicateFacets eval(rMesh);
-        std::vector<unsigned long> dupl = eval.GetIndices();
-    
-        if (dupl.empty()) {
-            checkDuplicatedFacesButton->setText(tr("No duplicated faces"));
-            checkDuplicatedFacesButton->setChecked(false);
-            repairDuplicatedFacesButton->setEnabled(false);
-            removeViewProvider("MeshGui::ViewProviderMeshDuplicatedFaces");
-        }
-        else {
-            checkDuplicatedFacesButton->setText(tr("%1 duplicated faces").arg(dupl.size()));
-            checkDuplicatedFacesButton->setChecked(true);
-            repairDuplicatedFacesButton->setEnabled(true);
-            repairAllTogether->setEnabled(true);
-
-            addViewProvider("MeshGui::ViewProviderMeshDuplicatedFaces", dupl);
-        }
+        showDuplicatedFaces(eval.GetIndices());
 
         qApp->restoreOverrideCursor();
         analyzeDuplicatedFacesButton->setEnabled(true);
     }
 }
 
+void DlgEvaluateMeshImp::showDuplicatedFaces(const std::vector<unsigned long>& dupl)
+{
+    if (dupl.empty()) {
+        checkDuplicatedFacesButton->setText(tr("No duplicated faces"));
+        checkDuplicatedFacesButton->setChecked(false);
+        repairDuplicatedFacesButton->setEnabled(false);
+        removeViewProvider("MeshGui::ViewProviderMeshDuplicatedFaces");
+    }
+    else {
+        checkDuplicatedFacesButton->setText(tr("%1 duplicated faces").arg(dupl.size()));
+        checkDuplicatedFacesButton->setChecked(true);
+        repairDuplicatedFacesButton->setEnabled(true);
+        repairAllTogether->setEnabled(true);
+
+        addViewProvider("MeshGui::ViewProviderMeshDuplicatedFaces", dupl);
+    }
+}
+
 void DlgEvaluateMeshImp::on_repairDuplicatedFacesButton_clicked()
 {
     if (d->meshFeature) {
@@ -786,26 +820,30 @@ void DlgEvaluateMeshImp::on_analyzeDuplicatedPointsButton_clicked()
 
         const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
         MeshEvalDuplicatePoints eval(rMesh);
-    
-        if (eval.Evaluate()) {
-            checkDuplicatedPointsButton->setText(tr("No duplicated points"));
-            checkDuplicatedPointsButton->setChecked(false);
-            repairDuplicatedPointsButton->setEnabled(false);
-            removeViewProvider("MeshGui::ViewProviderMeshDuplicatedPoints");
-        }
-        else {
-            checkDuplicatedPointsButton->setText(tr("Duplicated points"));
-            checkDuplicatedPointsButton->setChecked(true);
-            repairDuplicatedPointsButton->setEnabled(true);
-            repairAllTogether->setEnabled(true);
-            addViewProvider("MeshGui::ViewProviderMeshDuplicatedPoints", eval.GetIndices());
-        }
+        showDuplicatedPoints(eval.GetIndices());
 
         qApp->restoreOverrideCursor();
         analyzeDuplicatedPointsButton->setEnabled(true);
     }
 }
 
+void DlgEvaluateMeshImp::showDuplicatedPoints(const std::vector<unsigned long>& dupl)
+{
+    if (dupl.empty()) {
+        checkDuplicatedPointsButton->setText(tr("No duplicated points"));
+        checkDuplicatedPointsButton->setChecked(false);
+        repairDuplicatedPointsButton->setEnabled(false);
+        removeViewProvider("MeshGui::ViewProviderMeshDuplicatedPoints");
+    }
+    else {
+        checkDuplicatedPointsButton->setText(tr("Duplicated points"));
+        checkDuplicatedPointsButton->setChecked(true);
+        repairDuplicatedPointsButton->setEnabled(true);
+        repairAllTogether->setEnabled(true);
+        addViewProvider("MeshGui::ViewProviderMeshDuplicatedPoints", dupl);
+    }
+}
+
 void DlgEvaluateMeshImp::on_repairDuplicatedPointsButton_clicked()
 {
     if (d->meshFeature) {
@@ -859,34 +897,39 @@ void DlgEvaluateMeshImp::on_analyzeSelfIntersectionButton_clicked()
             Base::Console().Message("The self-intersection analyse was aborted by the user\n");
         }
 
-        if (intersection.empty()) {
-            checkSelfIntersectionButton->setText(tr("No self-intersections"));
-            checkSelfIntersectionButton->setChecked(false);
-            repairSelfIntersectionButton->setEnabled(false);
-            removeViewProvider("MeshGui::ViewProviderMeshSelfIntersections");
-        }
-        else {
-            checkSelfIntersectionButton->setText(tr("Self-intersections"));
-            checkSelfIntersectionButton->setChecked(true);
-            repairSelfIntersectionButton->setEnabled(true);
-            repairAllTogether->setEnabled(true);
-            std::vector<unsigned long> indices;
-            indices.reserve(2*intersection.size());
-            std::vector<std::pair<unsigned long, unsigned long> >::iterator it;
-            for (it = intersection.begin(); it != intersection.end(); ++it) {
-                indices.push_back(it->first);
-                indices.push_back(it->second);
-            }
-
-            addViewProvider("MeshGui::ViewProviderMeshSelfIntersections", indices);
-            d->self_intersections.swap(indices);
-        }
+        showSelfIntersections(intersection);
 
         qApp->restoreOverrideCursor();
         analyzeSelfIntersectionButton->setEnabled(true);
     }
 }
 
+void DlgEvaluateMeshImp::showSelfIntersections(const std::vector<std::pair<unsigned long, unsigned long> >& intersection)
+{
+    if (intersection.empty()) {
+        checkSelfIntersectionButton->setText(tr("No self-intersections"));
+        checkSelfIntersectionButton->setChecked(false);
+        repairSelfIntersectionButton->setEnabled(false);
+        removeViewProvider("MeshGui::ViewProviderMeshSelfIntersections");
+    }
+    else {
+        checkSelfIntersectionButton->setText(tr("Self-intersections"));
+        checkSelfIntersectionButton->setChecked(true);
+        repairSelfIntersectionButton->setEnabled(true);
+        repairAllTogether->setEnabled(true);
+        std::vector<unsigned long> indices;
+        indices.reserve(2*intersection.size());
+        std::vector<std::pair<unsigned long, unsigned long> >::const_iterator it;
+        for (it = intersection.begin(); it != intersection.end(); ++it) {
+            indices.push_back(it->first);
+            indices.push_back(it->second);
+        }
+
+        addViewProvider("MeshGui::ViewProviderMeshSelfIntersections", indices);
+        d->self_intersections.swap(indices);
+    }
+}
+
 void DlgEvaluateMeshImp::on_repairSelfIntersectionButton_clicked()
 {
     if (d->meshFeature) {
@@ -942,39 +985,43 @@ void DlgEvaluateMeshImp::on_analyzeFoldsButton_clicked()
         MeshEvalFoldsOnSurface s_eval(rMesh);
         MeshEvalFoldsOnBoundary b_eval(rMesh);
         MeshEvalFoldOversOnSurface f_eval(rMesh);
-        bool ok1 = s_eval.Evaluate();
-        bool ok2 = b_eval.Evaluate();
-        bool ok3 = f_eval.Evaluate();
-    
-        if (ok1 && ok2 && ok3) {
-            checkFoldsButton->setText(tr("No folds on surface"));
-            checkFoldsButton->setChecked(false);
-            repairFoldsButton->setEnabled(false);
-            removeViewProvider("MeshGui::ViewProviderMeshFolds");
-        }
-        else {
-            std::vector<unsigned long> inds  = f_eval.GetIndices();
-            std::vector<unsigned long> inds1 = s_eval.GetIndices();
-            std::vector<unsigned long> inds2 = b_eval.GetIndices();
-            inds.insert(inds.end(), inds1.begin(), inds1.end());
-            inds.insert(inds.end(), inds2.begin(), inds2.end());
-
-            // remove duplicates
-            std::sort(inds.begin(), inds.end());
-            inds.erase(std::unique(inds.begin(), inds.end()), inds.end());
-            
-            checkFoldsButton->setText(tr("%1 folds on surface").arg(inds.size()));
-            checkFoldsButton->setChecked(true);
-            repairFoldsButton->setEnabled(true);
-            repairAllTogether->setEnabled(true);
-            addViewProvider("MeshGui::ViewProviderMeshFolds", inds);
-        }
+        s_eval.Evaluate();
+        b_eval.Evaluate();
+        f_eval.Evaluate();
+        showFolds(s_eval.GetIndices(), b_eval.GetIndices(), f_eval.GetIndices());
 
         qApp->restoreOverrideCursor();
         analyzeFoldsButton->setEnabled(true);
     }
 }
 
+void DlgEvaluateMeshImp::showFolds(const std::vector<unsigned long>& onSurface,
+                                   const std::vector<unsigned long>& onBoundary,
+                                   const std::vector<unsigned long>& foldOvers)
+{
+    if (onSurface.empty() && onBoundary.empty() && foldOvers.empty()) {
+        checkFoldsButton->setText(tr("No folds on surface"));
+        checkFoldsButton->setChecked(false);
+        repairFoldsButton->setEnabled(false);
+        removeViewProvider("MeshGui::ViewProviderMeshFolds");
+    }
+    else {
+        std::vector<unsigned long> inds = foldOvers;
+        inds.insert(inds.end(), onSurface.begin(), onSurface.end());
+        inds.insert(inds.end(), onBoundary.begin(), onBoundary.end());
+
+        // remove duplicates
+        std::sort(inds.begin(), inds.end());
+        inds.erase(std::unique(inds.begin(), inds.end()), inds.end());
+        
+        checkFoldsButton->setText(tr("%1 folds on surface").arg(inds.size()));
+        checkFoldsButton->setChecked(true);
+        repairFoldsButton->setEnabled(true);
+        repairAllTogether->setEnabled(true);
+        addViewProvider("MeshGui::ViewProviderMeshFolds", inds);
+    }
+}
+
 void DlgEvaluateMeshImp::on_repairFoldsButton_clicked()
 {
     if (d->meshFeature) {
@@ -1004,14 +1051,31 @@ void DlgEvaluateMeshImp::on_repairFoldsButton_clicked()
 
 void DlgEvaluateMeshImp::on_analyzeAllTogether_clicked()
 {
-    on_analyzeOrientationButton_clicked();
-    on_analyzeDuplicatedFacesButton_clicked();
-    on_analyzeDuplicatedPointsButton_clicked();
-    on_analyzeNonmanifoldsButton_clicked();
-    on_analyzeDegeneratedButton_clicked();
-    on_analyzeIndicesButton_clicked();
-    on_analyzeSelfIntersectionButton_clicked();
-    on_analyzeFoldsButton_clicked();
+    if (d->meshFeature) {
+        analyzeAllTogether->setEnabled(false);
+        qApp->processEvents();
+        qApp->setOverrideCursor(Qt::WaitCursor);
+
+        // run all checks at once
+        const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
+        MeshEvalAll eval(rMesh);
+        eval.Evaluate();
+        const MeshDefectReport& report = eval.GetReport();
+
+        showOrientation(report.flippedFacets, report.nonUniformOrientation,
+                        report.nonUniformOrientation && !report.foldOversOnSurface.empty());
+        showDuplicatedFaces(report.duplicatedFacets);
+        showDuplicatedPoints(report.duplicatedPoints);
+        showNonManifolds(report.nonManifoldEdges, report.nonManifoldPoints);
+        showDegenerations(report.degeneratedFacets);
+        showIndices(report.invalidFacetIndices, report.invalidPointIndices,
+                    report.corruptedFacets, report.invalidNeighbours);
+        showSelfIntersections(report.selfIntersections);
+        showFolds(report.foldsOnSurface, report.foldsOnBoundary, report.foldOversOnSurface);
+
+        qApp->restoreOverrideCursor();
+        analyzeAllTogether->setEnabled(true);
+    }
 }
 
 void DlgEvaluateMeshImp::on_repairAllTogether_clicked()
@@ -1026,11 +1090,12 @@ void DlgEvaluateMeshImp::on_repairAllTogether_clicked()
         bool run = false;
         bool self = true;
         int max_iter=10;
-        const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
         try {
             do {
                 run = false;
                 {
+                    // get the kernel each time because a repair may replace the mesh object
+                    const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
                     MeshEvalSelfIntersection eval(rMesh);
                     if (self && !eval.Evaluate()) {
                         Gui::Application::Instance->runCommand(true,
@@ -1044,6 +1109,7 @@ void DlgEvaluateMeshImp::on_repairAllTogether_clicked()
                     qApp->processEvents();
                 }
                 {
+                    const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
                     MeshEvalFoldsOnSurface s_eval(rMesh);
                     MeshEvalFoldsOnBoundary b_eval(rMesh);
                     MeshEvalFoldOversOnSurface f_eval(rMesh);
@@ -1056,6 +1122,7 @@ void DlgEvaluateMeshImp::on_repairAllTogether_clicked()
                     qApp->processEvents();
                 }
                 {
+                    const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
                     MeshEvalOrientation eval(rMesh);
                     if (!eval.Evaluate()) {
                         Gui::Application::Instance->runCommand(true,
@@ -1066,6 +1133,7 @@ void DlgEvaluateMeshImp::on_repairAllTogether_clicked()
                     qApp->processEvents();
                 }
                 {
+                    const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
                     MeshEvalTopology eval(rMesh);
                     if (!eval.Evaluate()) {
                         Gui::Application::Instance->runCommand(true,
@@ -1076,6 +1144,7 @@ void DlgEvaluateMeshImp::on_repairAllTogether_clicked()
                     qApp->processEvents();
                 }
                 {
+                    const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
                     MeshEvalRangeFacet rf(rMesh);
                     MeshEvalRangePoint rp(rMesh);
                     MeshEvalCorruptedFacets cf(rMesh);
@@ -1088,6 +1157,7 @@ void DlgEvaluateMeshImp::on_repairAllTogether_clicked()
                     }
                 }
                 {
+                    const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
                     MeshEvalDegeneratedFacets eval(rMesh);
                     if (!eval.Evaluate()) {
                         Gui::Application::Instance->runCommand(true,
@@ -1098,6 +1168,7 @@ void DlgEvaluateMeshImp::on_repairAllTogether_clicked()
                     qApp->processEvents();
                 }
                 {
+                    const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
                     MeshEvalDuplicateFacets eval(rMesh);
                     if (!eval.Evaluate()) {
                         Gui::Application::Instance->runCommand(true,
@@ -1108,6 +1179,7 @@ void DlgEvaluateMeshImp::on_repairAllTogether_clicked()
                     qApp->processEvents();
                 }
                 {
+                    const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
                     MeshEvalDuplicatePoints eval(rMesh);
                     if (!eval.Evaluate()) {
                         Gui::Application::Instance->runCommand(true,
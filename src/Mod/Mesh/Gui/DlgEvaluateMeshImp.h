@@ -131,6 +131,21 @@ protected:
     void removeViewProviders();
     void changeEvent(QEvent *e);
 
+    void showOrientation(const std::vector<unsigned long>& inds, bool nonUniform, bool foldOvers);
+    void showNonManifolds(const std::vector<std::pair<unsigned long, unsigned long> >& edges,
+                          const std::vector<unsigned long>& points);
+    void showIndices(const std::vector<unsigned long>& rangeFacets,
+                     const std::vector<unsigned long>& rangePoints,
+                     const std::vector<unsigned long>& corruptedFacets,
+                     const std::vector<unsigned long>& neighbours);
+    void showDegenerations(const std::vector<unsigned long>& degen);
+    void showDuplicatedFaces(const std::vector<unsigned long>& dupl);
+    void showDuplicatedPoints(const std::vector<unsigned long>& dupl);
+    void showSelfIntersections(const std::vector<std::pair<unsigned long, unsigned long> >& intersection);
+    void showFolds(const std::vector<unsigned long>& onSurface,
+                   const std::vector<unsigned long>& onBoundary,
+                   const std::vector<unsigned long>& foldOvers);
+
 private:
     class Private;
     Private* d;
@@ -0,0 +1,233 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+#endif
+
+#include "MeshLevelOfDetail.h"
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+
+using namespace MeshGui;
+
+namespace MeshGui {
+// Interleaves the lower ten bits of v with two zero bits each
+static unsigned long spreadBits(unsigned long v)
+{
+    v = (v | (v << 16)) & 0x030000FF;
+    v = (v | (v <<  8)) & 0x0300F00F;
+    v = (v | (v <<  4)) & 0x030C30C3;
+    v = (v | (v <<  2)) & 0x09249249;
+    return v;
+}
+
+struct LevelTriangle
+{
+    unsigned long p[3];
+    bool operator < (const LevelTriangle& t) const
+    {
+        if (p[0] != t.p[0])
+            return p[0] < t.p[0];
+        if (p[1] != t.p[1])
+            return p[1] < t.p[1];
+        return p[2] < t.p[2];
+    }
+    bool operator == (const LevelTriangle& t) const
+    {
+        return p[0] == t.p[0] && p[1] == t.p[1] && p[2] == t.p[2];
+    }
+};
+}
+
+MeshLevelOfDetail::MeshLevelOfDetail()
+{
+}
+
+MeshLevelOfDetail::~MeshLevelOfDetail()
+{
+}
+
+void MeshLevelOfDetail::clear()
+{
+    levels.clear();
+    bbox = Base::BoundBox3f();
+}
+
+void MeshLevelOfDetail::build(const MeshCore::MeshKernel& kernel, bool ccw, unsigned long maxTriangles)
+{
+    clear();
+
+    const MeshCore::MeshPointArray& rPoints = kernel.GetPoints();
+    const MeshCore::MeshFacetArray& rFacets = kernel.GetFacets();
+    bbox = kernel.GetBoundBox();
+    float length = std::max<float>(bbox.LengthX(), std::max<float>(bbox.LengthY(), bbox.LengthZ()));
+    if (rFacets.empty() || length <= 0.0f)
+        return;
+
+    // octree code of the finest cell of each vertex
+    const int depth = 10;
+    const unsigned long cells = 1 << depth;
+    float scale = (float)cells / length;
+    std::vector<unsigned long> codes(rPoints.size());
+    std::vector<Base::Vector3f> sums(rPoints.size());
+    std::vector<unsigned long> weights(rPoints.size(), 1);
+    for (std::size_t i=0; i<rPoints.size(); i++) {
+        const MeshCore::MeshPoint& p = rPoints[i];
+        unsigned long x = std::min<unsigned long>(cells-1, (unsigned long)((p.x-bbox.MinX)*scale));
+        unsigned long y = std::min<unsigned long>(cells-1, (unsigned long)((p.y-bbox.MinY)*scale));
+        unsigned long z = std::min<unsigned long>(cells-1, (unsigned long)((p.z-bbox.MinZ)*scale));
+        codes[i] = spreadBits(x) | (spreadBits(y) << 1) | (spreadBits(z) << 2);
+        sums[i] = p;
+    }
+
+    std::vector<unsigned long> indices;
+    indices.reserve(3*rFacets.size());
+    for (MeshCore::MeshFacetArray::_TConstIterator it = rFacets.begin(); it != rFacets.end(); ++it) {
+        indices.push_back(it->_aulPoints[0]);
+        indices.push_back(it->_aulPoints[1]);
+        indices.push_back(it->_aulPoints[2]);
+    }
+
+    std::vector<std::pair<unsigned long, unsigned long> > keys;
+    std::vector<unsigned long> remap;
+    std::vector<unsigned long> newCodes, newWeights;
+    std::vector<Base::Vector3f> newSums, points;
+    std::vector<LevelTriangle> triangles;
+
+    int shift = 0;
+    for (int d = depth; d > 0; d--) {
+        // cluster the vertices of the finer level in the cells at depth d
+        keys.resize(codes.size());
+        for (std::size_t i=0; i<codes.size(); i++)
+            keys[i] = std::make_pair(codes[i] >> shift, (unsigned long)i);
+        std::sort(keys.begin(), keys.end());
+
+        remap.resize(codes.size());
+        newCodes.clear();
+        newSums.clear();
+        newWeights.clear();
+        for (std::size_t k=0; k<keys.size(); k++) {
+            if (k == 0 || keys[k].first != keys[k-1].first) {
+                newCodes.push_back(keys[k].first);
+                newSums.push_back(Base::Vector3f(0.0f, 0.0f, 0.0f));
+                newWeights.push_back(0);
+            }
+            unsigned long v = keys[k].second;
+            remap[v] = newCodes.size() - 1;
+            newSums.back() += sums[v];
+            newWeights.back() += weights[v];
+        }
+
+        // keep the triangles whose corners lie in three different cells
+        triangles.clear();
+        for (std::size_t t=0; t<indices.size(); t+=3) {
+            unsigned long a = remap[indices[t]];
+            unsigned long b = remap[indices[t+1]];
+            unsigned long c = remap[indices[t+2]];
+            if (a == b || b == c || c == a)
+                continue;
+            // start with the lowest index to keep the orientation
+            LevelTriangle tri;
+            if (a < b && a < c) {
+                tri.p[0] = a; tri.p[1] = b; tri.p[2] = c;
+            }
+            else if (b < c) {
+                tri.p[0] = b; tri.p[1] = c; tri.p[2] = a;
+            }
+            else {
+                tri.p[0] = c; tri.p[1] = a; tri.p[2] = b;
+            }
+            triangles.push_back(tri);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        triangles.erase(std::unique(triangles.begin(), triangles.end()), triangles.end());
+
+        indices.resize(3*triangles.size());
+        for (std::size_t t=0; t<triangles.size(); t++) {
+            indices[3*t  ] = triangles[t].p[0];
+            indices[3*t+1] = triangles[t].p[1];
+            indices[3*t+2] = triangles[t].p[2];
+        }
+
+        codes.swap(newCodes);
+        sums.swap(newSums);
+        weights.swap(newWeights);
+        shift = 3;
+
+        if (!triangles.empty() && triangles.size() <= maxTriangles) {
+            points.resize(sums.size());
+            for (std::size_t i=0; i<sums.size(); i++)
+                points[i] = sums[i] * (1.0f / (float)weights[i]);
+            addLevel(length / (float)(1 << d), points, indices, ccw);
+        }
+
+        // a coarser level would hardly show the shape any more
+        if (triangles.size() < 100)
+            break;
+    }
+}
+
+void MeshLevelOfDetail::addLevel(float cellSize, const std::vector<Base::Vector3f>& points,
+                                 const std::vector<unsigned long>& indices, bool ccw)
+{
+    levels.push_back(Level());
+    Level& level = levels.back();
+    level.cellSize = cellSize;
+    level.count = (int)indices.size();
+    level.array.resize(6*indices.size());
+    if (indices.empty())
+        return;
+
+    float sign = ccw ? 1.0f : -1.0f;
+    float* data = &(level.array[0]);
+    for (std::size_t i=0; i<indices.size(); i+=3) {
+        const Base::Vector3f& v0 = points[indices[i]];
+        const Base::Vector3f& v1 = points[indices[i+1]];
+        const Base::Vector3f& v2 = points[indices[i+2]];
+        Base::Vector3f n = ((v1-v0) % (v2-v0)) * sign;
+        for (int j=0; j<3; j++) {
+            const Base::Vector3f& v = points[indices[i+j]];
+            *data++ = n.x;
+            *data++ = n.y;
+            *data++ = n.z;
+            *data++ = v.x;
+            *data++ = v.y;
+            *data++ = v.z;
+        }
+    }
+}
+
+const MeshLevelOfDetail::Level* MeshLevelOfDetail::select(float maxCellSize, unsigned long maxTriangles) const
+{
+    const Level* level = 0;
+    for (std::vector<Level>::const_reverse_iterator it = levels.rbegin(); it != levels.rend(); ++it) {
+        if ((unsigned long)it->count > 3*maxTriangles && level)
+            break;
+        level = &(*it);
+        if (it->cellSize <= maxCellSize)
+            break;
+    }
+    return level;
+}
@@ -0,0 +1,85 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef MESHGUI_MESHLEVELOFDETAIL_H
+#define MESHGUI_MESHLEVELOFDETAIL_H
+
+#include <vector>
+#include <Base/BoundBox.h>
+
+namespace MeshCore {
+class MeshKernel;
+}
+
+namespace MeshGui {
+
+/**
+ * The MeshLevelOfDetail class holds a hierarchy of simplified versions of a mesh
+ * which are used to render huge meshes while navigating. The vertices of the mesh
+ * are clustered in the cells of an octree and replaced by their average, triangles
+ * collapsing this way are dropped. Each level clusters the vertices of the next
+ * finer level, so the cell size doubles from level to level.
+ */
+class MeshGuiExport MeshLevelOfDetail
+{
+public:
+    struct Level {
+        /// edge length of the octree cells
+        float cellSize;
+        /// interleaved normal and position of each triangle corner
+        std::vector<float> array;
+        /// number of triangle corners
+        int count;
+    };
+
+    MeshLevelOfDetail();
+    ~MeshLevelOfDetail();
+
+    /** Creates the levels for \a kernel. Only levels with at most \a maxTriangles
+     * triangles are kept. \a ccw specifies the vertex ordering of the triangles
+     * which determines the direction of the normals.
+     */
+    void build(const MeshCore::MeshKernel& kernel, bool ccw, unsigned long maxTriangles);
+    void clear();
+    bool empty() const
+    { return levels.empty(); }
+    const Base::BoundBox3f& getBoundBox() const
+    { return bbox; }
+    /** Returns the coarsest level whose cells are not bigger than \a maxCellSize.
+     * If this level has more than \a maxTriangles triangles the finest level
+     * within this limit is returned instead.
+     */
+    const Level* select(float maxCellSize, unsigned long maxTriangles) const;
+
+private:
+    void addLevel(float cellSize, const std::vector<Base::Vector3f>&,
+                  const std::vector<unsigned long>&, bool ccw);
+
+private:
+    std::vector<Level> levels; // from fine to coarse
+    Base::BoundBox3f bbox;
+};
+
+} // namespace MeshGui
+
+
+#endif // MESHGUI_MESHLEVELOFDETAIL_H
@@ -42,10 +42,18 @@
 # include <Inventor/actions/SoPickAction.h>
 # include <Inventor/actions/SoWriteAction.h>
 # include <Inventor/details/SoFaceDetail.h>
+# include <Inventor/elements/SoModelMatrixElement.h>
+# include <Inventor/elements/SoViewportRegionElement.h>
+# include <Inventor/elements/SoViewVolumeElement.h>
 # include <Inventor/errors/SoReadError.h>
 # include <Inventor/misc/SoState.h>
 #endif
 
+#include <Inventor/C/glue/gl.h>
+#include <Inventor/elements/SoGLCacheContextElement.h>
+#include <QtConcurrentRun>
+#include <boost/bind.hpp>
+
 #include "SoFCMeshObject.h"
 #include <Base/Console.h>
 #include <Base/Exception.h>
@@ -57,6 +65,13 @@
 #include <Mod/Mesh/App/Core/Elements.h>
 #include <Mod/Mesh/App/Core/Grid.h>
 
+#ifndef GL_ARRAY_BUFFER
+# define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_STATIC_DRAW
+# define GL_STATIC_DRAW 0x88E4
+#endif
+
 using namespace MeshGui;
 
 
@@ -588,12 +603,19 @@ void SoFCMeshObjectShape::initClass()
     SO_NODE_INIT_CLASS(SoFCMeshObjectShape, SoShape, "Shape");
 }
 
-SoFCMeshObjectShape::SoFCMeshObjectShape() : renderTriangleLimit(100000), meshChanged(true)
+SoFCMeshObjectShape::SoFCMeshObjectShape()
+  : renderTriangleLimit(100000), retainedMode(true), maxScreenError(2.0f), meshChanged(true)
+  , arrayMesh(0), arrayCcw(TRUE), arrayCount(0)
 {
     SO_NODE_CONSTRUCTOR(SoFCMeshObjectShape);
     setName(SoFCMeshObjectShape::getClassTypeId().getName());
 }
 
+SoFCMeshObjectShape::~SoFCMeshObjectShape()
+{
+    releaseBuffers();
+}
+
 void SoFCMeshObjectShape::notify(SoNotList * node)
 {
     inherited::notify(node);
@@ -601,7 +623,7 @@ void SoFCMeshObjectShape::notify(SoNotList * node)
 }
 
 /**
- * Either renders the complete mesh or only a subset of the points.
+ * Either renders the complete mesh or, while navigating, a simplified version of it.
  */
 void SoFCMeshObjectShape::GLRender(SoGLRenderAction *action)
 {
@@ -630,12 +652,27 @@ void SoFCMeshObjectShape::GLRender(SoGLRenderAction *action)
         if (SoShapeHintsElement::getVertexOrdering(state) == SoShapeHintsElement::CLOCKWISE) 
             ccw = FALSE;
 
+        updateArrays(mesh, ccw);
+        // the simplified meshes are prepared as soon as a big mesh is shown,
+        // so that they are usually ready when the user starts navigating
+        if (mbind == OVERALL && mesh->countFacets() > this->renderTriangleLimit && !this->levelOfDetail)
+            startLevelOfDetail(mesh, ccw);
         if (mode == false || mesh->countFacets() <= this->renderTriangleLimit) {
             if (mbind != OVERALL)
                 drawFaces(mesh, &mb, mbind, needNormals, ccw);
+            else if (this->retainedMode) {
+                drawArrays(state, mesh, ccw);
+                // The buffer objects must not be compiled into a display list
+                SoGLCacheContextElement::shouldAutoCache(state, SoGLCacheContextElement::DONT_AUTO_CACHE);
+            }
             else
                 drawFaces(mesh, 0, mbind, needNormals, ccw);
         }
+        else if (mbind == OVERALL) {
+            drawLevelOfDetail(state, mesh, needNormals, ccw);
+            // The chosen level depends on the view
+            SoGLCacheContextElement::shouldAutoCache(state, SoGLCacheContextElement::DONT_AUTO_CACHE);
+        }
         else {
             drawPoints(mesh, needNormals, ccw);
         }
@@ -755,6 +792,202 @@ void SoFCMeshObjectShape::drawFaces(const Mesh::MeshObject * mesh, SoMaterialBun
     }
 }
 
+/**
+ * Discards the vertex arrays and the simplified meshes if the mesh has changed.
+ */
+void SoFCMeshObjectShape::updateArrays(const Mesh::MeshObject * mesh, SbBool ccw)
+{
+    if (this->meshChanged || this->arrayMesh != mesh || this->arrayCcw != ccw) {
+        releaseBuffers();
+        std::vector<GLfloat>().swap(this->vertexArray);
+        this->arrayMesh = mesh;
+        this->arrayCcw = ccw;
+        this->arrayCount = 0;
+        // a running build keeps its own data and its result is dropped
+        this->levelOfDetail.reset();
+        this->levelOfDetailBuild = QFuture<void>();
+        this->meshChanged = false;
+    }
+}
+
+/**
+ * Renders the triangles of the complete mesh from interleaved vertex arrays.
+ * The arrays are only rebuilt when the mesh has changed. If the OpenGL driver
+ * supports vertex buffer objects the arrays are uploaded once per GL context
+ * and the local copy is released, otherwise they are passed as client-side
+ * vertex arrays.
+ */
+void SoFCMeshObjectShape::drawArrays(SoState * state, const Mesh::MeshObject * mesh, SbBool ccw)
+{
+    uint32_t contextid = SoGLCacheContextElement::get(state);
+    const cc_glglue * glue = cc_glglue_instance(static_cast<int>(contextid));
+    bool useBuffer = cc_glglue_has_vertex_buffer_object(glue) ? true : false;
+    std::map<uint32_t, GLuint>::iterator it = this->vertexBuffers.find(contextid);
+
+    if (it == this->vertexBuffers.end() && this->vertexArray.empty()) {
+        try {
+            buildArrays(mesh, ccw);
+        }
+        catch (const std::bad_alloc&) {
+            Base::Console().Log("Not enough memory to create vertex arrays, render in immediate mode instead\n");
+            std::vector<GLfloat>().swap(this->vertexArray);
+            this->arrayCount = 0;
+            drawFaces(mesh, 0, OVERALL, TRUE, ccw);
+            return;
+        }
+    }
+
+    if (this->arrayCount == 0)
+        return;
+
+    if (useBuffer) {
+        if (it == this->vertexBuffers.end()) {
+            GLuint buffer;
+            cc_glglue_glGenBuffers(glue, 1, &buffer);
+            cc_glglue_glBindBuffer(glue, GL_ARRAY_BUFFER, buffer);
+            cc_glglue_glBufferData(glue, GL_ARRAY_BUFFER,
+                this->vertexArray.size() * sizeof(GLfloat),
+                &(this->vertexArray[0]), GL_STATIC_DRAW);
+            this->vertexBuffers[contextid] = buffer;
+            // the data is now held by the driver
+            std::vector<GLfloat>().swap(this->vertexArray);
+        }
+        else {
+            cc_glglue_glBindBuffer(glue, GL_ARRAY_BUFFER, it->second);
+        }
+        glInterleavedArrays(GL_N3F_V3F, 0, 0);
+    }
+    else {
+        glInterleavedArrays(GL_N3F_V3F, 0, &(this->vertexArray[0]));
+    }
+
+    glDrawArrays(GL_TRIANGLES, 0, this->arrayCount);
+
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    if (useBuffer)
+        cc_glglue_glBindBuffer(glue, GL_ARRAY_BUFFER, 0);
+}
+
+/**
+ * Fills the interleaved array with the normal and position of each corner
+ * of all triangles. The normal of a triangle is used for all its corners.
+ */
+void SoFCMeshObjectShape::buildArrays(const Mesh::MeshObject * mesh, SbBool ccw)
+{
+    const MeshCore::MeshPointArray & rPoints = mesh->getKernel().GetPoints();
+    const MeshCore::MeshFacetArray & rFacets = mesh->getKernel().GetFacets();
+    GLfloat sign = ccw ? 1.0f : -1.0f;
+
+    this->vertexArray.resize(18 * rFacets.size());
+    this->arrayCount = 0;
+    if (rFacets.empty())
+        return;
+
+    GLfloat* data = &(this->vertexArray[0]);
+    for (MeshCore::MeshFacetArray::_TConstIterator it = rFacets.begin(); it != rFacets.end(); ++it)
+    {
+        const MeshCore::MeshPoint& v0 = rPoints[it->_aulPoints[0]];
+        const MeshCore::MeshPoint& v1 = rPoints[it->_aulPoints[1]];
+        const MeshCore::MeshPoint& v2 = rPoints[it->_aulPoints[2]];
+
+        // Calculate the normal n = (v1-v0)x(v2-v0)
+        GLfloat n[3];
+        n[0] = sign * ((v1.y-v0.y)*(v2.z-v0.z)-(v1.z-v0.z)*(v2.y-v0.y));
+        n[1] = sign * ((v1.z-v0.z)*(v2.x-v0.x)-(v1.x-v0.x)*(v2.z-v0.z));
+        n[2] = sign * ((v1.x-v0.x)*(v2.y-v0.y)-(v1.y-v0.y)*(v2.x-v0.x));
+
+        for (int i=0; i<3; i++) {
+            const MeshCore::MeshPoint& v = rPoints[it->_aulPoints[i]];
+            *data++ = n[0];
+            *data++ = n[1];
+            *data++ = n[2];
+            *data++ = v.x;
+            *data++ = v.y;
+            *data++ = v.z;
+        }
+    }
+
+    this->arrayCount = static_cast<GLint>(3 * rFacets.size());
+}
+
+namespace MeshGui {
+// The reference to the mesh object makes the mesh property copy the mesh before
+// it gets modified, so the mesh doesn't change while it's read in the worker thread.
+static void buildLevelOfDetail(boost::shared_ptr<MeshLevelOfDetail> lod,
+                               Base::Reference<const Mesh::MeshObject> mesh,
+                               bool ccw, unsigned long maxTriangles)
+{
+    try {
+        lod->build(mesh->getKernel(), ccw, maxTriangles);
+    }
+    catch (const std::bad_alloc&) {
+        // not enough memory, points are rendered instead
+        lod->clear();
+    }
+}
+}
+
+/**
+ * Starts building the simplified versions of the mesh in a worker thread.
+ */
+void SoFCMeshObjectShape::startLevelOfDetail(const Mesh::MeshObject * mesh, SbBool ccw)
+{
+    this->levelOfDetail.reset(new MeshLevelOfDetail());
+    this->levelOfDetailBuild = QtConcurrent::run(boost::bind(&buildLevelOfDetail,
+        this->levelOfDetail, Base::Reference<const Mesh::MeshObject>(mesh),
+        ccw ? true : false, (unsigned long)this->renderTriangleLimit));
+}
+
+/**
+ * Renders a simplified version of the mesh. The coarsest level is chosen whose
+ * cells appear not bigger than maxScreenError pixels, as long as it has at most
+ * renderTriangleLimit triangles. Points are rendered while the levels are built.
+ */
+void SoFCMeshObjectShape::drawLevelOfDetail(SoState * state, const Mesh::MeshObject * mesh,
+                                            SbBool needNormals, SbBool ccw)
+{
+    if (!this->levelOfDetail || !this->levelOfDetailBuild.isFinished() || this->levelOfDetail->empty()) {
+        drawPoints(mesh, needNormals, ccw);
+        return;
+    }
+
+    // size of a pixel at the center of the mesh
+    const Base::BoundBox3f& box = this->levelOfDetail->getBoundBox();
+    SbVec3f center(0.5f*(box.MinX+box.MaxX), 0.5f*(box.MinY+box.MaxY), 0.5f*(box.MinZ+box.MaxZ));
+    SoModelMatrixElement::get(state).multVecMatrix(center, center);
+    const SbViewVolume& vv = SoViewVolumeElement::get(state);
+    const SbViewportRegion& vp = SoViewportRegionElement::get(state);
+    float pixel = vv.getWorldToScreenScale(center, 1.0f) / (float)vp.getViewportSizePixels()[1];
+
+    const MeshLevelOfDetail::Level* level = this->levelOfDetail->select
+        (this->maxScreenError * pixel, this->renderTriangleLimit);
+    glInterleavedArrays(GL_N3F_V3F, 0, &(level->array[0]));
+    glDrawArrays(GL_TRIANGLES, 0, level->count);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+/**
+ * Schedules the deletion of all buffer objects. This is done by Coin as soon
+ * as the GL context of a buffer is current again.
+ */
+void SoFCMeshObjectShape::releaseBuffers()
+{
+    for (std::map<uint32_t, GLuint>::iterator it = this->vertexBuffers.begin(); it != this->vertexBuffers.end(); ++it) {
+        SoGLCacheContextElement::scheduleDeleteCallback(it->first, deleteBuffer,
+            reinterpret_cast<void*>(static_cast<size_t>(it->second)));
+    }
+    this->vertexBuffers.clear();
+}
+
+void SoFCMeshObjectShape::deleteBuffer(void * closure, uint32_t contextid)
+{
+    GLuint buffer = static_cast<GLuint>(reinterpret_cast<size_t>(closure));
+    const cc_glglue * glue = cc_glglue_instance(static_cast<int>(contextid));
+    cc_glglue_glDeleteBuffers(glue, 1, &buffer);
+}
+
 /**
  * Renders the gravity points of a subset of triangles.
  */
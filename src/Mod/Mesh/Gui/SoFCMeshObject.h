@@ -23,6 +23,8 @@
 #ifndef MESHGUI_SOFCMESHOBJECT_H
 #define MESHGUI_SOFCMESHOBJECT_H
 
+#include <map>
+#include <vector>
 #include <Inventor/fields/SoSField.h>
 #include <Inventor/fields/SoSFUInt32.h>
 #include <Inventor/fields/SoSubField.h>
@@ -31,8 +33,11 @@
 #include <Inventor/nodes/SoSubNode.h>
 #include <Inventor/nodes/SoShape.h>
 #include <Inventor/elements/SoReplacedElement.h>
+#include <QFuture>
+#include <boost/shared_ptr.hpp>
 #include <Mod/Mesh/App/Core/Elements.h>
 #include <Mod/Mesh/App/Mesh.h>
+#include "MeshLevelOfDetail.h"
 
 typedef unsigned int GLuint;
 typedef int GLint;
@@ -170,6 +175,10 @@ public:
     SoFCMeshObjectShape();
 
     unsigned int renderTriangleLimit;
+    /// Render from vertex arrays that are only rebuilt when the mesh changes
+    bool retainedMode;
+    /// Maximum size in pixels of the cells of the simplified mesh shown while navigating
+    float maxScreenError;
 
 protected:
     virtual void doAction(SoAction * action);
@@ -194,13 +203,21 @@ private:
 
 private:
     // Force using the reference count mechanism.
-    virtual ~SoFCMeshObjectShape() {};
+    virtual ~SoFCMeshObjectShape();
     virtual void notify(SoNotList * list);
     Binding findMaterialBinding(SoState * const state) const;
     // Draw faces
     void drawFaces(const Mesh::MeshObject *, SoMaterialBundle* mb, Binding bind, 
                    SbBool needNormals, SbBool ccw) const;
     void drawPoints(const Mesh::MeshObject *, SbBool needNormals, SbBool ccw) const;
+    // Draw faces from vertex arrays
+    void updateArrays(const Mesh::MeshObject *, SbBool ccw);
+    void drawArrays(SoState *, const Mesh::MeshObject *, SbBool ccw);
+    void startLevelOfDetail(const Mesh::MeshObject *, SbBool ccw);
+    void drawLevelOfDetail(SoState *, const Mesh::MeshObject *, SbBool needNormals, SbBool ccw);
+    void buildArrays(const Mesh::MeshObject *, SbBool ccw);
+    void releaseBuffers();
+    static void deleteBuffer(void * closure, uint32_t contextid);
     unsigned int countTriangles(SoAction * action) const;
 
     void startSelection(SoAction * action, const Mesh::MeshObject*);
@@ -212,6 +229,16 @@ private:
     GLuint *selectBuf;
     GLfloat modelview[16];
     GLfloat projection[16];
+    // interleaved normal and position of each triangle corner
+    std::vector<GLfloat> vertexArray;
+    // vertex buffer object of each GL context
+    std::map<uint32_t, GLuint> vertexBuffers;
+    const Mesh::MeshObject * arrayMesh;
+    SbBool arrayCcw;
+    GLint arrayCount;
+    // simplified versions of the mesh for navigation, built in the background
+    boost::shared_ptr<MeshLevelOfDetail> levelOfDetail;
+    QFuture<void> levelOfDetailBuild;
 };
 
 class MeshGuiExport SoFCMeshSegmentShape : public SoShape {
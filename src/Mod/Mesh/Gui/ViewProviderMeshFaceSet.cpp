@@ -124,6 +124,7 @@ void ViewProviderMeshFaceSet::attach(App::DocumentObject *pcFeat)
         pcMeshShape->renderTriangleLimit = (unsigned int)(pow(10.0f,size));
         static_cast<SoFCIndexedFaceSet*>(pcMeshFaces)->renderTriangleLimit = (unsigned int)(pow(10.0f,size));
     }
+    pcMeshShape->retainedMode = hGrp->GetBool("RetainedRendering", true);
 }
 
 void ViewProviderMeshFaceSet::updateData(const App::Property* prop)
@@ -28,6 +28,8 @@
 
 #include <Base/PyObjectBase.h>
 #include <Base/Console.h>
+#include <Base/FileInfo.h>
+#include <Base/Stream.h>
 #include <Base/Vector3D.h>
 #include <Mod/Part/App/TopoShapePy.h>
 #include <Mod/Part/App/TopoShapeWirePy.h>
@@ -37,6 +39,7 @@
 #include <Mod/Mesh/App/MeshPy.h>
 #include "MeshAlgos.h"
 #include "Mesher.h"
+#include "BatchMesher.h"
 
 static PyObject *                        
 loftOnCurve(PyObject *self, PyObject *args)
@@ -161,6 +164,92 @@ meshFromShape(PyObject *self, PyObject *args)
     }
 }
 
+static PyObject *
+meshFromShapes(PyObject *self, PyObject *args)
+{
+    PyObject *list;
+    double deflection=0.1;
+    if (!PyArg_ParseTuple(args, "O!|d", &PyList_Type, &list, &deflection))
+        return 0;
+
+    try {
+        MeshPart::BatchMesher mesher;
+        mesher.setDeflection(deflection);
+        Py::List shapes(list);
+        for (Py::List::iterator it = shapes.begin(); it != shapes.end(); ++it) {
+            if (!PyObject_TypeCheck((*it).ptr(), &(Part::TopoShapePy::Type))) {
+                PyErr_SetString(PyExc_TypeError, "list of shapes expected");
+                return 0;
+            }
+            mesher.addShape(static_cast<Part::TopoShapePy*>((*it).ptr())->getTopoShapePtr()->_Shape);
+        }
+        return new Mesh::MeshPy(mesher.createMesh());
+    }
+    catch (const Base::Exception& e) {
+        PyErr_SetString(PyExc_Exception, e.what());
+        return 0;
+    }
+    catch (Standard_Failure) {
+        Handle_Standard_Failure e = Standard_Failure::Caught();
+        PyErr_SetString(PyExc_Exception, e->GetMessageString());
+        return 0;
+    }
+}
+
+PyDoc_STRVAR(meshFromShapes_doc,
+"meshFromShapes(list of shapes,[deflection=0.1]) -> Mesh\n\n"
+"Meshes the shapes and merges the faces into one mesh. Shapes that don't share\n"
+"any sub-shape are meshed in parallel.\n"
+"Edges shared by several faces are discretized only once, so the mesh has\n"
+"no duplicated points along them.");
+
+static PyObject *
+writeShapesToSTL(PyObject *self, PyObject *args)
+{
+    PyObject *list;
+    char *name;
+    double deflection=0.1;
+    if (!PyArg_ParseTuple(args, "O!s|d", &PyList_Type, &list, &name, &deflection))
+        return 0;
+
+    try {
+        MeshPart::BatchMesher mesher;
+        mesher.setDeflection(deflection);
+        Py::List shapes(list);
+        for (Py::List::iterator it = shapes.begin(); it != shapes.end(); ++it) {
+            if (!PyObject_TypeCheck((*it).ptr(), &(Part::TopoShapePy::Type))) {
+                PyErr_SetString(PyExc_TypeError, "list of shapes expected");
+                return 0;
+            }
+            mesher.addShape(static_cast<Part::TopoShapePy*>((*it).ptr())->getTopoShapePtr()->_Shape);
+        }
+
+        Base::FileInfo fi(name);
+        Base::ofstream str(fi, std::ios::out | std::ios::binary);
+        if (!mesher.writeSTL(str)) {
+            PyErr_Format(PyExc_IOError, "Failed to write file '%s'", name);
+            return 0;
+        }
+        Py_Return;
+    }
+    catch (const Base::Exception& e) {
+        PyErr_SetString(PyExc_Exception, e.what());
+        return 0;
+    }
+    catch (Standard_Failure) {
+        Handle_Standard_Failure e = Standard_Failure::Caught();
+        PyErr_SetString(PyExc_Exception, e->GetMessageString());
+        return 0;
+    }
+}
+
+PyDoc_STRVAR(writeShapesToSTL_doc,
+"writeShapesToSTL(list of shapes,filename,[deflection=0.1])\n\n"
+"Meshes the shapes and writes the triangles face by face into a binary STL file.\n"
+"Shapes that don't share any sub-shape are meshed in parallel, the file is\n"
+"written serially. Like any meshing it stores the triangulation in the faces of\n"
+"the shapes, but it doesn't build a mesh with shared points.");
+
 /* registration table  */
 struct PyMethodDef MeshPart_methods[] = {
     {"loftOnCurve",loftOnCurve, METH_VARARGS, loft_doc},
@@ -168,5 +257,7 @@ struct PyMethodDef MeshPart_methods[] = {
      "Create wire(s) from boundary of segment"},
     {"meshFromShape",meshFromShape, METH_VARARGS,
      "Create mesh from shape"},
+    {"meshFromShapes",meshFromShapes, METH_VARARGS, meshFromShapes_doc},
+    {"writeShapesToSTL",writeShapesToSTL, METH_VARARGS, writeShapesToSTL_doc},
     {NULL, NULL}        /* end of table marker */
 };
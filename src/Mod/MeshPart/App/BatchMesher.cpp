@@ -0,0 +1,394 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <climits>
+# include <ostream>
+# include <BRep_Builder.hxx>
+# include <BRep_Tool.hxx>
+# include <Poly_PolygonOnTriangulation.hxx>
+# include <Poly_Triangulation.hxx>
+# include <Standard_Failure.hxx>
+# include <TColStd_Array1OfInteger.hxx>
+# include <TopExp.hxx>
+# include <TopExp_Explorer.hxx>
+# include <TopoDS.hxx>
+# include <TopoDS_Compound.hxx>
+# include <TopoDS_Edge.hxx>
+# include <TopoDS_Face.hxx>
+# include <TopoDS_Vertex.hxx>
+# include <TopTools_IndexedMapOfShape.hxx>
+#endif
+
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
+#include "BatchMesher.h"
+#include <Mod/Mesh/App/Mesh.h>
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/MeshIO.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include <Mod/Part/App/Tessellation.h>
+
+using namespace MeshPart;
+
+// marks the nodes of a face triangulation that don't lie on an edge
+#define INNER_NODE ULONG_MAX
+
+namespace MeshPart {
+struct BatchMesher::Batch
+{
+    TopTools_IndexedMapOfShape vertexMap;
+    TopTools_IndexedMapOfShape edgeMap;
+    std::vector<int> edgeOwner;            // the face whose discretization of an edge is used
+    std::vector<int> edgeNodes;            // number of nodes of an edge
+    std::vector<unsigned long> edgeOffset; // index of the first inner node of an edge
+    std::vector<Handle(Poly_PolygonOnTriangulation)> edgePolygon; // of the edge on its owner
+    MeshCore::MeshPointArray* points;
+    MeshCore::MeshFacetArray* facets;
+};
+
+struct BatchMesher::FaceMesh
+{
+    int index;
+    TopoDS_Face face;
+    TopLoc_Location loc;
+    Handle(Poly_Triangulation) mesh;
+    std::vector<unsigned long> nodes; // point index of each node of the triangulation
+    unsigned long numInner;
+    unsigned long numFacets;
+    unsigned long pointOffset;        // index of the first inner node
+    unsigned long facetOffset;
+};
+}
+
+BatchMesher::BatchMesher() : deflection(0.1)
+{
+}
+
+BatchMesher::~BatchMesher()
+{
+}
+
+void BatchMesher::addShape(const TopoDS_Shape& shape)
+{
+    if (!shape.IsNull())
+        shapes.push_back(shape);
+}
+
+void BatchMesher::clear()
+{
+    shapes.clear();
+}
+
+/**
+ * Maps the nodes of the face triangulation lying on its edges to the points of the
+ * vertices and edges and counts the remaining nodes and the valid triangles.
+ */
+void BatchMesher::mapNodes(const Batch& batch, FaceMesh& fm)
+{
+    fm.numInner = 0;
+    fm.numFacets = 0;
+    try {
+        fm.nodes.assign(fm.mesh->NbNodes(), INNER_NODE);
+        for (TopExp_Explorer xp(fm.face, TopAbs_EDGE); xp.More(); xp.Next()) {
+            const TopoDS_Edge& edge = TopoDS::Edge(xp.Current());
+            Handle(Poly_PolygonOnTriangulation) poly = BRep_Tool::PolygonOnTriangulation(edge, fm.mesh, fm.loc);
+            if (poly.IsNull())
+                continue;
+
+            int e = batch.edgeMap.FindIndex(edge) - 1;
+            const TColStd_Array1OfInteger& indices = poly->Nodes();
+            int n = indices.Length();
+            bool shared = (batch.edgeOwner[e] >= 0 && batch.edgeNodes[e] == n);
+            bool degenerated = BRep_Tool::Degenerated(edge) ? true : false;
+
+            // the nodes of the polygon are ordered along the edge
+            TopoDS_Vertex v1, v2;
+            TopExp::Vertices(TopoDS::Edge(edge.Oriented(TopAbs_FORWARD)), v1, v2);
+            unsigned long p1 = v1.IsNull() ? INNER_NODE : batch.vertexMap.FindIndex(v1) - 1;
+            unsigned long p2 = v2.IsNull() ? INNER_NODE : batch.vertexMap.FindIndex(v2) - 1;
+
+            for (int k=0; k<n; k++) {
+                unsigned long& node = fm.nodes[indices(indices.Lower()+k) - 1];
+                if (k == 0 || degenerated)
+                    node = p1;
+                else if (k == n-1)
+                    node = p2;
+                else if (shared)
+                    node = batch.edgeOffset[e] + k - 1;
+            }
+        }
+    }
+    catch (Standard_Failure) {
+        fm.nodes.clear();
+        return;
+    }
+
+    for (std::vector<unsigned long>::iterator it = fm.nodes.begin(); it != fm.nodes.end(); ++it) {
+        if (*it == INNER_NODE)
+            fm.numInner++;
+    }
+
+    // triangles collapsing at a vertex, e.g. at the pole of a sphere, are skipped
+    const Poly_Array1OfTriangle& triangles = fm.mesh->Triangles();
+    for (Standard_Integer i=triangles.Lower(); i<=triangles.Upper(); i++) {
+        Standard_Integer n1, n2, n3;
+        triangles(i).Get(n1, n2, n3);
+        unsigned long a = fm.nodes[n1-1], b = fm.nodes[n2-1], c = fm.nodes[n3-1];
+        if ((a == b && a != INNER_NODE) || (b == c && b != INNER_NODE) || (c == a && c != INNER_NODE))
+            continue;
+        fm.numFacets++;
+    }
+}
+
+/**
+ * Writes the inner nodes of the face and the triangles of the face into the arrays of the mesh.
+ */
+void BatchMesher::fillMesh(const Batch& batch, FaceMesh& fm)
+{
+    if (fm.nodes.empty())
+        return;
+
+    gp_Trsf trsf = fm.loc.Transformation();
+    bool identity = fm.loc.IsIdentity() ? true : false;
+    const TColgp_Array1OfPnt& pnts = fm.mesh->Nodes();
+    MeshCore::MeshPointArray& points = *batch.points;
+
+    unsigned long inner = fm.pointOffset;
+    for (std::size_t i=0; i<fm.nodes.size(); i++) {
+        if (fm.nodes[i] == INNER_NODE) {
+            gp_Pnt p = pnts(pnts.Lower()+(Standard_Integer)i);
+            if (!identity)
+                p.Transform(trsf);
+            fm.nodes[i] = inner;
+            points[inner++].Set((float)p.X(), (float)p.Y(), (float)p.Z());
+        }
+    }
+
+    bool reversed = (fm.face.Orientation() != TopAbs_FORWARD);
+    MeshCore::MeshFacetArray& facets = *batch.facets;
+    unsigned long index = fm.facetOffset;
+    const Poly_Array1OfTriangle& triangles = fm.mesh->Triangles();
+    for (Standard_Integer i=triangles.Lower(); i<=triangles.Upper(); i++) {
+        Standard_Integer n1, n2, n3;
+        triangles(i).Get(n1, n2, n3);
+        if (reversed)
+            std::swap(n1, n2);
+        unsigned long a = fm.nodes[n1-1], b = fm.nodes[n2-1], c = fm.nodes[n3-1];
+        if (a == b || b == c || c == a)
+            continue;
+        MeshCore::MeshFacet& facet = facets[index++];
+        facet._aulPoints[0] = a;
+        facet._aulPoints[1] = b;
+        facet._aulPoints[2] = c;
+    }
+}
+
+/**
+ * Writes the inner nodes of the edges into the arrays of the mesh. This doesn't depend on
+ * the faces, so the nodes are valid even if the face owning an edge cannot be converted.
+ */
+void BatchMesher::fillEdges(const Batch& batch, const std::vector<FaceMesh>& faces)
+{
+    MeshCore::MeshPointArray& points = *batch.points;
+    for (int e=0; e<batch.edgeMap.Extent(); e++) {
+        if (batch.edgeOwner[e] < 0)
+            continue;
+        const FaceMesh& fm = faces[batch.edgeOwner[e]];
+        const TColgp_Array1OfPnt& pnts = fm.mesh->Nodes();
+        const TColStd_Array1OfInteger& indices = batch.edgePolygon[e]->Nodes();
+        for (int k=1; k<indices.Length()-1; k++) {
+            gp_Pnt p = pnts(indices(indices.Lower()+k));
+            if (!fm.loc.IsIdentity())
+                p.Transform(fm.loc.Transformation());
+            points[batch.edgeOffset[e]+k-1].Set((float)p.X(), (float)p.Y(), (float)p.Z());
+        }
+    }
+}
+
+/**
+ * Gets the corners of a triangle of the face in the orientation of the face. Returns false
+ * for a triangle collapsing at a vertex, e.g. at the pole of a sphere.
+ */
+bool BatchMesher::getTriangle(const FaceMesh& fm, int i, MeshCore::MeshGeomFacet& facet)
+{
+    Standard_Integer n[3];
+    fm.mesh->Triangles()(i).Get(n[0], n[1], n[2]);
+    if (fm.face.Orientation() != TopAbs_FORWARD)
+        std::swap(n[0], n[1]);
+
+    const TColgp_Array1OfPnt& pnts = fm.mesh->Nodes();
+    for (int k=0; k<3; k++) {
+        gp_Pnt p = pnts(n[k]);
+        if (!fm.loc.IsIdentity())
+            p.Transform(fm.loc.Transformation());
+        facet._aclPoints[k].Set((float)p.X(), (float)p.Y(), (float)p.Z());
+    }
+
+    return facet._aclPoints[0] != facet._aclPoints[1] &&
+           facet._aclPoints[1] != facet._aclPoints[2] &&
+           facet._aclPoints[2] != facet._aclPoints[0];
+}
+
+/**
+ * Meshes the shapes, whereby independent parts are triangulated in parallel, and
+ * collects the triangulated faces.
+ */
+void BatchMesher::triangulate(std::vector<FaceMesh>& faces) const
+{
+    BRep_Builder builder;
+    TopoDS_Compound comp;
+    builder.MakeCompound(comp);
+    for (std::vector<TopoDS_Shape>::const_iterator it = shapes.begin(); it != shapes.end(); ++it)
+        builder.Add(comp, *it);
+
+    Part::Tessellation(comp).perform(deflection);
+
+    for (TopExp_Explorer xp(comp, TopAbs_FACE); xp.More(); xp.Next()) {
+        FaceMesh fm;
+        fm.index = (int)faces.size();
+        fm.face = TopoDS::Face(xp.Current());
+        fm.mesh = BRep_Tool::Triangulation(fm.face, fm.loc);
+        if (fm.mesh.IsNull())
+            continue;
+        faces.push_back(fm);
+    }
+}
+
+void BatchMesher::perform(MeshCore::MeshKernel& kernel) const
+{
+    std::vector<FaceMesh> faces;
+    triangulate(faces);
+
+    // collect the vertices and edges of the triangulated faces
+    Batch batch;
+    for (std::vector<FaceMesh>::iterator it = faces.begin(); it != faces.end(); ++it) {
+        TopExp::MapShapes(it->face, TopAbs_VERTEX, batch.vertexMap);
+        TopExp::MapShapes(it->face, TopAbs_EDGE, batch.edgeMap);
+    }
+
+    // the vertices come first, then the inner nodes of the edges
+    MeshCore::MeshPointArray points;
+    MeshCore::MeshFacetArray facets;
+    unsigned long numPoints = batch.vertexMap.Extent();
+    batch.edgeOwner.resize(batch.edgeMap.Extent(), -1);
+    batch.edgeNodes.resize(batch.edgeMap.Extent(), 0);
+    batch.edgeOffset.resize(batch.edgeMap.Extent(), 0);
+    batch.edgePolygon.resize(batch.edgeMap.Extent());
+    for (std::vector<FaceMesh>::iterator it = faces.begin(); it != faces.end(); ++it) {
+        for (TopExp_Explorer xp(it->face, TopAbs_EDGE); xp.More(); xp.Next()) {
+            const TopoDS_Edge& edge = TopoDS::Edge(xp.Current());
+            int e = batch.edgeMap.FindIndex(edge) - 1;
+            if (batch.edgeOwner[e] >= 0 || BRep_Tool::Degenerated(edge))
+                continue;
+            Handle(Poly_PolygonOnTriangulation) poly = BRep_Tool::PolygonOnTriangulation(edge, it->mesh, it->loc);
+            if (poly.IsNull())
+                continue;
+            batch.edgeOwner[e] = it->index;
+            batch.edgePolygon[e] = poly;
+            batch.edgeNodes[e] = poly->NbNodes();
+            batch.edgeOffset[e] = numPoints;
+            numPoints += std::max<int>(0, poly->NbNodes() - 2);
+        }
+    }
+
+    QtConcurrent::blockingMap(faces, boost::bind(&BatchMesher::mapNodes, boost::cref(batch), _1));
+
+    // reserve the space of the inner nodes and triangles of each face
+    unsigned long numFacets = 0;
+    for (std::vector<FaceMesh>::iterator it = faces.begin(); it != faces.end(); ++it) {
+        it->pointOffset = numPoints;
+        it->facetOffset = numFacets;
+        numPoints += it->numInner;
+        numFacets += it->numFacets;
+    }
+
+    points.resize(numPoints);
+    facets.resize(numFacets);
+    for (int i=1; i<=batch.vertexMap.Extent(); i++) {
+        gp_Pnt p = BRep_Tool::Pnt(TopoDS::Vertex(batch.vertexMap(i)));
+        points[i-1].Set((float)p.X(), (float)p.Y(), (float)p.Z());
+    }
+
+    batch.points = &points;
+    batch.facets = &facets;
+    fillEdges(batch, faces);
+    QtConcurrent::blockingMap(faces, boost::bind(&BatchMesher::fillMesh, boost::cref(batch), _1));
+
+    kernel.Adopt(points, facets, true);
+}
+
+bool BatchMesher::writeSTL(std::ostream& out) const
+{
+    if (!out || out.bad())
+        return false;
+
+    std::vector<FaceMesh> faces;
+    triangulate(faces);
+
+    // the number of triangles precedes the triangles
+    MeshCore::MeshGeomFacet facet;
+    uint32_t count = 0;
+    for (std::vector<FaceMesh>::iterator it = faces.begin(); it != faces.end(); ++it) {
+        for (int i=1; i<=it->mesh->NbTriangles(); i++) {
+            if (getTriangle(*it, i, facet))
+                count++;
+        }
+    }
+
+    const std::string& header = MeshCore::MeshOutput::GetSTLHeaderData();
+    out.write(header.c_str(), header.size());
+    out.write((const char*)&count, sizeof(count));
+
+    uint16_t attribute = 0;
+    for (std::vector<FaceMesh>::iterator it = faces.begin(); it != faces.end(); ++it) {
+        for (int i=1; i<=it->mesh->NbTriangles(); i++) {
+            if (!getTriangle(*it, i, facet))
+                continue;
+            Base::Vector3f normal = facet.GetNormal();
+            out.write((const char*)&(normal.x), sizeof(float));
+            out.write((const char*)&(normal.y), sizeof(float));
+            out.write((const char*)&(normal.z), sizeof(float));
+            for (int k=0; k<3; k++) {
+                out.write((const char*)&(facet._aclPoints[k].x), sizeof(float));
+                out.write((const char*)&(facet._aclPoints[k].y), sizeof(float));
+                out.write((const char*)&(facet._aclPoints[k].z), sizeof(float));
+            }
+            out.write((const char*)&attribute, sizeof(attribute));
+        }
+    }
+
+    return out.good();
+}
+
+Mesh::MeshObject* BatchMesher::createMesh() const
+{
+    MeshCore::MeshKernel kernel;
+    perform(kernel);
+
+    Mesh::MeshObject* meshdata = new Mesh::MeshObject();
+    meshdata->swap(kernel);
+    return meshdata;
+}
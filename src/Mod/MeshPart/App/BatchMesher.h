@@ -0,0 +1,83 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef MESHPART_BATCHMESHER_H
+#define MESHPART_BATCHMESHER_H
+
+#include <iosfwd>
+#include <vector>
+#include <TopoDS_Shape.hxx>
+
+namespace MeshCore { class MeshKernel; class MeshGeomFacet; }
+namespace Mesh { class MeshObject; }
+namespace MeshPart {
+
+/**
+ * The BatchMesher class converts many shapes into one mesh, e.g. to export an assembly.
+ * The shapes are triangulated with BRepMesh whereby parts that share no faces or edges
+ * are meshed in parallel (see Part::Tessellation). Faces sharing an edge use the same
+ * discretization of it, so the nodes on the edge are identified by the edge itself and
+ * added only once. This makes the mesh watertight without merging points by their
+ * coordinates. The points and triangles of the faces are written concurrently straight
+ * into the arrays of the mesh kernel. Alternatively, the triangles can be streamed into
+ * a binary STL file without building a mesh at all.
+ */
+class BatchMesher
+{
+public:
+    BatchMesher();
+    ~BatchMesher();
+
+    void setDeflection(double s)
+    { deflection = s; }
+    double getDeflection() const
+    { return deflection; }
+
+    void addShape(const TopoDS_Shape&);
+    void clear();
+
+    /// Meshes the shapes and replaces the content of \a kernel with the result
+    void perform(MeshCore::MeshKernel& kernel) const;
+    Mesh::MeshObject* createMesh() const;
+    /**
+     * Meshes the shapes and writes the triangles face by face into the binary STL stream
+     * \a out. The points aren't shared in an STL file, so no mesh kernel is built.
+     */
+    bool writeSTL(std::ostream& out) const;
+
+private:
+    struct Batch;
+    struct FaceMesh;
+    void triangulate(std::vector<FaceMesh>&) const;
+    static void mapNodes(const Batch&, FaceMesh&);
+    static void fillMesh(const Batch&, FaceMesh&);
+    static void fillEdges(const Batch&, const std::vector<FaceMesh>&);
+    static bool getTriangle(const FaceMesh&, int, MeshCore::MeshGeomFacet&);
+
+private:
+    std::vector<TopoDS_Shape> shapes;
+    double deflection;
+};
+
+} // namespace MeshPart
+
+#endif // MESHPART_BATCHMESHER_H
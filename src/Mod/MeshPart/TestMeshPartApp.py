@@ -0,0 +1,70 @@
+#   (c) agent (agent@local) 2026                              LGPL        *
+#                                                                         *
+#   This file is part of the FreeCAD CAx development system.              *
+#                                                                         *
+#   This program is free software; you can redistribute it and/or modify  *
+#   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#   as published by the Free Software Foundation; either version 2 of     *
+#   the License, or (at your option) any later version.                   *
+#   for detail see the LICENCE text file.                                 *
+#                                                                         *
+#   FreeCAD is distributed in the hope that it will be useful,            *
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#   GNU Library General Public License for more details.                  *
+#                                                                         *
+#   You should have received a copy of the GNU Library General Public     *
+#   License along with FreeCAD; if not, write to the Free Software        *
+#   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#   USA                                                                   *
+#**************************************************************************
+
+
+import FreeCAD, os, sys, unittest, tempfile, Part, Mesh, MeshPart
+App = FreeCAD
+
+#---------------------------------------------------------------------------
+# define the test cases to test the FreeCAD MeshPart module
+#---------------------------------------------------------------------------
+
+
+class MeshPartBatchTestCases(unittest.TestCase):
+	def setUp(self):
+		# the boxes touch along a face but don't share any topology
+		self.boxes = [Part.makeBox(1,1,1), Part.makeBox(1,1,1,App.Vector(1,0,0))]
+		self.sphere = Part.makeSphere(1,App.Vector(5,0,0))
+		self.name = tempfile.gettempdir() + os.sep + "batchmesher.stl"
+
+	def testBoxes(self):
+		mesh = MeshPart.meshFromShapes(self.boxes)
+		self.failUnless(mesh.CountPoints == 16)
+		self.failUnless(mesh.CountFacets == 24)
+		self.failUnless(mesh.isSolid())
+
+	def testSphere(self):
+		mesh = MeshPart.meshFromShapes([self.sphere])
+		self.failUnless(mesh.isSolid())
+		self.failUnless(not mesh.hasNonManifolds())
+		# the points along the seam and at the poles are shared
+		points = set()
+		for p in mesh.Points:
+			points.add((p.x, p.y, p.z))
+		self.failUnless(len(points) == mesh.CountPoints)
+
+	def testShapes(self):
+		sphere = MeshPart.meshFromShapes([self.sphere])
+		mesh = MeshPart.meshFromShapes(self.boxes + [self.sphere])
+		self.failUnless(mesh.CountPoints == 16 + sphere.CountPoints)
+		self.failUnless(mesh.CountFacets == 24 + sphere.CountFacets)
+		self.failUnless(mesh.isSolid())
+		self.failUnless(not mesh.hasNonManifolds())
+
+	def testWriteSTL(self):
+		MeshPart.writeShapesToSTL(self.boxes + [self.sphere], self.name)
+		mesh = MeshPart.meshFromShapes(self.boxes + [self.sphere])
+		stl = Mesh.Mesh(self.name)
+		self.failUnless(stl.CountFacets == mesh.CountFacets)
+
+	def tearDown(self):
+		if os.path.exists(self.name):
+			os.remove(self.name)
@@ -13,6 +13,7 @@
 #ifndef _PreComp_
 # include <Python.h>
 # include <Interface_Static.hxx>
+# include <Standard.hxx>
 # include <sstream>
 #endif
 
@@ -248,6 +249,10 @@ void PartExport initPart()
             Interface_Static::SetCVal("write.step.unit","MM");
             break;
     }
+
+    // Shapes are meshed in worker threads, e.g. by Part::Tessellation, which needs
+    // a thread-safe memory manager and reference counting of OCC
+    Standard::SetReentrant(Standard_True);
 }
 
 } // extern "C"
@@ -44,16 +44,16 @@
 #endif
 
 
-#include <strstream>
 #include <Base/Console.h>
 #include <Base/Writer.h>
 #include <Base/Reader.h>
 #include <Base/Exception.h>
-#include <Base/FileInfo.h>
-#include <Base/Stream.h>
+#include <Base/Parameter.h>
+#include <App/Application.h>
 #include <App/DocumentObject.h>
 
 #include "PropertyTopoShape.h"
+#include "Tessellation.h"
 #include "TopoShapePy.h"
 #include "TopoShapeFacePy.h"
 #include "TopoShapeEdgePy.h"
@@ -92,21 +92,25 @@ void PropertyPartShape::setValue(const TopoDS_Shape& sh)
 
 const TopoDS_Shape& PropertyPartShape::getValue(void)const 
 {
+    restoreDeferred();
     return _Shape._Shape;
 }
 
 const TopoShape& PropertyPartShape::getShape() const
 {
+    restoreDeferred();
     return this->_Shape;
 }
 
 const Data::ComplexGeoData* PropertyPartShape::getComplexData() const
 {
+    restoreDeferred();
     return &(this->_Shape);
 }
 
 Base::BoundBox3d PropertyPartShape::getBoundingBox() const
 {
+    restoreDeferred();
     Base::BoundBox3d box;
     if (_Shape._Shape.IsNull())
         return box;
@@ -135,6 +139,7 @@ void PropertyPartShape::getFaces(std::vector<Base::Vector3d> &aPoints,
                                  std::vector<Data::ComplexGeoData::Facet> &aTopo,
                                  float accuracy, uint16_t flags) const
 {
+    restoreDeferred();
     _Shape.getFaces(aPoints, aTopo, accuracy, flags);
 }
 
@@ -211,6 +216,8 @@ App::Property *PropertyPartShape::Copy(void) const
     if (!_Shape._Shape.IsNull()) {
         BRepBuilderAPI_Copy copy(_Shape._Shape);
         prop->_Shape._Shape = copy.Shape();
+        // keep the triangulation so that undo/redo doesn't need to re-mesh the shape
+        Tessellation(_Shape._Shape).copyTo(prop->_Shape._Shape);
     }
 
     return prop;
@@ -255,97 +262,65 @@ void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
     // can be checked when reading in the data.
     if (_Shape._Shape.IsNull())
         return;
-    // NOTE: Cleaning the triangulation may cause problems on some algorithms like BOP
-    // Before writing to the project we clean all triangulation data to save memory
-    BRepBuilderAPI_Copy copy(_Shape._Shape);
-    const TopoDS_Shape& myShape = copy.Shape();
-    BRepTools::Clean(myShape); // remove triangulation
-
-    // create a temporary file and copy the content to the zip stream
-    // once the tmp. filename is known use always the same because otherwise
-    // we may run into some problems on the Linux platform
-    static Base::FileInfo fi(Base::FileInfo::getTempFileName());
-
-    if (!BRepTools::Write(myShape,(const Standard_CString)fi.filePath().c_str())) {
-        // Note: Do NOT throw an exception here because if the tmp. file could
-        // not be created we should not abort.
+    // If wanted the triangulation is saved, too, so that big shapes can be displayed
+    // after loading the project without meshing them again
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part");
+    TopoDS_Shape myShape = _Shape._Shape;
+    if (!hGrp->GetBool("SaveTriangulation", false)) {
+        // NOTE: Cleaning the triangulation may cause problems on some algorithms like BOP
+        // Before writing to the project we clean all triangulation data to save memory
+        BRepBuilderAPI_Copy copy(_Shape._Shape);
+        myShape = copy.Shape();
+        BRepTools::Clean(myShape); // remove triangulation
+    }
+
+    // write the shape directly into the zip stream without going through a temp. file
+    std::ostream& str = writer.Stream();
+    BRepTools::Write(myShape, str);
+    if (!str) {
+        // Note: Do NOT throw an exception here because if the shape could
+        // not be written we should not abort.
         // We only print an error message but continue writing the next files to the
         // stream...
         App::PropertyContainer* father = this->getContainer();
         if (father && father->isDerivedFrom(App::DocumentObject::getClassTypeId())) {
             App::DocumentObject* obj = static_cast<App::DocumentObject*>(father);
-            Base::Console().Error("Shape of '%s' cannot be written to BRep file '%s'\n", 
-                obj->Label.getValue(),fi.filePath().c_str());
+            Base::Console().Error("Shape of '%s' cannot be written to BRep file\n", 
+                obj->Label.getValue());
         }
         else {
-            Base::Console().Error("Cannot save BRep file '%s'\n", fi.filePath().c_str());
+            Base::Console().Error("Cannot save BRep file\n");
         }
     }
-
-    Base::ifstream file(fi, std::ios::in | std::ios::binary);
-    if (file){
-        unsigned long ulSize = 0; 
-        std::streambuf* buf = file.rdbuf();
-        if (buf) {
-            unsigned long ulCurr;
-            ulCurr = buf->pubseekoff(0, std::ios::cur, std::ios::in);
-            ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
-            buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
-        }
-
-        // read in the ASCII file and write back to the stream
-        std::strstreambuf sbuf(ulSize);
-        file >> &sbuf;
-        writer.Stream() << &sbuf;
-    }
-
-    file.close();
-    // remove temp file
-    fi.deleteFile();
 }
 
 void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
 {
-    BRep_Builder builder;
-
-    // create a temporary file and copy the content from the zip stream
-    Base::FileInfo fi(Base::FileInfo::getTempFileName());
-
-    // read in the ASCII file and write back to the file stream
-    Base::ofstream file(fi, std::ios::out | std::ios::binary);
-    unsigned long ulSize = 0; 
-    if (reader) {
-        std::streambuf* buf = file.rdbuf();
-        reader >> buf;
-        file.flush();
-        ulSize = buf->pubseekoff(0, std::ios::cur, std::ios::in);
-    }
-    file.close();
-
-    // Read the shape from the temp file, if the file is empty the stored shape was already empty.
-    // If it's still empty after reading the (non-empty) file there must occurred an error.
+    // Read the shape directly from the zip stream, if the file is empty the stored shape
+    // was already empty. If it's still empty after reading the (non-empty) file there
+    // must occurred an error.
     TopoDS_Shape shape;
-    if (ulSize > 0) {
-        if (!BRepTools::Read(shape, (const Standard_CString)fi.filePath().c_str(), builder)) {
-            // Note: Do NOT throw an exception here because if the tmp. created file could
-            // not be read it's NOT an indication for an invalid input stream 'reader'.
+    if (reader && reader.peek() != std::char_traits<char>::eof()) {
+        BRep_Builder builder;
+        BRepTools::Read(shape, reader, builder);
+        if (shape.IsNull()) {
+            // Note: Do NOT throw an exception here because if the shape could not
+            // be read it's NOT an indication for an invalid input stream 'reader'.
             // We only print an error message but continue reading the next files from the
             // stream...
             App::PropertyContainer* father = this->getContainer();
             if (father && father->isDerivedFrom(App::DocumentObject::getClassTypeId())) {
                 App::DocumentObject* obj = static_cast<App::DocumentObject*>(father);
-                Base::Console().Error("BRep file '%s' with shape of '%s' seems to be empty\n", 
-                    fi.filePath().c_str(),obj->Label.getValue());
+                Base::Console().Error("BRep file with shape of '%s' seems to be empty\n", 
+                    obj->Label.getValue());
             }
             else {
-                Base::Console().Warning("Loaded BRep file '%s' seems to be empty\n", fi.filePath().c_str());
+                Base::Console().Warning("Loaded BRep file seems to be empty\n");
             }
         }
     }
 
-    // delete the temp file
-    fi.deleteFile();
-
     setValue(shape);
 }
 
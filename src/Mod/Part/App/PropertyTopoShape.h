@@ -171,6 +171,7 @@ public:
         _lValueList.resize(newSize);
     }
     virtual int getSize(void) const {
+        restoreDeferred();
         return _lValueList.size();
     }
 
@@ -181,6 +182,7 @@ public:
     void setValues (const std::vector<FilletElement>& values);
 
     const std::vector<FilletElement> &getValues(void) const {
+        restoreDeferred();
         return _lValueList;
     }
 
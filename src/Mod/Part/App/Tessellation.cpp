@@ -0,0 +1,172 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <map>
+# include <BRep_Builder.hxx>
+# include <BRep_Tool.hxx>
+# include <BRepMesh_IncrementalMesh.hxx>
+# include <Poly_Polygon3D.hxx>
+# include <Poly_PolygonOnTriangulation.hxx>
+# include <Poly_Triangulation.hxx>
+# include <TopExp_Explorer.hxx>
+# include <TopoDS.hxx>
+# include <TopoDS_Compound.hxx>
+# include <TopoDS_Edge.hxx>
+# include <TopoDS_Face.hxx>
+#endif
+
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
+#include "Tessellation.h"
+
+using namespace Part;
+
+
+Tessellation::Tessellation(const TopoDS_Shape& s) : s(s)
+{
+}
+
+// the parts are collected with a union-find over the faces and free edges
+static int findPart(std::vector<int>& parent, int i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+static void joinPart(std::map<const void*, int>& owner, std::vector<int>& parent,
+                     const TopoDS_Shape& sub, int i)
+{
+    // BRepMesh stores the mesh in the TShape which may be shared by sub-shapes
+    // with different locations
+    const void* key = sub.TShape().operator->();
+    std::map<const void*, int>::iterator it = owner.find(key);
+    if (it == owner.end())
+        owner[key] = i;
+    else
+        parent[findPart(parent, it->second)] = findPart(parent, i);
+}
+
+std::vector<TopoDS_Shape> Tessellation::independentParts() const
+{
+    std::vector<TopoDS_Shape> items;
+    TopExp_Explorer xp;
+    for (xp.Init(s, TopAbs_FACE); xp.More(); xp.Next())
+        items.push_back(xp.Current());
+    for (xp.Init(s, TopAbs_EDGE, TopAbs_FACE); xp.More(); xp.Next())
+        items.push_back(xp.Current());
+
+    std::vector<int> parent(items.size());
+    std::map<const void*, int> owner;
+    for (std::size_t i = 0; i < items.size(); i++) {
+        parent[i] = (int)i;
+        joinPart(owner, parent, items[i], (int)i);
+        if (items[i].ShapeType() == TopAbs_FACE) {
+            TopExp_Explorer xe;
+            for (xe.Init(items[i], TopAbs_EDGE); xe.More(); xe.Next())
+                joinPart(owner, parent, xe.Current(), (int)i);
+        }
+    }
+
+    BRep_Builder builder;
+    std::vector<TopoDS_Shape> parts;
+    std::map<int, std::size_t> partIndex;
+    for (std::size_t i = 0; i < items.size(); i++) {
+        int root = findPart(parent, (int)i);
+        std::map<int, std::size_t>::iterator it = partIndex.find(root);
+        if (it == partIndex.end()) {
+            TopoDS_Compound comp;
+            builder.MakeCompound(comp);
+            it = partIndex.insert(std::make_pair(root, parts.size())).first;
+            parts.push_back(comp);
+        }
+        builder.Add(parts[it->second], items[i]);
+    }
+
+    return parts;
+}
+
+void Tessellation::meshPart(const TopoDS_Shape& part, double deflection)
+{
+    BRepMesh_IncrementalMesh(part, deflection);
+}
+
+void Tessellation::perform(double deflection) const
+{
+    std::vector<TopoDS_Shape> parts = independentParts();
+    if (parts.size() < 2) {
+        BRepMesh_IncrementalMesh(s, deflection);
+        return;
+    }
+
+    // the memory manager of OCC is set thread-safe by the Part module
+    QtConcurrent::blockingMap(parts, boost::bind(&Tessellation::meshPart, _1, deflection));
+}
+
+void Tessellation::copyTo(const TopoDS_Shape& c) const
+{
+    // BRepBuilderAPI_Copy keeps the order of the sub-shapes, so that the
+    // faces and edges of both shapes can be visited in parallel
+    BRep_Builder builder;
+    TopExp_Explorer xp, xc;
+    for (xp.Init(s, TopAbs_FACE), xc.Init(c, TopAbs_FACE); xp.More() && xc.More(); xp.Next(), xc.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(xp.Current());
+        TopLoc_Location loc;
+        Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(face, loc);
+        if (mesh.IsNull())
+            continue;
+        builder.UpdateFace(TopoDS::Face(xc.Current()), mesh);
+
+        TopExp_Explorer xpe, xce;
+        for (xpe.Init(face, TopAbs_EDGE), xce.Init(xc.Current(), TopAbs_EDGE);
+             xpe.More() && xce.More(); xpe.Next(), xce.Next()) {
+            TopoDS_Edge edge = TopoDS::Edge(xpe.Current().Oriented(TopAbs_FORWARD));
+            Handle(Poly_PolygonOnTriangulation) poly = BRep_Tool::PolygonOnTriangulation(edge, mesh, loc);
+            if (poly.IsNull())
+                continue;
+            const TopoDS_Edge& copy = TopoDS::Edge(xce.Current());
+            if (BRep_Tool::IsClosed(edge, face)) {
+                // a seam edge has a polygon for either orientation
+                Handle(Poly_PolygonOnTriangulation) poly2 = BRep_Tool::PolygonOnTriangulation
+                    (TopoDS::Edge(edge.Reversed()), mesh, loc);
+                builder.UpdateEdge(copy, poly, poly2, mesh, loc);
+            }
+            else {
+                builder.UpdateEdge(copy, poly, mesh, loc);
+            }
+        }
+    }
+
+    for (xp.Init(s, TopAbs_EDGE, TopAbs_FACE), xc.Init(c, TopAbs_EDGE, TopAbs_FACE);
+         xp.More() && xc.More(); xp.Next(), xc.Next()) {
+        TopLoc_Location loc;
+        Handle(Poly_Polygon3D) poly = BRep_Tool::Polygon3D(TopoDS::Edge(xp.Current()), loc);
+        if (!poly.IsNull())
+            builder.UpdateEdge(TopoDS::Edge(xc.Current()), poly, loc);
+    }
+}
@@ -0,0 +1,62 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef PART_TESSELLATION_H
+#define PART_TESSELLATION_H
+
+#include <vector>
+
+class TopoDS_Shape;
+
+namespace Part {
+
+/**
+ * The Tessellation class meshes the faces and free edges of a shape with BRepMesh.
+ * As BRepMesh stores the triangulation in the faces and edges, parts of the shape
+ * that share faces or edges cannot be meshed concurrently. Thus, the shape is split
+ * into independent parts, e.g. the solids of an assembly, which are meshed in parallel.
+ */
+class PartExport Tessellation
+{
+public:
+    Tessellation(const TopoDS_Shape& s);
+    /// Returns compounds of the faces and free edges that share no faces and edges with each other
+    std::vector<TopoDS_Shape> independentParts() const;
+    /// Meshes the shape with the absolute deflection
+    void perform(double deflection) const;
+    /**
+     * Passes the triangulation of the shape to the faces and edges of \a c which must be
+     * a copy of the shape, e.g. made by BRepBuilderAPI_Copy.
+     */
+    void copyTo(const TopoDS_Shape& c) const;
+
+private:
+    static void meshPart(const TopoDS_Shape& part, double deflection);
+
+private:
+    const TopoDS_Shape& s;
+};
+
+}
+
+#endif // PART_TESSELLATION_H
@@ -0,0 +1,107 @@
+#***************************************************************************
+#*   Copyright (c) 2026 agent <agent@local>                                *
+#*                                                                         *
+#*   This file is part of the FreeCAD CAx development system.              *
+#*                                                                         *
+#*   This program is free software; you can redistribute it and/or modify  *
+#*   it under the terms of the GNU General Public License (GPL)            *
+#*   as published by the Free Software Foundation; either version 2 of     *
+#*   the License, or (at your option) any later version.                   *
+#*   for detail see the LICENCE text file.                                 *
+#*                                                                         *
+#*   FreeCAD is distributed in the hope that it will be useful,            *
+#*   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#*   GNU Library General Public License for more details.                  *
+#*                                                                         *
+#*   You should have received a copy of the GNU Library General Public     *
+#*   License along with FreeCAD; if not, write to the Free Software        *
+#*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#*   USA                                                                   *
+#*                                                                         *
+#***************************************************************************
+
+# Measures the wall time and the peak memory of saving and loading a document
+# with big Part shapes. Run it with the builds to compare, e.g.
+#   FreeCADCmd BenchmarkShapeIO.py
+# or from the Python console:
+#   import BenchmarkShapeIO
+#   BenchmarkShapeIO.run(count=200)
+
+import os, tempfile, time
+import FreeCAD, Part
+
+def peakMemory():
+    "Returns the peak resident set size of the process in kB"
+    try:
+        for line in open("/proc/self/status"):
+            if line.startswith("VmHWM:"):
+                return int(line.split()[1])
+    except IOError:
+        pass
+    import resource
+    # kB on Linux, bytes on Mac OS X
+    return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+
+def resetPeakMemory():
+    "Resets the peak resident set size where the system supports it (Linux 4.0 and later)"
+    try:
+        f = open("/proc/self/clear_refs","w")
+        f.write("5")
+        f.close()
+        return True
+    except IOError:
+        return False
+
+def makeShape(count):
+    "Creates a compound of drilled and filleted blocks"
+    solids = []
+    for i in range(count):
+        box = Part.makeBox(10,10,10,FreeCAD.Vector(15*(i%20),15*(i//20),0))
+        box = box.makeFillet(1,box.Edges)
+        for j in range(3):
+            center = box.BoundBox.Center
+            dir = FreeCAD.Vector(j==0, j==1, j==2)
+            hole = Part.makeCylinder(2,20,center-dir*10,dir)
+            box = box.cut(hole)
+        solids.append(box)
+    return Part.makeCompound(solids)
+
+def run(count=100, objects=10):
+    "Saves and loads a document with 'objects' features holding 'count' solids each"
+    name = "BenchmarkShapeIO"
+    path = os.path.join(tempfile.gettempdir(), name + ".FCStd")
+    doc = FreeCAD.newDocument(name)
+    shape = makeShape(count)
+    for i in range(objects):
+        doc.addObject("Part::Feature","Shape").Shape = shape.copy()
+
+    resetPeakMemory()
+    before = peakMemory()
+    start = time.time()
+    doc.saveAs(path)
+    saveTime = time.time() - start
+    saveMemory = peakMemory() - before
+    FreeCAD.closeDocument(name)
+
+    resetPeakMemory()
+    before = peakMemory()
+    start = time.time()
+    doc = FreeCAD.openDocument(path)
+    # a lazy restore reads the shapes when they are accessed
+    faces = 0
+    for obj in doc.Objects:
+        faces += len(obj.Shape.Faces)
+    loadTime = time.time() - start
+    loadMemory = peakMemory() - before
+    FreeCAD.closeDocument(doc.Name)
+
+    size = os.path.getsize(path)
+    os.remove(path)
+    FreeCAD.Console.PrintMessage("File size:   %.1f MB, %d faces\n" % (size/1048576.0, faces))
+    FreeCAD.Console.PrintMessage("Save:        %.3f s, peak memory +%d kB\n" % (saveTime, saveMemory))
+    FreeCAD.Console.PrintMessage("Load:        %.3f s, peak memory +%d kB\n" % (loadTime, loadMemory))
+    return {"save": saveTime, "load": loadTime, "saveMemory": saveMemory, "loadMemory": loadMemory}
+
+if __name__ == "__main__":
+    run()
@@ -71,6 +71,7 @@ void DlgSettingsGeneral::saveSettings()
     }
     ui->checkBooleanRefine->onSave();
     ui->checkBooleanCheck->onSave();
+    ui->checkSaveTriangulation->onSave();
 }
 
 void DlgSettingsGeneral::loadSettings()
@@ -81,6 +82,7 @@ void DlgSettingsGeneral::loadSettings()
     ui->comboBoxUnits->setCurrentIndex(unit);
     ui->checkBooleanRefine->onRestore();
     ui->checkBooleanCheck->onRestore();
+    ui->checkSaveTriangulation->onRestore();
 }
 
 /**
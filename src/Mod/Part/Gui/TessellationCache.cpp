@@ -0,0 +1,621 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <climits>
+# include <set>
+# include <Bnd_Box.hxx>
+# include <BRepBndLib.hxx>
+# include <BRepBuilderAPI_Copy.hxx>
+# include <BRep_Tool.hxx>
+# include <gp_Pnt.hxx>
+# include <gp_Pnt2d.hxx>
+# include <gp_Trsf.hxx>
+# include <gp_Vec.hxx>
+# include <Poly_Array1OfTriangle.hxx>
+# include <Poly_Polygon3D.hxx>
+# include <Poly_PolygonOnTriangulation.hxx>
+# include <Poly_Triangle.hxx>
+# include <Poly_Triangulation.hxx>
+# include <TColgp_Array1OfPnt.hxx>
+# include <TColStd_Array1OfInteger.hxx>
+# include <TopExp.hxx>
+# include <TopExp_Explorer.hxx>
+# include <TopLoc_Location.hxx>
+# include <TopoDS.hxx>
+# include <TopoDS_Edge.hxx>
+# include <TopoDS_Face.hxx>
+# include <TopoDS_Vertex.hxx>
+# include <TopTools_IndexedMapOfShape.hxx>
+# include <Inventor/nodes/SoIndexedFaceSet.h>
+#endif
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QMutexLocker>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+#include <boost/bind.hpp>
+
+#include <Base/Parameter.h>
+#include <App/Application.h>
+#include <Mod/Part/App/Tessellation.h>
+#include <Mod/Part/App/TopoShape.h>
+
+#include "TessellationCache.h"
+#include "ViewProviderExt.h"
+
+using namespace PartGui;
+
+
+struct ShapeTessellation::FaceJob
+{
+    TopoDS_Face face;
+    TopLoc_Location loc;
+    Handle(Poly_Triangulation) mesh;
+    int index;
+    int nodeOffset;
+    int triaOffset;
+};
+
+ShapeTessellation::ShapeTessellation(const TopoDS_Shape& shape, double deflection)
+  : vertexStart(0), numEdges(0)
+{
+    // create or use the mesh on the data structure
+    Part::Tessellation(shape).perform(deflection);
+
+    // count triangles and nodes in the mesh
+    int nbrTriangles=0,nbrNodes=0;
+    std::set<int> faceEdges;
+    std::vector<FaceJob> faces;
+    TopExp_Explorer Ex;
+    for (Ex.Init(shape,TopAbs_FACE);Ex.More();Ex.Next()) {
+        FaceJob job;
+        job.face = TopoDS::Face(Ex.Current());
+        job.mesh = BRep_Tool::Triangulation(job.face, job.loc);
+        job.index = (int)faces.size();
+        job.nodeOffset = nbrNodes;
+        job.triaOffset = nbrTriangles;
+        // Note: we must also count empty faces
+        if (!job.mesh.IsNull()) {
+            nbrTriangles += job.mesh->NbTriangles();
+            nbrNodes     += job.mesh->NbNodes();
+        }
+
+        TopExp_Explorer xp;
+        for (xp.Init(job.face,TopAbs_EDGE);xp.More();xp.Next())
+            faceEdges.insert(xp.Current().HashCode(INT_MAX));
+        faces.push_back(job);
+    }
+    int nbrNorms = nbrNodes;
+
+    // get an indexed map of edges
+    TopTools_IndexedMapOfShape M;
+    TopExp::MapShapes(shape, TopAbs_EDGE, M);
+    numEdges = M.Extent();
+
+    // handling of the vertices
+    TopTools_IndexedMapOfShape V;
+    TopExp::MapShapes(shape, TopAbs_VERTEX, V);
+
+    // collect the free edges that are not associated to a face
+    // Note: The assumption that if for an edge BRep_Tool::Polygon3D
+    // returns a valid object is wrong. This e.g. happens for ruled
+    // surfaces which gets created by two edges or wires.
+    // So, we have to store the hashes of the edges associated to a face.
+    // If the hash of a given edge is not in this list we know it's really
+    // a free edge.
+    std::vector<int> freeEdges;
+    for (int i=1; i <= M.Extent(); i++) {
+        const TopoDS_Edge& aEdge = TopoDS::Edge(M(i));
+        TopLoc_Location aLoc;
+        int hash = aEdge.HashCode(INT_MAX);
+        if (faceEdges.find(hash) == faceEdges.end()) {
+            Handle(Poly_Polygon3D) aPoly = BRep_Tool::Polygon3D(aEdge, aLoc);
+            if (!aPoly.IsNull()) {
+                nbrNodes += aPoly->NbNodes();
+                freeEdges.push_back(i);
+            }
+        }
+    }
+
+    // create memory for the nodes and indexes
+    coords   .resize(nbrNodes + V.Extent());
+    normals  .resize(nbrNorms, SbVec3f(0.0f,0.0f,0.0f));
+    faceIndex.resize(nbrTriangles*4);
+    partIndex.resize(faces.size(), 0);
+    lineIndex.reserve(M.Extent()*8);
+
+    // the faces fill disjoint ranges of the arrays, for small shapes
+    // this doesn't pay off the thread overhead
+    if (nbrTriangles >= 10000 && faces.size() > 1) {
+        QtConcurrent::blockingMap(faces, boost::bind(&ShapeTessellation::fillFace, this, _1));
+    }
+    else {
+        for (std::vector<FaceJob>::iterator it = faces.begin(); it != faces.end(); ++it)
+            fillFace(*it);
+    }
+
+    // handling the edges lying on the faces
+    std::vector<bool> edgeDone(M.Extent()+1, false);
+    for (std::vector<FaceJob>::iterator it = faces.begin(); it != faces.end(); ++it) {
+        if (it->mesh.IsNull())
+            continue;
+
+        // getting the transformation of the shape/face
+        gp_Trsf myTransf;
+        Standard_Boolean identity = true;
+        if (!it->loc.IsIdentity()) {
+            identity = false;
+            myTransf = it->loc.Transformation();
+        }
+
+        const TColgp_Array1OfPnt& Nodes = it->mesh->Nodes();
+        TopExp_Explorer Exp;
+        for(Exp.Init(it->face,TopAbs_EDGE);Exp.More();Exp.Next()) {
+            const TopoDS_Edge &actEdge = TopoDS::Edge(Exp.Current());
+            // get the overall index of this edge
+            int idx = M.FindIndex(actEdge);
+            // already processed this index ?
+            if (edgeDone[idx])
+                continue;
+
+            // this holds the indices of the edge's triangulation to the current polygon
+            Handle(Poly_PolygonOnTriangulation) aPoly = BRep_Tool::PolygonOnTriangulation(actEdge, it->mesh, it->loc);
+            if (aPoly.IsNull())
+                continue; // polygon does not exist
+
+            // getting the indexes of the edge polygon
+            const TColStd_Array1OfInteger& indices = aPoly->Nodes();
+            for (Standard_Integer i=indices.Lower();i <= indices.Upper();i++) {
+                int inx = indices(i);
+                lineIndex.push_back(it->nodeOffset+inx-1);
+
+                // usually the coordinates for this edge are already set by the
+                // triangles of the face this edge belongs to. However, there are
+                // rare cases where some points are only referenced by the polygon
+                // but not by any triangle. Thus, we must apply the coordinates to
+                // make sure that everything is properly set.
+                gp_Pnt p(Nodes(inx));
+                if (!identity)
+                    p.Transform(myTransf);
+                coords[it->nodeOffset+inx-1].setValue((float)(p.X()),(float)(p.Y()),(float)(p.Z()));
+            }
+            lineIndex.push_back(-1);
+
+            // mark the handled edge index
+            edgeDone[idx] = true;
+        }
+    }
+
+    // handling of the free edges
+    int FaceNodeOffset = nbrNorms;
+    for (std::vector<int>::iterator it = freeEdges.begin(); it != freeEdges.end(); ++it) {
+        const TopoDS_Edge& aEdge = TopoDS::Edge(M(*it));
+        Standard_Boolean identity = true;
+        gp_Trsf myTransf;
+        TopLoc_Location aLoc;
+
+        Handle(Poly_Polygon3D) aPoly = BRep_Tool::Polygon3D(aEdge, aLoc);
+        if (!aLoc.IsIdentity()) {
+            identity = false;
+            myTransf = aLoc.Transformation();
+        }
+
+        const TColgp_Array1OfPnt& aNodes = aPoly->Nodes();
+        int nbNodesInEdge = aPoly->NbNodes();
+
+        gp_Pnt pnt;
+        for (Standard_Integer j=1;j <= nbNodesInEdge;j++) {
+            pnt = aNodes(j);
+            if (!identity)
+                pnt.Transform(myTransf);
+            coords[FaceNodeOffset+j-1].setValue((float)(pnt.X()),(float)(pnt.Y()),(float)(pnt.Z()));
+            lineIndex.push_back(FaceNodeOffset+j-1);
+        }
+
+        lineIndex.push_back(-1);
+        FaceNodeOffset += nbNodesInEdge;
+    }
+
+    vertexStart = FaceNodeOffset;
+    for (int i=0; i<V.Extent(); i++) {
+        const TopoDS_Vertex& aVertex = TopoDS::Vertex(V(i+1));
+        gp_Pnt pnt = BRep_Tool::Pnt(aVertex);
+        coords[FaceNodeOffset+i].setValue((float)(pnt.X()),(float)(pnt.Y()),(float)(pnt.Z()));
+    }
+}
+
+void ShapeTessellation::fillFace(FaceJob& job)
+{
+    const Handle(Poly_Triangulation)& mesh = job.mesh;
+    if (mesh.IsNull() || mesh->NbNodes() == 0)
+        return;
+
+    // getting the transformation of the shape/face
+    gp_Trsf myTransf;
+    Standard_Boolean identity = true;
+    if (!job.loc.IsIdentity()) {
+        identity = false;
+        myTransf = job.loc.Transformation();
+    }
+
+    // getting size of node and triangle array of this face
+    int nbNodesInFace = mesh->NbNodes();
+    int nbTriInFace   = mesh->NbTriangles();
+    // check orientation
+    TopAbs_Orientation orient = job.face.Orientation();
+
+    SbVec3f* verts = &coords[job.nodeOffset];
+    SbVec3f* norms = &normals[job.nodeOffset];
+    int32_t* index = &faceIndex[job.triaOffset*4];
+
+    // cycling through the poly mesh
+    const Poly_Array1OfTriangle& Triangles = mesh->Triangles();
+    const TColgp_Array1OfPnt& Nodes = mesh->Nodes();
+    for (int g=1;g<=nbTriInFace;g++) {
+        // Get the triangle
+        Standard_Integer N1,N2,N3;
+        Triangles(g).Get(N1,N2,N3);
+
+        // change orientation of the triangle if the face is reversed
+        if ( orient != TopAbs_FORWARD ) {
+            Standard_Integer tmp = N1;
+            N1 = N2;
+            N2 = tmp;
+        }
+
+        // get the 3 points of this triangle
+        gp_Pnt V1(Nodes(N1)), V2(Nodes(N2)), V3(Nodes(N3));
+
+        // transform the vertices to the place of the face
+        if (!identity) {
+            V1.Transform(myTransf);
+            V2.Transform(myTransf);
+            V3.Transform(myTransf);
+        }
+
+        // calculating per vertex normals
+        // Calculate triangle normal
+        gp_Vec v1(V1.X(),V1.Y(),V1.Z()),v2(V2.X(),V2.Y(),V2.Z()),v3(V3.X(),V3.Y(),V3.Z());
+        gp_Vec Normal = (v2-v1)^(v3-v1);
+
+        // add the triangle normal to the vertex normal for all points of this triangle
+        norms[N1-1] += SbVec3f(Normal.X(),Normal.Y(),Normal.Z());
+        norms[N2-1] += SbVec3f(Normal.X(),Normal.Y(),Normal.Z());
+        norms[N3-1] += SbVec3f(Normal.X(),Normal.Y(),Normal.Z());
+
+        // set the vertices
+        verts[N1-1].setValue((float)(V1.X()),(float)(V1.Y()),(float)(V1.Z()));
+        verts[N2-1].setValue((float)(V2.X()),(float)(V2.Y()),(float)(V2.Z()));
+        verts[N3-1].setValue((float)(V3.X()),(float)(V3.Y()),(float)(V3.Z()));
+
+        // set the index vector with the 3 point indexes and the end delimiter
+        index[4*(g-1)]   = job.nodeOffset+N1-1;
+        index[4*(g-1)+1] = job.nodeOffset+N2-1;
+        index[4*(g-1)+2] = job.nodeOffset+N3-1;
+        index[4*(g-1)+3] = SO_END_FACE_INDEX;
+    }
+
+    partIndex[job.index] = nbTriInFace; // new part
+
+    // normalize all normals of this face
+    for (int i=0; i<nbNodesInFace; i++)
+        norms[i].normalize();
+}
+
+unsigned int ShapeTessellation::getMemSize() const
+{
+    return coords.size() * sizeof(SbVec3f) +
+           normals.size() * sizeof(SbVec3f) +
+           faceIndex.size() * sizeof(int32_t) +
+           partIndex.size() * sizeof(int32_t) +
+           lineIndex.size() * sizeof(int32_t);
+}
+
+// ----------------------------------------------------------------------------
+
+TessellationCache* TessellationCache::_instance = 0;
+
+TessellationCache& TessellationCache::instance()
+{
+    if (!_instance)
+        _instance = new TessellationCache();
+    return *_instance;
+}
+
+TessellationCache::TessellationCache() : memSize(0)
+{
+}
+
+TessellationCache::~TessellationCache()
+{
+}
+
+bool TessellationCache::Key::operator < (const Key& k) const
+{
+    if (tshape != k.tshape)
+        return tshape < k.tshape;
+    if (orientation != k.orientation)
+        return orientation < k.orientation;
+    return deviation < k.deviation;
+}
+
+TessellationCache::Key TessellationCache::makeKey(const TopoDS_Shape& shape, double deviation)
+{
+    Key key;
+    key.tshape = shape.TShape().operator->();
+    key.orientation = (int)shape.Orientation();
+    key.deviation = deviation;
+    return key;
+}
+
+// The entry holds the shape, so its B-Rep and the triangulation of its faces are counted too
+static unsigned int getShapeMemSize(const TopoDS_Shape& shape)
+{
+    unsigned int memsize = Part::TopoShape(shape).getMemSize();
+    TopTools_IndexedMapOfShape M;
+    TopExp::MapShapes(shape, TopAbs_FACE, M);
+    for (int i=1; i <= M.Extent(); i++) {
+        TopLoc_Location loc;
+        Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(TopoDS::Face(M(i)), loc);
+        if (mesh.IsNull())
+            continue;
+        memsize += mesh->NbNodes() * sizeof(gp_Pnt) + mesh->NbTriangles() * sizeof(Poly_Triangle);
+        if (mesh->HasUVNodes())
+            memsize += mesh->NbNodes() * sizeof(gp_Pnt2d);
+    }
+    return memsize;
+}
+
+boost::shared_ptr<const ShapeTessellation>
+TessellationCache::find(const TopoDS_Shape& shape, double deviation, const ViewProviderPartExt* owner)
+{
+    Key key = makeKey(shape, deviation);
+    QMutexLocker locker(&mutex);
+    std::map<Key, EntryList::iterator>::iterator it = index.find(key);
+    if (it == index.end())
+        return boost::shared_ptr<const ShapeTessellation>();
+    entries.splice(entries.begin(), entries, it->second);
+    if (owner)
+        it->second->owners.insert(owner);
+    return it->second->mesh;
+}
+
+boost::shared_ptr<const ShapeTessellation>
+TessellationCache::tessellate(const TopoDS_Shape& inputShape, double deviation,
+                              const ViewProviderPartExt* owner, const TopoDS_Shape& copy)
+{
+    // We must reset the location here because the transformation data
+    // are set in the placement property
+    TopoDS_Shape shape(inputShape);
+    shape.Location(TopLoc_Location());
+
+    boost::shared_ptr<const ShapeTessellation> cached = find(shape, deviation, owner);
+    if (cached)
+        return cached;
+    Key key = makeKey(shape, deviation);
+
+    // BRepMesh stores the triangulation in the faces and edges of the meshed shape,
+    // only the converted arrays of the copy are kept
+    TopoDS_Shape meshed(shape);
+    if (!copy.IsNull()) {
+        meshed = copy;
+        meshed.Location(TopLoc_Location());
+    }
+
+    // calculating the deflection value
+    Bnd_Box bounds;
+    BRepBndLib::Add(meshed, bounds);
+    bounds.SetGap(0.0);
+    Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
+    bounds.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+    Standard_Real deflection = ((xMax-xMin)+(yMax-yMin)+(zMax-zMin))/300.0 * deviation;
+
+    boost::shared_ptr<const ShapeTessellation> mesh(new ShapeTessellation(meshed, deflection));
+    // the copy has the same B-Rep as the shape
+    unsigned int size = mesh->getMemSize() + getShapeMemSize(meshed);
+
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part");
+    unsigned long maxSize = hGrp->GetUnsigned("TessellationCacheSize", 256) * 1024 * 1024;
+
+    QMutexLocker locker(&mutex);
+    std::map<Key, EntryList::iterator>::iterator it = index.find(key);
+    if (it == index.end()) {
+        Entry entry;
+        entry.key = key;
+        entry.shape = shape;
+        entry.mesh = mesh;
+        entry.memSize = size;
+        entries.push_front(entry);
+        it = index.insert(std::make_pair(key, entries.begin())).first;
+        memSize += size;
+    }
+    if (owner)
+        it->second->owners.insert(owner);
+
+    // drop the least recently used entries but keep the new one
+    while (memSize > maxSize && entries.size() > 1) {
+        const Entry& last = entries.back();
+        memSize -= last.memSize;
+        index.erase(last.key);
+        entries.pop_back();
+    }
+
+    return mesh;
+}
+
+void TessellationCache::release(const ViewProviderPartExt* owner)
+{
+    QMutexLocker locker(&mutex);
+    for (EntryList::iterator it = entries.begin(); it != entries.end();) {
+        // an entry without users, e.g. the result of the worker thread that isn't
+        // passed to its view provider yet, is only dropped as least recently used
+        if (it->owners.erase(owner) > 0 && it->owners.empty()) {
+            memSize -= it->memSize;
+            index.erase(it->key);
+            it = entries.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+void TessellationCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    index.clear();
+    entries.clear();
+    memSize = 0;
+}
+
+unsigned int TessellationCache::getMemSize() const
+{
+    QMutexLocker locker(&mutex);
+    return memSize;
+}
+
+// ----------------------------------------------------------------------------
+
+TessellationQueue* TessellationQueue::_instance = 0;
+
+TessellationQueue& TessellationQueue::instance()
+{
+    if (!_instance)
+        _instance = new TessellationQueue();
+    return *_instance;
+}
+
+TessellationQueue::TessellationQueue() : lastId(0), running(false)
+{
+}
+
+TessellationQueue::~TessellationQueue()
+{
+}
+
+void TessellationQueue::submit(ViewProviderPartExt* vp, const TopoDS_Shape& shape, double deviation)
+{
+    // the copy is made in the GUI thread because BRepBuilderAPI_Copy reads the B-Rep
+    // which the GUI thread may modify while the worker is running
+    Job job;
+    job.vp = vp;
+    job.shape = shape;
+    job.copy = BRepBuilderAPI_Copy(shape).Shape();
+    job.deviation = deviation;
+
+    QMutexLocker locker(&mutex);
+    job.id = ++lastId;
+    current[vp] = job.id;
+
+    // an outdated job that hasn't started yet isn't needed any more
+    for (std::list<Job>::iterator it = pending.begin(); it != pending.end();) {
+        if (it->vp == vp)
+            it = pending.erase(it);
+        else
+            ++it;
+    }
+    pending.push_back(job);
+
+    if (!running) {
+        running = true;
+        QtConcurrent::run(this, &TessellationQueue::process);
+    }
+}
+
+void TessellationQueue::cancel(ViewProviderPartExt* vp)
+{
+    QMutexLocker locker(&mutex);
+    current.erase(vp);
+    for (std::list<Job>::iterator it = pending.begin(); it != pending.end();) {
+        if (it->vp == vp)
+            it = pending.erase(it);
+        else
+            ++it;
+    }
+}
+
+bool TessellationQueue::isPending(ViewProviderPartExt* vp) const
+{
+    QMutexLocker locker(&mutex);
+    return current.find(vp) != current.end();
+}
+
+void TessellationQueue::process()
+{
+    for (;;) {
+        Job job;
+        {
+            QMutexLocker locker(&mutex);
+            if (pending.empty() || QCoreApplication::closingDown()) {
+                pending.clear();
+                running = false;
+                return;
+            }
+            job = pending.front();
+            pending.pop_front();
+        }
+
+        try {
+            // the view provider may be destroyed in the meantime, so it's added to the
+            // users of the entry in the GUI thread
+            job.mesh = TessellationCache::instance().tessellate(job.shape, job.deviation, 0, job.copy);
+        }
+        catch (...) {
+            // a null mesh makes the view provider report the error
+        }
+
+        {
+            QMutexLocker locker(&mutex);
+            finished.push_back(job);
+        }
+        QCoreApplication::postEvent(this, new QEvent(QEvent::User));
+    }
+}
+
+void TessellationQueue::customEvent(QEvent*)
+{
+    std::list<Job> jobs;
+    {
+        QMutexLocker locker(&mutex);
+        jobs.swap(finished);
+    }
+
+    for (std::list<Job>::iterator it = jobs.begin(); it != jobs.end(); ++it) {
+        {
+            // the result is ignored if the shape has changed in the meantime
+            QMutexLocker locker(&mutex);
+            std::map<ViewProviderPartExt*, unsigned long>::iterator jt = current.find(it->vp);
+            if (jt == current.end() || jt->second != it->id)
+                continue;
+            current.erase(jt);
+        }
+        if (it->mesh)
+            TessellationCache::instance().find(it->shape, it->deviation, it->vp);
+        it->vp->applyTessellation(it->mesh.get());
+    }
+}
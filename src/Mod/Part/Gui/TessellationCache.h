@@ -0,0 +1,187 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef PARTGUI_TESSELLATIONCACHE_H
+#define PARTGUI_TESSELLATIONCACHE_H
+
+#include <Inventor/SbVec3f.h>
+#include <TopoDS_Shape.hxx>
+#include <boost/shared_ptr.hpp>
+#include <QMutex>
+#include <QObject>
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+
+class TopoDS_Face;
+class TopLoc_Location;
+class Poly_Triangulation;
+
+namespace PartGui {
+
+class ViewProviderPartExt;
+
+/**
+ * The ShapeTessellation class holds the triangulation of a shape in the form of the
+ * fields of the Inventor nodes of ViewProviderPartExt. It doesn't touch any Inventor
+ * node and thus can be computed in a worker thread.
+ */
+class PartGuiExport ShapeTessellation
+{
+public:
+    /// Meshes the shape with the absolute deflection if needed and converts the triangulation
+    ShapeTessellation(const TopoDS_Shape& shape, double deflection);
+
+    std::vector<SbVec3f> coords;    /**< nodes of the faces, nodes of the free edges and the vertices */
+    std::vector<SbVec3f> normals;   /**< per-vertex normals of the nodes of the faces */
+    std::vector<int32_t> faceIndex; /**< three node indices and SO_END_FACE_INDEX per triangle */
+    std::vector<int32_t> partIndex; /**< number of triangles per face */
+    std::vector<int32_t> lineIndex; /**< node indices of the edges, each edge terminated by -1 */
+    int vertexStart;                /**< index of the first vertex in coords */
+    int numEdges;                   /**< number of edges of the shape */
+
+    unsigned int getMemSize() const;
+
+private:
+    struct FaceJob;
+    void fillFace(FaceJob&);
+};
+
+/**
+ * The TessellationCache class keeps the tessellations of recently displayed shapes, so that
+ * re-displaying a shape, toggling its visibility or changing its placement doesn't mesh it again.
+ * The entries are identified by the shape without its location and the deviation. An entry
+ * holds its shape, so that the address of the TShape cannot be reused by another shape, and it
+ * is dropped when the last view provider that has shown the shape is destroyed. The least
+ * recently used entries are dropped if the cache exceeds the size set by the parameter
+ * TessellationCacheSize (in MB) of the Part module. The size of an entry includes its shape.
+ */
+class PartGuiExport TessellationCache
+{
+public:
+    static TessellationCache& instance();
+
+    /**
+     * Returns the tessellation of the shape. The deflection is the \a deviation in percent of
+     * the size of the bounding box. The location of the shape is ignored because it's handled
+     * by the placement of the view provider. The view provider \a owner, if not null, is added
+     * to the users of the entry. If \a copy isn't null it's meshed instead of the shape, which
+     * isn't accessed then. A worker thread must pass a copy that was made in the GUI thread.
+     */
+    boost::shared_ptr<const ShapeTessellation> tessellate(const TopoDS_Shape& shape, double deviation,
+                                                          const ViewProviderPartExt* owner,
+                                                          const TopoDS_Shape& copy=TopoDS_Shape());
+    /// Returns the tessellation of the shape if it's in the cache, otherwise null
+    boost::shared_ptr<const ShapeTessellation> find(const TopoDS_Shape& shape, double deviation,
+                                                    const ViewProviderPartExt* owner);
+    /**
+     * Removes the view provider from the users of all entries and drops the entries that have
+     * no users left. Entries that had no users before are kept. It must be called when a view
+     * provider is destroyed, i.e. when its object is deleted or its document is closed, so
+     * that the cache doesn't keep their shapes alive.
+     */
+    void release(const ViewProviderPartExt* owner);
+    /// Removes all entries
+    void clear();
+    unsigned int getMemSize() const;
+
+private:
+    TessellationCache();
+    ~TessellationCache();
+
+    struct Key {
+        const void* tshape;
+        int orientation;
+        double deviation;
+        bool operator < (const Key&) const;
+    };
+    static Key makeKey(const TopoDS_Shape& shape, double deviation);
+    struct Entry {
+        Key key;
+        TopoDS_Shape shape; // holds the TShape so that its address cannot be reused
+        boost::shared_ptr<const ShapeTessellation> mesh;
+        std::set<const ViewProviderPartExt*> owners;
+        unsigned int memSize; // of the tessellation and the shape
+    };
+    typedef std::list<Entry> EntryList;
+
+    EntryList entries; // most recently used first
+    std::map<Key, EntryList::iterator> index;
+    unsigned int memSize;
+    mutable QMutex mutex;
+
+    static TessellationCache* _instance;
+};
+
+/**
+ * The TessellationQueue class tessellates shapes in a worker thread, one job after the other.
+ * The worker meshes a copy of the shape that is made when the job is submitted, so the B-Rep
+ * that the GUI thread works with is never accessed by the worker. The result is passed to the view provider in the GUI thread. If the shape of a view
+ * provider changes before its job is done the outdated job is dropped or its result is ignored.
+ */
+class PartGuiExport TessellationQueue : public QObject
+{
+public:
+    static TessellationQueue& instance();
+
+    /// Copies the shape, queues its tessellation for the view provider and drops the outdated job
+    void submit(ViewProviderPartExt* vp, const TopoDS_Shape& shape, double deviation);
+    /**
+     * Drops the job of the view provider if it hasn't started yet. A running job cannot be
+     * interrupted because BRepMesh cannot be stopped, it runs to the end and its result is
+     * discarded.
+     */
+    void cancel(ViewProviderPartExt* vp);
+    /// Returns true if the view provider waits for its tessellation
+    bool isPending(ViewProviderPartExt* vp) const;
+
+protected:
+    void customEvent(QEvent*);
+
+private:
+    TessellationQueue();
+    ~TessellationQueue();
+    void process();
+
+    struct Job {
+        ViewProviderPartExt* vp;
+        unsigned long id;
+        TopoDS_Shape shape;
+        TopoDS_Shape copy; // is meshed by the worker
+        double deviation;
+        boost::shared_ptr<const ShapeTessellation> mesh;
+    };
+
+    std::list<Job> pending, finished;
+    std::map<ViewProviderPartExt*, unsigned long> current; // id of the valid job of a view provider
+    unsigned long lastId;
+    bool running;
+    mutable QMutex mutex;
+
+    static TessellationQueue* _instance;
+};
+
+} // namespace PartGui
+
+#endif // PARTGUI_TESSELLATIONCACHE_H
@@ -24,8 +24,10 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
 # include <sstream>
 # include <Poly_Polygon3D.hxx>
+# include <Bnd_Box.hxx>
 # include <BRepBndLib.hxx>
 # include <BRepMesh.hxx>
 # include <BRepMesh_IncrementalMesh.hxx>
@@ -46,6 +48,7 @@
 # include <Poly_Array1OfTriangle.hxx>
 # include <Poly_Triangulation.hxx>
 # include <TColgp_Array1OfPnt.hxx>
+# include <TopLoc_Location.hxx>
 # include <TopoDS.hxx>
 # include <TopoDS_Edge.hxx>
 # include <TopoDS_Wire.hxx>
@@ -103,6 +106,7 @@
 #include "ViewProviderExt.h"
 #include "SoBrepShape.h"
 #include "TaskFaceColors.h"
+#include "TessellationCache.h"
 
 #include <Mod/Part/App/PartFeature.h>
 #include <Mod/Part/App/PrimitiveFeature.h>
@@ -201,6 +205,8 @@ ViewProviderPartExt::ViewProviderPartExt()
 
 ViewProviderPartExt::~ViewProviderPartExt()
 {
+    TessellationQueue::instance().cancel(this);
+    TessellationCache::instance().release(this);
     pcShapeBind->unref();
     pcLineMaterial->unref();
     pcPointMaterial->unref();
@@ -515,13 +521,6 @@ void ViewProviderPartExt::updateData(const App::Property* prop)
             updateVisual(cShape);
         else
             VisualTouched = true;
-
-        if (!VisualTouched) {
-            if (this->faceset->partIndex.getNum() > 
-                this->pcShapeMaterial->diffuseColor.getNum()) {
-                this->pcShapeBind->value = SoMaterialBinding::OVERALL;
-            }
-        }
     }
     Gui::ViewProviderGeometryObject::updateData(prop);
 }
@@ -563,6 +562,21 @@ void ViewProviderPartExt::unsetEdit(int ModNum)
     }
 }
 
+// Shapes with at least this number of faces are tessellated in the background
+static bool tessellateInBackground(const TopoDS_Shape& shape)
+{
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part");
+    if (!hGrp->GetBool("BackgroundTessellation", true))
+        return false;
+    int minFaces = hGrp->GetInt("BackgroundTessellationFaces", 200);
+    int nbrFaces = 0;
+    TopExp_Explorer xp;
+    for (xp.Init(shape, TopAbs_FACE); xp.More() && nbrFaces < minFaces; xp.Next())
+        nbrFaces++;
+    return nbrFaces >= minFaces;
+}
+
 void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
 {
     // Clear selection
@@ -573,6 +587,7 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
 
     TopoDS_Shape cShape(inputShape);
     if (cShape.IsNull()) {
+        TessellationQueue::instance().cancel(this);
         coords  ->point      .setNum(0);
         norm    ->vector     .setNum(0);
         faceset ->coordIndex .setNum(0);
@@ -585,285 +600,126 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
 
     // time measurement and book keeping
     Base::TimeInfo start_time;
-    int nbrTriangles=0,nbrNodes=0,nbrNorms=0,nbrFaces=0,nbrEdges=0,nbrLines=0;
-    std::set<int> faceEdges;
+    boost::shared_ptr<const ShapeTessellation> mesh;
 
     try {
-        // calculating the deflection value
-        Bnd_Box bounds;
-        BRepBndLib::Add(cShape, bounds);
-        bounds.SetGap(0.0);
-        Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
-        bounds.Get(xMin, yMin, zMin, xMax, yMax, zMax);
-        Standard_Real deflection = ((xMax-xMin)+(yMax-yMin)+(zMax-zMin))/300.0 *
-            Deviation.getValue();
-
-        // create or use the mesh on the data structure
-        BRepMesh_IncrementalMesh myMesh(cShape,deflection);
-        // We must reset the location here because the transformation data
-        // are set in the placement property
-        TopLoc_Location aLoc;
-        cShape.Location(aLoc);
-
-        // count triangles and nodes in the mesh
-        TopExp_Explorer Ex;
-        for (Ex.Init(cShape,TopAbs_FACE);Ex.More();Ex.Next()) {
-            Handle (Poly_Triangulation) mesh = BRep_Tool::Triangulation(TopoDS::Face(Ex.Current()), aLoc);
-            // Note: we must also count empty faces
-            if (!mesh.IsNull()) {
-                nbrTriangles += mesh->NbTriangles();
-                nbrNodes     += mesh->NbNodes();
-                nbrNorms     += mesh->NbNodes();
-            }
-
-            TopExp_Explorer xp;
-            for (xp.Init(Ex.Current(),TopAbs_EDGE);xp.More();xp.Next())
-                faceEdges.insert(xp.Current().HashCode(INT_MAX));
-            nbrFaces++;
+        // the tessellation is computed or taken from the cache if the shape has been
+        // shown before, the location is ignored because it's set in the placement property
+        mesh = TessellationCache::instance().find(cShape, Deviation.getValue(), this);
+        if (!mesh && tessellateInBackground(cShape)) {
+            // show the bounding box until the tessellation is done
+            showBoundingBox(cShape);
+            TessellationQueue::instance().submit(this, cShape, Deviation.getValue());
+            VisualTouched = false;
+            return;
         }
 
-        // get an indexed map of edges
-        TopTools_IndexedMapOfShape M;
-        TopExp::MapShapes(cShape, TopAbs_EDGE, M);
-
-        std::set<int>         edgeIdxSet;
-        std::vector<int32_t>  indxVector;
-        std::vector<int32_t>  edgeVector;
-
-        // count and index the edges
-        for (int i=1; i <= M.Extent(); i++) {
-            edgeIdxSet.insert(i);
-            nbrEdges++;
-
-            const TopoDS_Edge& aEdge = TopoDS::Edge(M(i));
-            TopLoc_Location aLoc;
-
-            // handling of the free edge that are not associated to a face
-            // Note: The assumption that if for an edge BRep_Tool::Polygon3D
-            // returns a valid object is wrong. This e.g. happens for ruled
-            // surfaces which gets created by two edges or wires.
-            // So, we have to store the hashes of the edges associated to a face.
-            // If the hash of a given edge is not in this list we know it's really
-            // a free edge.
-            int hash = aEdge.HashCode(INT_MAX);
-            if (faceEdges.find(hash) == faceEdges.end()) {
-                Handle(Poly_Polygon3D) aPoly = BRep_Tool::Polygon3D(aEdge, aLoc);
-                if (!aPoly.IsNull()) {
-                    int nbNodesInEdge = aPoly->NbNodes();
-                    nbrNodes += nbNodesInEdge;
-                }
-            }
-        }
-        // reserve some memory
-        indxVector.reserve(nbrEdges*8);
-
-        // handling of the vertices
-        TopTools_IndexedMapOfShape V;
-        TopExp::MapShapes(cShape, TopAbs_VERTEX, V);
-        nbrNodes += V.Extent();
-
-        // create memory for the nodes and indexes
-        coords  ->point      .setNum(nbrNodes);
-        norm    ->vector     .setNum(nbrNorms);
-        faceset ->coordIndex .setNum(nbrTriangles*4);
-        faceset ->partIndex  .setNum(nbrFaces);
-        // get the raw memory for fast fill up
-        SbVec3f* verts = coords  ->point       .startEditing();
-        SbVec3f* norms = norm    ->vector      .startEditing();
-        int32_t* index = faceset ->coordIndex  .startEditing();
-        int32_t* parts = faceset ->partIndex   .startEditing();
-
-        // preset the normal vector with null vector
-        for (int i=0;i < nbrNorms;i++) 
-            norms[i]= SbVec3f(0.0,0.0,0.0);
-
-        int ii = 0,FaceNodeOffset=0,FaceTriaOffset=0;
-        for (Ex.Init(cShape, TopAbs_FACE); Ex.More(); Ex.Next(),ii++) {
-            TopLoc_Location aLoc;
-            const TopoDS_Face &actFace = TopoDS::Face(Ex.Current());
-            // get the mesh of the shape
-            Handle (Poly_Triangulation) mesh = BRep_Tool::Triangulation(actFace,aLoc);
-            if (mesh.IsNull()) continue;
-
-            // getting the transformation of the shape/face
-            gp_Trsf myTransf;
-            Standard_Boolean identity = true;
-            if (!aLoc.IsIdentity()) {
-                identity = false;
-                myTransf = aLoc.Transformation();
-            }
-
-            // getting size of node and triangle array of this face
-            int nbNodesInFace = mesh->NbNodes();
-            int nbTriInFace   = mesh->NbTriangles();
-            // check orientation
-            TopAbs_Orientation orient = actFace.Orientation();
-
-
-            // cycling through the poly mesh
-            const Poly_Array1OfTriangle& Triangles = mesh->Triangles();
-            const TColgp_Array1OfPnt& Nodes = mesh->Nodes();
-            for (int g=1;g<=nbTriInFace;g++) {
-                // Get the triangle
-                Standard_Integer N1,N2,N3;
-                Triangles(g).Get(N1,N2,N3);
-
-                // change orientation of the triangle if the face is reversed
-                if ( orient != TopAbs_FORWARD ) {
-                    Standard_Integer tmp = N1;
-                    N1 = N2;
-                    N2 = tmp;
-                }
-
-                // get the 3 points of this triangle
-                gp_Pnt V1(Nodes(N1)), V2(Nodes(N2)), V3(Nodes(N3));
-
-                // transform the vertices to the place of the face
-                if (!identity) {
-                    V1.Transform(myTransf);
-                    V2.Transform(myTransf);
-                    V3.Transform(myTransf);
-                }
-                
-                // calculating per vertex normals                    
-                // Calculate triangle normal
-                gp_Vec v1(V1.X(),V1.Y(),V1.Z()),v2(V2.X(),V2.Y(),V2.Z()),v3(V3.X(),V3.Y(),V3.Z());
-                gp_Vec Normal = (v2-v1)^(v3-v1); 
-
-                // add the triangle normal to the vertex normal for all points of this triangle
-                norms[FaceNodeOffset+N1-1] += SbVec3f(Normal.X(),Normal.Y(),Normal.Z());
-                norms[FaceNodeOffset+N2-1] += SbVec3f(Normal.X(),Normal.Y(),Normal.Z());
-                norms[FaceNodeOffset+N3-1] += SbVec3f(Normal.X(),Normal.Y(),Normal.Z());                 
-
-                // set the vertices
-                verts[FaceNodeOffset+N1-1].setValue((float)(V1.X()),(float)(V1.Y()),(float)(V1.Z()));
-                verts[FaceNodeOffset+N2-1].setValue((float)(V2.X()),(float)(V2.Y()),(float)(V2.Z()));
-                verts[FaceNodeOffset+N3-1].setValue((float)(V3.X()),(float)(V3.Y()),(float)(V3.Z()));
-
-                // set the index vector with the 3 point indexes and the end delimiter
-                index[FaceTriaOffset*4+4*(g-1)]   = FaceNodeOffset+N1-1; 
-                index[FaceTriaOffset*4+4*(g-1)+1] = FaceNodeOffset+N2-1; 
-                index[FaceTriaOffset*4+4*(g-1)+2] = FaceNodeOffset+N3-1; 
-                index[FaceTriaOffset*4+4*(g-1)+3] = SO_END_FACE_INDEX;
-            }
+        // a pending result would be outdated
+        TessellationQueue::instance().cancel(this);
+        if (!mesh)
+            mesh = TessellationCache::instance().tessellate(cShape, Deviation.getValue(), this);
+    }
+    catch (...) {
+    }
 
-            parts[ii] = nbTriInFace; // new part
-
-            // handling the edges lying on this face
-            TopExp_Explorer Exp;
-            for(Exp.Init(actFace,TopAbs_EDGE);Exp.More();Exp.Next()) {
-                const TopoDS_Edge &actEdge = TopoDS::Edge(Exp.Current());
-                // get the overall index of this edge
-                int idx = M.FindIndex(actEdge);
-                edgeVector.push_back((int32_t)idx-1);
-                // already processed this index ?
-                if (edgeIdxSet.find(idx)!=edgeIdxSet.end()) {
-                    
-                    // this holds the indices of the edge's triangulation to the current polygon
-                    Handle(Poly_PolygonOnTriangulation) aPoly = BRep_Tool::PolygonOnTriangulation(actEdge, mesh, aLoc);
-                    if (aPoly.IsNull())
-                        continue; // polygon does not exist
-                    
-                    // getting the indexes of the edge polygon
-                    const TColStd_Array1OfInteger& indices = aPoly->Nodes();
-                    for (Standard_Integer i=indices.Lower();i <= indices.Upper();i++) {
-                        int inx = indices(i);
-                        indxVector.push_back(FaceNodeOffset+inx-1);
-
-                        // usually the coordinates for this edge are already set by the
-                        // triangles of the face this edge belongs to. However, there are
-                        // rare cases where some points are only referenced by the polygon
-                        // but not by any triangle. Thus, we must apply the coordinates to
-                        // make sure that everything is properly set.
-                        gp_Pnt p(Nodes(inx));
-                        if (!identity)
-                            p.Transform(myTransf);
-                        verts[FaceNodeOffset+inx-1].setValue((float)(p.X()),(float)(p.Y()),(float)(p.Z()));
-                    }
-                    indxVector.push_back(-1);
-
-                    // remove the handled edge index from the set
-                    edgeIdxSet.erase(idx);
-                }
-            }
+    applyTessellation(mesh.get());
 
-            edgeVector.push_back(-1);
-            
-            // counting up the per Face offsets
-            FaceNodeOffset += nbNodesInFace;
-            FaceTriaOffset += nbTriInFace;
-        }
+#   ifdef FC_DEBUG
+        // printing some informations
+        Base::Console().Log("ViewProvider update time: %f s\n",Base::TimeInfo::diffTimeF(start_time,Base::TimeInfo()));
+#   endif 
+    VisualTouched = false;
+}
 
-        // handling of the free edges
-        for (int i=1; i <= M.Extent(); i++) {
-            const TopoDS_Edge& aEdge = TopoDS::Edge(M(i));
-            Standard_Boolean identity = true;
-            gp_Trsf myTransf;
-            TopLoc_Location aLoc;
-
-            // handling of the free edge that are not associated to a face
-            int hash = aEdge.HashCode(INT_MAX);
-            if (faceEdges.find(hash) == faceEdges.end()) {
-                Handle(Poly_Polygon3D) aPoly = BRep_Tool::Polygon3D(aEdge, aLoc);
-                if (!aPoly.IsNull()) {
-                    if (!aLoc.IsIdentity()) {
-                        identity = false;
-                        myTransf = aLoc.Transformation();
-                    }
-
-                    const TColgp_Array1OfPnt& aNodes = aPoly->Nodes();
-                    int nbNodesInEdge = aPoly->NbNodes();
-
-                    gp_Pnt pnt;
-                    for (Standard_Integer j=1;j <= nbNodesInEdge;j++) {
-                        pnt = aNodes(j);
-                        if (!identity)
-                            pnt.Transform(myTransf);
-                        verts[FaceNodeOffset+j-1].setValue((float)(pnt.X()),(float)(pnt.Y()),(float)(pnt.Z()));
-                        indxVector.push_back(FaceNodeOffset+j-1);
-                    }
-
-                    indxVector.push_back(-1);
-                    FaceNodeOffset += nbNodesInEdge;
-                }
-            }
-        }
+void ViewProviderPartExt::applyTessellation(const ShapeTessellation* mesh)
+{
+    if (!mesh) {
+        Base::Console().Error("Cannot compute Inventor representation for the shape of %s.\n",pcObject->getNameInDocument());
+        return;
+    }
 
-        nodeset->startIndex.setValue(FaceNodeOffset);
-        for (int i=0; i<V.Extent(); i++) {
-            const TopoDS_Vertex& aVertex = TopoDS::Vertex(V(i+1));
-            gp_Pnt pnt = BRep_Tool::Pnt(aVertex);
-            verts[FaceNodeOffset+i].setValue((float)(pnt.X()),(float)(pnt.Y()),(float)(pnt.Z()));
-        }
+    // Clear selection
+    Gui::SoSelectionElementAction action(Gui::SoSelectionElementAction::None);
+    action.apply(this->faceset);
+    action.apply(this->lineset);
+    action.apply(this->nodeset);
 
-        // normalize all normals 
-        for (int i = 0; i< nbrNorms ;i++)
-            norms[i].normalize();
-        
-        // preset the index vector size
-        nbrLines =  indxVector.size();
-        lineset ->coordIndex .setNum(nbrLines);
-        int32_t* lines = lineset ->coordIndex  .startEditing();
-
-        int l=0;
-        for (std::vector<int32_t>::const_iterator it=indxVector.begin();it!=indxVector.end();++it,l++)
-            lines[l] = *it;
-
-        // end the editing of the nodes
-        coords  ->point       .finishEditing();
-        norm    ->vector      .finishEditing();
-        faceset ->coordIndex  .finishEditing();
-        faceset ->partIndex   .finishEditing();
-        lineset ->coordIndex  .finishEditing();
-    }
-    catch (...) {
-        Base::Console().Error("Cannot compute Inventor representation for the shape of %s.\n",pcObject->getNameInDocument());
+    int nbrNodes     = (int)mesh->coords.size();
+    int nbrNorms     = (int)mesh->normals.size();
+    int nbrTriangles = (int)mesh->faceIndex.size()/4;
+    int nbrFaces     = (int)mesh->partIndex.size();
+    int nbrLines     = (int)mesh->lineIndex.size();
+
+    // create memory for the nodes and indexes
+    coords  ->point      .setNum(nbrNodes);
+    norm    ->vector     .setNum(nbrNorms);
+    faceset ->coordIndex .setNum(nbrTriangles*4);
+    faceset ->partIndex  .setNum(nbrFaces);
+    lineset ->coordIndex .setNum(nbrLines);
+    nodeset ->startIndex .setValue(mesh->vertexStart);
+
+    // copy the tessellation into the raw memory of the nodes
+    std::copy(mesh->coords.begin(), mesh->coords.end(), coords->point.startEditing());
+    std::copy(mesh->normals.begin(), mesh->normals.end(), norm->vector.startEditing());
+    std::copy(mesh->faceIndex.begin(), mesh->faceIndex.end(), faceset->coordIndex.startEditing());
+    std::copy(mesh->partIndex.begin(), mesh->partIndex.end(), faceset->partIndex.startEditing());
+    std::copy(mesh->lineIndex.begin(), mesh->lineIndex.end(), lineset->coordIndex.startEditing());
+
+    // end the editing of the nodes
+    coords  ->point       .finishEditing();
+    norm    ->vector      .finishEditing();
+    faceset ->coordIndex  .finishEditing();
+    faceset ->partIndex   .finishEditing();
+    lineset ->coordIndex  .finishEditing();
+
+    if (this->faceset->partIndex.getNum() > 
+        this->pcShapeMaterial->diffuseColor.getNum()) {
+        this->pcShapeBind->value = SoMaterialBinding::OVERALL;
     }
 
+    // per-face colors that were set while the shape was tessellated in the background
+    // couldn't be applied because the number of faces wasn't known yet
+    if (DiffuseColor.getSize() > 1)
+        onChanged(&DiffuseColor);
+
 #   ifdef FC_DEBUG
         // printing some informations
-        Base::Console().Log("ViewProvider update time: %f s\n",Base::TimeInfo::diffTimeF(start_time,Base::TimeInfo()));
-        Base::Console().Log("Shape tria info: Faces:%d Edges:%d Nodes:%d Triangles:%d IdxVec:%d\n",nbrFaces,nbrEdges,nbrNodes,nbrTriangles,nbrLines);
+        Base::Console().Log("Shape tria info: Faces:%d Edges:%d Nodes:%d Triangles:%d IdxVec:%d\n",nbrFaces,mesh->numEdges,nbrNodes,nbrTriangles,nbrLines);
 #   endif 
-    VisualTouched = false;
+}
+
+void ViewProviderPartExt::showBoundingBox(const TopoDS_Shape& inputShape)
+{
+    TopoDS_Shape cShape(inputShape);
+    cShape.Location(TopLoc_Location());
+    Bnd_Box bounds;
+    BRepBndLib::Add(cShape, bounds);
+    bounds.SetGap(0.0);
+
+    norm    ->vector     .setNum(0);
+    faceset ->coordIndex .setNum(0);
+    faceset ->partIndex  .setNum(0);
+    if (bounds.IsVoid()) {
+        coords  ->point      .setNum(0);
+        lineset ->coordIndex .setNum(0);
+        nodeset ->startIndex .setValue(0);
+        return;
+    }
+
+    Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
+    bounds.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+    coords->point.setNum(8);
+    SbVec3f* verts = coords->point.startEditing();
+    for (int i=0; i<8; i++) {
+        verts[i].setValue((float)((i & 1) ? xMax : xMin),
+                          (float)((i & 2) ? yMax : yMin),
+                          (float)((i & 4) ? zMax : zMin));
+    }
+    coords->point.finishEditing();
+
+    // bottom and top rectangle and the four vertical edges
+    static const int32_t box[24] = {0,1,3,2,0,-1, 4,5,7,6,4,-1, 0,4,-1, 1,5,-1, 2,6,-1, 3,7,-1};
+    lineset ->coordIndex .setNum(24);
+    lineset ->coordIndex .setValues(0, 24, box);
+    nodeset ->startIndex .setValue(8);
 }
@@ -56,6 +56,7 @@ namespace PartGui {
 class SoBrepFaceSet;
 class SoBrepEdgeSet;
 class SoBrepPointSet;
+class ShapeTessellation;
 
 class PartGuiExport ViewProviderPartExt : public Gui::ViewProviderGeometryObject
 {
@@ -90,6 +91,8 @@ public:
     void reload();
 
     virtual void updateData(const App::Property*);
+    /// Sets the tessellation of the shape, a null pointer means that it couldn't be computed
+    void applyTessellation(const ShapeTessellation*);
 
       /** @name Selection handling
       * This group of methodes do the selection handling.
@@ -119,6 +122,7 @@ protected:
     virtual void onChanged(const App::Property* prop);
     bool loadParameter();
     void updateVisual(const TopoDS_Shape &);
+    void showBoundingBox(const TopoDS_Shape &);
 
     // nodes for the data representation
     SoMaterialBinding * pcShapeBind;
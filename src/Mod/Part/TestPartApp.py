@@ -19,7 +19,7 @@
 #   USA                                                                   *
 #**************************************************************************
 
-import FreeCAD, os, sys, unittest, Part
+import FreeCAD, os, sys, unittest, tempfile, Part
 App = FreeCAD
 
 #---------------------------------------------------------------------------
@@ -40,3 +40,50 @@ class PartTestCases(unittest.TestCase):
 		#closing doc
 		FreeCAD.closeDocument("PartTest")
 		#print ("omit clos document for debuging")
+
+class PartTriangulationTestCases(unittest.TestCase):
+	def setUp(self):
+		self.Param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Part")
+		self.SaveTriangulation = self.Param.GetBool("SaveTriangulation", False)
+		self.Doc = FreeCAD.newDocument("PartTriangulationTest")
+		self.DocName = tempfile.gettempdir() + os.sep + "PartTriangulationTest.FCStd"
+		self.Box = self.Doc.addObject("Part::Feature","Box")
+		# meshing the shape stores the triangulation in its faces
+		shape = Part.makeBox(10,10,10)
+		shape.tessellate(0.1)
+		self.Box.Shape = shape
+
+	def countTriangulations(self, shape):
+		# the number of triangulations is written in the BRep format
+		for line in shape.exportBrepToString().splitlines():
+			if line.startswith("Triangulations"):
+				return int(line.split()[1])
+		return 0
+
+	def testSaveTriangulation(self):
+		self.failUnless(self.countTriangulations(self.Box.Shape) == 6)
+		for save, count in [(True, 6), (False, 0)]:
+			self.Param.SetBool("SaveTriangulation", save)
+			self.Doc.FileName = self.DocName
+			self.Doc.save()
+			FreeCAD.closeDocument("PartTriangulationTest")
+			self.Doc = FreeCAD.open(self.DocName)
+			self.Box = self.Doc.getObject("Box")
+			self.failUnless(len(self.Box.Shape.Faces) == 6)
+			self.failUnless(self.countTriangulations(self.Box.Shape) == count)
+
+	def testUndoKeepsTriangulation(self):
+		# the copy of the shape in the undo transaction gets the triangulation
+		self.Doc.UndoMode = 1
+		self.Doc.openTransaction("Change")
+		self.Box.Shape = Part.makeSphere(5)
+		self.Doc.commitTransaction()
+		self.Doc.undo()
+		self.failUnless(len(self.Box.Shape.Faces) == 6)
+		self.failUnless(self.countTriangulations(self.Box.Shape) == 6)
+
+	def tearDown(self):
+		self.Param.SetBool("SaveTriangulation", self.SaveTriangulation)
+		FreeCAD.closeDocument("PartTriangulationTest")
+		if os.path.exists(self.DocName):
+			os.remove(self.DocName)
@@ -147,6 +147,11 @@ void PointKernel::RestoreDocFile(Base::Reader &reader)
     }
 }
 
+bool PointKernel::isSaveDocFileThreadSafe() const
+{
+    return true;
+}
+
 void PointKernel::save(const char* file) const
 {
     //MeshCore::MeshOutput aWriter(_kernel);
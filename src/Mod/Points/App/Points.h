@@ -91,6 +91,7 @@ public:
     void SaveDocFile (Base::Writer &writer) const;
     void Restore(Base::XMLReader &reader);
     void RestoreDocFile(Base::Reader &reader);
+    bool isSaveDocFileThreadSafe() const;
     void save(const char* file) const;
     void save(std::ostream&) const;
     void load(const char* file);
@@ -25,9 +25,12 @@
 
 #ifndef _PreComp_
 # include <algorithm>
+# include <numeric>
 #endif
 
-
+#include <QThread>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
 
 #include "PointsGrid.h"
 
@@ -96,6 +99,7 @@ void PointsGrid::Attach (const PointKernel &rclM)
 void PointsGrid::Clear (void)
 {
   _aulGrid.clear();
+  _aulGridOffsets.clear();
   _pclPoints = NULL;  
 }
 
@@ -126,8 +130,6 @@ void PointsGrid::InitGrid (void)
 {
   assert(_pclPoints != NULL);
 
-  unsigned long i, j;
-
   // Grid Laengen berechnen wenn nicht initialisiert
   //
   if ((_ulCtGridsX == 0) || (_ulCtGridsX == 0) || (_ulCtGridsX == 0))
@@ -164,13 +166,8 @@ void PointsGrid::InitGrid (void)
 
   // Daten-Struktur anlegen
   _aulGrid.clear();
-  _aulGrid.resize(_ulCtGridsX);
-  for (i = 0; i < _ulCtGridsX; i++)
-  {
-    _aulGrid[i].resize(_ulCtGridsY);
-    for (j = 0; j < _ulCtGridsY; j++)
-      _aulGrid[i][j].resize(_ulCtGridsZ);
-  }
+  _aulGridOffsets.clear();
+  _aulGridOffsets.resize(_ulCtGridsX * _ulCtGridsY * _ulCtGridsZ + 1, 0);
 }
 
 unsigned long PointsGrid::InSide (const Base::BoundBox3d &rclBB, std::vector<unsigned long> &raulElements, bool bDelDoubles) const
@@ -189,7 +186,7 @@ unsigned long PointsGrid::InSide (const Base::BoundBox3d &rclBB, std::vector<uns
     {
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
-        raulElements.insert(raulElements.end(), _aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+        raulElements.insert(raulElements.end(), GridBegin(i, j, k), GridEnd(i, j, k));
       }
     }
   }  
@@ -223,7 +220,7 @@ unsigned long PointsGrid::InSide (const Base::BoundBox3d &rclBB, std::vector<uns
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
         if (Base::DistanceP2(GetBoundBox(i, j, k).CalcCenter(), rclOrg) < fMinDistP2)
-          raulElements.insert(raulElements.end(), _aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+          raulElements.insert(raulElements.end(), GridBegin(i, j, k), GridEnd(i, j, k));
       }
     }
   }  
@@ -254,7 +251,7 @@ unsigned long PointsGrid::InSide (const Base::BoundBox3d &rclBB, std::set<unsign
     {
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
-        raulElements.insert(_aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+        raulElements.insert(GridBegin(i, j, k), GridEnd(i, j, k));
       }
     }
   }  
@@ -475,7 +472,7 @@ void PointsGrid::SearchNearestFromPoint (const Base::Vector3d &rclPt, std::set<u
           for (unsigned long i = 0; i < _ulCtGridsY; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+              raclInd.insert(GridBegin(nX, i, j), GridEnd(nX, i, j));
           }
           nX++;
         }
@@ -489,7 +486,7 @@ void PointsGrid::SearchNearestFromPoint (const Base::Vector3d &rclPt, std::set<u
           for (unsigned long i = 0; i < _ulCtGridsY; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+              raclInd.insert(GridBegin(nX, i, j), GridEnd(nX, i, j));
           }
           nX++;
         }
@@ -503,7 +500,7 @@ void PointsGrid::SearchNearestFromPoint (const Base::Vector3d &rclPt, std::set<u
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+              raclInd.insert(GridBegin(i, nY, j), GridEnd(i, nY, j));
           }
           nY++;
         }
@@ -517,7 +514,7 @@ void PointsGrid::SearchNearestFromPoint (const Base::Vector3d &rclPt, std::set<u
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+              raclInd.insert(GridBegin(i, nY, j), GridEnd(i, nY, j));
           }
           nY--;
         }
@@ -531,7 +528,7 @@ void PointsGrid::SearchNearestFromPoint (const Base::Vector3d &rclPt, std::set<u
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsY; j++)
-              raclInd.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+              raclInd.insert(GridBegin(i, j, nZ), GridEnd(i, j, nZ));
           }
           nZ++;
         }
@@ -545,7 +542,7 @@ void PointsGrid::SearchNearestFromPoint (const Base::Vector3d &rclPt, std::set<u
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsY; j++)
-              raclInd.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+              raclInd.insert(GridBegin(i, j, nZ), GridEnd(i, j, nZ));
           }
           nZ--;
         }
@@ -611,22 +608,36 @@ void PointsGrid::GetHull (unsigned long ulX, unsigned long ulY, unsigned long ul
 unsigned long PointsGrid::GetElements (unsigned long ulX, unsigned long ulY, unsigned long ulZ,  
                                      std::set<unsigned long> &raclInd) const
 {
-  const std::set<unsigned long> &rclSet = _aulGrid[ulX][ulY][ulZ];
-  if (rclSet.size() > 0)
+  unsigned long ulCount = GetCtElements(ulX, ulY, ulZ);
+  if (ulCount > 0)
   {
-    raclInd.insert(rclSet.begin(), rclSet.end());
-    return rclSet.size();
+    raclInd.insert(GridBegin(ulX, ulY, ulZ), GridEnd(ulX, ulY, ulZ));
+    return ulCount;
   }
 
   return 0;
 }
 
-void PointsGrid::AddPoint (const Base::Vector3d &rclPt, unsigned long ulPtIndex, float fEpsilon)
+namespace Points {
+struct PointsGrid::GridChunk
 {
-  unsigned long ulX, ulY, ulZ;
-  Pos(Base::Vector3d(rclPt.x, rclPt.y, rclPt.z), ulX, ulY, ulZ);
-  if ( (ulX < _ulCtGridsX) && (ulY < _ulCtGridsY) && (ulZ < _ulCtGridsZ) )
-    _aulGrid[ulX][ulY][ulZ].insert(ulPtIndex);
+  unsigned long begin, end;
+  std::vector<unsigned long>* grids;
+};
+}
+
+void PointsGrid::FindGrids (GridChunk &rclChunk) const
+{
+  std::vector<unsigned long>& aulGrids = *rclChunk.grids;
+  for (unsigned long i = rclChunk.begin; i < rclChunk.end; i++)
+  {
+    unsigned long ulX, ulY, ulZ;
+    Pos(_pclPoints->getPoint(i), ulX, ulY, ulZ);
+    if ( (ulX < _ulCtGridsX) && (ulY < _ulCtGridsY) && (ulZ < _ulCtGridsZ) )
+      aulGrids[i] = (ulZ * _ulCtGridsY + ulY) * _ulCtGridsX + ulX;
+    else
+      aulGrids[i] = ULONG_MAX;
+  }
 }
 
 void PointsGrid::Validate (const PointKernel &rclPoints)
@@ -675,12 +686,40 @@ void PointsGrid::RebuildGrid (void)
 
   InitGrid();
  
-  // Daten-Struktur fuellen
+  // fill the data structure, the grid of each point is determined by several threads
+  std::vector<unsigned long> aulGrids(_ulCtElements);
+  unsigned long ulCtChunks = 1;
+  if (_ulCtElements > 10000)
+    ulCtChunks = 4 * std::max<int>(QThread::idealThreadCount(), 1);
+  unsigned long ulChunkSize = _ulCtElements / ulCtChunks + 1;
+
+  std::vector<GridChunk> aclChunks;
+  for (unsigned long ulBegin = 0; ulBegin < _ulCtElements; ulBegin += ulChunkSize)
+  {
+    GridChunk clChunk;
+    clChunk.begin = ulBegin;
+    clChunk.end = std::min<unsigned long>(ulBegin + ulChunkSize, _ulCtElements);
+    clChunk.grids = &aulGrids;
+    aclChunks.push_back(clChunk);
+  }
 
-  unsigned long i = 0;
-  for (PointKernel::const_iterator it = _pclPoints->begin(); it != _pclPoints->end(); ++it )
+  QtConcurrent::blockingMap(aclChunks, boost::bind(&PointsGrid::FindGrids, this, _1));
+
+  // counting sort by grid index, the points outside the grid are skipped
+  std::vector<unsigned long>::iterator it;
+  for (it = aulGrids.begin(); it != aulGrids.end(); ++it)
+  {
+    if (*it != ULONG_MAX)
+      _aulGridOffsets[*it + 1]++;
+  }
+  std::partial_sum(_aulGridOffsets.begin(), _aulGridOffsets.end(), _aulGridOffsets.begin());
+
+  std::vector<unsigned long> aulPos(_aulGridOffsets.begin(), _aulGridOffsets.end() - 1);
+  _aulGrid.resize(_aulGridOffsets.back());
+  for (it = aulGrids.begin(); it != aulGrids.end(); ++it)
   {
-    AddPoint(*it, i++);
+    if (*it != ULONG_MAX)
+      _aulGrid[aulPos[*it]++] = it - aulGrids.begin();
   }
 }
 
@@ -743,7 +782,7 @@ bool PointsGridIterator::InitOnRay (const Base::Vector3d &rclPt, const Base::Vec
   if ((_rclGrid.GetBoundBox().IsInBox(rclPt)) == true)
   {  // Voxel bestimmen, indem der Startpunkt liegt
     _rclGrid.Position(rclPt, _ulX, _ulY, _ulZ);
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+    raulElements.insert(raulElements.end(), _rclGrid.GridBegin(_ulX, _ulY, _ulZ), _rclGrid.GridEnd(_ulX, _ulY, _ulZ));
     _bValidRay = true;
   }
   else
@@ -756,7 +795,7 @@ bool PointsGridIterator::InitOnRay (const Base::Vector3d &rclPt, const Base::Vec
       else
         _rclGrid.Position(cP1, _ulX, _ulY, _ulZ);
 
-      raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+      raulElements.insert(raulElements.end(), _rclGrid.GridBegin(_ulX, _ulY, _ulZ), _rclGrid.GridEnd(_ulX, _ulY, _ulZ));
       _bValidRay = true;
     }
   }
@@ -807,7 +846,7 @@ bool PointsGridIterator::NextOnRay (std::vector<unsigned long> &raulElements)
   if ((_bValidRay == true) && (_rclGrid.CheckPos(_ulX, _ulY, _ulZ) == true))
   {
     GridElement pos(_ulX, _ulY, _ulZ); _cSearchPositions.insert(pos);
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end()); 
+    raulElements.insert(raulElements.end(), _rclGrid.GridBegin(_ulX, _ulY, _ulZ), _rclGrid.GridEnd(_ulX, _ulY, _ulZ)); 
   }
   else
     _bValidRay = false;  // Strahl ausgetreten
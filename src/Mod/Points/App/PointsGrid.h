@@ -25,6 +25,7 @@
 #define POINTS_GRID_H
 
 #include <set>
+#include <vector>
 
 #include "Points.h"
 #include <Base/Vector3D.h>
@@ -105,7 +106,7 @@ public:
   //@}
   /** Returns the number of elements in a given grid. */
   unsigned long GetCtElements(unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
-  { return _aulGrid[ulX][ulY][ulZ].size(); }
+  { return GridEnd(ulX, ulY, ulZ) - GridBegin(ulX, ulY, ulZ); }
   /** Finds all points that lie in the same grid as the point \a rclPoint. */
   unsigned long FindElements(const Base::Vector3d &rclPoint, std::set<unsigned long>& aulElements) const;
   /** Validates the grid structure and rebuilds it if needed. */
@@ -138,9 +139,16 @@ protected:
   { return _pclPoints->size(); }
   /** Get the indices of all elements lying in the grids around a given grid with distance \a ulDistance. */
   void GetHull (unsigned long ulX, unsigned long ulY, unsigned long ulZ, unsigned long ulDistance, std::set<unsigned long> &raclInd) const;
+  /** Returns an iterator to the first element index of the given grid element. */
+  inline std::vector<unsigned long>::const_iterator GridBegin (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const;
+  /** Returns an iterator behind the last element index of the given grid element. */
+  inline std::vector<unsigned long>::const_iterator GridEnd (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const;
 
 protected:
-  std::vector<std::vector<std::vector<std::set<unsigned long> > > >  _aulGrid;   /**< Grid data structure. */
+  /** Grid data structure. The point indices of all grid elements are stored in one array sorted
+   * by grid element, the indices of grid element i are in the range [_aulGridOffsets[i], _aulGridOffsets[i+1]). */
+  std::vector<unsigned long> _aulGrid;
+  std::vector<unsigned long> _aulGridOffsets; /**< Offsets of the grid elements in _aulGrid. */
   const PointKernel* _pclPoints;  /**< The point kernel. */
   unsigned long     _ulCtElements;/**< Number of grid elements for validation issues. */
   unsigned long     _ulCtGridsX;  /**< Number of grid elements in z. */
@@ -160,11 +168,12 @@ protected:
 public:
 
 protected:
-  /** Adds a new point element to the grid structure. \a rclPt is the geometric point and \a ulPtIndex 
-   * the corresponding index in the point kernel. */
-  void AddPoint (const Base::Vector3d &rclPt, unsigned long ulPtIndex, float fEpsilon = 0.0f);
   /** Returns the grid numbers to the given point \a rclPoint. */
   void Pos(const Base::Vector3d &rclPoint, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ) const;
+
+private:
+  struct GridChunk;
+  void FindGrids (GridChunk &rclChunk) const;
 };
 
 /**
@@ -182,7 +191,7 @@ public:
   /** Returns indices of the elements in the current grid. */
   void GetElements (std::vector<unsigned long> &raulElements) const
   {
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+    raulElements.insert(raulElements.end(), _rclGrid.GridBegin(_ulX, _ulY, _ulZ), _rclGrid.GridEnd(_ulX, _ulY, _ulZ));
   }
   /** @name Iteration */
   //@{
@@ -265,6 +274,16 @@ inline bool PointsGrid::CheckPos (unsigned long ulX, unsigned long ulY, unsigned
   return ((ulX < _ulCtGridsX) && (ulY < _ulCtGridsY) && (ulZ < _ulCtGridsZ));
 }
 
+inline std::vector<unsigned long>::const_iterator PointsGrid::GridBegin (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+{
+  return _aulGrid.begin() + _aulGridOffsets[(ulZ * _ulCtGridsY + ulY) * _ulCtGridsX + ulX];
+}
+
+inline std::vector<unsigned long>::const_iterator PointsGrid::GridEnd (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+{
+  return _aulGrid.begin() + _aulGridOffsets[(ulZ * _ulCtGridsY + ulY) * _ulCtGridsX + ulX + 1];
+}
+
 // --------------------------------------------------------------
 
 } // namespace Points
@@ -304,6 +304,11 @@ void PropertyCurvatureList::RestoreDocFile(Base::Reader &reader)
     setValues(values);
 }
 
+bool PropertyCurvatureList::isSaveDocFileThreadSafe() const
+{
+    return true;
+}
+
 App::Property *PropertyCurvatureList::Copy(void) const 
 {
     PropertyCurvatureList* prop = new PropertyCurvatureList();
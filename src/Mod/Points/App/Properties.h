@@ -125,15 +125,15 @@ public:
     ~PropertyCurvatureList();
 
     void setSize(int newSize){_lValueList.resize(newSize);}   
-    int getSize(void) const {return _lValueList.size();}   
+    int getSize(void) const {restoreDeferred(); return _lValueList.size();}   
     void setValue(const CurvatureInfo&);
     void setValues(const std::vector<CurvatureInfo>&);
     std::vector<float> getCurvature( int tMode) const;
 
     /// index operator
-    const CurvatureInfo& operator[] (const int idx) const {return _lValueList.operator[] (idx);} 
-    void  set1Value (const int idx, const CurvatureInfo& value){_lValueList.operator[] (idx) = value;}
-    const std::vector<CurvatureInfo> &getValues(void) const{return _lValueList;}
+    const CurvatureInfo& operator[] (const int idx) const {restoreDeferred(); return _lValueList.operator[] (idx);} 
+    void  set1Value (const int idx, const CurvatureInfo& value){restoreDeferred(); _lValueList.operator[] (idx) = value;}
+    const std::vector<CurvatureInfo> &getValues(void) const{restoreDeferred(); return _lValueList;}
 
     /** @name Save/restore */
     //@{
@@ -142,6 +142,7 @@ public:
 
     void SaveDocFile (Base::Writer &writer) const;
     void RestoreDocFile(Base::Reader &reader);
+    bool isSaveDocFileThreadSafe() const;
     //@}
 
     /** @name Undo/Redo */
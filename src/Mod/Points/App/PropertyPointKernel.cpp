@@ -54,22 +54,41 @@ PropertyPointKernel::~PropertyPointKernel()
 void PropertyPointKernel::setValue(const PointKernel& m)
 {
     aboutToSetValue();
+    detachPoints(false);
     *_cPoints = m;
     hasSetValue();
 }
 
+void PropertyPointKernel::detachPoints(bool copyContent)
+{
+    // The points are shared with a copy of this property, e.g. a snapshot in
+    // the undo stack or a Python wrapper. So, they must be duplicated before
+    // they get modified.
+    if (_cPoints.getRefCount() > 1) {
+        PointKernel* kernel = new PointKernel();
+        if (copyContent)
+            *kernel = *_cPoints;
+        else
+            kernel->setTransform(_cPoints->getTransform());
+        _cPoints = kernel;
+    }
+}
+
 const PointKernel& PropertyPointKernel::getValue(void) const 
 {
+    restoreDeferred();
     return *_cPoints;
 }
 
 const Data::ComplexGeoData* PropertyPointKernel::getComplexData() const
 {
+    restoreDeferred();
     return _cPoints;
 }
 
 Base::BoundBox3d PropertyPointKernel::getBoundingBox() const
 {
+    restoreDeferred();
     Base::BoundBox3d box;
     for (PointKernel::const_iterator it = _cPoints->begin(); it != _cPoints->end(); ++it)
         box.Add(*it);
@@ -80,6 +99,7 @@ void PropertyPointKernel::getFaces(std::vector<Base::Vector3d> &Points,
                                    std::vector<Data::ComplexGeoData::Facet> &Topo,
                                    float Accuracy, uint16_t flags) const
 {
+    restoreDeferred();
     _cPoints->getFaces(Points, Topo, Accuracy, flags);
 }
 
@@ -124,6 +144,7 @@ void PropertyPointKernel::Restore(Base::XMLReader &reader)
         mtrx.fromString(Matrix);
 
         aboutToSetValue();
+        detachPoints(true);
         _cPoints->setTransform(mtrx);
         hasSetValue();
     }
@@ -137,14 +158,16 @@ void PropertyPointKernel::SaveDocFile (Base::Writer &writer) const
 void PropertyPointKernel::RestoreDocFile(Base::Reader &reader)
 {
     aboutToSetValue();
+    detachPoints(false);
     _cPoints->RestoreDocFile(reader);
     hasSetValue();
 }
 
 App::Property *PropertyPointKernel::Copy(void) const 
 {
+    // Note: The copy references the same points (copy-on-write), see detachPoints()
     PropertyPointKernel* prop = new PropertyPointKernel();
-    (*prop->_cPoints) = (*this->_cPoints);
+    prop->_cPoints = this->_cPoints;
     return prop;
 }
 
@@ -152,13 +175,25 @@ void PropertyPointKernel::Paste(const App::Property &from)
 {
     aboutToSetValue();
     const PropertyPointKernel& prop = dynamic_cast<const PropertyPointKernel&>(from);
-    *(this->_cPoints) = *(prop._cPoints);
+    this->_cPoints = prop._cPoints;
     hasSetValue();
 }
 
 unsigned int PropertyPointKernel::getMemSize (void) const
 {
-    return sizeof(Base::Vector3f) * this->_cPoints->size();
+    // shared points are only counted once in total
+    int count = _cPoints.getRefCount();
+    return sizeof(Base::Vector3f) * this->_cPoints->size() / (count > 1 ? count : 1);
+}
+
+void PropertyPointKernel::setTransform(const Base::Matrix4D &rclMat)
+{
+    restoreDeferred();
+    // the view provider must be notified if the points get replaced
+    aboutToSetValue();
+    detachPoints(true);
+    _cPoints->setTransform(rclMat);
+    hasSetValue();
 }
 
 void PropertyPointKernel::removeIndices( const std::vector<unsigned long>& uIndices )
@@ -192,6 +227,7 @@ void PropertyPointKernel::removeIndices( const std::vector<unsigned long>& uIndi
 void PropertyPointKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
     aboutToSetValue();
+    detachPoints(true);
     _cPoints->transformGeometry(rclMat);
     hasSetValue();
 }
@@ -85,9 +85,17 @@ public:
     //@{
     /// Transform the real 3d point kernel
     void transformGeometry(const Base::Matrix4D &rclMat);
+    /** Sets the placement of the points without notifying the container.
+     * Points shared with a copy of this property are duplicated before.
+     */
+    void setTransform(const Base::Matrix4D &rclMat);
     void removeIndices( const std::vector<unsigned long>& );
     //@}
 
+private:
+    /// Creates own points if they are shared with a copy of this property
+    void detachPoints(bool copyContent);
+
 private:
     Base::Reference<PointKernel> _cPoints;
 };
@@ -31,6 +31,7 @@
 #include <Gui/Language/Translator.h>
 #include <Mod/Points/App/PropertyPointKernel.h>
 
+#include "SoFCPointSet.h"
 #include "ViewProvider.h"
 #include "Workbench.h"
 #include "qrc_Points.cpp"
@@ -75,6 +76,7 @@ void PointsGuiExport initPointsGui()
     // instantiating the commands
     CreatePointsCommands();
 
+    PointsGui::SoFCPointSet      ::initClass();
     PointsGui::ViewProviderPoints::init();
     PointsGui::ViewProviderPython::init();
     PointsGui::Workbench         ::init();
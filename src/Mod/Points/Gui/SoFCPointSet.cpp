@@ -0,0 +1,215 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <Inventor/actions/SoGLRenderAction.h>
+# include <Inventor/elements/SoGLCacheContextElement.h>
+# include <Inventor/elements/SoModelMatrixElement.h>
+# include <Inventor/elements/SoViewportRegionElement.h>
+# include <Inventor/elements/SoViewVolumeElement.h>
+# include <Inventor/misc/SoState.h>
+# include <Inventor/nodes/SoCoordinate3.h>
+#endif
+
+#include "SoFCPointSet.h"
+#include <Base/BoundBox.h>
+#include <Gui/SoFCInteractiveElement.h>
+
+using namespace PointsGui;
+
+// depth of the finest octree cells
+#define OCTREE_DEPTH 10
+
+namespace PointsGui {
+// Interleaves the lower ten bits of v with two zero bits each
+static uint64_t spreadBits(uint64_t v)
+{
+    v = (v | (v << 16)) & 0x030000FF;
+    v = (v | (v <<  8)) & 0x0300F00F;
+    v = (v | (v <<  4)) & 0x030C30C3;
+    v = (v | (v <<  2)) & 0x09249249;
+    return v;
+}
+}
+
+SO_NODE_SOURCE(SoFCPointSet);
+
+void SoFCPointSet::initClass()
+{
+    SO_NODE_INIT_CLASS(SoFCPointSet, SoPointSet, "PointSet");
+}
+
+SoFCPointSet::SoFCPointSet() : renderPointLimit(1000000), maxScreenError(2.0f)
+{
+    SO_NODE_CONSTRUCTOR(SoFCPointSet);
+}
+
+SoFCPointSet::~SoFCPointSet()
+{
+}
+
+void SoFCPointSet::setPoints(const std::vector<Base::Vector3f>& points, SoCoordinate3* coords)
+{
+    pointOrder.clear();
+    levelCount.clear();
+    levelSize.clear();
+    if (points.size() > renderPointLimit)
+        sortPoints(points);
+
+    // disable the notification, otherwise whenever a point is inserted SoPointSet gets notified
+    coords->enableNotify(false);
+    coords->point.deleteValues(0);
+    coords->point.setNum(points.size());
+
+    SbVec3f* coord = coords->point.startEditing();
+    if (pointOrder.empty()) {
+        for (std::size_t i=0; i<points.size(); i++) {
+            const Base::Vector3f& p = points[i];
+            coord[i].setValue(p.x, p.y, p.z);
+        }
+    }
+    else {
+        for (std::size_t i=0; i<pointOrder.size(); i++) {
+            const Base::Vector3f& p = points[pointOrder[i]];
+            coord[i].setValue(p.x, p.y, p.z);
+        }
+    }
+    coords->point.finishEditing();
+
+    this->numPoints = points.size();
+    coords->enableNotify(true);
+    coords->touch();
+}
+
+/**
+ * Sorts the points by the octree levels. To determine the level of a point all points
+ * are ordered along the Z-order curve of the finest octree cells, so that the points of
+ * each cell at any depth follow each other. A point is the first one of its cell at
+ * depth n if its cell code differs from the code of its predecessor in the first n octal
+ * digits.
+ */
+void SoFCPointSet::sortPoints(const std::vector<Base::Vector3f>& points)
+{
+    Base::BoundBox3f bbox;
+    for (std::vector<Base::Vector3f>::const_iterator it = points.begin(); it != points.end(); ++it)
+        bbox.Add(*it);
+    center.setValue(0.5f*(bbox.MinX+bbox.MaxX), 0.5f*(bbox.MinY+bbox.MaxY), 0.5f*(bbox.MinZ+bbox.MaxZ));
+    float length = std::max<float>(bbox.LengthX(), std::max<float>(bbox.LengthY(), bbox.LengthZ()));
+    if (length <= 0.0f)
+        return;
+
+    // cell code in the upper and point index in the lower half
+    const uint64_t cells = 1 << OCTREE_DEPTH;
+    float scale = (float)cells / length;
+    std::vector<uint64_t> keys(points.size());
+    for (std::size_t i=0; i<points.size(); i++) {
+        const Base::Vector3f& p = points[i];
+        uint64_t x = std::min<uint64_t>(cells-1, (uint64_t)((p.x-bbox.MinX)*scale));
+        uint64_t y = std::min<uint64_t>(cells-1, (uint64_t)((p.y-bbox.MinY)*scale));
+        uint64_t z = std::min<uint64_t>(cells-1, (uint64_t)((p.z-bbox.MinZ)*scale));
+        uint64_t code = spreadBits(x) | (spreadBits(y) << 1) | (spreadBits(z) << 2);
+        keys[i] = (code << 32) | (uint64_t)i;
+    }
+    std::sort(keys.begin(), keys.end());
+
+    // the points sharing the finest cell with their predecessor get the last level
+    const int numLevels = OCTREE_DEPTH + 2;
+    std::vector<unsigned char> levels(keys.size());
+    std::vector<int> count(numLevels, 0);
+    for (std::size_t i=0; i<keys.size(); i++) {
+        int level = 0;
+        if (i > 0) {
+            uint64_t diff = (keys[i] >> 32) ^ (keys[i-1] >> 32);
+            if (diff == 0) {
+                level = OCTREE_DEPTH + 1;
+            }
+            else {
+                int bit = 3 * OCTREE_DEPTH - 1;
+                while (!(diff & ((uint64_t)1 << bit)))
+                    bit--;
+                level = (3 * OCTREE_DEPTH - 1 - bit) / 3 + 1;
+            }
+        }
+        levels[i] = (unsigned char)level;
+        count[level]++;
+    }
+
+    // stable counting sort by level
+    std::vector<int> offset(numLevels, 0);
+    levelCount.resize(numLevels);
+    levelSize.resize(numLevels);
+    int sum = 0;
+    for (int l=0; l<numLevels; l++) {
+        offset[l] = sum;
+        sum += count[l];
+        levelCount[l] = sum;
+        levelSize[l] = l <= OCTREE_DEPTH ? length / (float)(1 << l) : 0.0f;
+    }
+
+    pointOrder.resize(keys.size());
+    for (std::size_t i=0; i<keys.size(); i++)
+        pointOrder[offset[levels[i]]++] = (unsigned int)(keys[i] & 0xFFFFFFFF);
+}
+
+/**
+ * While navigating only the first levels are rendered. The finest level is chosen whose
+ * cells appear not bigger than maxScreenError pixels, as long as the number of points
+ * doesn't exceed renderPointLimit.
+ */
+void SoFCPointSet::GLRender(SoGLRenderAction *action)
+{
+    SoState* state = action->getState();
+    if (this->levelCount.empty() || !Gui::SoFCInteractiveElement::get(state)) {
+        inherited::GLRender(action);
+        return;
+    }
+
+    // The number of rendered points depends on the view
+    SoGLCacheContextElement::shouldAutoCache(state, SoGLCacheContextElement::DONT_AUTO_CACHE);
+
+    // size of a pixel at the center of the points
+    SbVec3f pos;
+    SoModelMatrixElement::get(state).multVecMatrix(this->center, pos);
+    const SbViewVolume& vv = SoViewVolumeElement::get(state);
+    const SbViewportRegion& vp = SoViewportRegionElement::get(state);
+    float pixel = vv.getWorldToScreenScale(pos, 1.0f) / (float)vp.getViewportSizePixels()[1];
+    float maxSize = this->maxScreenError * pixel;
+
+    int count = this->levelCount.front();
+    for (std::size_t l=0; l<this->levelCount.size(); l++) {
+        if (this->levelCount[l] > (int)this->renderPointLimit)
+            break;
+        count = this->levelCount[l];
+        if (this->levelSize[l] <= maxSize)
+            break;
+    }
+
+    int num = this->numPoints.getValue();
+    this->numPoints.enableNotify(FALSE);
+    this->numPoints.setValue(count);
+    inherited::GLRender(action);
+    this->numPoints.setValue(num);
+    this->numPoints.enableNotify(TRUE);
+}
@@ -0,0 +1,82 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef POINTSGUI_SOFCPOINTSET_H
+#define POINTSGUI_SOFCPOINTSET_H
+
+#include <vector>
+#include <Inventor/nodes/SoPointSet.h>
+#include <Inventor/nodes/SoSubNode.h>
+#include <Base/Vector3D.h>
+
+class SoCoordinate3;
+
+namespace PointsGui {
+
+/**
+ * The SoFCPointSet class is designed to render huge point clouds. The points are
+ * sorted by the levels of an octree: level n holds one point of each cell at depth n
+ * that doesn't contain a point of a lower level yet. This way any number of leading
+ * coordinates covers the whole cloud and while navigating only the levels are rendered
+ * whose cells appear bigger than the allowed screen error. When the view is idle all
+ * points are rendered.
+ */
+class PointsGuiExport SoFCPointSet : public SoPointSet {
+    typedef SoPointSet inherited;
+
+    SO_NODE_HEADER(SoFCPointSet);
+
+public:
+    static void initClass();
+    SoFCPointSet();
+
+    /** Sets \a points to \a coords. If there are more than renderPointLimit points
+     * they are sorted by the octree levels, otherwise the order is kept.
+     */
+    void setPoints(const std::vector<Base::Vector3f>& points, SoCoordinate3* coords);
+    /// Returns the original index of each coordinate or an empty list if the points were not sorted
+    const std::vector<unsigned int>& getPointOrder() const
+    { return pointOrder; }
+
+    unsigned int renderPointLimit;
+    /// Maximum size in pixels of the octree cells of the points shown while navigating
+    float maxScreenError;
+
+protected:
+    virtual void GLRender(SoGLRenderAction *action);
+
+private:
+    // Force using the reference count mechanism.
+    virtual ~SoFCPointSet();
+    void sortPoints(const std::vector<Base::Vector3f>& points);
+
+private:
+    std::vector<unsigned int> pointOrder;
+    std::vector<int> levelCount;  // number of points up to and including each level
+    std::vector<float> levelSize; // edge length of the octree cells of each level
+    SbVec3f center;
+};
+
+} // namespace PointsGui
+
+
+#endif // POINTSGUI_SOFCPOINTSET_H
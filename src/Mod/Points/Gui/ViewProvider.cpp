@@ -27,6 +27,7 @@
 # ifdef FC_OS_WIN32
 #  include <windows.h>
 # endif
+# include <cmath>
 # include <Inventor/nodes/SoCamera.h>
 # include <Inventor/nodes/SoCoordinate3.h>
 # include <Inventor/nodes/SoDrawStyle.h>
@@ -55,6 +56,7 @@
 #include <Mod/Points/App/PointsFeature.h>
 
 #include "ViewProvider.h"
+#include "SoFCPointSet.h"
 #include "../App/Properties.h"
 
 
@@ -74,7 +76,7 @@ ViewProviderPoints::ViewProviderPoints()
 
     pcPointsCoord = new SoCoordinate3();
     pcPointsCoord->ref();
-    pcPoints = new SoPointSet();
+    pcPoints = new SoFCPointSet();
     pcPoints->ref();
     pcPointsNormal = new SoNormal();  
     pcPointsNormal->ref();
@@ -109,14 +111,18 @@ void ViewProviderPoints::onChanged(const App::Property* prop)
 void ViewProviderPoints::setVertexColorMode(App::PropertyColorList* pcProperty)
 {
     const std::vector<App::Color>& val = pcProperty->getValues();
-    unsigned long i=0;
+    const std::vector<unsigned int>& order = static_cast<SoFCPointSet*>(pcPoints)->getPointOrder();
 
     pcColorMat->enableNotify(false);
     pcColorMat->diffuseColor.deleteValues(0);
     pcColorMat->diffuseColor.setNum(val.size());
 
-    for ( std::vector<App::Color>::const_iterator it = val.begin(); it != val.end(); ++it ) {
-        pcColorMat->diffuseColor.set1Value(i++, SbColor(it->r, it->g, it->b));
+    // the coordinates may be sorted for level-of-detail rendering, a list
+    // that doesn't fit to the coordinates is left as it is
+    bool sorted = (val.size() == order.size());
+    for ( unsigned long i = 0; i < val.size(); i++ ) {
+        const App::Color& c = val[sorted ? order[i] : i];
+        pcColorMat->diffuseColor.set1Value(i, SbColor(c.r, c.g, c.b));
     }
 
     pcColorMat->enableNotify(true);
@@ -126,14 +132,16 @@ void ViewProviderPoints::setVertexColorMode(App::PropertyColorList* pcProperty)
 void ViewProviderPoints::setVertexGreyvalueMode(Points::PropertyGreyValueList* pcProperty)
 {
     const std::vector<float>& val = pcProperty->getValues();
-    unsigned long i=0;
+    const std::vector<unsigned int>& order = static_cast<SoFCPointSet*>(pcPoints)->getPointOrder();
 
     pcColorMat->enableNotify(false);
     pcColorMat->diffuseColor.deleteValues(0);
     pcColorMat->diffuseColor.setNum(val.size());
 
-    for ( std::vector<float>::const_iterator it = val.begin(); it != val.end(); ++it ) {
-        pcColorMat->diffuseColor.set1Value(i++, SbColor(*it, *it, *it));
+    bool sorted = (val.size() == order.size());
+    for ( unsigned long i = 0; i < val.size(); i++ ) {
+        float g = val[sorted ? order[i] : i];
+        pcColorMat->diffuseColor.set1Value(i, SbColor(g, g, g));
     }
 
     pcColorMat->enableNotify(true);
@@ -143,14 +151,16 @@ void ViewProviderPoints::setVertexGreyvalueMode(Points::PropertyGreyValueList* p
 void ViewProviderPoints::setVertexNormalMode(Points::PropertyNormalList* pcProperty)
 {
     const std::vector<Base::Vector3f>& val = pcProperty->getValues();
-    unsigned long i=0;
+    const std::vector<unsigned int>& order = static_cast<SoFCPointSet*>(pcPoints)->getPointOrder();
 
     pcPointsNormal->enableNotify(false);
     pcPointsNormal->vector.deleteValues(0);
     pcPointsNormal->vector.setNum(val.size());
 
-    for ( std::vector<Base::Vector3f>::const_iterator it = val.begin(); it != val.end(); ++it ) {
-        pcPointsNormal->vector.set1Value(i++, it->x, it->y, it->z);
+    bool sorted = (val.size() == order.size());
+    for ( unsigned long i = 0; i < val.size(); i++ ) {
+        const Base::Vector3f& n = val[sorted ? order[i] : i];
+        pcPointsNormal->vector.set1Value(i, n.x, n.y, n.z);
     }
 
     pcPointsNormal->enableNotify(true);
@@ -162,6 +172,13 @@ void ViewProviderPoints::attach(App::DocumentObject* pcObj)
     // call parent's attach to define display modes
     ViewProviderGeometryObject::attach(pcObj);
 
+    // read the threshold for level-of-detail rendering from the preferences
+    Base::Reference<ParameterGrp> hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Points");
+    int size = hGrp->GetInt("RenderPointLimit", -1);
+    if (size > 0)
+        static_cast<SoFCPointSet*>(pcPoints)->renderPointLimit = (unsigned int)(pow(10.0f,size));
+
     SoGroup* pcPointRoot = new SoGroup();
     SoGroup* pcPointShadedRoot = new SoGroup();
     SoGroup* pcColorShadedRoot = new SoGroup();
@@ -462,6 +479,11 @@ void ViewProviderPointsBuilder::createPoints(const App::Property* prop, SoCoordi
     const Points::PropertyPointKernel* prop_points = static_cast<const Points::PropertyPointKernel*>(prop);
     const Points::PointKernel& cPts = prop_points->getValue();
 
+    if (points->getTypeId() == SoFCPointSet::getClassTypeId()) {
+        static_cast<SoFCPointSet*>(points)->setPoints(cPts.getBasicPoints(), coords);
+        return;
+    }
+
     // disable the notification, otherwise whenever a point is inserted SoPointSet gets notified
     coords->enableNotify(false);
     coords->point.deleteValues(0);
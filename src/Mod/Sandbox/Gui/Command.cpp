@@ -59,6 +59,7 @@
 
 #include <Base/Console.h>
 #include <Base/Sequencer.h>
+#include <Base/TimeInfo.h>
 #include <App/Application.h>
 #include <App/Document.h>
 #include <Gui/Application.h>
@@ -74,6 +75,9 @@
 #include <Mod/Sandbox/App/DocumentProtector.h>
 #include <Mod/Mesh/App/MeshFeature.h>
 #include <Mod/Mesh/App/Core/Degeneration.h>
+#include <Mod/Mesh/App/Core/Evaluation.h>
+#include <Mod/Mesh/App/Core/Grid.h>
+#include <Mod/Mesh/App/Core/SetOperations.h>
 #include "Workbench.h"
 
 
@@ -1421,6 +1425,235 @@ void CmdMengerSponge::activated(int iMsg)
     feature->purgeTouched();
 }
 
+//===========================================================================
+// Sandbox_MeshSelfIntersection
+//===========================================================================
+DEF_STD_CMD(CmdSandboxMeshSelfIntersection);
+
+CmdSandboxMeshSelfIntersection::CmdSandboxMeshSelfIntersection()
+  :Command("Sandbox_MeshSelfIntersection")
+{
+    sAppModule    = "Sandbox";
+    sGroup        = QT_TR_NOOP("Sandbox");
+    sMenuText     = QT_TR_NOOP("Self-intersection benchmark");
+    sToolTipText  = QT_TR_NOOP("Checks a noisy sphere for self-intersections");
+    sWhatsThis    = QT_TR_NOOP("Self-intersection benchmark");
+    sStatusTip    = QT_TR_NOOP("Checks a noisy sphere for self-intersections");
+}
+
+static void makeNoisySphere(MeshCore::MeshKernel& kernel, unsigned long ctFacets, float noise)
+{
+    // a sphere with r rings of 2r points each has about 4r^2 facets
+    unsigned long rings = std::max<unsigned long>((unsigned long)sqrt(ctFacets / 4.0), 2);
+    unsigned long segments = 2 * rings;
+    float radius = 1.0f;
+    float edge = F_PI * radius / float(rings);
+
+    MeshCore::MeshPointArray points;
+    points.reserve((rings - 1) * segments + 2);
+    points.push_back(MeshCore::MeshPoint(Base::Vector3f(0, 0, radius)));
+    for (unsigned long i = 1; i < rings; i++) {
+        float theta = float(i) * F_PI / float(rings);
+        for (unsigned long j = 0; j < segments; j++) {
+            float phi = float(j) * 2.0f * F_PI / float(segments);
+            float r = radius + noise * edge * (2.0f * float(rand()) / float(RAND_MAX) - 1.0f);
+            points.push_back(MeshCore::MeshPoint(Base::Vector3f(r * sin(theta) * cos(phi),
+                                                                r * sin(theta) * sin(phi),
+                                                                r * cos(theta))));
+        }
+    }
+    points.push_back(MeshCore::MeshPoint(Base::Vector3f(0, 0, -radius)));
+
+    MeshCore::MeshFacetArray facets;
+    facets.reserve(2 * (rings - 1) * segments);
+    unsigned long south = points.size() - 1;
+    for (unsigned long j = 0; j < segments; j++) {
+        unsigned long k = (j + 1) % segments;
+        facets.push_back(MeshCore::MeshFacet(0, 1 + j, 1 + k));
+        unsigned long last = 1 + (rings - 2) * segments;
+        facets.push_back(MeshCore::MeshFacet(south, last + k, last + j));
+    }
+    for (unsigned long i = 0; i < rings - 2; i++) {
+        unsigned long upper = 1 + i * segments;
+        unsigned long lower = upper + segments;
+        for (unsigned long j = 0; j < segments; j++) {
+            unsigned long k = (j + 1) % segments;
+            facets.push_back(MeshCore::MeshFacet(upper + j, lower + j, lower + k));
+            facets.push_back(MeshCore::MeshFacet(upper + j, lower + k, upper + k));
+        }
+    }
+
+    kernel.Adopt(points, facets, true);
+}
+
+void CmdSandboxMeshSelfIntersection::activated(int iMsg)
+{
+    bool ok;
+    int count = QInputDialog::getInteger(Gui::getMainWindow(),
+        QString::fromAscii("Self-intersection benchmark"),
+        QString::fromAscii("Number of facets (in millions):"),
+        1, 1, 50, 1, &ok);
+    if (!ok) return;
+
+    Gui::WaitCursor wc;
+    srand(0);
+    MeshCore::MeshKernel kernel;
+    makeNoisySphere(kernel, (unsigned long)count * 1000000, 0.5f);
+
+    Base::TimeInfo start;
+    std::vector<std::pair<unsigned long, unsigned long> > intersection;
+    MeshCore::MeshEvalSelfIntersection eval(kernel);
+    eval.GetIntersections(intersection);
+    Base::Console().Message("Checked %lu facets for self-intersections in %f s, %lu pairs found\n",
+        kernel.CountFacets(), Base::TimeInfo::diffTimeF(start, Base::TimeInfo()),
+        (unsigned long)intersection.size());
+}
+
+//===========================================================================
+// Sandbox_MeshGrid
+//===========================================================================
+DEF_STD_CMD(CmdSandboxMeshGrid);
+
+CmdSandboxMeshGrid::CmdSandboxMeshGrid()
+  :Command("Sandbox_MeshGrid")
+{
+    sAppModule    = "Sandbox";
+    sGroup        = QT_TR_NOOP("Sandbox");
+    sMenuText     = QT_TR_NOOP("Facet grid benchmark");
+    sToolTipText  = QT_TR_NOOP("Builds and queries a facet grid of a noisy sphere");
+    sWhatsThis    = QT_TR_NOOP("Facet grid benchmark");
+    sStatusTip    = QT_TR_NOOP("Builds and queries a facet grid of a noisy sphere");
+}
+
+void CmdSandboxMeshGrid::activated(int iMsg)
+{
+    bool ok;
+    int count = QInputDialog::getInteger(Gui::getMainWindow(),
+        QString::fromAscii("Facet grid benchmark"),
+        QString::fromAscii("Number of facets (in millions):"),
+        10, 1, 50, 1, &ok);
+    if (!ok) return;
+
+    Gui::WaitCursor wc;
+    srand(0);
+    MeshCore::MeshKernel kernel;
+    makeNoisySphere(kernel, (unsigned long)count * 1000000, 0.5f);
+
+    Base::TimeInfo start;
+    MeshCore::MeshFacetGrid grid(kernel);
+    Base::Console().Message("Built facet grid of %lu facets in %f s\n",
+        kernel.CountFacets(), Base::TimeInfo::diffTimeF(start, Base::TimeInfo()));
+
+    // the grid stores one index per entry and one offset per grid element
+    unsigned long ctEntries = 0, ctGrids = 0;
+    MeshCore::MeshGridIterator it(grid);
+    for (it.Init(); it.More(); it.Next()) {
+        ctEntries += it.GetCtElements();
+        ctGrids++;
+    }
+    Base::Console().Message("%lu grid elements with %lu entries use %lu kB\n",
+        ctGrids, ctEntries, (ctEntries + ctGrids + 1) * sizeof(unsigned long) / 1024);
+
+    // query random points near the surface
+    const int ctQueries = 100000;
+    std::vector<Base::Vector3f> points(ctQueries);
+    for (int i = 0; i < ctQueries; i++) {
+        Base::Vector3f p(float(rand()) / float(RAND_MAX) - 0.5f,
+                         float(rand()) / float(RAND_MAX) - 0.5f,
+                         float(rand()) / float(RAND_MAX) - 0.5f);
+        points[i] = p.Normalize();
+    }
+
+    start = Base::TimeInfo();
+    unsigned long ctFound = 0;
+    for (int i = 0; i < ctQueries; i++) {
+        if (grid.SearchNearestFromPoint(points[i]) != ULONG_MAX)
+            ctFound++;
+    }
+    Base::Console().Message("%d nearest facet queries in %f s, %lu found\n",
+        ctQueries, Base::TimeInfo::diffTimeF(start, Base::TimeInfo()), ctFound);
+
+    start = Base::TimeInfo();
+    ctFound = 0;
+    std::vector<unsigned long> elements;
+    for (int i = 0; i < ctQueries; i++) {
+        Base::BoundBox3f box(points[i], 0.01f);
+        ctFound += grid.Inside(box, elements);
+    }
+    Base::Console().Message("%d box queries in %f s, %lu facets found\n",
+        ctQueries, Base::TimeInfo::diffTimeF(start, Base::TimeInfo()), ctFound);
+}
+
+//===========================================================================
+// Sandbox_MeshBoolean
+//===========================================================================
+DEF_STD_CMD(CmdSandboxMeshBoolean);
+
+CmdSandboxMeshBoolean::CmdSandboxMeshBoolean()
+  :Command("Sandbox_MeshBoolean")
+{
+    sAppModule    = "Sandbox";
+    sGroup        = QT_TR_NOOP("Sandbox");
+    sMenuText     = QT_TR_NOOP("Mesh boolean benchmark");
+    sToolTipText  = QT_TR_NOOP("Runs union, intersection and difference on overlapping spheres");
+    sWhatsThis    = QT_TR_NOOP("Mesh boolean benchmark");
+    sStatusTip    = QT_TR_NOOP("Runs union, intersection and difference on overlapping spheres");
+}
+
+void CmdSandboxMeshBoolean::activated(int iMsg)
+{
+    bool ok;
+    int count = QInputDialog::getInteger(Gui::getMainWindow(),
+        QString::fromAscii("Mesh boolean benchmark"),
+        QString::fromAscii("Number of facets per mesh (in thousands):"),
+        100, 1, 5000, 1, &ok);
+    if (!ok) return;
+
+    Gui::WaitCursor wc;
+    srand(0);
+
+    // a smooth and a noisy sphere, each pair is moved against each other
+    MeshCore::MeshKernel smooth, noisy;
+    makeNoisySphere(smooth, (unsigned long)count * 1000, 0.0f);
+    makeNoisySphere(noisy, (unsigned long)count * 1000, 0.3f);
+
+    struct Case {
+        const char* name;
+        const MeshCore::MeshKernel* mesh;
+        Base::Vector3f offset;
+    } cases[] = {
+        { "sphere/sphere", &smooth, Base::Vector3f(0.5f, 0.0f, 0.0f) },
+        { "sphere/tilted sphere", &smooth, Base::Vector3f(0.3f, 0.2f, 0.4f) },
+        { "sphere/noisy sphere", &noisy, Base::Vector3f(0.5f, 0.1f, 0.0f) }
+    };
+
+    struct Operation {
+        const char* name;
+        MeshCore::SetOperations::OperationType type;
+    } operations[] = {
+        { "union", MeshCore::SetOperations::Union },
+        { "intersection", MeshCore::SetOperations::Intersect },
+        { "difference", MeshCore::SetOperations::Difference }
+    };
+
+    for (int i = 0; i < 3; i++) {
+        MeshCore::MeshKernel tool = *cases[i].mesh;
+        Base::Matrix4D mat;
+        mat.move(cases[i].offset);
+        tool.Transform(mat);
+
+        for (int j = 0; j < 3; j++) {
+            Base::TimeInfo start;
+            MeshCore::MeshKernel result;
+            MeshCore::SetOperations setOp(smooth, tool, result, operations[j].type, 1.0e-5f);
+            setOp.Do();
+            Base::Console().Message("%s %s: %lu + %lu -> %lu facets in %f s\n",
+                cases[i].name, operations[j].name, smooth.CountFacets(), tool.CountFacets(),
+                result.CountFacets(), Base::TimeInfo::diffTimeF(start, Base::TimeInfo()));
+        }
+    }
+}
+
 
 void CreateSandboxCommands(void)
 {
@@ -1444,6 +1677,9 @@ void CreateSandboxCommands(void)
     rcCmdMgr.addCommand(new CmdSandboxMeshLoaderFuture);
     rcCmdMgr.addCommand(new CmdSandboxMeshTestJob);
     rcCmdMgr.addCommand(new CmdSandboxMeshTestRef);
+    rcCmdMgr.addCommand(new CmdSandboxMeshSelfIntersection);
+    rcCmdMgr.addCommand(new CmdSandboxMeshGrid);
+    rcCmdMgr.addCommand(new CmdSandboxMeshBoolean);
     rcCmdMgr.addCommand(new CmdTestGrabWidget());
     rcCmdMgr.addCommand(new CmdTestImageNode());
     rcCmdMgr.addCommand(new CmdTestWidgetShape());
@@ -72,6 +72,9 @@ Gui::MenuItem* Workbench::setupMenuBar() const
           << "Sandbox_MeshLoaderFuture"
           << "Sandbox_MeshTestJob"
           << "Sandbox_MeshTestRef"
+          << "Sandbox_MeshSelfIntersection"
+          << "Sandbox_MeshGrid"
+          << "Sandbox_MeshBoolean"
           << "Sandbox_CryptographicHash"
           << "Sandbox_MengerSponge";
 
@@ -1806,7 +1806,8 @@ int Sketch::initMove(int geoId, PointPos pos, bool fine)
     }
     InitParameters = MoveParameters;
 
-    GCSsys.initSolution();
+    // the moves of a drag start from the solution of the previous move
+    GCSsys.initSolution(true);
     isInitMove = true;
     return 0;
 }
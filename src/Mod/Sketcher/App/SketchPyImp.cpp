@@ -25,6 +25,7 @@
 #include <Base/VectorPy.h>
 
 #include <Mod/Part/App/Geometry.h>
+#include <Mod/Part/App/GeometryPy.h>
 #include <Mod/Part/App/GeometryCurvePy.h>
 #include <Mod/Part/App/LinePy.h>
 #include <Mod/Part/App/TopoShapePy.h>
@@ -117,6 +118,38 @@ PyObject* SketchPy::addConstraint(PyObject *args)
 
 }
 
+PyObject* SketchPy::setUp(PyObject *args)
+{
+    PyObject *pcGeo, *pcCons;
+    if (!PyArg_ParseTuple(args, "O!O!", &PyList_Type, &pcGeo, &PyList_Type, &pcCons))
+        return 0;
+
+    std::vector<Part::Geometry*> geoList;
+    Py::List geos(pcGeo);
+    for (Py::List::iterator it = geos.begin(); it != geos.end(); ++it) {
+        if (!PyObject_TypeCheck((*it).ptr(), &(Part::GeometryPy::Type))) {
+            std::string error = std::string("types in list must be 'Geometry', not ");
+            error += (*it).ptr()->ob_type->tp_name;
+            throw Py::TypeError(error);
+        }
+        geoList.push_back(static_cast<Part::GeometryPy*>((*it).ptr())->getGeometryPtr());
+    }
+
+    std::vector<Constraint*> constrList;
+    Py::List cons(pcCons);
+    for (Py::List::iterator it = cons.begin(); it != cons.end(); ++it) {
+        if (!PyObject_TypeCheck((*it).ptr(), &(ConstraintPy::Type))) {
+            std::string error = std::string("types in list must be 'Constraint', not ");
+            error += (*it).ptr()->ob_type->tp_name;
+            throw Py::TypeError(error);
+        }
+        constrList.push_back(static_cast<ConstraintPy*>((*it).ptr())->getConstraintPtr());
+    }
+
+    // the sketch makes its own copies of the geometries
+    return Py::new_reference_to(Py::Int(getSketchPtr()->setUpSketch(geoList, constrList)));
+}
+
 PyObject* SketchPy::clear(PyObject *args)
 {
     int index;
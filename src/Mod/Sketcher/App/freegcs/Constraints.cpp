@@ -21,6 +21,7 @@
  ***************************************************************************/
 
 #include <cmath>
+#include <algorithm>
 #include "Constraints.h"
 
 namespace GCS
@@ -35,7 +36,7 @@ Constraint::Constraint()
 {
 }
 
-void Constraint::redirectParams(MAP_pD_pD redirectionmap)
+void Constraint::redirectParams(const MAP_pD_pD &redirectionmap)
 {
     int i=0;
     for (VEC_pD::iterator param=origpvec.begin();
@@ -71,6 +72,17 @@ double Constraint::grad(double *param)
     return 0.;
 }
 
+void Constraint::grad(VEC_D &deriv)
+{
+    // fallback for constraints without a dedicated implementation, a parameter
+    // that appears more than once in pvec gets its derivative only at its first slot
+    deriv.assign(pvec.size(), 0.);
+    for (int i=0; i < int(pvec.size()); i++) {
+        if (std::find(pvec.begin(), pvec.begin()+i, pvec[i]) == pvec.begin()+i)
+            deriv[i] = grad(pvec[i]);
+    }
+}
+
 double Constraint::maxStep(MAP_pD_D &dir, double lim)
 {
     return lim;
@@ -108,6 +120,13 @@ double ConstraintEqual::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintEqual::grad(VEC_D &deriv)
+{
+    deriv.resize(2);
+    deriv[0] = scale;
+    deriv[1] = -scale;
+}
+
 // Difference
 ConstraintDifference::ConstraintDifference(double *p1, double *p2, double *d)
 {
@@ -142,6 +161,14 @@ double ConstraintDifference::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintDifference::grad(VEC_D &deriv)
+{
+    deriv.resize(3);
+    deriv[0] = -scale;
+    deriv[1] = scale;
+    deriv[2] = -scale;
+}
+
 // P2PDistance
 ConstraintP2PDistance::ConstraintP2PDistance(Point &p1, Point &p2, double *d)
 {
@@ -191,6 +218,19 @@ double ConstraintP2PDistance::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintP2PDistance::grad(VEC_D &deriv)
+{
+    double dx = (*p1x() - *p2x());
+    double dy = (*p1y() - *p2y());
+    double d = sqrt(dx*dx + dy*dy);
+    deriv.resize(5);
+    deriv[0] = scale * dx/d;
+    deriv[1] = scale * dy/d;
+    deriv[2] = scale * -dx/d;
+    deriv[3] = scale * -dy/d;
+    deriv[4] = -scale;
+}
+
 double ConstraintP2PDistance::maxStep(MAP_pD_D &dir, double lim)
 {
     MAP_pD_D::iterator it;
@@ -282,6 +322,26 @@ double ConstraintP2PAngle::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintP2PAngle::grad(VEC_D &deriv)
+{
+    double dx = (*p2x() - *p1x());
+    double dy = (*p2y() - *p1y());
+    double a = *angle() + da;
+    double ca = cos(a);
+    double sa = sin(a);
+    double x = dx*ca + dy*sa;
+    double y = -dx*sa + dy*ca;
+    double r2 = dx*dx+dy*dy;
+    dx = -y/r2;
+    dy = x/r2;
+    deriv.resize(5);
+    deriv[0] = scale * (-ca*dx + sa*dy);
+    deriv[1] = scale * (-sa*dx - ca*dy);
+    deriv[2] = scale * ( ca*dx - sa*dy);
+    deriv[3] = scale * ( sa*dx + ca*dy);
+    deriv[4] = -scale;
+}
+
 double ConstraintP2PAngle::maxStep(MAP_pD_D &dir, double lim)
 {
     // step(angle()) <= pi/18 = 10°
@@ -360,6 +420,26 @@ double ConstraintP2LDistance::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintP2LDistance::grad(VEC_D &deriv)
+{
+    double x0=*p0x(), x1=*p1x(), x2=*p2x();
+    double y0=*p0y(), y1=*p1y(), y2=*p2y();
+    double dx = x2-x1;
+    double dy = y2-y1;
+    double d2 = dx*dx+dy*dy;
+    double d = sqrt(d2);
+    double area = -x0*dy+y0*dx+x1*y2-x2*y1;
+    double s = (area < 0) ? -scale : scale;
+    deriv.resize(7);
+    deriv[0] = s * (y1-y2) / d;
+    deriv[1] = s * (x2-x1) / d;
+    deriv[2] = s * ((y2-y0)*d + (dx/d)*area) / d2;
+    deriv[3] = s * ((x0-x2)*d + (dy/d)*area) / d2;
+    deriv[4] = s * ((y0-y1)*d - (dx/d)*area) / d2;
+    deriv[5] = s * ((x1-x0)*d - (dy/d)*area) / d2;
+    deriv[6] = -scale;
+}
+
 double ConstraintP2LDistance::maxStep(MAP_pD_D &dir, double lim)
 {
     MAP_pD_D::iterator it;
@@ -472,6 +552,24 @@ double ConstraintPointOnLine::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintPointOnLine::grad(VEC_D &deriv)
+{
+    double x0=*p0x(), x1=*p1x(), x2=*p2x();
+    double y0=*p0y(), y1=*p1y(), y2=*p2y();
+    double dx = x2-x1;
+    double dy = y2-y1;
+    double d2 = dx*dx+dy*dy;
+    double d = sqrt(d2);
+    double area = -x0*dy+y0*dx+x1*y2-x2*y1;
+    deriv.resize(6);
+    deriv[0] = scale * (y1-y2) / d;
+    deriv[1] = scale * (x2-x1) / d;
+    deriv[2] = scale * ((y2-y0)*d + (dx/d)*area) / d2;
+    deriv[3] = scale * ((x0-x2)*d + (dy/d)*area) / d2;
+    deriv[4] = scale * ((y0-y1)*d - (dx/d)*area) / d2;
+    deriv[5] = scale * ((x1-x0)*d - (dy/d)*area) / d2;
+}
+
 // PointOnPerpBisector
 ConstraintPointOnPerpBisector::ConstraintPointOnPerpBisector(Point &p, Line &l)
 {
@@ -540,6 +638,23 @@ double ConstraintPointOnPerpBisector::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintPointOnPerpBisector::grad(VEC_D &deriv)
+{
+    double dx1 = *p1x() - *p0x();
+    double dy1 = *p1y() - *p0y();
+    double dx2 = *p2x() - *p0x();
+    double dy2 = *p2y() - *p0y();
+    double d1 = sqrt(dx1*dx1+dy1*dy1);
+    double d2 = sqrt(dx2*dx2+dy2*dy2);
+    deriv.resize(6);
+    deriv[0] = scale * (dx2/d2 - dx1/d1);
+    deriv[1] = scale * (dy2/d2 - dy1/d1);
+    deriv[2] = scale * dx1/d1;
+    deriv[3] = scale * dy1/d1;
+    deriv[4] = scale * -dx2/d2;
+    deriv[5] = scale * -dy2/d2;
+}
+
 // Parallel
 ConstraintParallel::ConstraintParallel(Line &l1, Line &l2)
 {
@@ -594,6 +709,23 @@ double ConstraintParallel::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintParallel::grad(VEC_D &deriv)
+{
+    double dx1 = (*l1p1x() - *l1p2x());
+    double dy1 = (*l1p1y() - *l1p2y());
+    double dx2 = (*l2p1x() - *l2p2x());
+    double dy2 = (*l2p1y() - *l2p2y());
+    deriv.resize(8);
+    deriv[0] = scale * dy2;
+    deriv[1] = scale * -dx2;
+    deriv[2] = scale * -dy2;
+    deriv[3] = scale * dx2;
+    deriv[4] = scale * -dy1;
+    deriv[5] = scale * dx1;
+    deriv[6] = scale * dy1;
+    deriv[7] = scale * -dx1;
+}
+
 // Perpendicular
 ConstraintPerpendicular::ConstraintPerpendicular(Line &l1, Line &l2)
 {
@@ -663,6 +795,23 @@ double ConstraintPerpendicular::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintPerpendicular::grad(VEC_D &deriv)
+{
+    double dx1 = (*l1p1x() - *l1p2x());
+    double dy1 = (*l1p1y() - *l1p2y());
+    double dx2 = (*l2p1x() - *l2p2x());
+    double dy2 = (*l2p1y() - *l2p2y());
+    deriv.resize(8);
+    deriv[0] = scale * dx2;
+    deriv[1] = scale * dy2;
+    deriv[2] = scale * -dx2;
+    deriv[3] = scale * -dy2;
+    deriv[4] = scale * dx1;
+    deriv[5] = scale * dy1;
+    deriv[6] = scale * -dx1;
+    deriv[7] = scale * -dy1;
+}
+
 // L2LAngle
 ConstraintL2LAngle::ConstraintL2LAngle(Line &l1, Line &l2, double *a)
 {
@@ -756,6 +905,33 @@ double ConstraintL2LAngle::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintL2LAngle::grad(VEC_D &deriv)
+{
+    double dx1 = (*l1p2x() - *l1p1x());
+    double dy1 = (*l1p2y() - *l1p1y());
+    double r1 = dx1*dx1+dy1*dy1;
+    double dx2 = (*l2p2x() - *l2p1x());
+    double dy2 = (*l2p2y() - *l2p1y());
+    double a = atan2(dy1,dx1) + *angle();
+    double ca = cos(a);
+    double sa = sin(a);
+    double x2 = dx2*ca + dy2*sa;
+    double y2 = -dx2*sa + dy2*ca;
+    double r2 = dx2*dx2+dy2*dy2;
+    dx2 = -y2/r2;
+    dy2 = x2/r2;
+    deriv.resize(9);
+    deriv[0] = scale * -dy1/r1;
+    deriv[1] = scale * dx1/r1;
+    deriv[2] = scale * dy1/r1;
+    deriv[3] = scale * -dx1/r1;
+    deriv[4] = scale * (-ca*dx2 + sa*dy2);
+    deriv[5] = scale * (-sa*dx2 - ca*dy2);
+    deriv[6] = scale * ( ca*dx2 - sa*dy2);
+    deriv[7] = scale * ( sa*dx2 + ca*dy2);
+    deriv[8] = -scale;
+}
+
 double ConstraintL2LAngle::maxStep(MAP_pD_D &dir, double lim)
 {
     // step(angle()) <= pi/18 = 10°
@@ -851,6 +1027,28 @@ double ConstraintMidpointOnLine::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintMidpointOnLine::grad(VEC_D &deriv)
+{
+    double x0=((*l1p1x())+(*l1p2x()))/2;
+    double y0=((*l1p1y())+(*l1p2y()))/2;
+    double x1=*l2p1x(), x2=*l2p2x();
+    double y1=*l2p1y(), y2=*l2p2y();
+    double dx = x2-x1;
+    double dy = y2-y1;
+    double d2 = dx*dx+dy*dy;
+    double d = sqrt(d2);
+    double area = -x0*dy+y0*dx+x1*y2-x2*y1;
+    deriv.resize(8);
+    deriv[0] = scale * (y1-y2) / (2*d);
+    deriv[1] = scale * (x2-x1) / (2*d);
+    deriv[2] = scale * (y1-y2) / (2*d);
+    deriv[3] = scale * (x2-x1) / (2*d);
+    deriv[4] = scale * ((y2-y0)*d + (dx/d)*area) / d2;
+    deriv[5] = scale * ((x0-x2)*d + (dy/d)*area) / d2;
+    deriv[6] = scale * ((y0-y1)*d - (dx/d)*area) / d2;
+    deriv[7] = scale * ((x1-x0)*d - (dy/d)*area) / d2;
+}
+
 // TangentCircumf
 ConstraintTangentCircumf::ConstraintTangentCircumf(Point &p1, Point &p2,
                                                    double *rad1, double *rad2, bool internal_)
@@ -911,4 +1109,24 @@ double ConstraintTangentCircumf::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintTangentCircumf::grad(VEC_D &deriv)
+{
+    double dx = (*c1x() - *c2x());
+    double dy = (*c1y() - *c2y());
+    double d = sqrt(dx*dx + dy*dy);
+    deriv.resize(6);
+    deriv[0] = scale * dx/d;
+    deriv[1] = scale * dy/d;
+    deriv[2] = scale * -dx/d;
+    deriv[3] = scale * -dy/d;
+    if (internal) {
+        deriv[4] = scale * ((*r1() > *r2()) ? -1 : 1);
+        deriv[5] = scale * ((*r1() > *r2()) ? 1 : -1);
+    }
+    else {
+        deriv[4] = -scale;
+        deriv[5] = -scale;
+    }
+}
+
 } //namespace GCS
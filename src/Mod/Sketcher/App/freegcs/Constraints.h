@@ -59,9 +59,9 @@ namespace GCS
     public:
         Constraint();
 
-        inline VEC_pD params() { return pvec; }
+        inline const VEC_pD &params() { return pvec; }
 
-        void redirectParams(MAP_pD_pD redirectionmap);
+        void redirectParams(const MAP_pD_pD &redirectionmap);
         void revertParams();
         void setTag(int tagId) { tag = tagId; }
         int getTag() { return tag; }
@@ -70,7 +70,8 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
-        // virtual void grad(MAP_pD_D &deriv);  --> TODO: vectorized grad version
+        // derivatives with respect to all params() at once, deriv[i] belongs to params()[i]
+        virtual void grad(VEC_D &deriv);
         virtual double maxStep(MAP_pD_D &dir, double lim=1.);
     };
 
@@ -86,6 +87,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual void grad(VEC_D &deriv);
     };
 
     // Difference
@@ -101,6 +103,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual void grad(VEC_D &deriv);
     };
 
     // P2PDistance
@@ -118,6 +121,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual void grad(VEC_D &deriv);
         virtual double maxStep(MAP_pD_D &dir, double lim=1.);
     };
 
@@ -137,6 +141,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual void grad(VEC_D &deriv);
         virtual double maxStep(MAP_pD_D &dir, double lim=1.);
     };
 
@@ -157,6 +162,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual void grad(VEC_D &deriv);
         virtual double maxStep(MAP_pD_D &dir, double lim=1.);
     };
 
@@ -177,6 +183,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual void grad(VEC_D &deriv);
     };
 
     // PointOnPerpBisector
@@ -196,6 +203,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual void grad(VEC_D &deriv);
     };
 
     // Parallel
@@ -216,6 +224,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual void grad(VEC_D &deriv);
     };
 
     // Perpendicular
@@ -237,6 +246,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual void grad(VEC_D &deriv);
     };
 
     // L2LAngle
@@ -260,6 +270,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual void grad(VEC_D &deriv);
         virtual double maxStep(MAP_pD_D &dir, double lim=1.);
     };
 
@@ -282,6 +293,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual void grad(VEC_D &deriv);
     };
 
     // TangentCircumf
@@ -302,6 +314,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual void grad(VEC_D &deriv);
     };
 
 } //namespace GCS
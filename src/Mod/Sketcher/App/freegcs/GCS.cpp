@@ -26,15 +26,66 @@
 #include "GCS.h"
 #include "qp_eq.h"
 #include <Eigen/QR>
+#include <Eigen/SparseCholesky>
 
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/connected_components.hpp>
+#include <boost/bind.hpp>
+
+#include <QtConcurrentMap>
 
 namespace GCS
 {
 
 typedef boost::adjacency_list <boost::vecS, boost::vecS, boost::undirectedS> Graph;
 
+// Least squares solutions of sparse systems, see solve_DL
+class SparseLeastSquares
+{
+public:
+    bool solve(const Eigen::SparseMatrix<double> &J,
+               const Eigen::VectorXd &rhs, Eigen::VectorXd &h);
+
+private:
+    Eigen::SparseMatrix<double> N;  // normal equations
+    Eigen::VectorXd b, y;
+    VEC_I outer, inner;             // pattern of N that ldlt has analysed
+    Eigen::SimplicialLDLT< Eigen::SparseMatrix<double> > ldlt;
+};
+
+// Buffers of the DogLeg solver. In incremental mode they are kept for each component
+// from one solution to the next one together with a subsystem that holds all constraints
+// of the component. So a drag neither rebuilds the subsystem nor reallocates the
+// matrices or analyses the pattern of the sparse factorization again on each move.
+struct System::Workspace
+{
+    Workspace() : subsys(0)
+    {
+    }
+    ~Workspace()
+    {
+        delete subsys;
+    }
+    SubSystem *subsys;
+    Eigen::VectorXd x, x_new, fx, fx_new, g, h_sd, h_gn, h_dl;
+    Eigen::MatrixXd Jx, Jx_new;
+    Eigen::SparseMatrix<double> Jxs, Jxs_new;
+    SparseLeastSquares lsq;
+};
+
+struct System::SolveJob
+{
+    SolveJob(int cid_, bool isFine_, Algorithm alg_)
+    : cid(cid_), isFine(isFine_), alg(alg_), result(Failed)
+    {
+    }
+    int cid;
+    bool isFine;
+    Algorithm alg;
+    int result;
+    VEC_D inputs; // isFine and the values of fixedlists[cid]
+};
+
 ///////////////////////////////////////
 // Solver
 ///////////////////////////////////////
@@ -45,7 +96,7 @@ System::System()
   c2p(), p2c(),
   subSystems(0), subSystemsAux(0),
   reference(0),
-  hasUnknowns(false), hasDiagnosis(false), isInit(false)
+  hasUnknowns(false), hasDiagnosis(false), isInit(false), isIncremental(false)
 {
 }
 
@@ -54,7 +105,7 @@ System::System(std::vector<Constraint *> clist_)
   c2p(), p2c(),
   subSystems(0), subSystemsAux(0),
   reference(0),
-  hasUnknowns(false), hasDiagnosis(false), isInit(false)
+  hasUnknowns(false), hasDiagnosis(false), isInit(false), isIncremental(false)
 {
     // create own (shallow) copy of constraints
     for (std::vector<Constraint *>::iterator constr=clist_.begin();
@@ -583,8 +634,11 @@ void System::rescaleConstraint(int id, double coeff)
 {
     if (id >= clist.size() || id < 0)
         return;
-    if (clist[id])
+    if (clist[id]) {
         clist[id]->rescale(coeff);
+        // the last solutions may not be accurate enough for the new scale
+        solvedInputs.assign(solvedInputs.size(), VEC_D());
+    }
 }
 
 void System::declareUnknowns(VEC_pD &params)
@@ -596,7 +650,7 @@ void System::declareUnknowns(VEC_pD &params)
     hasUnknowns = true;
 }
 
-void System::initSolution()
+void System::initSolution(bool incremental)
 {
     // - Stores the current parameters values in the vector "reference"
     // - identifies any decoupled subsystems and partitions the original
@@ -607,8 +661,11 @@ void System::initSolution()
     // - Organizes the rest of constraints into two subsystems for
     //   tag ids >=0 and < 0 respectively and applies the
     //   system reduction specified in the previous step
+    // - In incremental mode, prepares the workspaces for solving the
+    //   components with tag ids < 0 starting from the last solution
 
     isInit = false;
+    isIncremental = incremental;
     if (!hasUnknowns)
         return;
 
@@ -699,6 +756,23 @@ void System::initSolution()
         plists[cid].push_back(plist[i]);
     }
 
+    // constant parameters of each component, their values decide whether
+    // a component that was solved before has to be solved again
+    fixedlists.clear();
+    fixedlists.resize(componentsSize);
+    for (int cid=0; cid < componentsSize; cid++) {
+        SET_pD fixed;
+        for (std::vector<Constraint *>::const_iterator constr=clists[cid].begin();
+             constr != clists[cid].end(); ++constr) {
+            VEC_pD &cparams = c2p[*constr];
+            for (VEC_pD::const_iterator param=cparams.begin();
+                 param != cparams.end(); ++param)
+                if (pIndex.find(*param) == pIndex.end())
+                    fixed.insert(*param);
+        }
+        fixedlists[cid].assign(fixed.begin(), fixed.end());
+    }
+
     // calculates subSystems and subSystemsAux from clists, plists and reductionmaps
     clearSubSystems();
     for (int cid=0; cid < clists.size(); cid++) {
@@ -718,6 +792,17 @@ void System::initSolution()
         if (clist1.size() > 0)
             subSystemsAux[cid] = new SubSystem(clist1, plists[cid], reductionmaps[cid]);
     }
+    solvedInputs.resize(componentsSize);
+
+    workspaces.assign(componentsSize, NULL);
+    if (isIncremental) {
+        for (int cid=0; cid < componentsSize; cid++) {
+            if (subSystems[cid] && subSystemsAux[cid]) {
+                workspaces[cid] = new Workspace();
+                workspaces[cid]->subsys = new SubSystem(clists[cid], plists[cid], reductionmaps[cid]);
+            }
+        }
+    }
 
     isInit = true;
 }
@@ -753,21 +838,52 @@ int System::solve(bool isFine, Algorithm alg)
     if (!isInit)
         return Failed;
 
+    // The decoupled components are independent of each other and are solved
+    // concurrently if they are big enough. A component that was solved successfully
+    // with the same values of its constant parameters is skipped because its
+    // subsystems still hold that solution, e.g. while dragging a point of another
+    // component. In incremental mode the last solution is the starting point
+    // instead of the reference.
     bool isReset = false;
-    // return success by default in order to permit coincidence constraints to be applied
-    // even if no other system has to be solved
-    int res = Success;
+    int paramsNum = 0;
+    std::vector<SolveJob> jobs;
     for (int cid=0; cid < int(subSystems.size()); cid++) {
-        if ((subSystems[cid] || subSystemsAux[cid]) && !isReset) {
-             resetToReference();
+        if (!subSystems[cid] && !subSystemsAux[cid])
+            continue;
+        if (!isReset) {
+             if (!isIncremental)
+                 resetToReference();
              isReset = true;
         }
-        if (subSystems[cid] && subSystemsAux[cid])
-            res = std::max(res, solve(subSystems[cid], subSystemsAux[cid], isFine));
-        else if (subSystems[cid])
-            res = std::max(res, solve(subSystems[cid], isFine, alg));
-        else if (subSystemsAux[cid])
-            res = std::max(res, solve(subSystemsAux[cid], isFine, alg));
+        SolveJob job(cid, isFine, alg);
+        job.inputs.reserve(fixedlists[cid].size() + 1);
+        job.inputs.push_back(isFine ? 1. : 0.);
+        for (VEC_pD::const_iterator param=fixedlists[cid].begin();
+             param != fixedlists[cid].end(); ++param)
+            job.inputs.push_back(**param);
+        if (job.inputs == solvedInputs[cid])
+            continue;
+        jobs.push_back(job);
+        paramsNum += int(plists[cid].size());
+    }
+
+    if (jobs.size() > 1 && paramsNum >= ParallelThreshold) {
+        QtConcurrent::blockingMap(jobs, boost::bind(&System::solveComponent, this, _1));
+    }
+    else {
+        for (std::vector<SolveJob>::iterator job=jobs.begin(); job != jobs.end(); ++job)
+            solveComponent(*job);
+    }
+
+    // return success by default in order to permit coincidence constraints to be applied
+    // even if no other system has to be solved
+    int res = Success;
+    for (std::vector<SolveJob>::iterator job=jobs.begin(); job != jobs.end(); ++job) {
+        res = std::max(res, job->result);
+        if (job->result == Success)
+            solvedInputs[job->cid].swap(job->inputs);
+        else
+            solvedInputs[job->cid].clear();
     }
     if (res == Success) {
         for (std::set<Constraint *>::const_iterator constr=redundant.begin();
@@ -780,6 +896,31 @@ int System::solve(bool isFine, Algorithm alg)
     return res;
 }
 
+void System::solveComponent(SolveJob &job)
+{
+    int cid = job.cid;
+    if (subSystems[cid] && subSystemsAux[cid]) {
+        // In incremental mode all constraints of the component are solved together
+        // which is much cheaper than SQP as long as the moved geometry can follow
+        // exactly. SQP is only needed if the constraints tagged with ids < 0 cannot
+        // be satisfied, e.g. if a point is dragged out of its reach.
+        if (workspaces[cid] && solve_DL(workspaces[cid]->subsys, workspaces[cid]) == Success) {
+            VEC_pD &plistC = plists[cid];
+            Eigen::VectorXd &x = workspaces[cid]->x;
+            workspaces[cid]->subsys->getParams(plistC, x);
+            subSystems[cid]->setParams(plistC, x);
+            subSystemsAux[cid]->setParams(plistC, x);
+            job.result = Success;
+        }
+        else
+            job.result = solve(subSystems[cid], subSystemsAux[cid], job.isFine);
+    }
+    else if (subSystems[cid])
+        job.result = solve(subSystems[cid], job.isFine, job.alg);
+    else if (subSystemsAux[cid])
+        job.result = solve(subSystemsAux[cid], job.isFine, job.alg);
+}
+
 int System::solve(SubSystem *subsys, bool isFine, Algorithm alg)
 {
     if (alg == BFGS)
@@ -865,6 +1006,61 @@ int System::solve_BFGS(SubSystem *subsys, bool isFine)
     return Failed;
 }
 
+// Returns false if the factorized matrix is singular or nearly singular. The pivots
+// of the normal equations are the squares of those of J, so the tolerance is bigger
+// than the rounding errors of forming J^T*J.
+static bool isRegular(const Eigen::SimplicialLDLT< Eigen::SparseMatrix<double> > &ldlt)
+{
+    if (ldlt.info() != Eigen::Success)
+        return false;
+    const Eigen::VectorXd &D = ldlt.vectorD();
+    if (D.size() == 0)
+        return true;
+    return D.minCoeff() > 1e-12 * D.cwiseAbs().maxCoeff();
+}
+
+// Solves the Gauss-Newton step J*h = rhs with a sparse Cholesky factorization of
+// the normal equations. If there are less equations than unknowns, the minimum norm
+// solution h = J^T*y with (J*J^T)*y = rhs is computed instead. If J is rank-deficient,
+// e.g. because of redundant constraints, false is returned and the caller must use
+// the dense solver, which handles this case.
+bool SparseLeastSquares::solve(const Eigen::SparseMatrix<double> &J,
+                               const Eigen::VectorXd &rhs, Eigen::VectorXd &h)
+{
+    bool minNorm = J.rows() <= J.cols();
+    if (minNorm) {
+        N = J * Eigen::SparseMatrix<double>(J.transpose());
+        b = rhs;
+    }
+    else {
+        N = Eigen::SparseMatrix<double>(J.transpose()) * J;
+        b = J.transpose() * rhs;
+    }
+
+    N.makeCompressed();
+
+    // the jacobian of a subsystem keeps its pattern, so the symbolic analysis
+    // is done once for all iterations and for all moves of an incremental drag
+    int nnz = int(N.nonZeros());
+    if (int(outer.size()) != N.outerSize() + 1 || int(inner.size()) != nnz ||
+        !std::equal(outer.begin(), outer.end(), N.outerIndexPtr()) ||
+        !std::equal(inner.begin(), inner.end(), N.innerIndexPtr())) {
+        outer.assign(N.outerIndexPtr(), N.outerIndexPtr() + N.outerSize() + 1);
+        inner.assign(N.innerIndexPtr(), N.innerIndexPtr() + nnz);
+        ldlt.analyzePattern(N);
+    }
+    ldlt.factorize(N);
+    if (!isRegular(ldlt))
+        return false;
+
+    y = ldlt.solve(b);
+    if (minNorm)
+        h = J.transpose() * y;
+    else
+        h = y;
+    return true;
+}
+
 int System::solve_LM(SubSystem* subsys)
 {
     int xsize = subsys->pSize();
@@ -873,9 +1069,14 @@ int System::solve_LM(SubSystem* subsys)
     if (xsize == 0)
         return Success;
 
+    // big systems are solved with sparse matrices because each constraint
+    // only depends on a few parameters
+    bool sparse = xsize >= SparseThreshold;
+
     Eigen::VectorXd e(csize), e_new(csize); // vector of all function errors (every constraint is one function)
-    Eigen::MatrixXd J(csize, xsize);        // Jacobi of the subsystem
-    Eigen::MatrixXd A(xsize, xsize);
+    Eigen::MatrixXd J, A;                   // Jacobi of the subsystem and J^T J
+    Eigen::SparseMatrix<double> Js, As;     // the same as sparse matrices
+    Eigen::SimplicialLDLT< Eigen::SparseMatrix<double> > ldlt;
     Eigen::VectorXd x(xsize), h(xsize), x_new(xsize), g(xsize), diag_A(xsize);
 
     subsys->redirectParams();
@@ -905,14 +1106,22 @@ int System::solve_LM(SubSystem* subsys)
         }
 
         // J^T J, J^T e
-        subsys->calcJacobi(J);;
-
-        A = J.transpose()*J;
-        g = J.transpose()*e;
+        if (sparse) {
+            subsys->calcJacobi(Js);
+            As = Eigen::SparseMatrix<double>(Js.transpose()) * Js;
+            g = Js.transpose()*e;
+            for (int i=0; i < xsize; ++i)
+                diag_A(i) = As.coeff(i,i);
+        }
+        else {
+            subsys->calcJacobi(J);
+            A = J.transpose()*J;
+            g = J.transpose()*e;
+            diag_A = A.diagonal(); // save diagonal entries so that augmentation can be later canceled
+        }
 
         // Compute ||J^T e||_inf
         double g_inf = g.lpNorm<Eigen::Infinity>();
-        diag_A = A.diagonal(); // save diagonal entries so that augmentation can be later canceled
 
         // check for convergence
         if (g_inf <= eps1) {
@@ -927,13 +1136,28 @@ int System::solve_LM(SubSystem* subsys)
         // determine increment using adaptive damping
         int k=0;
         while (k < 50) {
-            // augment normal equations A = A+uI
-            for (int i=0; i < xsize; ++i)
-                A(i,i) += mu;
-
-            //solve augmented functions A*h=-g
-            h = A.fullPivLu().solve(g);
-            double rel_error = (A*h - g).norm() / g.norm();
+            // augment normal equations A = A+uI and solve augmented functions A*h=-g
+            double rel_error;
+            if (sparse) {
+                for (int i=0; i < xsize; ++i)
+                    As.coeffRef(i,i) = diag_A(i) + mu;
+                ldlt.compute(As);
+                if (isRegular(ldlt)) {
+                    h = ldlt.solve(g);
+                }
+                else {
+                    // redundant constraints with a small damping, solve it like a small system
+                    A = Eigen::MatrixXd(As);
+                    h = A.fullPivLu().solve(g);
+                }
+                rel_error = (As*h - g).norm() / g.norm();
+            }
+            else {
+                for (int i=0; i < xsize; ++i)
+                    A(i,i) += mu;
+                h = A.fullPivLu().solve(g);
+                rel_error = (A*h - g).norm() / g.norm();
+            }
 
             // check if solving works
             if (rel_error < 1e-5) {
@@ -980,8 +1204,10 @@ int System::solve_LM(SubSystem* subsys)
 
             mu*=nu;
             nu*=2.0;
-            for (int i=0; i < xsize; ++i) // restore diagonal J^T J entries
-                A(i,i) = diag_A(i);
+            if (!sparse) {
+                for (int i=0; i < xsize; ++i) // restore diagonal J^T J entries
+                    A(i,i) = diag_A(i);
+            }
 
             k++;
         }
@@ -1000,7 +1226,7 @@ int System::solve_LM(SubSystem* subsys)
 }
 
 
-int System::solve_DL(SubSystem* subsys)
+int System::solve_DL(SubSystem* subsys, Workspace *ws)
 {
     double tolg=1e-80, tolx=1e-80, tolf=1e-10;
 
@@ -1010,19 +1236,38 @@ int System::solve_DL(SubSystem* subsys)
     if (xsize == 0)
         return Success;
 
-    Eigen::VectorXd x(xsize), x_new(xsize);
-    Eigen::VectorXd fx(csize), fx_new(csize);
-    Eigen::MatrixXd Jx(csize, xsize), Jx_new(csize, xsize);
-    Eigen::VectorXd g(xsize), h_sd(xsize), h_gn(xsize), h_dl(xsize);
+    bool sparse = xsize >= SparseThreshold;
+
+    // in incremental mode the caller falls back to SQP if the system cannot be solved,
+    // so there is no need to wait for the end of a stagnating iteration
+    bool incremental = ws != NULL;
+    Workspace wsTmp;
+    if (!ws)
+        ws = &wsTmp;
+    Eigen::VectorXd &x = ws->x, &x_new = ws->x_new;
+    Eigen::VectorXd &fx = ws->fx, &fx_new = ws->fx_new;
+    Eigen::MatrixXd &Jx = ws->Jx, &Jx_new = ws->Jx_new;
+    Eigen::SparseMatrix<double> &Jxs = ws->Jxs, &Jxs_new = ws->Jxs_new;
+    Eigen::VectorXd &g = ws->g, &h_sd = ws->h_sd, &h_gn = ws->h_gn, &h_dl = ws->h_dl;
+    x.resize(xsize);
+    x_new.resize(xsize);
+    fx.resize(csize);
+    fx_new.resize(csize);
+    g.resize(xsize);
 
     subsys->redirectParams();
 
     double err;
     subsys->getParams(x);
     subsys->calcResidual(fx, err);
-    subsys->calcJacobi(Jx);
-
-    g = Jx.transpose()*(-fx);
+    if (sparse) {
+        subsys->calcJacobi(Jxs);
+        g = Jxs.transpose()*(-fx);
+    }
+    else {
+        subsys->calcJacobi(Jx);
+        g = Jx.transpose()*(-fx);
+    }
 
     // get the infinity norm fx_inf and g_inf
     double g_inf = g.lpNorm<Eigen::Infinity>();
@@ -1035,6 +1280,8 @@ int System::solve_DL(SubSystem* subsys)
     double alpha=0.;
     double nu=2.;
     int iter=0, stop=0, reduce=0;
+    double err_check = err;
+    bool rankDeficient = false;
     while (!stop) {
 
         // check if finished
@@ -1046,17 +1293,35 @@ int System::solve_DL(SubSystem* subsys)
             stop = 2;
         else if (iter >= maxIterNumber)
             stop = 4;
+        else if (incremental && iter > 0 && iter % IncrementalCheckIterations == 0 &&
+                 err > 0.9 * err_check)
+            stop = 4;
         else if (err > divergingLim || err != err) { // check for diverging and NaN
             stop = 6;
         }
         else {
-            // get the steepest descent direction
-            alpha = g.squaredNorm()/(Jx*g).squaredNorm();
+            if (iter % IncrementalCheckIterations == 0)
+                err_check = err;
+
+            // get the steepest descent direction and the gauss-newton step
+            double rel_error;
+            if (sparse) {
+                alpha = g.squaredNorm()/(Jxs*g).squaredNorm();
+                // the rank usually doesn't change from one iteration to the next, so after the
+                // first failure the dense solver is used directly
+                if (rankDeficient || !ws->lsq.solve(Jxs, -fx, h_gn)) {
+                    rankDeficient = true;
+                    Jx = Eigen::MatrixXd(Jxs);
+                    h_gn = Jx.fullPivLu().solve(-fx);
+                }
+                rel_error = (Jxs*h_gn + fx).norm() / fx.norm();
+            }
+            else {
+                alpha = g.squaredNorm()/(Jx*g).squaredNorm();
+                h_gn = Jx.fullPivLu().solve(-fx);
+                rel_error = (Jx*h_gn + fx).norm() / fx.norm();
+            }
             h_sd  = alpha*g;
-
-            // get the gauss-newton step
-            h_gn = Jx.fullPivLu().solve(-fx);
-            double rel_error = (Jx*h_gn + fx).norm() / fx.norm();
             if (rel_error > 1e15)
                 break;
 
@@ -1104,20 +1369,33 @@ int System::solve_DL(SubSystem* subsys)
         x_new = x + h_dl;
         subsys->setParams(x_new);
         subsys->calcResidual(fx_new, err_new);
-        subsys->calcJacobi(Jx_new);
 
         // calculate the linear model and the update ratio
-        double dL = err - 0.5*(fx + Jx*h_dl).squaredNorm();
+        double dL;
+        if (sparse) {
+            subsys->calcJacobi(Jxs_new);
+            dL = err - 0.5*(fx + Jxs*h_dl).squaredNorm();
+        }
+        else {
+            subsys->calcJacobi(Jx_new);
+            dL = err - 0.5*(fx + Jx*h_dl).squaredNorm();
+        }
         double dF = err - err_new;
         double rho = dL/dF;
 
         if (dF > 0 && dL > 0) {
             x  = x_new;
-            Jx = Jx_new;
             fx = fx_new;
             err = err_new;
 
-            g = Jx.transpose()*(-fx);
+            if (sparse) {
+                Jxs = Jxs_new;
+                g = Jxs.transpose()*(-fx);
+            }
+            else {
+                Jx = Jx_new;
+                g = Jx.transpose()*(-fx);
+            }
 
             // get infinity norms
             g_inf = g.lpNorm<Eigen::Infinity>();
@@ -1328,6 +1606,9 @@ void System::applySolution()
 void System::undoSolution()
 {
     resetToReference();
+    // the subsystems still hold the undone solution, so the next call of solve()
+    // must not skip any component
+    solvedInputs.assign(solvedInputs.size(), VEC_D());
 }
 
 int System::diagnose()
@@ -1351,171 +1632,223 @@ int System::diagnose()
     redundant.clear();
     conflictingTags.clear();
     redundantTags.clear();
-    Eigen::MatrixXd J(clist.size(), plist.size());
-    int count=0;
+
+    // The jacobian is block diagonal with one block for each decoupled component
+    // of the constraint graph. Therefore, the components are analysed one by one
+    // which is much cheaper than a decomposition of the jacobian of the whole system.
+    std::vector<Constraint *> clistD;
     for (std::vector<Constraint *>::iterator constr=clist.begin();
          constr != clist.end(); ++constr) {
         (*constr)->revertParams();
-        if ((*constr)->getTag() >= 0) {
-            count++;
-            for (int j=0; j < int(plist.size()); j++)
-                J(count-1,j) = (*constr)->grad(plist[j]);
+        if ((*constr)->getTag() >= 0)
+            clistD.push_back(*constr);
+    }
+
+    Graph g;
+    for (int i=0; i < int(plist.size() + clistD.size()); i++)
+        boost::add_vertex(g);
+
+    int cvtid = int(plist.size());
+    for (std::vector<Constraint *>::const_iterator constr=clistD.begin();
+         constr != clistD.end(); ++constr, cvtid++) {
+        VEC_pD &cparams = c2p[*constr];
+        for (VEC_pD::const_iterator param=cparams.begin();
+             param != cparams.end(); ++param) {
+            MAP_pD_I::const_iterator it = pIndex.find(*param);
+            if (it != pIndex.end())
+                boost::add_edge(cvtid, it->second, g);
         }
     }
 
-    if (J.rows() > 0) {
-        Eigen::FullPivHouseholderQR<Eigen::MatrixXd> qrJT(J.topRows(count).transpose());
-        Eigen::MatrixXd Q = qrJT.matrixQ ();
-        int paramsNum = qrJT.rows();
-        int constrNum = qrJT.cols();
-        int rank = qrJT.rank();
-
+    VEC_I components(boost::num_vertices(g));
+    int componentsSize = boost::connected_components(g, &components[0]);
+
+    std::vector< VEC_pD > plistsD(componentsSize);
+    for (int i=0; i < int(plist.size()); ++i)
+        plistsD[components[i]].push_back(plist[i]);
+    std::vector< std::vector<Constraint *> > clistsD(componentsSize);
+    for (int i=0; i < int(clistD.size()); ++i)
+        clistsD[components[plist.size()+i]].push_back(clistD[i]);
+
+    int paramsNum = int(plist.size());
+    int constrNum = 0;
+    int rank = 0;
+    SET_I conflictingTagsSet;
+    for (int cid=0; cid < componentsSize; cid++) {
+        if (clistsD[cid].size() > 0)
+            diagnoseComponent(clistsD[cid], plistsD[cid], rank, constrNum, conflictingTagsSet);
+    }
+
+    // simplified output of conflicting tags
+    conflictingTagsSet.erase(0); // exclude constraints tagged with zero
+    conflictingTags.resize(conflictingTagsSet.size());
+    std::copy(conflictingTagsSet.begin(), conflictingTagsSet.end(),
+              conflictingTags.begin());
+
+    // output of redundant tags
+    SET_I redundantTagsSet;
+    for (std::set<Constraint *>::iterator constr=redundant.begin();
+         constr != redundant.end(); ++constr)
+        redundantTagsSet.insert((*constr)->getTag());
+    // remove tags represented at least in one non-redundant constraint
+    for (std::vector<Constraint *>::iterator constr=clist.begin();
+         constr != clist.end(); ++constr)
+        if (redundant.count(*constr) == 0)
+            redundantTagsSet.erase((*constr)->getTag());
+    redundantTags.resize(redundantTagsSet.size());
+    std::copy(redundantTagsSet.begin(), redundantTagsSet.end(),
+              redundantTags.begin());
+
+    hasDiagnosis = true;
+    if (paramsNum == rank && constrNum > rank) // over-constrained
+        dofs = paramsNum - constrNum;
+    else
+        dofs = paramsNum - rank;
+    return dofs;
+}
+
+void System::diagnoseComponent(std::vector<Constraint *> &clistC, VEC_pD &plistC,
+                               int &rank, int &constrNum, SET_I &conflictingTagsSet)
+{
+    // Adds the rank of the jacobian of a decoupled component and its number of
+    // not redundant constraints to rank and constrNum. Redundant constraints are
+    // added to "redundant" and the tags of conflicting ones to conflictingTagsSet.
+    MAP_pD_I pIndexC;
+    for (int j=0; j < int(plistC.size()); j++)
+        pIndexC[plistC[j]] = j;
+
+    Eigen::MatrixXd J = Eigen::MatrixXd::Zero(clistC.size(), plistC.size());
+    VEC_D deriv;
+    for (int i=0; i < int(clistC.size()); i++) {
+        const VEC_pD &constr_params = clistC[i]->params();
+        clistC[i]->grad(deriv);
+        for (int k=0; k < int(constr_params.size()); k++) {
+            MAP_pD_I::const_iterator it = pIndexC.find(constr_params[k]);
+            if (it != pIndexC.end())
+                J(i,it->second) += deriv[k];
+        }
+    }
+
+    Eigen::FullPivHouseholderQR<Eigen::MatrixXd> qrJT(J.transpose());
+    int paramsNumC = qrJT.rows();
+    int constrNumC = qrJT.cols();
+    int rankC = qrJT.rank();
+
+    if (constrNumC > rankC) { // conflicting or redundant constraints
         Eigen::MatrixXd R;
-        if (constrNum >= paramsNum)
+        if (constrNumC >= paramsNumC)
             R = qrJT.matrixQR().triangularView<Eigen::Upper>();
         else
-            R = qrJT.matrixQR().topRows(constrNum)
+            R = qrJT.matrixQR().topRows(constrNumC)
                                .triangularView<Eigen::Upper>();
 
-        if (constrNum > rank) { // conflicting or redundant constraints
-            for (int i=1; i < rank; i++) {
-                // eliminate non zeros above pivot
-                assert(R(i,i) != 0);
-                for (int row=0; row < i; row++) {
-                    if (R(row,i) != 0) {
-                        double coef=R(row,i)/R(i,i);
-                        R.block(row,i+1,1,constrNum-i-1) -= coef * R.block(i,i+1,1,constrNum-i-1);
-                        R(row,i) = 0;
-                    }
+        for (int i=1; i < rankC; i++) {
+            // eliminate non zeros above pivot
+            assert(R(i,i) != 0);
+            for (int row=0; row < i; row++) {
+                if (R(row,i) != 0) {
+                    double coef=R(row,i)/R(i,i);
+                    R.block(row,i+1,1,constrNumC-i-1) -= coef * R.block(i,i+1,1,constrNumC-i-1);
+                    R(row,i) = 0;
                 }
             }
-            std::vector< std::vector<Constraint *> > conflictGroups(constrNum-rank);
-            for (int j=rank; j < constrNum; j++) {
-                for (int row=0; row < rank; row++) {
-                    if (fabs(R(row,j)) > 1e-10) {
-                        int origCol = qrJT.colsPermutation().indices()[row];
-                        conflictGroups[j-rank].push_back(clist[origCol]);
-                    }
+        }
+        std::vector< std::vector<Constraint *> > conflictGroups(constrNumC-rankC);
+        for (int j=rankC; j < constrNumC; j++) {
+            for (int row=0; row < rankC; row++) {
+                if (fabs(R(row,j)) > 1e-10) {
+                    int origCol = qrJT.colsPermutation().indices()[row];
+                    conflictGroups[j-rankC].push_back(clistC[origCol]);
                 }
-                int origCol = qrJT.colsPermutation().indices()[j];
-                conflictGroups[j-rank].push_back(clist[origCol]);
             }
+            int origCol = qrJT.colsPermutation().indices()[j];
+            conflictGroups[j-rankC].push_back(clistC[origCol]);
+        }
 
-            // try to remove the conflicting constraints and solve the
-            // system in order to check if the removed constraints were
-            // just redundant but not really conflicting
-            std::set<Constraint *> skipped;
-            SET_I satisfiedGroups;
-            while (1) {
-                std::map< Constraint *, SET_I > conflictingMap;
-                for (int i=0; i < conflictGroups.size(); i++) {
-                    if (satisfiedGroups.count(i) == 0) {
-                        for (int j=0; j < conflictGroups[i].size(); j++) {
-                            Constraint *constr = conflictGroups[i][j];
-                            if (constr->getTag() != 0) // exclude constraints tagged with zero
-                                conflictingMap[constr].insert(i);
-                        }
-                    }
-                }
-                if (conflictingMap.empty())
-                    break;
-            
-                int maxPopularity = 0;
-                Constraint *mostPopular = NULL;
-                for (std::map< Constraint *, SET_I >::const_iterator it=conflictingMap.begin();
-                     it != conflictingMap.end(); it++) {
-                    if (it->second.size() > maxPopularity ||
-                        (it->second.size() == maxPopularity && mostPopular &&
-                         it->first->getTag() > mostPopular->getTag())) {
-                        mostPopular = it->first;
-                        maxPopularity = it->second.size();
+        // try to remove the conflicting constraints and solve the
+        // system in order to check if the removed constraints were
+        // just redundant but not really conflicting
+        std::set<Constraint *> skipped;
+        SET_I satisfiedGroups;
+        while (1) {
+            std::map< Constraint *, SET_I > conflictingMap;
+            for (int i=0; i < conflictGroups.size(); i++) {
+                if (satisfiedGroups.count(i) == 0) {
+                    for (int j=0; j < conflictGroups[i].size(); j++) {
+                        Constraint *constr = conflictGroups[i][j];
+                        if (constr->getTag() != 0) // exclude constraints tagged with zero
+                            conflictingMap[constr].insert(i);
                     }
                 }
-                if (maxPopularity > 0) {
-                    skipped.insert(mostPopular);
-                    for (SET_I::const_iterator it=conflictingMap[mostPopular].begin();
-                         it != conflictingMap[mostPopular].end(); it++)
-                        satisfiedGroups.insert(*it);
-                }
             }
+            if (conflictingMap.empty())
+                break;
 
-            std::vector<Constraint *> clistTmp;
-            clistTmp.reserve(clist.size());
-            for (std::vector<Constraint *>::iterator constr=clist.begin();
-                 constr != clist.end(); ++constr)
-                if (skipped.count(*constr) == 0)
-                    clistTmp.push_back(*constr);
-
-            SubSystem *subSysTmp = new SubSystem(clistTmp, plist);
-            int res = solve(subSysTmp);
-            if (res == Success) {
-                subSysTmp->applySolution();
-                for (std::set<Constraint *>::const_iterator constr=skipped.begin();
-                     constr != skipped.end(); constr++) {
-                    double err = (*constr)->error();
-                    if (err * err < XconvergenceFine)
-                        redundant.insert(*constr);
-                }
-                resetToReference();
-
-                std::vector< std::vector<Constraint *> > conflictGroupsOrig=conflictGroups;
-                conflictGroups.clear();
-                for (int i=conflictGroupsOrig.size()-1; i >= 0; i--) {
-                    bool isRedundant = false;
-                    for (int j=0; j < conflictGroupsOrig[i].size(); j++) {
-                        if (redundant.count(conflictGroupsOrig[i][j]) > 0) {
-                            isRedundant = true;
-                            break;
-                        }
-                    }
-                    if (!isRedundant)
-                        conflictGroups.push_back(conflictGroupsOrig[i]);
-                    else
-                        constrNum--;
+            int maxPopularity = 0;
+            Constraint *mostPopular = NULL;
+            for (std::map< Constraint *, SET_I >::const_iterator it=conflictingMap.begin();
+                 it != conflictingMap.end(); it++) {
+                if (it->second.size() > maxPopularity ||
+                    (it->second.size() == maxPopularity && mostPopular &&
+                     it->first->getTag() > mostPopular->getTag())) {
+                    mostPopular = it->first;
+                    maxPopularity = it->second.size();
                 }
             }
-            delete subSysTmp;
+            if (maxPopularity > 0) {
+                skipped.insert(mostPopular);
+                for (SET_I::const_iterator it=conflictingMap[mostPopular].begin();
+                     it != conflictingMap[mostPopular].end(); it++)
+                    satisfiedGroups.insert(*it);
+            }
+        }
 
-            // simplified output of conflicting tags
-            SET_I conflictingTagsSet;
-            for (int i=0; i < conflictGroups.size(); i++) {
-                for (int j=0; j < conflictGroups[i].size(); j++) {
-                    conflictingTagsSet.insert(conflictGroups[i][j]->getTag());
+        std::vector<Constraint *> clistTmp;
+        clistTmp.reserve(clistC.size());
+        for (std::vector<Constraint *>::iterator constr=clistC.begin();
+             constr != clistC.end(); ++constr)
+            if (skipped.count(*constr) == 0)
+                clistTmp.push_back(*constr);
+
+        SubSystem *subSysTmp = new SubSystem(clistTmp, plistC);
+        int res = solve(subSysTmp);
+        if (res == Success) {
+            subSysTmp->applySolution();
+            for (std::set<Constraint *>::const_iterator constr=skipped.begin();
+                 constr != skipped.end(); constr++) {
+                double err = (*constr)->error();
+                if (err * err < XconvergenceFine)
+                    redundant.insert(*constr);
+            }
+            resetToReference();
+
+            std::vector< std::vector<Constraint *> > conflictGroupsOrig=conflictGroups;
+            conflictGroups.clear();
+            for (int i=conflictGroupsOrig.size()-1; i >= 0; i--) {
+                bool isRedundant = false;
+                for (int j=0; j < conflictGroupsOrig[i].size(); j++) {
+                    if (redundant.count(conflictGroupsOrig[i][j]) > 0) {
+                        isRedundant = true;
+                        break;
+                    }
                 }
+                if (!isRedundant)
+                    conflictGroups.push_back(conflictGroupsOrig[i]);
+                else
+                    constrNumC--;
             }
-            conflictingTagsSet.erase(0); // exclude constraints tagged with zero
-            conflictingTags.resize(conflictingTagsSet.size());
-            std::copy(conflictingTagsSet.begin(), conflictingTagsSet.end(),
-                      conflictingTags.begin());
-
-            // output of redundant tags
-            SET_I redundantTagsSet;
-            for (std::set<Constraint *>::iterator constr=redundant.begin();
-                 constr != redundant.end(); ++constr)
-                redundantTagsSet.insert((*constr)->getTag());
-            // remove tags represented at least in one non-redundant constraint
-            for (std::vector<Constraint *>::iterator constr=clist.begin();
-                 constr != clist.end(); ++constr)
-                if (redundant.count(*constr) == 0)
-                    redundantTagsSet.erase((*constr)->getTag());
-            redundantTags.resize(redundantTagsSet.size());
-            std::copy(redundantTagsSet.begin(), redundantTagsSet.end(),
-                      redundantTags.begin());
-
-            if (paramsNum == rank && constrNum > rank) { // over-constrained
-                hasDiagnosis = true;
-                dofs = paramsNum - constrNum;
-                return dofs;
+        }
+        delete subSysTmp;
+
+        for (int i=0; i < conflictGroups.size(); i++) {
+            for (int j=0; j < conflictGroups[i].size(); j++) {
+                conflictingTagsSet.insert(conflictGroups[i][j]->getTag());
             }
         }
-
-        hasDiagnosis = true;
-        dofs = paramsNum - rank;
-        return dofs;
     }
-    hasDiagnosis = true;
-    dofs = plist.size();
-    return dofs;
+
+    rank += rankC;
+    constrNum += constrNumC;
 }
 
 void System::clearSubSystems()
@@ -1525,6 +1858,11 @@ void System::clearSubSystems()
     free(subSystemsAux);
     subSystems.clear();
     subSystemsAux.clear();
+    solvedInputs.clear();
+    for (std::vector<Workspace *>::iterator it=workspaces.begin();
+         it != workspaces.end(); ++it)
+        delete *it;
+    workspaces.clear();
 }
 
 double lineSearch(SubSystem *subsys, Eigen::VectorXd &xdir)
@@ -66,6 +66,8 @@ namespace GCS
         std::vector< VEC_pD > plists;                    // partitioned plist except equality constraints
         std::vector< std::vector<Constraint *> > clists; // partitioned clist except equality constraints
         std::vector< MAP_pD_pD > reductionmaps;          // for simplification of equality constraints
+        std::vector< VEC_pD > fixedlists;                // partitioned constant parameters that the constraints depend on
+        std::vector< VEC_D > solvedInputs;               // values of fixedlists at the last successful solution
 
         int dofs;
         std::set<Constraint *> redundant;
@@ -74,10 +76,18 @@ namespace GCS
         bool hasUnknowns;  // if plist is filled with the unknown parameters
         bool hasDiagnosis; // if dofs, conflictingTags, redundantTags are up to date
         bool isInit;       // if plists, clists, reductionmaps are up to date
+        bool isIncremental; // if solving starts from the last solution instead of the reference
 
         int solve_BFGS(SubSystem *subsys, bool isFine);
         int solve_LM(SubSystem *subsys);
-        int solve_DL(SubSystem *subsys);
+        struct Workspace;
+        std::vector<Workspace *> workspaces; // per component buffers kept in incremental mode
+        int solve_DL(SubSystem *subsys, Workspace *ws=NULL);
+
+        struct SolveJob;
+        void solveComponent(SolveJob &job);
+        void diagnoseComponent(std::vector<Constraint *> &clistC, VEC_pD &plistC,
+                               int &rank, int &constrNum, SET_I &conflictingTagsSet);
     public:
         System();
         System(std::vector<Constraint *> clist_);
@@ -158,7 +168,7 @@ namespace GCS
         void rescaleConstraint(int id, double coeff);
 
         void declareUnknowns(VEC_pD &params);
-        void initSolution();
+        void initSolution(bool incremental=false);
 
         int solve(bool isFine=true, Algorithm alg=DogLeg);
         int solve(VEC_pD &params, bool isFine=true, Algorithm alg=DogLeg);
@@ -184,6 +194,17 @@ namespace GCS
     #define smallF            1e-20
     #define MaxIterations     100 //Note that the total number of iterations allowed is MaxIterations *xLength
 
+    ///////////////////////////////////////
+    // LM and DogLeg Solver parameters
+    ///////////////////////////////////////
+    #define SparseThreshold   200 //Subsystems with at least this number of parameters are solved with sparse matrices
+    #define IncrementalCheckIterations 50 //In incremental mode DogLeg gives up if the error decreases by less than 10% within this number of iterations
+
+    ///////////////////////////////////////
+    // Decoupled components parameters
+    ///////////////////////////////////////
+    #define ParallelThreshold 100 //Decoupled components are solved concurrently if they have at least this number of parameters in total
+
     ///////////////////////////////////////
     // Helper elements
     ///////////////////////////////////////
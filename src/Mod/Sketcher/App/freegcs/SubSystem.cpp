@@ -253,21 +253,81 @@ void SubSystem::calcJacobi()
 }
 */
 
-void SubSystem::calcJacobi(VEC_pD &params, Eigen::MatrixXd &jacobi)
+int SubSystem::pindex(double *param) const
 {
-    jacobi.setZero(csize, params.size());
+    // parameters of the constraints that are not redirected lie outside of pvals
+    if (psize == 0 || param < &pvals[0] || param >= &pvals[0] + psize)
+        return -1;
+    return int(param - &pvals[0]);
+}
+
+void SubSystem::getColumns(VEC_pD &params, std::vector<VEC_I> &pcols)
+{
+    // a variable can have several columns if params contains more than one
+    // of the original parameters that were reduced to it
+    pcols.clear();
+    pcols.resize(psize);
     for (int j=0; j < int(params.size()); j++) {
         MAP_pD_pD::const_iterator
           pmapfind = pmap.find(params[j]);
         if (pmapfind != pmap.end())
-            for (int i=0; i < csize; i++)
-                jacobi(i,j) = clist[i]->grad(pmapfind->second);
+            pcols[pindex(pmapfind->second)].push_back(j);
+    }
+}
+
+void SubSystem::calcJacobi(VEC_pD &params, Eigen::MatrixXd &jacobi)
+{
+    jacobi.setZero(csize, params.size());
+    std::vector<VEC_I> pcols;
+    getColumns(params, pcols);
+    VEC_D deriv;
+    for (int i=0; i < csize; i++) {
+        const VEC_pD &constr_params = clist[i]->params();
+        clist[i]->grad(deriv);
+        for (int k=0; k < int(constr_params.size()); k++) {
+            int p = pindex(constr_params[k]);
+            if (p >= 0) {
+                for (VEC_I::const_iterator j=pcols[p].begin(); j != pcols[p].end(); ++j)
+                    jacobi(i,*j) += deriv[k];
+            }
+        }
     }
 }
 
 void SubSystem::calcJacobi(Eigen::MatrixXd &jacobi)
 {
-    calcJacobi(plist, jacobi);
+    // the columns of plist are the positions in pvals
+    jacobi.setZero(csize, psize);
+    VEC_D deriv;
+    for (int i=0; i < csize; i++) {
+        const VEC_pD &constr_params = clist[i]->params();
+        clist[i]->grad(deriv);
+        for (int k=0; k < int(constr_params.size()); k++) {
+            int p = pindex(constr_params[k]);
+            if (p >= 0)
+                jacobi(i,p) += deriv[k];
+        }
+    }
+}
+
+void SubSystem::calcJacobi(Eigen::SparseMatrix<double> &jacobi)
+{
+    // only the parameters of each constraint give non-zero entries, the column
+    // of a parameter is its position in pvals and duplicates are summed up
+    std::vector< Eigen::Triplet<double> > entries;
+    entries.reserve(4*csize);
+    VEC_D deriv;
+    for (int i=0; i < csize; i++) {
+        const VEC_pD &constr_params = clist[i]->params();
+        clist[i]->grad(deriv);
+        for (int k=0; k < int(constr_params.size()); k++) {
+            int p = pindex(constr_params[k]);
+            if (p >= 0)
+                entries.push_back(Eigen::Triplet<double>(i, p, deriv[k]));
+        }
+    }
+    jacobi.resize(csize, psize);
+    jacobi.setFromTriplets(entries.begin(), entries.end());
 }
 
 void SubSystem::calcGrad(VEC_pD &params, Eigen::VectorXd &grad)
@@ -275,22 +335,39 @@ void SubSystem::calcGrad(VEC_pD &params, Eigen::VectorXd &grad)
     assert(grad.size() == int(params.size()));
 
     grad.setZero();
-    for (int j=0; j < int(params.size()); j++) {
-        MAP_pD_pD::const_iterator
-          pmapfind = pmap.find(params[j]);
-        if (pmapfind != pmap.end()) {
-            // assert(p2c.find(pmapfind->second) != p2c.end());
-            std::vector<Constraint *> constrs=p2c[pmapfind->second];
-            for (std::vector<Constraint *>::const_iterator constr = constrs.begin();
-                 constr != constrs.end(); ++constr)
-                grad[j] += (*constr)->error() * (*constr)->grad(pmapfind->second);
+    std::vector<VEC_I> pcols;
+    getColumns(params, pcols);
+    VEC_D deriv;
+    for (int i=0; i < csize; i++) {
+        const VEC_pD &constr_params = clist[i]->params();
+        double err = clist[i]->error();
+        clist[i]->grad(deriv);
+        for (int k=0; k < int(constr_params.size()); k++) {
+            int p = pindex(constr_params[k]);
+            if (p >= 0) {
+                for (VEC_I::const_iterator j=pcols[p].begin(); j != pcols[p].end(); ++j)
+                    grad[*j] += err * deriv[k];
+            }
         }
     }
 }
 
 void SubSystem::calcGrad(Eigen::VectorXd &grad)
 {
-    calcGrad(plist, grad);
+    assert(grad.size() == psize);
+
+    grad.setZero();
+    VEC_D deriv;
+    for (int i=0; i < csize; i++) {
+        const VEC_pD &constr_params = clist[i]->params();
+        double err = clist[i]->error();
+        clist[i]->grad(deriv);
+        for (int k=0; k < int(constr_params.size()); k++) {
+            int p = pindex(constr_params[k]);
+            if (p >= 0)
+                grad[p] += err * deriv[k];
+        }
+    }
 }
 
 double SubSystem::maxStep(VEC_pD &params, Eigen::VectorXd &xdir)
@@ -20,7 +20,7 @@
 #**************************************************************************
 
 
-import FreeCAD, os, sys, unittest, Part, Sketcher
+import FreeCAD, os, sys, math, unittest, Part, Sketcher
 App = FreeCAD
 
 def CreateBoxSketchSet(SketchFeature):
@@ -83,6 +83,69 @@ def CreateSlotPlateInnerSet(SketchFeature):
 	SketchFeature.addConstraint(Sketcher.Constraint('Coincident',8,2,5,1))
 	
 
+def CreateGridSketchSet(SketchFeature, count, size=10.0):
+	# a grid of count x count cells where each line has a fixed length and
+	# direction and starts on another line. There are no equality constraints,
+	# so the solver gets one big system where no parameter is eliminated.
+	# Returns the pairs of the line and the line its start point lies on.
+	def point(i, j):
+		return App.Vector(j * size + 0.1 * ((i * 7 + j * 3) % 5), i * size + 0.1 * ((i * 3 + j * 7) % 5), 0)
+	horizontal = {}
+	vertical = {}
+	for i in range(count + 1):
+		for j in range(count + 1):
+			if j < count:
+				horizontal[(i, j)] = SketchFeature.addGeometry(Part.Line(point(i, j), point(i, j + 1)))
+			if i < count:
+				vertical[(i, j)] = SketchFeature.addGeometry(Part.Line(point(i, j), point(i + 1, j)))
+	links = []
+	for (i, j), geo in horizontal.items():
+		SketchFeature.addConstraint(Sketcher.Constraint('Distance', geo, size))
+		SketchFeature.addConstraint(Sketcher.Constraint('Angle', geo, 0.0))
+		if j > 0:
+			links.append((geo, horizontal[(i, j - 1)]))
+		elif i > 0:
+			links.append((geo, vertical[(i - 1, 0)]))
+	for (i, j), geo in vertical.items():
+		SketchFeature.addConstraint(Sketcher.Constraint('Distance', geo, size))
+		SketchFeature.addConstraint(Sketcher.Constraint('Angle', geo, math.pi / 2))
+		links.append((geo, horizontal[(i, min(j, count - 1))]))
+	for geo, other in links:
+		SketchFeature.addConstraint(Sketcher.Constraint('PointOnObject', geo, 1, other))
+	first = horizontal[(0, 0)]
+	SketchFeature.addConstraint(Sketcher.Constraint('DistanceX', first, 1, 0.0))
+	SketchFeature.addConstraint(Sketcher.Constraint('DistanceY', first, 1, 0.0))
+	return links
+
+def CreateProfilesSketchSet(SketchFeature, count, size=10.0):
+	# count rectangles that are not connected to each other, so that the
+	# solver gets count decoupled components
+	for k in range(count):
+		x = k * 2 * size
+		geo = SketchFeature.addGeometry(Part.Line(App.Vector(x,0,0),App.Vector(x+size,0,0)))
+		SketchFeature.addGeometry(Part.Line(App.Vector(x+size,0,0),App.Vector(x+size,size,0)))
+		SketchFeature.addGeometry(Part.Line(App.Vector(x+size,size,0),App.Vector(x,size,0)))
+		SketchFeature.addGeometry(Part.Line(App.Vector(x,size,0),App.Vector(x,0,0)))
+		for i in range(4):
+			SketchFeature.addConstraint(Sketcher.Constraint('Coincident',geo+i,2,geo+(i+1)%4,1))
+		SketchFeature.addConstraint(Sketcher.Constraint('Horizontal',geo))
+		SketchFeature.addConstraint(Sketcher.Constraint('Horizontal',geo+2))
+		SketchFeature.addConstraint(Sketcher.Constraint('Vertical',geo+1))
+		SketchFeature.addConstraint(Sketcher.Constraint('Vertical',geo+3))
+		SketchFeature.addConstraint(Sketcher.Constraint('Distance',geo,size))
+		SketchFeature.addConstraint(Sketcher.Constraint('Distance',geo+1,size))
+
+def CreateChainSketchSet(SketchFeature, count, size=10.0):
+	# zigzag of count connected lines with fixed lengths, so that most
+	# of the sketch follows when its first point is dragged
+	for i in range(count):
+		p1 = App.Vector(i * size * 0.8, (i % 2) * size * 0.6, 0)
+		p2 = App.Vector((i + 1) * size * 0.8, ((i + 1) % 2) * size * 0.6, 0)
+		SketchFeature.addGeometry(Part.Line(p1,p2))
+		SketchFeature.addConstraint(Sketcher.Constraint('Distance',i,size))
+		if i > 0:
+			SketchFeature.addConstraint(Sketcher.Constraint('Coincident',i-1,2,i,1))
+
 
 #---------------------------------------------------------------------------
 # define the test cases to test the FreeCAD Sketcher module
@@ -113,6 +176,87 @@ class SketcherSolverTestCases(unittest.TestCase):
 		CreateSlotPlateInnerSet(self.Slot)
 		self.Doc.recompute()
 		self.failUnless(len(self.Slot.Shape.Edges) == 9)
+
+	def testLargeGridCase(self):
+		# a big connected sketch with 4 * 312 parameters is solved with sparse matrices
+		self.Grid = self.Doc.addObject('Sketcher::SketchObject','SketchGrid')
+		links = CreateGridSketchSet(self.Grid, 12)
+		self.Doc.recompute()
+		self.failUnless(self.Grid.State == ["Up-to-date"])
+		self.failUnless(len(self.Grid.Shape.Edges) == 2 * 12 * 13)
+		for geo in self.Grid.Geometry:
+			dir = geo.EndPoint - geo.StartPoint
+			self.failUnless(abs(dir.Length - 10.0) < 1e-6)
+			self.failUnless(abs(dir.x) < 1e-6 or abs(dir.y) < 1e-6)
+		for geo, other in links:
+			p = self.Grid.Geometry[geo].StartPoint
+			line = self.Grid.Geometry[other]
+			dir = line.EndPoint - line.StartPoint
+			self.failUnless((p - line.StartPoint).cross(dir).Length / dir.Length < 1e-6)
+
+	def testManyProfilesCase(self):
+		# the decoupled profiles of a sketch are solved one by one
+		self.Profiles = self.Doc.addObject('Sketcher::SketchObject','SketchProfiles')
+		CreateProfilesSketchSet(self.Profiles, 40)
+		self.Doc.recompute()
+		self.failUnless(len(self.Profiles.Shape.Edges) == 4 * 40)
+		# moving a point of one profile must not move the other ones
+		other = self.Profiles.Geometry[4].StartPoint
+		self.Profiles.movePoint(0,1,App.Vector(-5.0,-5.0,0))
+		self.failUnless(self.Profiles.Geometry[0].StartPoint.distanceToPoint(App.Vector(-5.0,-5.0,0)) < 1e-6)
+		self.failUnless(self.Profiles.Geometry[4].StartPoint.distanceToPoint(other) < 1e-6)
+
+	def testSolveTwiceCase(self):
+		# solving a solved sketch again must keep it and a changed dimension must be applied
+		self.Twice = self.Doc.addObject('Sketcher::SketchObject','SketchTwice')
+		CreateProfilesSketchSet(self.Twice, 2)
+		self.Doc.recompute()
+		self.Twice.touch()
+		self.Doc.recompute()
+		for geo in self.Twice.Geometry:
+			self.failUnless(abs(geo.StartPoint.distanceToPoint(geo.EndPoint) - 10.0) < 1e-6)
+		# the distance of the first line of the second profile
+		self.Twice.setDatum(18, 15.0)
+		self.failUnless(abs(self.Twice.Geometry[4].StartPoint.distanceToPoint(self.Twice.Geometry[4].EndPoint) - 15.0) < 1e-6)
+		self.failUnless(abs(self.Twice.Geometry[0].StartPoint.distanceToPoint(self.Twice.Geometry[0].EndPoint) - 10.0) < 1e-6)
+
+	def testSolveSketchAgainCase(self):
+		# a sketch that is kept alive solves again only the profiles whose constant parameters have changed
+		self.Profiles = self.Doc.addObject('Sketcher::SketchObject','SketchAgain')
+		CreateProfilesSketchSet(self.Profiles, 2)
+		sketch = Sketcher.Sketch()
+		self.failUnless(sketch.setUp(self.Profiles.Geometry, self.Profiles.Constraints) == 4)
+		self.failUnless(sketch.solve() == 0)
+		solved = sketch.Geometries
+		self.failUnless(sketch.solve() == 0)
+		for geo, old in zip(sketch.Geometries, solved):
+			self.failUnless(geo.StartPoint.distanceToPoint(old.StartPoint) < 1e-12)
+			self.failUnless(geo.EndPoint.distanceToPoint(old.EndPoint) < 1e-12)
+		# dragging the first profile must not change the second one
+		for k in range(1,6):
+			self.failUnless(sketch.movePoint(0,1,App.Vector(-k,-k,0)) == 0)
+		geos = sketch.Geometries
+		self.failUnless(geos[0].StartPoint.distanceToPoint(App.Vector(-5.0,-5.0,0)) < 1e-6)
+		for geo in geos:
+			self.failUnless(abs(geo.StartPoint.distanceToPoint(geo.EndPoint) - 10.0) < 1e-6)
+		for geo, old in zip(geos[4:], solved[4:]):
+			self.failUnless(geo.StartPoint.distanceToPoint(old.StartPoint) < 1e-12)
+			self.failUnless(geo.EndPoint.distanceToPoint(old.EndPoint) < 1e-12)
+
+	def testDragChainCase(self):
+		# moving the first point of a big chain step by step must keep the lengths of all lines,
+		# like in the editor all moves of the drag are solved by the same sketch
+		self.Chain = self.Doc.addObject('Sketcher::SketchObject','SketchChain')
+		CreateChainSketchSet(self.Chain, 100)
+		self.Doc.recompute()
+		sketch = Sketcher.Sketch()
+		sketch.setUp(self.Chain.Geometry, self.Chain.Constraints)
+		for k in range(1,11):
+			self.failUnless(sketch.movePoint(0,1,App.Vector(-k,k,0)) == 0)
+			geos = sketch.Geometries
+			self.failUnless(geos[0].StartPoint.distanceToPoint(App.Vector(-k,k,0)) < 1e-6)
+			for geo in geos:
+				self.failUnless(abs(geo.StartPoint.distanceToPoint(geo.EndPoint) - 10.0) < 1e-6)
 	
 	
 	def tearDown(self):
@@ -165,6 +165,18 @@ class DocumentBasicCases(unittest.TestCase):
       self.failUnless(False)
     del L2
 
+  def testInList(self):
+    T = self.Doc.addObject("App::FeatureTest","Target")
+    for name in ["C","A","B"]:
+      L = self.Doc.addObject("App::FeaturePython",name)
+      L.addProperty("App::PropertyLink","Link")
+      L.Link = T
+    # the objects linking to T are sorted by their names
+    self.failUnless([o.Name for o in T.InList] == ["A","B","C"])
+    # removing the link property removes the link
+    self.Doc.getObject("B").removeProperty("Link")
+    self.failUnless([o.Name for o in T.InList] == ["A","C"])
+
   def tearDown(self):
     #closing doc
     FreeCAD.closeDocument("CreateTest")
@@ -250,6 +262,82 @@ class DocumentRecomputeCases(unittest.TestCase):
     #closing doc
     FreeCAD.closeDocument("RecomputeTests")
 
+class ChainFeature:
+  """Adds one to the value of its source and records the order of execution"""
+  def __init__(self, obj, log):
+    obj.addProperty("App::PropertyLink","Source")
+    obj.addProperty("App::PropertyInteger","Value")
+    obj.Proxy = self
+    self.log = log
+
+  def execute(self, obj):
+    value = 0
+    if obj.Source:
+      value = obj.Source.Value
+    obj.Value = value + 1
+    self.log.append(obj.Name)
+
+class DocumentParallelRecomputeCases(unittest.TestCase):
+  def setUp(self):
+    self.Doc = FreeCAD.newDocument("ParallelRecomputeTests")
+    self.Doc.RecomputeThreads = 4
+    self.Log = []
+
+  def addChain(self, name, length):
+    source = None
+    chain = []
+    for i in range(length):
+      obj = self.Doc.addObject("App::FeaturePython",name + str(i))
+      ChainFeature(obj, self.Log)
+      obj.Source = source
+      source = obj
+      chain.append(obj)
+    return chain
+
+  def testIndependentChains(self):
+    chains = [self.addChain(name, 4) for name in ["A","B","C"]]
+    self.Doc.recompute()
+
+    # each object is executed once after its source
+    self.failUnless(len(self.Log) == 12)
+    for chain in chains:
+      for i in range(len(chain)):
+        self.failUnless(chain[i].Value == i + 1)
+        self.failUnless(self.Log.count(chain[i].Name) == 1)
+        if i > 0:
+          self.failUnless(self.Log.index(chain[i-1].Name) < self.Log.index(chain[i].Name))
+
+    # only the touched object and its dependents are recomputed
+    self.Log[:] = []
+    chains[1][2].touch()
+    self.Doc.recompute()
+    self.failUnless(sorted(self.Log) == ["B2","B3"])
+
+  def testDependentObjects(self):
+    sources = []
+    for i in range(6):
+      sources.append(self.Doc.addObject("App::FeatureTest","Source" + str(i)))
+    target = self.Doc.addObject("App::FeatureTest","Target")
+    target.SourceN = sources
+    self.Doc.recompute()
+
+    for obj in sources + [target]:
+      self.failUnless(obj.ExecCount == 1)
+      self.failUnless(obj.ExecResult == "Exec")
+      self.failUnless(obj.State == ["Up-to-date"])
+
+    # the result matches the serial recompute
+    sources[0].touch()
+    self.Doc.RecomputeThreads = 1
+    self.Doc.recompute()
+    self.failUnless(sources[0].ExecCount == 2)
+    self.failUnless(sources[1].ExecCount == 1)
+    self.failUnless(target.ExecCount == 2)
+
+  def tearDown(self):
+    #closing doc
+    FreeCAD.closeDocument("ParallelRecomputeTests")
+
 class UndoRedoCases(unittest.TestCase):
   def setUp(self):
     self.Doc = FreeCAD.newDocument("UndoTest")
@@ -620,6 +708,57 @@ class DocumentPlatformCases(unittest.TestCase):
   def tearDown(self):
     #closing doc
     FreeCAD.closeDocument("PlatformTests")
+
+class DocumentLazyRestoreCases(unittest.TestCase):
+  def setUp(self):
+    self.Param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+    self.Lazy = self.Param.GetBool("LazyRestore",False)
+    self.Param.SetBool("LazyRestore",True)
+    self.Doc = FreeCAD.newDocument("LazyRestoreTests")
+    # both lists are saved as data files
+    First = self.Doc.addObject("App::FeatureTest","First")
+    First.VectorList = [(1.0,2.0,3.0),(4.0,5.0,6.0)]
+    First.FloatList = [0.5,1.5]
+    Second = self.Doc.addObject("App::FeatureTest","Second")
+    Second.VectorList = [(7.0,8.0,9.0)]
+    self.DocName = tempfile.gettempdir() + os.sep + "LazyRestoreTests.FCStd"
+    self.Doc.FileName = self.DocName
+    self.Doc.save()
+    FreeCAD.closeDocument("LazyRestoreTests")
+
+  def testAccess(self):
+    self.Doc = FreeCAD.open(self.DocName)
+    First = self.Doc.getObject("First")
+    Second = self.Doc.getObject("Second")
+    self.failUnless(self.Doc.hasPendingFiles(First))
+    self.failUnless(self.Doc.hasPendingFiles(Second))
+
+    # accessing an object reads its data but not the data of other objects
+    self.failUnless(len(First.VectorList) == 2)
+    self.failUnless(not self.Doc.hasPendingFiles(First))
+    self.failUnless(self.Doc.hasPendingFiles(Second))
+    self.failUnless(First.VectorList[1] == FreeCAD.Vector(4.0,5.0,6.0))
+    self.failUnless(First.FloatList == [0.5,1.5])
+
+    self.failUnless(Second.VectorList == [FreeCAD.Vector(7.0,8.0,9.0)])
+    self.failUnless(not self.Doc.hasPendingFiles(Second))
+
+  def testSaveWithPendingFiles(self):
+    # the data that is still deferred must be written again
+    self.Doc = FreeCAD.open(self.DocName)
+    self.failUnless(self.Doc.hasPendingFiles(self.Doc.getObject("Second")))
+    self.Doc.save()
+    FreeCAD.closeDocument("LazyRestoreTests")
+
+    self.Param.SetBool("LazyRestore",False)
+    self.Doc = FreeCAD.open(self.DocName)
+    self.failUnless(not self.Doc.hasPendingFiles(self.Doc.getObject("Second")))
+    self.failUnless(self.Doc.Second.VectorList == [FreeCAD.Vector(7.0,8.0,9.0)])
+    self.failUnless(len(self.Doc.First.VectorList) == 2)
+
+  def tearDown(self):
+    self.Param.SetBool("LazyRestore",self.Lazy)
+    FreeCAD.closeDocument("LazyRestoreTests")
 class DocumentFileIncludeCases(unittest.TestCase):
   def setUp(self):
     self.Doc = FreeCAD.newDocument("FileIncludeTests")
@@ -55,6 +55,11 @@ void ZipOutputStream::putNextEntry(const std::string& entryName) {
   putNextEntry( ZipCDirEntry(entryName));
 }
 
+void ZipOutputStream::putRawEntry( const std::string& entryName, const char *data, uint32 size,
+                                   uint32 crc, uint32 uncompressed_size ) {
+  ozf->putRawEntry( ZipCDirEntry(entryName), data, size, crc, uncompressed_size ) ;
+}
+
 
 void ZipOutputStream::setComment( const std::string &comment ) {
   ozf->setComment( comment ) ;
@@ -10,6 +10,9 @@
 #include "ziphead.h"
 #include "zipoutputstreambuf.h"
 
+// FreeCAD: entries deflated by the caller can be appended with putRawEntry()
+#define ZIPIOS_HAVE_RAW_ENTRY
+
 namespace zipios {
 
 /** \anchor ZipOutputStream_anchor
@@ -54,6 +57,11 @@ public:
   */
   void putNextEntry(const std::string& entryName);
 
+  /** Writes an entry whose data has already been deflated by the caller,
+      see ZipOutputStreambuf::putRawEntry(). */
+  void putRawEntry( const std::string& entryName, const char *data, uint32 size,
+                    uint32 crc, uint32 uncompressed_size ) ;
+
   /** Sets the global comment for the Zip archive. */
   void setComment( const std::string& comment ) ;
 
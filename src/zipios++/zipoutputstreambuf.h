@@ -49,6 +49,16 @@ public:
       entry. */
   void putNextEntry( const ZipCDirEntry &entry ) ;
 
+  /** Writes an entry whose data has already been deflated by the caller
+      (raw deflate stream without zlib header). Any open entry is closed
+      first and no entry is open afterwards.
+      @param data the deflated data.
+      @param size the size of the deflated data.
+      @param crc the crc32 of the uncompressed data.
+      @param uncompressed_size the size of the uncompressed data. */
+  void putRawEntry( const ZipCDirEntry &entry, const char *data, uint32 size,
+                    uint32 crc, uint32 uncompressed_size ) ;
+
   /** Sets the global comment for the Zip archive. */
   void setComment( const string &comment ) ;
 
@@ -68,6 +78,7 @@ protected:
 
   void setEntryClosedState() ;
   void updateEntryHeaderInfo() ;
+  static int currentDosTime() ;
 
   // Should/could be moved to zipheadio.h ?!
   static void writeCentralDirectory( const vector< ZipCDirEntry > &entries, 